@@ -1,4 +1,26 @@
 set(TESTS
+    test_common_hex_round_trip
+    test_common_hex_to_bytes_lower_case
+    test_common_hex_to_bytes_invalid
+    test_common_hex_span_to_bytes
+    test_common_nfc_next_line
+    test_common_set_allocator
+    test_common_arena
+    test_common_context
+    test_common_random_pool_seeded
+    test_common_crc32
+    test_json_reader_members
+    test_json_reader_fallback
+    test_json_reader_key_index
+    test_detect_binary_sizes
+    test_detect_binary_amiibo
+    test_detect_text
+    test_columns_filter_column
+    test_columns_query_amiibo
+    test_columns_mfc1k
+    test_delta_diff
+    test_delta_ntag215
+    test_delta_mfc1k
     test_ntag21x_validate_manufacturer_data
     test_ntag21x_validate_manufacturer_data_failed
     test_ntag21x_randomize_uid
@@ -14,11 +36,15 @@ set(TESTS
     test_ntag215_parse_data_from_json_missing_or_invalid
     test_ntag215_parse_json_success
     test_ntag215_parse_json_errors
+    test_ntag215_parse_json_out_of_order
     test_ntag215_dump_header_to_json
     test_ntag215_dump_data_to_json
     test_ntag215_serialize_json
+    test_ntag215_serialize_json_matches_cjson
+    test_ntag215_serialize_into
     test_ntag215_parse_nfc_success
     test_ntag215_parse_nfc_errors
+    test_ntag215_parse_nfc_crlf
     test_ntag215_serialize_nfc
     test_ntag215_generate_success
     test_ntag215_wipe
@@ -32,11 +58,15 @@ set(TESTS
     test_ntag215_load_binary_dump_with_header
     test_ntag215_save_binary_and_reload
     test_ntag215_load_binary_dump_real
+    test_ntag215_map_binary
     test_ntag215_load_json_dump_real
     test_ntag215_save_json_dump_and_reload
     test_ntag215_load_nfc_dump_real
     test_ntag215_save_nfc_dump_and_reload
+    test_mfc1k_serialize_json_matches_cjson
+    test_mfc1k_serialize_into
     test_mfc1k_load_binary_dump_real
+    test_mfc1k_map_binary
     test_mfc1k_save_binary_and_reload
     test_mfc1k_load_json_dump_real
     test_mfc1k_save_json_dump_and_reload
@@ -54,6 +84,7 @@ set(TESTS
     test_rfidx_read_tag_from_file_ntag215
     test_rfidx_read_tag_from_file_amiibo
     test_rfidx_read_tag_from_file_unknown
+    test_rfidx_read_tag_from_file_detect
     test_rfidx_read_tag_from_file_missing
     test_rfidx_save_tag_to_file_binary
     test_rfidx_save_tag_to_file_invalid_format
@@ -64,6 +95,24 @@ set(TESTS
     test_rfidx_randomize_uid_mfc1k
     test_rfidx_randomize_uid_amiibo
     test_rfidx_generate_amiibo
+    test_rfidx_write_file_vectored
+    test_rfidx_in_place_wipe_ntag215
+    test_rfidx_in_place_randomize_uid_mfc1k
+    test_rfidx_read_fd_pipe
+    test_rfidx_read_tag_from_buffer_nfc
+    test_rfidx_binary_to_stdout
+    test_rfidx_stdin_needs_format
+    test_rfidx_convert_stream_mfc1k_wipe
+    test_rfidx_convert_stream_partial_record
+    test_rfidx_output_format_list
+    test_rfidx_fan_out_formats
+    test_rfidx_batch_convert
+    test_rfidx_run_manifest
+    test_rfidx_watch
+    test_rfidx_convert_cached
+    test_rfidx_archive
+    test_rfidx_uid_index
+    test_rfidx_store
 )
 
 foreach(TEST ${TESTS})
@@ -0,0 +1,155 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Startup latency benchmark for the rfidx CLI.
+ *
+ * Scripts call rfidx once per file, so the time from exec to exit matters as much as the
+ * parsers themselves. Each case spawns the binary repeatedly with its output discarded and
+ * reports the wall-clock time of the whole process.
+ *
+ * Usage: bench_startup [rfidx-executable] [assets-directory] [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#ifndef RFIDX_BENCH_EXECUTABLE
+#define RFIDX_BENCH_EXECUTABLE "./rfidx"
+#endif
+#ifndef RFIDX_BENCH_ASSETS
+#define RFIDX_BENCH_ASSETS "tests/assets"
+#endif
+
+#define BENCH_DEFAULT_ITERATIONS 200
+#define BENCH_MAX_ARGS 8
+
+extern char **environ;
+
+typedef struct {
+    const char *name;
+    const char *args[BENCH_MAX_ARGS];   /**< Arguments after the executable; "@" is replaced by the asset */
+    const char *asset;                  /**< Asset file name, or NULL */
+} BenchCase;
+
+static const BenchCase bench_cases[] = {
+    {"help (exec only)", {"-h"}, NULL},
+    {"ntag215 binary", {"-I", "ntag215", "-i", "@"}, "ntag215.bin"},
+    {"ntag215 json", {"-I", "ntag215", "-i", "@"}, "ntag215.json"},
+    {"ntag215 nfc", {"-I", "ntag215", "-i", "@"}, "ntag215.nfc"},
+    {"mfc1k binary", {"-I", "mfc1k", "-i", "@"}, "mifare-classic-1k-v2.bin"},
+    {"mfc1k json", {"-I", "mfc1k", "-i", "@"}, "mifare-classic-1k-v2.json"},
+    {"mfc1k nfc", {"-I", "mfc1k", "-i", "@"}, "mifare-classic-1k-v2.nfc"},
+    {"ntag215 nfc -> json", {"-I", "ntag215", "-i", "@", "-F", "json"}, "ntag215.nfc"},
+    {"ntag215 wipe", {"-I", "ntag215", "-i", "@", "-t", "wipe"}, "ntag215.nfc"},
+    {"ntag215 randomize-uid", {"-I", "ntag215", "-i", "@", "-t", "randomize-uid"}, "ntag215.nfc"},
+};
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e6 + (double) ts.tv_nsec / 1e3;
+}
+
+static int compare_double(const void *a, const void *b) {
+    const double x = *(const double *) a;
+    const double y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+static int run_once(const char *executable, char **argv, posix_spawn_file_actions_t *actions, double *elapsed) {
+    pid_t pid;
+    const double start = now_us();
+    if (posix_spawn(&pid, executable, actions, NULL, argv, environ) != 0) {
+        return -1;
+    }
+
+    int status;
+    if (waitpid(pid, &status, 0) < 0) {
+        return -1;
+    }
+    *elapsed = now_us() - start;
+
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+int main(const int argc, char **argv) {
+    const char *executable = argc > 1 ? argv[1] : RFIDX_BENCH_EXECUTABLE;
+    const char *assets = argc > 2 ? argv[2] : RFIDX_BENCH_ASSETS;
+    const int iterations = argc > 3 ? atoi(argv[3]) : BENCH_DEFAULT_ITERATIONS;
+    if (iterations <= 0) {
+        fprintf(stderr, "Iterations must be a positive number.\n");
+        return EXIT_FAILURE;
+    }
+
+    // Discard the output so terminal speed does not leak into the numbers
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+    double *samples = malloc(sizeof(double) * (size_t) iterations);
+    if (!samples) {
+        posix_spawn_file_actions_destroy(&actions);
+        return EXIT_FAILURE;
+    }
+
+    printf("%-24s %10s %10s %10s\n", "case", "min (us)", "median", "mean");
+
+    int result = EXIT_SUCCESS;
+    for (size_t c = 0; c < sizeof(bench_cases) / sizeof(bench_cases[0]); c++) {
+        const BenchCase *bench = &bench_cases[c];
+
+        char asset_path[4096];
+        if (bench->asset) {
+            snprintf(asset_path, sizeof(asset_path), "%s/%s", assets, bench->asset);
+        }
+
+        char *child_argv[BENCH_MAX_ARGS + 2] = {0};
+        child_argv[0] = (char *) executable;
+        for (size_t i = 0; i < BENCH_MAX_ARGS && bench->args[i]; i++) {
+            child_argv[i + 1] = strcmp(bench->args[i], "@") == 0 ? asset_path : (char *) bench->args[i];
+        }
+
+        double total = 0;
+        int failed = 0;
+        for (int i = 0; i < iterations; i++) {
+            if (run_once(executable, child_argv, &actions, &samples[i]) != 0) {
+                failed = 1;
+                break;
+            }
+            total += samples[i];
+        }
+
+        if (failed) {
+            printf("%-24s %10s\n", bench->name, "failed");
+            result = EXIT_FAILURE;
+            continue;
+        }
+
+        qsort(samples, (size_t) iterations, sizeof(double), compare_double);
+        printf("%-24s %10.1f %10.1f %10.1f\n",
+               bench->name,
+               samples[0],
+               samples[iterations / 2],
+               total / iterations
+        );
+    }
+
+    free(samples);
+    posix_spawn_file_actions_destroy(&actions);
+
+    return result;
+}
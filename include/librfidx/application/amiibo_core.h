@@ -264,6 +264,12 @@ RFIDX_EXPORT RfidxStatus amiibo_generate(
     AmiiboData *amiibo_data,
     Ntag21xMetadataHeader *header
 );
+RFIDX_EXPORT RfidxStatus amiibo_generate_ctx(
+    RfidxContext *ctx,
+    const uint8_t *uuid,
+    AmiiboData *amiibo_data,
+    Ntag21xMetadataHeader *header
+);
 
 /**
  * @brief Wipe the Amiibo data
@@ -282,6 +288,14 @@ RFIDX_EXPORT RfidxStatus amiibo_transform_data(
     const uint8_t *uuid,
     const DumpedKeys *dumped_keys
 );
+RFIDX_EXPORT RfidxStatus amiibo_transform_data_ctx(
+    RfidxContext *ctx,
+    AmiiboData **amiibo_data,
+    Ntag21xMetadataHeader **header,
+    TransformCommand command,
+    const uint8_t *uuid,
+    const DumpedKeys *dumped_keys
+);
 
 _Static_assert(sizeof(DumpedKeySingle) == 80, "Amiibo single key size mismatch");
 _Static_assert(sizeof(DumpedKeys) == 160, "Amiibo combined key size mismatch");
@@ -0,0 +1,226 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBRFIDX_ARCHIVE_H
+#define LIBRFIDX_ARCHIVE_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "librfidx/common.h"
+#include "librfidx/mapping.h"
+#include "librfidx/batch.h"
+#include "librfidx/columns.h"
+
+/*
+ * Archive layout, all integers little-endian:
+ *
+ *   header   RFIDX_ARCHIVE_HEADER_SIZE bytes
+ *   records  record_count * record_size bytes, from RFIDX_ARCHIVE_HEADER_SIZE
+ *   index    record_count * RFIDX_ARCHIVE_INDEX_ENTRY_SIZE bytes, at index_offset
+ *   names    the names of the records, back to back, right after the index
+ *
+ * A record is a CRC-32 of the rest of the record, followed by the metadata header and the
+ * data of the tag, as the packed structures of the tag type. The index is written when the
+ * archive is closed; an archive that was never closed has index_offset 0 and is rejected.
+ */
+#define RFIDX_ARCHIVE_MAGIC "RFIDXARC"
+#define RFIDX_ARCHIVE_VERSION 1
+#define RFIDX_ARCHIVE_HEADER_SIZE 64
+#define RFIDX_ARCHIVE_INDEX_ENTRY_SIZE 16
+#define RFIDX_ARCHIVE_CRC_SIZE 4
+
+/**
+ * @brief An archive opened for appending
+ *
+ * The index is kept in memory, and written out by rfidx_archive_close().
+ */
+typedef struct {
+    FILE *file;
+    TagType tag_type;           /**< NTAG_215, AMIIBO or MFC_1K */
+    size_t header_size;         /**< Size of the metadata header in each record */
+    size_t data_size;           /**< Size of the tag data in each record */
+    uint8_t *record;            /**< Scratch buffer for one record */
+    uint64_t *offsets;          /**< Offset of every record */
+    uint32_t *name_offsets;     /**< Offset of every name in names */
+    char *names;
+    size_t names_len;
+    size_t names_cap;
+    size_t count;
+    size_t cap;
+} RfidxArchiveWriter;
+
+/**
+ * @brief An archive mapped read-only
+ */
+typedef struct {
+    RfidxMapping mapping;
+    TagType tag_type;
+    size_t header_size;         /**< Size of the metadata header in each record */
+    size_t data_size;           /**< Size of the tag data in each record */
+    size_t record_size;         /**< CRC, metadata header and data */
+    size_t count;
+    const uint8_t *index;       /**< The index, inside the mapping */
+    const char *names;          /**< The names, inside the mapping */
+    size_t names_len;
+} RfidxArchive;
+
+/**
+ * @brief One record of a mapped archive
+ *
+ * The pointers are into the mapping, and valid until the archive is unmapped. The tag
+ * structures are packed, so they can be used in place.
+ */
+typedef struct {
+    const void *header;         /**< Ntag21xMetadataHeader or MfcMetadataHeader */
+    const void *data;           /**< Ntag215Data or Mfc1kData */
+    const char *name;           /**< Name of the record, not null-terminated */
+    size_t name_len;
+} RfidxArchiveRecord;
+
+/**
+ * @brief Called by rfidx_archive_iterate() for every record
+ * @return RFIDX_OK to carry on, anything else to stop and return it
+ */
+typedef RfidxStatus (*RfidxArchiveVisitor)(size_t number, const RfidxArchiveRecord *record, void *user);
+
+/**
+ * @brief Create an empty archive, replacing any file at the path
+ * @param filename Path of the archive.
+ * @param tag_type Type of every record: NTAG_215, AMIIBO or MFC_1K.
+ * @param writer Set to the open archive.
+ * @return RFIDX_OK, RFIDX_UNKNOWN_ENUM_ERROR for another tag type, or RFIDX_BINARY_FILE_IO_ERROR
+ */
+RFIDX_EXPORT RfidxStatus rfidx_archive_create(const char *filename, TagType tag_type, RfidxArchiveWriter *writer);
+
+/**
+ * @brief Open an existing archive to append records to it
+ *
+ * The index is read back into memory, and is overwritten by the new records.
+ * @param filename Path of the archive.
+ * @param writer Set to the open archive.
+ * @return RFIDX_OK, RFIDX_FILE_FORMAT_ERROR if the file is not a complete archive, or an I/O error
+ */
+RFIDX_EXPORT RfidxStatus rfidx_archive_open(const char *filename, RfidxArchiveWriter *writer);
+
+/**
+ * @brief Append a record
+ * @param writer The open archive.
+ * @param data The tag data, Ntag215Data or Mfc1kData.
+ * @param header The metadata header, Ntag21xMetadataHeader or MfcMetadataHeader. NULL for a blank one.
+ * @param name Name of the record, usually the path it was packed from. Can be NULL.
+ * @return RfidxStatus indicating success or failure of the write
+ */
+RFIDX_EXPORT RfidxStatus rfidx_archive_append(
+    RfidxArchiveWriter *writer,
+    const void *data,
+    const void *header,
+    const char *name
+);
+
+/**
+ * @brief Write the index and close the archive
+ *
+ * The writer is released even if writing fails.
+ * @param writer The open archive.
+ * @return RfidxStatus indicating success or failure of the write
+ */
+RFIDX_EXPORT RfidxStatus rfidx_archive_close(RfidxArchiveWriter *writer);
+
+/**
+ * @brief Map an archive for reading
+ *
+ * The header and the bounds of the index are checked. Records are checked when they are read.
+ * @param filename Path of the archive.
+ * @param archive Set to the mapped archive.
+ * @return RFIDX_OK, RFIDX_FILE_FORMAT_ERROR if the file is not a complete archive, or an I/O error
+ */
+RFIDX_EXPORT RfidxStatus rfidx_archive_map(const char *filename, RfidxArchive *archive);
+
+/**
+ * @brief Get a record by its number
+ * @param archive The mapped archive.
+ * @param number Number of the record, from 0.
+ * @param record Set to the record.
+ * @return RFIDX_OK, RFIDX_BUFFER_SIZE_ERROR past the last record, or RFIDX_CHECKSUM_ERROR if the
+ * record is damaged
+ */
+RFIDX_EXPORT RfidxStatus rfidx_archive_get(const RfidxArchive *archive, size_t number, RfidxArchiveRecord *record);
+
+/**
+ * @brief Visit every record in order
+ * @param archive The mapped archive.
+ * @param visit Called for every record.
+ * @param user Passed to visit.
+ * @return RFIDX_OK once all records are visited, or the first error from reading or from visit
+ */
+RFIDX_EXPORT RfidxStatus rfidx_archive_iterate(const RfidxArchive *archive, RfidxArchiveVisitor visit, void *user);
+
+/**
+ * @brief Release a mapped archive
+ * @param archive The archive.
+ */
+RFIDX_EXPORT void rfidx_archive_unmap(RfidxArchive *archive);
+
+/**
+ * @brief Extract the columns of every record of an archive
+ *
+ * Dump number i of the store is record number i of the archive.
+ * @param archive The mapped archive.
+ * @param store Initialised with the columns of the archive's tag type, and filled.
+ * @return RFIDX_OK, RFIDX_CHECKSUM_ERROR if a record is damaged, or RFIDX_MEMORY_ERROR
+ */
+RFIDX_EXPORT RfidxStatus rfidx_archive_load_columns(const RfidxArchive *archive, RfidxColumnStore *store);
+
+/**
+ * @brief Pack every dump under a directory tree into a new archive
+ *
+ * Records are named by their path relative to the directory, and packed in name order.
+ * Dumps of another tag family than the archive's are reported as failed and left out.
+ * @param input_dir The directory to read dumps from.
+ * @param filename Path of the archive to create.
+ * @param tag_type Type of the archive, or TAG_UNSPECIFIED to use the type of the first dump.
+ * @param on_result Called for every dump, can be NULL.
+ * @param user Passed to on_result.
+ * @param summary Set to the number of packed and failed dumps. Can be NULL.
+ * @return RFIDX_OK if the archive was written, even if some dumps failed
+ */
+RFIDX_EXPORT RfidxStatus rfidx_archive_pack(
+    const char *input_dir,
+    const char *filename,
+    TagType tag_type,
+    RfidxBatchCallback on_result,
+    void *user,
+    RfidxBatchSummary *summary
+);
+
+/**
+ * @brief Write every record of an archive to its own file
+ *
+ * Each record goes to its name under the output directory, with the extension of the format.
+ * A record whose name only differs in its extension from an earlier record fails with
+ * RFIDX_OUTPUT_COLLISION_ERROR instead of replacing its output.
+ * @param filename Path of the archive.
+ * @param output_dir The directory to write to, created along with its subdirectories as needed.
+ * @param format The output format, one of FORMAT_BINARY, FORMAT_JSON or FORMAT_NFC.
+ * @param on_result Called for every record, can be NULL.
+ * @param user Passed to on_result.
+ * @param summary Set to the number of written and failed records. Can be NULL.
+ * @return RFIDX_OK if the archive could be read, even if some records failed
+ */
+RFIDX_EXPORT RfidxStatus rfidx_archive_unpack(
+    const char *filename,
+    const char *output_dir,
+    FileFormat format,
+    RfidxBatchCallback on_result,
+    void *user,
+    RfidxBatchSummary *summary
+);
+
+#endif //LIBRFIDX_ARCHIVE_H
@@ -0,0 +1,73 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBRFIDX_BATCH_H
+#define LIBRFIDX_BATCH_H
+
+#include <stddef.h>
+#include "librfidx/common.h"
+
+#define RFIDX_BATCH_MAX_THREADS 256
+
+/**
+ * @brief Called once for every file of a batch
+ *
+ * Calls are serialized, so the callback does not need to be thread safe. The output path
+ * is NULL when the input failed before an output name could be made.
+ */
+typedef void (*RfidxBatchCallback)(const char *input, const char *output, RfidxStatus status, void *user);
+
+/**
+ * @brief How to convert a directory of dumps
+ */
+typedef struct {
+    TagType input_type;             /**< Type of every input, or TAG_UNSPECIFIED to detect each one */
+    TransformCommand command;       /**< Transform applied to every input, or TRANSFORM_NONE */
+    FileFormat output_format;       /**< FORMAT_BINARY, FORMAT_JSON or FORMAT_NFC */
+    const char *uuid;               /**< Hex encoded Amiibo UUID, can be NULL */
+    const char *retail_key;         /**< Path to the Amiibo retail key, required for Amiibo transforms */
+    unsigned int threads;           /**< Number of worker threads, 0 for one per online CPU */
+    const char *cache_dir;          /**< Conversion cache, see rfidx_convert_cached(). NULL to disable */
+    RfidxBatchCallback on_result;   /**< Per file report, can be NULL */
+    void *user;                     /**< Passed to on_result */
+} RfidxBatchOptions;
+
+/**
+ * @brief Outcome of a batch
+ */
+typedef struct {
+    size_t converted;               /**< Files written */
+    size_t failed;                  /**< Files that could not be read, transformed or written */
+    size_t cached;                  /**< Files written from the cache, also counted as converted */
+} RfidxBatchSummary;
+
+/**
+ * @brief Convert every regular file under a directory tree
+ *
+ * Each input is read, transformed and written to the same relative path under the output
+ * directory, with the extension of the output format. The files are split across worker
+ * threads, and a worker that runs out of files takes work queued for the others. Every worker
+ * has its own RfidxContext. Outputs are written to a temporary file and renamed into place, so
+ * a reader never sees a partial file. A failing file does not stop the batch. Of several inputs
+ * that only differ in their extension, the first in name order is converted and the others fail
+ * with RFIDX_OUTPUT_COLLISION_ERROR.
+ * @param input_dir The directory to read dumps from.
+ * @param output_dir The directory to write to. Created along with its subdirectories as needed.
+ * @param options How to convert the files.
+ * @param summary Set to the number of converted and failed files. Can be NULL.
+ * @return RFIDX_OK if the batch ran, even if some files failed; an error if it could not start
+ */
+RFIDX_EXPORT RfidxStatus rfidx_batch_convert(
+    const char *input_dir,
+    const char *output_dir,
+    const RfidxBatchOptions *options,
+    RfidxBatchSummary *summary
+);
+
+#endif //LIBRFIDX_BATCH_H
@@ -0,0 +1,120 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBRFIDX_CACHE_H
+#define LIBRFIDX_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "librfidx/common.h"
+
+#define RFIDX_CACHE_KEY_SIZE 32
+
+/**
+ * @brief Version of the cached outputs
+ *
+ * Part of every key, so that entries written by a serializer that has since changed are
+ * no longer found. Bump it whenever the output of a serializer changes.
+ */
+#define RFIDX_CACHE_VERSION 1
+
+/**
+ * @brief Tell whether the result of a transform only depends on its input
+ *
+ * generate and randomize-uid draw from the random generator, so their output is never cached.
+ * @param command The transform command.
+ * @return true if conversions with this command can be cached
+ */
+RFIDX_EXPORT bool rfidx_cache_applies(TransformCommand command);
+
+/**
+ * @brief Compute the cache key of a conversion
+ *
+ * The key is the SHA-256 of the input bytes together with the requested tag type, the
+ * transform, the output format and RFIDX_CACHE_VERSION.
+ * @param input The input file content.
+ * @param length Number of bytes of input.
+ * @param tag_type The requested tag type, TAG_UNSPECIFIED if it is detected.
+ * @param command The transform command.
+ * @param format The output format.
+ * @param key Set to the key.
+ */
+RFIDX_EXPORT void rfidx_cache_key(
+    const uint8_t *input,
+    size_t length,
+    TagType tag_type,
+    TransformCommand command,
+    FileFormat format,
+    uint8_t key[RFIDX_CACHE_KEY_SIZE]
+);
+
+/**
+ * @brief Look up a cached output
+ * @param cache_dir The cache directory.
+ * @param key The key of the conversion.
+ * @param output Set to the cached output, allocated WITHIN THE FUNCTION. Must be freed with rfidx_free.
+ * @param length Set to the size of the output.
+ * @return RFIDX_OK on a hit, RFIDX_BINARY_FILE_IO_ERROR on a miss
+ */
+RFIDX_EXPORT RfidxStatus rfidx_cache_lookup(
+    const char *cache_dir,
+    const uint8_t key[RFIDX_CACHE_KEY_SIZE],
+    char **output,
+    size_t *length
+);
+
+/**
+ * @brief Add an output to the cache
+ *
+ * Entries are written to a temporary file and renamed into place, so processes and threads
+ * can share a cache directory.
+ * @param cache_dir The cache directory, created if missing.
+ * @param key The key of the conversion.
+ * @param output The serialized output.
+ * @param length Size of the output.
+ * @return RfidxStatus indicating success or failure of the write
+ */
+RFIDX_EXPORT RfidxStatus rfidx_cache_store(
+    const char *cache_dir,
+    const uint8_t key[RFIDX_CACHE_KEY_SIZE],
+    const void *output,
+    size_t length
+);
+
+/**
+ * @brief Convert a file, reusing the output of an earlier conversion of the same content
+ *
+ * On a hit, the cached output is copied to the output file without parsing anything. On a
+ * miss, the input is parsed, transformed, serialized and written, and the output is added
+ * to the cache. Amiibo transforms also depend on the retail key, so they are converted but
+ * never cached.
+ * @param ctx The context used for the transform.
+ * @param cache_dir The cache directory.
+ * @param input Path of the input file.
+ * @param tag_type The tag type, or TAG_UNSPECIFIED to detect it.
+ * @param command The transform command, for which rfidx_cache_applies() must hold.
+ * @param format The output format, one of FORMAT_BINARY, FORMAT_JSON or FORMAT_NFC.
+ * @param retail_key Path to the Amiibo retail key, required for Amiibo transforms.
+ * @param output Path of the output file.
+ * @param hit Set to true if the output came from the cache. Can be NULL.
+ * @return RfidxStatus indicating success or failure of the conversion
+ */
+RFIDX_EXPORT RfidxStatus rfidx_convert_cached(
+    RfidxContext *ctx,
+    const char *cache_dir,
+    const char *input,
+    TagType tag_type,
+    TransformCommand command,
+    FileFormat format,
+    const char *retail_key,
+    const char *output,
+    bool *hit
+);
+
+#endif //LIBRFIDX_CACHE_H
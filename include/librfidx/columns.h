@@ -0,0 +1,136 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBRFIDX_COLUMNS_H
+#define LIBRFIDX_COLUMNS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "librfidx/common.h"
+
+/**
+ * @brief Most columns a store can have
+ *
+ * Mifare Classic 1K has the most: UID, ATQA, SAK, and both keys of its 16 sectors.
+ */
+#define RFIDX_COLUMNS_MAX 35
+
+/**
+ * @brief Comparison of a column against a constant
+ */
+typedef enum {
+    RFIDX_COMPARE_EQ = 0,           /**< == */
+    RFIDX_COMPARE_NE,               /**< != */
+    RFIDX_COMPARE_LT,               /**< < */
+    RFIDX_COMPARE_LE,               /**< <= */
+    RFIDX_COMPARE_GT,               /**< > */
+    RFIDX_COMPARE_GE,               /**< >= */
+} RfidxCompareOp;
+
+/**
+ * @brief Fields of many dumps, one contiguous column per field
+ *
+ * Every field is widened to a 64-bit value, reading multibyte fields big-endian as they are
+ * written in hex, so a UID of 04 A1 B2 C3 D4 E5 F6 is 0x04A1B2C3D4E5F6. The columns depend on
+ * the tag family:
+ *   - NTAG 215 and Amiibo: uid, version, character_id, variation, form, amiibo_id, set
+ *   - Mifare Classic 1K: uid, atqa, sak, key_a0 to key_a15, key_b0 to key_b15
+ * The Amiibo columns are read from the model information pages, which are never encrypted.
+ */
+typedef struct {
+    TagType tag_type;
+    size_t count;                               /**< Number of dumps in every column */
+    size_t cap;
+    size_t column_count;
+    uint64_t *columns[RFIDX_COLUMNS_MAX];
+} RfidxColumnStore;
+
+/**
+ * @brief Initialise an empty store
+ * @param store The store to initialise.
+ * @param tag_type NTAG_215, AMIIBO or MFC_1K.
+ * @param capacity Number of dumps to make room for, 0 to grow as they are added.
+ * @return RFIDX_OK, RFIDX_UNKNOWN_ENUM_ERROR for another tag type, or RFIDX_MEMORY_ERROR
+ */
+RFIDX_EXPORT RfidxStatus rfidx_columns_init(RfidxColumnStore *store, TagType tag_type, size_t capacity);
+
+/**
+ * @brief Add the fields of one dump to the end of every column
+ * @param store The store.
+ * @param data The tag data, Ntag215Data or Mfc1kData.
+ * @param header The metadata header, Ntag21xMetadataHeader or MfcMetadataHeader.
+ * @return RFIDX_OK or RFIDX_MEMORY_ERROR
+ */
+RFIDX_EXPORT RfidxStatus rfidx_columns_append(RfidxColumnStore *store, const void *data, const void *header);
+
+/**
+ * @brief Find a column by name
+ * @param store The store.
+ * @param name Name of the column, e.g. "amiibo_id".
+ * @return The column, with store->count values, or NULL if the family has no such column
+ */
+RFIDX_EXPORT const uint64_t *rfidx_columns_find(const RfidxColumnStore *store, const char *name);
+
+/**
+ * @brief Name of a column
+ * @param store The store.
+ * @param column Index of the column, below store->column_count.
+ * @return The name, or NULL past the last column
+ */
+RFIDX_EXPORT const char *rfidx_columns_name(const RfidxColumnStore *store, size_t column);
+
+/**
+ * @brief Release the columns of a store
+ * @param store The store.
+ */
+RFIDX_EXPORT void rfidx_columns_free(RfidxColumnStore *store);
+
+/**
+ * @brief Compare every value of a column against a constant
+ *
+ * Bit i of the bitmap, counting from the least significant bit of the first word, is set if
+ * value i matches. Runs four values at a time with AVX2 where the CPU has it, and two at a
+ * time with SSE2 otherwise on x86. Bits past the last value are cleared.
+ * @param column The values.
+ * @param count Number of values.
+ * @param op The comparison, with the column value on the left.
+ * @param value The constant.
+ * @param bitmap (count + 63) / 64 words to write.
+ */
+RFIDX_EXPORT void rfidx_filter_column(
+    const uint64_t *column,
+    size_t count,
+    RfidxCompareOp op,
+    uint64_t value,
+    uint64_t *bitmap
+);
+
+/**
+ * @brief Find the dumps of a store that match an expression
+ *
+ * An expression compares columns against integer constants, in decimal or 0x hex, with
+ * ==, !=, <, <=, > and >=, and combines the comparisons with &&, || and !, grouped with
+ * parentheses, e.g. "amiibo_id == 0x0001 && (set == 0x02 || set == 0x03)". Every comparison
+ * is a pass of rfidx_filter_column() over one column.
+ * @param store The store.
+ * @param expression The expression.
+ * @param bitmap Set to (store->count + 63) / 64 words with a bit set for every match,
+ * allocated WITHIN THE FUNCTION. Must be freed with rfidx_free.
+ * @param matches Set to the number of matches. Can be NULL.
+ * @return RFIDX_OK, RFIDX_QUERY_ERROR if the expression is invalid or names an unknown column,
+ * or RFIDX_MEMORY_ERROR
+ */
+RFIDX_EXPORT RfidxStatus rfidx_query(
+    const RfidxColumnStore *store,
+    const char *expression,
+    uint64_t **bitmap,
+    size_t *matches
+);
+
+#endif //LIBRFIDX_COLUMNS_H
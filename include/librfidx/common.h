@@ -27,6 +27,10 @@
 #define RFIDX_MEMORY_ERROR 0xFFFF0008U
 #define RFIDX_DRNG_ERROR 0xFFFF0009U
 #define RFIDX_UNKNOWN_ENUM_ERROR 0xFFFF0010U
+#define RFIDX_BUFFER_SIZE_ERROR 0xFFFF0011U
+#define RFIDX_CHECKSUM_ERROR 0xFFFF0012U
+#define RFIDX_QUERY_ERROR 0xFFFF0013U
+#define RFIDX_OUTPUT_COLLISION_ERROR 0xFFFF0014U
 
 #ifdef _WIN32
     #define RFIDX_EXPORT __declspec(dllexport)
@@ -38,8 +42,43 @@
 
 #define JSON_FORMAT_CREATOR "librfidx"
 
+#define RFIDX_RANDOM_POOL_SIZE 4096
+#define RFIDX_RANDOM_POOL_CHUNK MBEDTLS_CTR_DRBG_MAX_REQUEST
+#define RFIDX_RANDOM_SEED_MAX_LEN 32
+
 typedef uint32_t RfidxStatus;
 
+/**
+ * @brief Append-only writer over a caller provided character buffer
+ *
+ * With a NULL buffer the writer only counts, which gives the exact size of an output
+ * before allocating it. Nothing is ever written past cap; len keeps counting instead,
+ * so len > cap at the end means the buffer was too small.
+ */
+typedef struct {
+    char *buf;                  /**< Output buffer, or NULL to only measure */
+    size_t cap;                 /**< Size of the output buffer */
+    size_t len;                 /**< Number of characters produced so far */
+} TextWriter;
+
+typedef void *(*rfidx_malloc_fn)(size_t size, void *ctx);
+typedef void *(*rfidx_realloc_fn)(void *ptr, size_t size, void *ctx);
+typedef void (*rfidx_free_fn)(void *ptr, void *ctx);
+
+/**
+ * @brief Bump allocator over a caller provided buffer
+ *
+ * Allocations are carved from the buffer in order and are never freed one by one;
+ * rfidx_arena_reset() releases all of them at once. When the buffer is exhausted,
+ * allocation fails instead of falling back to the heap.
+ */
+typedef struct {
+    uint8_t *base;              /**< Start of the buffer, aligned for any type */
+    size_t size;                /**< Usable size of the buffer */
+    size_t used;                /**< Bytes handed out so far, including block headers */
+    size_t last;                /**< Offset of the most recent allocation, for in place growth */
+} RfidxArena;
+
 /**
  * @brief Type of tags
  *
@@ -95,21 +134,243 @@ typedef enum {
     TRANSFORM_WIPE,             /**< Wipe all data from the tag, turn it into a blank state */
 } TransformCommand;
 
-RFIDX_EXPORT extern mbedtls_ctr_drbg_context rfidx_ctr_drbg;
-RFIDX_EXPORT extern mbedtls_entropy_context rfidx_entropy;
-RFIDX_EXPORT extern bool rfidx_rng_initialized;
+/**
+ * @brief Library state that must not be shared between threads
+ *
+ * Every function that draws random bytes takes its generator from a context. The functions
+ * without a _ctx suffix use rfidx_default_context; threads that run in parallel must each
+ * use their own context instead. A context must be zero-initialized, or initialized with
+ * rfidx_context_init(), before use.
+ *
+ * Random bytes are handed out from a pool that is refilled from the DRBG RFIDX_RANDOM_POOL_SIZE
+ * bytes at a time, so generating a UID costs a copy rather than a full DRBG request.
+ */
+typedef struct {
+    mbedtls_ctr_drbg_context ctr_drbg;  /**< CTR-DRBG seeded by rfidx_init_rng_ctx() */
+    mbedtls_entropy_context entropy;    /**< Entropy source feeding the DRBG */
+    bool rng_initialized;               /**< The DRBG has been seeded and can be used */
+    uint8_t seed[RFIDX_RANDOM_SEED_MAX_LEN]; /**< Fixed seed in deterministic mode */
+    size_t seed_len;                    /**< Length of the fixed seed, 0 when seeded from entropy */
+    size_t pool_available;              /**< Unused bytes left at the end of the pool */
+    uint8_t pool[RFIDX_RANDOM_POOL_SIZE]; /**< Random bytes drawn ahead from the DRBG */
+} RfidxContext;
+
+RFIDX_EXPORT extern RfidxContext rfidx_default_context;
 
+// The DRBG used to be a set of globals; keep the old names pointing at the default context
+#define rfidx_ctr_drbg (rfidx_default_context.ctr_drbg)
+#define rfidx_entropy (rfidx_default_context.entropy)
+#define rfidx_rng_initialized (rfidx_default_context.rng_initialized)
+
+/**
+ * @brief Convert a hex string into bytes
+ *
+ * Decodes exactly len bytes from the first 2 * len characters of the string. Both upper and
+ * lower case digits are accepted; any other character, including a string that ends early,
+ * is rejected. Uses SSE2/AVX2 kernels when the CPU supports them.
+ * @param hex The null-terminated hex string to decode.
+ * @param out Buffer of at least len bytes to decode into.
+ * @param len Number of bytes to decode.
+ * @return Status code
+ */
 RFIDX_EXPORT RfidxStatus hex_to_bytes(const char *hex, uint8_t *out, size_t len);
+
+/**
+ * @brief Convert a span of hex characters separated by whitespace into bytes
+ *
+ * Whitespace anywhere in the span is skipped, so both "04 48 B8" and "0448B8" decode
+ * to the same bytes. The span does not need to be null-terminated; the function never
+ * reads past src_len. Characters after the first 2 * len hex digits are ignored.
+ * @param src Start of the span.
+ * @param src_len Length of the span.
+ * @param out Buffer of at least len bytes to decode into.
+ * @param len Number of bytes to decode.
+ * @return Status code
+ */
+RfidxStatus hex_span_to_bytes(const char *src, size_t src_len, uint8_t *out, size_t len);
+
+/**
+ * @brief Convert bytes into an upper case hex string
+ *
+ * Writes 2 * len hex characters followed by a null terminator, so the output
+ * buffer must hold at least 2 * len + 1 characters.
+ * @param bytes The bytes to encode.
+ * @param len Number of bytes to encode.
+ * @param out Buffer to write the hex string into.
+ * @return Status code
+ */
 RfidxStatus bytes_to_hex(const uint8_t *bytes, size_t len, char *out);
+
+/**
+ * @brief Decode hex characters without bounds or terminator checks
+ *
+ * Low level kernel behind hex_to_bytes. The caller guarantees that 2 * len characters
+ * are readable from hex, which does not need to be null-terminated.
+ * @param hex Hex characters to decode.
+ * @param len Number of bytes to decode.
+ * @param out Buffer of at least len bytes to decode into.
+ * @return true if every character was a valid hex digit
+ */
+bool hex_decode(const char *hex, size_t len, uint8_t *out);
+
+/**
+ * @brief Encode bytes as upper case hex without writing a terminator
+ *
+ * Low level kernel behind bytes_to_hex, writing exactly 2 * len characters.
+ * @param bytes The bytes to encode.
+ * @param len Number of bytes to encode.
+ * @param out Buffer of at least 2 * len characters.
+ */
+void hex_encode(const uint8_t *bytes, size_t len, char *out);
+
+/**
+ * @brief Update a CRC-32 (IEEE 802.3, as used by zlib) with more bytes
+ *
+ * Start with 0, and feed the previous result back in to checksum data in several pieces.
+ * @param crc The CRC of the bytes so far.
+ * @param data The next bytes.
+ * @param len Number of bytes.
+ * @return The CRC of all bytes
+ */
+RFIDX_EXPORT uint32_t rfidx_crc32(uint32_t crc, const void *data, size_t len);
 char* remove_whitespace(const char *str);
 RFIDX_EXPORT TagType string_to_tag_type(const char *str);
+bool str_to_uint(const char *str, size_t len, unsigned int base, uint32_t *out);
+
 RFIDX_EXPORT FileFormat string_to_file_format(const char *str);
 void uint_to_str(unsigned int val, char *out, size_t out_size);
 int appendf(char **buf, size_t *len, size_t *cap, const char *fmt, ...);
+void text_writer_init(TextWriter *writer, char *buf, size_t cap);
+
+/**
+ * @brief Reserve space for n characters
+ * @param writer The writer.
+ * @param n Number of characters.
+ * @return Where to write them, or NULL when only measuring or out of space
+ */
+char *text_writer_reserve(TextWriter *writer, size_t n);
+void text_writer_append(TextWriter *writer, const char *str, size_t len);
+void text_writer_uint(TextWriter *writer, unsigned int value);
+
+/**
+ * @brief Append bytes as upper case hex, each preceded by a space: " 04 48 B8"
+ * @param writer The writer.
+ * @param bytes Bytes to encode.
+ * @param len Number of bytes.
+ */
+void text_writer_hex_spaced(TextWriter *writer, const uint8_t *bytes, size_t len);
+
+/**
+ * @brief Terminate the output with a null character
+ * @param writer The writer.
+ * @return true if the whole output, including the terminator, fitted in the buffer
+ */
+bool text_writer_finish(TextWriter *writer);
 RFIDX_EXPORT int rfidx_init_rng(
     mbedtls_entropy_f_source_ptr custom_entropy_func,
     void *custom_entropy_param
 );
 RFIDX_EXPORT int rfidx_free_rng(void);
 
+/**
+ * @brief Prepare a context for use, with its random generator not yet seeded
+ * @param ctx The context to initialize.
+ */
+RFIDX_EXPORT void rfidx_context_init(RfidxContext *ctx);
+
+/**
+ * @brief Release everything owned by a context
+ *
+ * The context can be initialized and used again afterwards.
+ * @param ctx The context to release.
+ */
+RFIDX_EXPORT void rfidx_context_free(RfidxContext *ctx);
+
+/**
+ * @brief Seed the random generator of a context
+ *
+ * Same as rfidx_init_rng(), for the given context. Seeding an already seeded context does nothing.
+ * @param ctx The context to seed.
+ * @param custom_entropy_func Optional additional entropy source.
+ * @param custom_entropy_param Parameter passed to the entropy source.
+ * @return 0 on success, or the mbedTLS error code
+ */
+RFIDX_EXPORT int rfidx_init_rng_ctx(
+    RfidxContext *ctx,
+    mbedtls_entropy_f_source_ptr custom_entropy_func,
+    void *custom_entropy_param
+);
+
+/**
+ * @brief Seed the random generator of a context from a fixed seed
+ *
+ * The context then produces the same sequence of bytes every time it is seeded with the same
+ * value, which makes benchmarks and test fixtures reproducible. The output is only as
+ * unpredictable as the seed; never use this for tags that leave the test bench.
+ * @param ctx The context to seed. Seeding an already seeded context does nothing.
+ * @param seed The seed.
+ * @param seed_len Length of the seed, between 1 and RFIDX_RANDOM_SEED_MAX_LEN bytes.
+ * @return 0 on success, or the mbedTLS error code
+ */
+RFIDX_EXPORT int rfidx_init_rng_seeded_ctx(RfidxContext *ctx, const uint8_t *seed, size_t seed_len);
+RFIDX_EXPORT int rfidx_free_rng_ctx(RfidxContext *ctx);
+
+/**
+ * @brief Fill a buffer with random bytes from a context
+ * @param ctx The context to draw from. Its generator must be seeded.
+ * @param output Buffer to fill.
+ * @param len Number of bytes to generate.
+ * @return RFIDX_OK, or RFIDX_DRNG_ERROR if the generator is not seeded or fails
+ */
+RFIDX_EXPORT RfidxStatus rfidx_random_ctx(RfidxContext *ctx, uint8_t *output, size_t len);
+
+/**
+ * @brief Route every allocation made by the library through custom callbacks
+ *
+ * Covers the parsers, serializers, file loaders and cJSON. Buffers returned by the
+ * library, such as serialized strings and the tag data from *_read_from_file, must
+ * be released with rfidx_free() once an allocator is set. Passing NULL for any of the
+ * callbacks restores the C library allocator. The allocator is global; do not change
+ * it while another thread is using the library.
+ * @param malloc_fn Allocation callback.
+ * @param realloc_fn Reallocation callback, with realloc semantics.
+ * @param free_fn Release callback. Called with NULL pointers too.
+ * @param ctx Opaque pointer passed to every callback.
+ */
+RFIDX_EXPORT void rfidx_set_allocator(
+    rfidx_malloc_fn malloc_fn,
+    rfidx_realloc_fn realloc_fn,
+    rfidx_free_fn free_fn,
+    void *ctx
+);
+RFIDX_EXPORT void *rfidx_malloc(size_t size);
+RFIDX_EXPORT void *rfidx_realloc(void *ptr, size_t size);
+RFIDX_EXPORT void rfidx_free(void *ptr);
+
+/**
+ * @brief Prepare an arena over a buffer
+ * @param arena The arena.
+ * @param buffer Memory to allocate from. It must outlive every allocation.
+ * @param size Size of the buffer.
+ */
+RFIDX_EXPORT void rfidx_arena_init(RfidxArena *arena, void *buffer, size_t size);
+RFIDX_EXPORT void *rfidx_arena_alloc(RfidxArena *arena, size_t size);
+
+/**
+ * @brief Release every allocation of an arena at once
+ * @param arena The arena.
+ */
+RFIDX_EXPORT void rfidx_arena_reset(RfidxArena *arena);
+
+/**
+ * @brief Make the library allocate from an arena
+ *
+ * Shorthand for rfidx_set_allocator() with the arena callbacks. rfidx_free() becomes
+ * a no-op; call rfidx_arena_reset() once the results are no longer needed.
+ * @param arena The arena, or NULL to restore the C library allocator.
+ */
+RFIDX_EXPORT void rfidx_use_arena(RfidxArena *arena);
+
+_Static_assert(RFIDX_RANDOM_POOL_SIZE % RFIDX_RANDOM_POOL_CHUNK == 0, "Random pool must be a whole number of DRBG requests");
+
 #endif //LIBRFIDX_COMMON_H
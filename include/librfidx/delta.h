@@ -0,0 +1,135 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBRFIDX_DELTA_H
+#define LIBRFIDX_DELTA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "librfidx/common.h"
+
+/*
+ * Delta layout, all integers little-endian:
+ *
+ *   header   RFIDX_DELTA_HEADER_SIZE bytes: RFIDX_DELTA_MAGIC, then the version, tag type,
+ *            unit size and number of changed units as 16-bit integers, then the CRC-32 of
+ *            the base data and the CRC-32 of the data the delta produces.
+ *   units    For every changed unit in increasing order, its index as a 16-bit integer
+ *            followed by its new content.
+ *
+ * A unit is a 4-byte page of an NTAG 215 or Amiibo, or a 16-byte block of a Mifare Classic.
+ * Only the tag data is covered, not the metadata header.
+ */
+#define RFIDX_DELTA_MAGIC "RFIDXDLT"
+#define RFIDX_DELTA_VERSION 1
+#define RFIDX_DELTA_HEADER_SIZE 24
+
+/**
+ * @brief Find the units that differ between two buffers
+ *
+ * Compares whole 16 or 32-byte chunks with SSE2/AVX2 when the CPU supports them and the unit
+ * is 4 or 16 bytes, and falls back to comparing unit by unit otherwise.
+ * @param base The first buffer.
+ * @param target The second buffer, of the same size.
+ * @param size Size of both buffers, a multiple of unit_size.
+ * @param unit_size Size of a unit in bytes.
+ * @param changed Set to one bit per unit, least significant bit of the first word first,
+ * set if the unit differs. Must hold (size / unit_size + 63) / 64 words.
+ * @return The number of units that differ
+ */
+RFIDX_EXPORT size_t rfidx_delta_diff(
+    const uint8_t *base,
+    const uint8_t *target,
+    size_t size,
+    size_t unit_size,
+    uint64_t *changed
+);
+
+/**
+ * @brief Encode the pages or blocks of a dump that differ from a base dump
+ * @param tag_type The type of both dumps.
+ * @param base The base data, Ntag215Data or Mfc1kData.
+ * @param target The new data, of the same type.
+ * @param delta Set to the delta, allocated WITHIN THE FUNCTION. Must be freed with rfidx_free.
+ * @param delta_len Set to the size of the delta.
+ * @return RFIDX_OK, RFIDX_UNKNOWN_ENUM_ERROR for an unsupported tag type, or RFIDX_MEMORY_ERROR
+ */
+RFIDX_EXPORT RfidxStatus rfidx_delta_encode(
+    TagType tag_type,
+    const void *base,
+    const void *target,
+    uint8_t **delta,
+    size_t *delta_len
+);
+
+/**
+ * @brief Rebuild a dump from its base and a delta
+ *
+ * The base is checked against the CRC recorded in the delta before anything is written, and
+ * the result against the CRC of the target.
+ * @param tag_type The type of the dump. NTAG 215 and Amiibo deltas apply to each other.
+ * @param base The base data, Ntag215Data or Mfc1kData.
+ * @param delta The delta.
+ * @param delta_len Size of the delta.
+ * @param out Set to the new data. Can be the same buffer as base.
+ * @return RFIDX_OK, RFIDX_FILE_FORMAT_ERROR for a malformed delta or one of another tag type,
+ * or RFIDX_CHECKSUM_ERROR if the delta was not made from this base
+ */
+RFIDX_EXPORT RfidxStatus rfidx_delta_apply(
+    TagType tag_type,
+    const void *base,
+    const uint8_t *delta,
+    size_t delta_len,
+    void *out
+);
+
+/**
+ * @brief Rebuild a dump from its base and the deltas of every save since
+ * @param tag_type The type of the dump.
+ * @param base The base data, Ntag215Data or Mfc1kData.
+ * @param deltas The deltas, each made from the result of the one before.
+ * @param delta_lens Size of each delta.
+ * @param count Number of deltas.
+ * @param out Set to the data after the last delta. Can be the same buffer as base.
+ * @return RFIDX_OK, or the error of the first delta that does not apply, in which case out
+ * holds the result of the deltas before it
+ */
+RFIDX_EXPORT RfidxStatus rfidx_delta_apply_chain(
+    TagType tag_type,
+    const void *base,
+    const uint8_t *const *deltas,
+    const size_t *delta_lens,
+    size_t count,
+    void *out
+);
+
+/**
+ * @brief Merge two successive deltas into one
+ *
+ * Applying the result to the base of the first delta gives the same data as applying both.
+ * Used to squash old history without rebuilding every version.
+ * @param first The earlier delta.
+ * @param first_len Size of the earlier delta.
+ * @param second The later delta, made from the result of the first.
+ * @param second_len Size of the later delta.
+ * @param delta Set to the merged delta, allocated WITHIN THE FUNCTION. Must be freed with rfidx_free.
+ * @param delta_len Set to the size of the merged delta.
+ * @return RFIDX_OK, RFIDX_FILE_FORMAT_ERROR for a malformed delta or two of different tag types,
+ * or RFIDX_CHECKSUM_ERROR if the second delta does not follow the first
+ */
+RFIDX_EXPORT RfidxStatus rfidx_delta_compose(
+    const uint8_t *first,
+    size_t first_len,
+    const uint8_t *second,
+    size_t second_len,
+    uint8_t **delta,
+    size_t *delta_len
+);
+
+#endif //LIBRFIDX_DELTA_H
@@ -0,0 +1,46 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBRFIDX_DETECT_H
+#define LIBRFIDX_DETECT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "librfidx/common.h"
+
+/**
+ * @brief How much of a file the classifier needs
+ *
+ * Enough for every binary dump, and for the header and first pages of the text formats.
+ */
+#define RFIDX_DETECT_PREFIX_SIZE 4096
+
+/**
+ * @brief Detect the tag type and format of a dump from its first bytes
+ *
+ * Binary dumps are recognised by their size alone. JSON dumps by their "FileType", and NFC
+ * dumps by their "Device type" line. NTAG215 dumps are reported as AMIIBO when the capability
+ * container, the fixed 0xA5 byte, and the fixed bytes of the dynamic lock and configuration
+ * pages that are present in the prefix all hold the values every Amiibo has.
+ * @param prefix The first bytes of the dump, not necessarily null-terminated.
+ * @param prefix_len Number of bytes in the prefix, at most the size of the dump.
+ * @param size Size of the whole dump.
+ * @param tag_type Set to the detected tag type.
+ * @param format Set to the detected format.
+ * @return RFIDX_OK, or RFIDX_FILE_FORMAT_ERROR if the dump is not recognised
+ */
+RFIDX_EXPORT RfidxStatus rfidx_detect_tag(
+    const uint8_t *prefix,
+    size_t prefix_len,
+    size_t size,
+    TagType *tag_type,
+    FileFormat *format
+);
+
+#endif //LIBRFIDX_DETECT_H
@@ -0,0 +1,66 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBRFIDX_MANIFEST_H
+#define LIBRFIDX_MANIFEST_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "librfidx/common.h"
+#include "librfidx/batch.h"
+
+/**
+ * @brief Number of jobs that can be between the first and the last stage at once
+ */
+#define RFIDX_MANIFEST_PIPELINE_DEPTH 8
+
+/**
+ * @brief Called once for every job of a manifest, in manifest order
+ *
+ * The input and output paths are NULL when the line could not be parsed.
+ */
+typedef void (*RfidxManifestCallback)(size_t line, const char *input, const char *output, RfidxStatus status,
+                                      void *user);
+
+/**
+ * @brief Settings shared by every job of a manifest
+ */
+typedef struct {
+    const char *retail_key;          /**< Path to the Amiibo retail key, loaded once for all jobs. Can be NULL */
+    RfidxManifestCallback on_result; /**< Per job report, can be NULL */
+    void *user;                      /**< Passed to on_result */
+} RfidxManifestOptions;
+
+/**
+ * @brief Run every job of a newline-delimited JSON manifest
+ *
+ * Each non-empty line is an object such as
+ * {"input": "a.nfc", "input_type": "amiibo", "transform": "randomize-uid", "uuid": "...",
+ * "output": "a.bin", "output_format": "binary"}. Only "input", "output" and "output_format"
+ * are required; the tag type is detected when "input_type" is missing.
+ *
+ * Jobs go through three stages, each on its own thread: reading and parsing the input,
+ * transforming it, and writing the output. While one job is being written the next is
+ * transformed and the one after is read. The retail key is read once, before the first job.
+ * Outputs are written like batch outputs: missing parent directories are created, and a file
+ * only appears once it is complete. A failing job is reported and does not stop the others.
+ * @param ctx The context used for the transforms.
+ * @param manifest The manifest to read.
+ * @param options Settings for all jobs.
+ * @param summary Set to the number of jobs that succeeded and failed. Can be NULL.
+ * @return RFIDX_OK if the manifest was run, even if some jobs failed; an error if it could not start
+ */
+RFIDX_EXPORT RfidxStatus rfidx_run_manifest(
+    RfidxContext *ctx,
+    FILE *manifest,
+    const RfidxManifestOptions *options,
+    RfidxBatchSummary *summary
+);
+
+#endif //LIBRFIDX_MANIFEST_H
@@ -0,0 +1,66 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBRFIDX_MAPPING_H
+#define LIBRFIDX_MAPPING_H
+
+#include <stddef.h>
+#include "librfidx/common.h"
+
+/**
+ * @brief A file mapped into memory
+ *
+ * All tag structures are packed with fixed sizes, so a binary dump can be used in place
+ * through a pointer into the mapping instead of being read and copied into the heap.
+ */
+typedef struct {
+    void *base;                 /**< Start of the mapped file, NULL when nothing is mapped */
+    size_t length;              /**< Length of the file in bytes */
+    bool writable;              /**< Writes to the mapping go through to the file */
+} RfidxMapping;
+
+/**
+ * @brief Map a whole file read-only
+ * @param filename Path to the file.
+ * @param mapping Set to the mapping. Left empty on failure.
+ * @return RFIDX_OK, RFIDX_BINARY_FILE_SIZE_ERROR for an empty file, or RFIDX_BINARY_FILE_IO_ERROR
+ */
+RFIDX_EXPORT RfidxStatus rfidx_map_file(const char *filename, RfidxMapping *mapping);
+
+/**
+ * @brief Map a whole file for reading and writing
+ *
+ * The mapping is shared with the file: every change made through it ends up in the file,
+ * at the latest when it is unmapped. Use rfidx_sync_mapping() to flush a range right away.
+ * @param filename Path to the file.
+ * @param mapping Set to the mapping. Left empty on failure.
+ * @return RFIDX_OK, RFIDX_BINARY_FILE_SIZE_ERROR for an empty file, or RFIDX_BINARY_FILE_IO_ERROR
+ */
+RFIDX_EXPORT RfidxStatus rfidx_map_file_writable(const char *filename, RfidxMapping *mapping);
+
+/**
+ * @brief Write a changed range of a writable mapping back to the file
+ *
+ * Only the pages covering the range are flushed.
+ * @param mapping The mapping.
+ * @param offset Offset of the first changed byte.
+ * @param length Number of bytes in the range. Nothing is flushed for 0.
+ * @return RFIDX_OK, or RFIDX_BINARY_FILE_IO_ERROR
+ */
+RFIDX_EXPORT RfidxStatus rfidx_sync_mapping(const RfidxMapping *mapping, size_t offset, size_t length);
+
+/**
+ * @brief Release a mapping
+ *
+ * Pointers into the mapping must not be used afterwards. Releasing an empty mapping does nothing.
+ * @param mapping The mapping to release.
+ */
+RFIDX_EXPORT void rfidx_unmap_file(RfidxMapping *mapping);
+
+#endif //LIBRFIDX_MAPPING_H
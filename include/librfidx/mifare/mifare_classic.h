@@ -152,6 +152,7 @@ RfidxStatus mfc_validate_manufacturer_data(const uint8_t *manufacturer_data);
  * @return RfidxStatus indicating success or failure of the randomization.
  */
 RfidxStatus mfc_randomize_uid(uint8_t *manufacturer_data);
+RfidxStatus mfc_randomize_uid_ctx(RfidxContext *ctx, uint8_t *manufacturer_data);
 
 _Static_assert(sizeof(MfcManufacturerData4B) == 16, "Mifare Classic manufacturer data size mismatch");
 _Static_assert(sizeof(MfcManufacturerData7B) == 16, "Mifare Classic manufacturer data size mismatch");
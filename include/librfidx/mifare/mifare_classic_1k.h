@@ -14,6 +14,8 @@
 
 #ifndef LIBRFIDX_NO_PLATFORM
 
+#include "librfidx/mapping.h"
+
 RFIDX_EXPORT RfidxStatus mfc1k_load_from_binary(
     const char *filename,
     Mfc1kData *mfc1k,
@@ -26,6 +28,12 @@ RFIDX_EXPORT RfidxStatus mfc1k_save_to_binary(
     const MfcMetadataHeader *header
 );
 
+RFIDX_EXPORT RfidxStatus mfc1k_map_binary(
+    const char *filename,
+    RfidxMapping *mapping,
+    const Mfc1kData **mfc1k
+);
+
 RFIDX_EXPORT RfidxStatus mfc1k_load_from_json(
     const char *filename,
     Mfc1kData *mfc1k,
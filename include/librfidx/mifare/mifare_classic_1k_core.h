@@ -44,6 +44,14 @@ uint8_t *mfc1k_serialize_binary(
     const MfcMetadataHeader *header
 );
 
+RfidxStatus mfc1k_serialize_binary_into(
+    const Mfc1kData *mfc1k,
+    const MfcMetadataHeader *header,
+    uint8_t *out,
+    size_t cap,
+    size_t *written
+);
+
 RfidxStatus mfc1k_parse_json(
     const char *json_str,
     Mfc1kData *mfc1k,
@@ -55,6 +63,19 @@ char *mfc1k_serialize_json(
     const MfcMetadataHeader *header
 );
 
+char *mfc1k_serialize_json_unformatted(
+    const Mfc1kData *mfc1k,
+    const MfcMetadataHeader *header
+);
+
+RfidxStatus mfc1k_serialize_json_into(
+    const Mfc1kData *mfc1k,
+    const MfcMetadataHeader *header,
+    char *out,
+    size_t cap,
+    size_t *written
+);
+
 RfidxStatus mfc1k_parse_nfc(
     const char *nfc_str,
     Mfc1kData *mfc1k,
@@ -66,11 +87,31 @@ char *mfc1k_serialize_nfc(
     const MfcMetadataHeader *header
 );
 
+RfidxStatus mfc1k_serialize_nfc_into(
+    const Mfc1kData *mfc1k,
+    const MfcMetadataHeader *header,
+    char *out,
+    size_t cap,
+    size_t *written
+);
+
+size_t mfc1k_serialized_size(
+    FileFormat format,
+    const Mfc1kData *mfc1k,
+    const MfcMetadataHeader *header
+);
+
 RfidxStatus mfc1k_generate(
     Mfc1kData *mfc1k,
     MfcMetadataHeader *header
 );
 
+RfidxStatus mfc1k_generate_ctx(
+    RfidxContext *ctx,
+    Mfc1kData *mfc1k,
+    MfcMetadataHeader *header
+);
+
 RfidxStatus mfc1k_wipe(Mfc1kData* mfc1k);
 
 RFIDX_EXPORT RfidxStatus mfc1k_transform_data(
@@ -79,6 +120,13 @@ RFIDX_EXPORT RfidxStatus mfc1k_transform_data(
     TransformCommand command
 );
 
+RFIDX_EXPORT RfidxStatus mfc1k_transform_data_ctx(
+    RfidxContext *ctx,
+    Mfc1kData **mfc1k,
+    MfcMetadataHeader **header,
+    TransformCommand command
+);
+
 _Static_assert(sizeof(Mfc1kData) == MFC_1K_TOTAL_BYTES, "Mifare Classic 1K data size mismatch");
 
 #endif //LIBRFIDX_MIFARE_CLASSIC_1K_CORE_H
@@ -14,6 +14,8 @@
 
 #ifndef LIBRFIDX_NO_PLATFORM
 
+#include "librfidx/mapping.h"
+
 /**
  * @brief Load NTAG215 data from a binary file
  *
@@ -50,6 +52,25 @@ RFIDX_EXPORT RfidxStatus ntag215_save_to_binary(
     const Ntag21xMetadataHeader *header
 );
 
+/**
+ * @brief Map an NTAG215 binary file and view it without copying
+ *
+ * The file is mapped read-only and the returned pointers point straight into the mapping,
+ * so nothing is read into the heap. They stay valid until rfidx_unmap_file() is called on
+ * the mapping, which must be done even if the dump is not used.
+ * @param filename Path to the binary file.
+ * @param mapping Set to the mapping of the file.
+ * @param ntag215 Set to the tag data inside the mapping.
+ * @param header Set to the metadata header inside the mapping, or NULL if the dump has none.
+ * @return Status code
+ */
+RFIDX_EXPORT RfidxStatus ntag215_map_binary(
+    const char *filename,
+    RfidxMapping *mapping,
+    const Ntag215Data **ntag215,
+    const Ntag21xMetadataHeader **header
+);
+
 RfidxStatus ntag215_load_from_eml(
     char *filename,
     Ntag215Data *ntag215,
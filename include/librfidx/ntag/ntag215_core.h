@@ -86,6 +86,25 @@ uint8_t *ntag215_serialize_binary(
     const Ntag21xMetadataHeader *header
 );
 
+/**
+ * @brief Serialize NTAG215 data and header to binary in a caller provided buffer
+ *
+ * Writes the same bytes as ntag215_serialize_binary without allocating.
+ * @param ntag215 Pointer to the NTAG215Data data.
+ * @param header: Pointer to the Ntag21xMetadataHeader buffer to save tag metadata into.
+ * @param out Buffer to write into.
+ * @param cap Size of the buffer, at least ntag215_serialized_size(FORMAT_BINARY, ...).
+ * @param written Set to the number of bytes written. Can be NULL.
+ * @return Status code
+ */
+RfidxStatus ntag215_serialize_binary_into(
+    const Ntag215Data *ntag215,
+    const Ntag21xMetadataHeader *header,
+    uint8_t *out,
+    size_t cap,
+    size_t *written
+);
+
 /**
  * @brief Parse a JSON string into NTAG215 data and header
  *
@@ -117,6 +136,39 @@ char *ntag215_serialize_json(
     const Ntag21xMetadataHeader *header
 );
 
+/**
+ * @brief Serialize NTAG215 data and header to JSON string without whitespace
+ *
+ * Same content as ntag215_serialize_json, in the compact form of cJSON_PrintUnformatted.
+ * @param ntag215 Pointer to the NTAG215Data data.
+ * @param header: Pointer to the Ntag21xMetadataHeader buffer to save tag metadata into.
+ * @return JSON string
+ */
+char *ntag215_serialize_json_unformatted(
+    const Ntag215Data *ntag215,
+    const Ntag21xMetadataHeader *header
+);
+
+/**
+ * @brief Serialize NTAG215 data and header to JSON string in a caller provided buffer
+ *
+ * Writes the same string as ntag215_serialize_json without allocating. The string is
+ * null-terminated, and nothing is written past cap if the buffer is too small.
+ * @param ntag215 Pointer to the NTAG215Data data.
+ * @param header: Pointer to the Ntag21xMetadataHeader buffer to save tag metadata into.
+ * @param out Buffer to write into.
+ * @param cap Size of the buffer, at least ntag215_serialized_size(FORMAT_JSON, ...).
+ * @param written Set to the length of the string, without the null terminator. Can be NULL.
+ * @return Status code
+ */
+RfidxStatus ntag215_serialize_json_into(
+    const Ntag215Data *ntag215,
+    const Ntag21xMetadataHeader *header,
+    char *out,
+    size_t cap,
+    size_t *written
+);
+
 /**
  * @brief Parse a NFC string into NTAG215 data and header
  *
@@ -148,6 +200,41 @@ char *ntag215_serialize_nfc(
     const Ntag21xMetadataHeader *header
 );
 
+/**
+ * @brief Serialize NTAG215 data and header to NFC string in a caller provided buffer
+ *
+ * Writes the same string as ntag215_serialize_nfc without allocating. The string is
+ * null-terminated, and nothing is written past cap if the buffer is too small.
+ * @param ntag215 Pointer to the NTAG215Data data.
+ * @param header: Pointer to the Ntag21xMetadataHeader buffer to save tag metadata into.
+ * @param out Buffer to write into.
+ * @param cap Size of the buffer, at least ntag215_serialized_size(FORMAT_NFC, ...).
+ * @param written Set to the length of the string, without the null terminator. Can be NULL.
+ * @return Status code
+ */
+RfidxStatus ntag215_serialize_nfc_into(
+    const Ntag215Data *ntag215,
+    const Ntag21xMetadataHeader *header,
+    char *out,
+    size_t cap,
+    size_t *written
+);
+
+/**
+ * @brief Get the exact buffer size needed to serialize NTAG215 data and header
+ *
+ * For the text formats the size includes the null terminator.
+ * @param format Output format, one of FORMAT_BINARY, FORMAT_JSON or FORMAT_NFC.
+ * @param ntag215 Pointer to the NTAG215Data data.
+ * @param header: Pointer to the Ntag21xMetadataHeader buffer to save tag metadata into.
+ * @return Size in bytes, or 0 if the format is not supported
+ */
+size_t ntag215_serialized_size(
+    FileFormat format,
+    const Ntag215Data *ntag215,
+    const Ntag21xMetadataHeader *header
+);
+
 /**
  * @brief Generate a blank NTAG215 data structure
  *
@@ -162,6 +249,11 @@ RfidxStatus ntag215_generate(
     Ntag215Data* ntag215,
     Ntag21xMetadataHeader *header
 );
+RfidxStatus ntag215_generate_ctx(
+    RfidxContext *ctx,
+    Ntag215Data* ntag215,
+    Ntag21xMetadataHeader *header
+);
 
 /**
  * @brief Wipe an NTAG215 dump
@@ -188,6 +280,21 @@ RFIDX_EXPORT RfidxStatus ntag215_transform_data(
     TransformCommand command
 );
 
+/**
+ * @brief Transform NTAG215 data, drawing random bytes from the given context
+ * @param ctx The context that owns the random generator.
+ * @param ntag215 Pointer to the NTAG215Data data to transform.
+ * @param header Pointer to the Ntag21xMetadataHeader buffer to save tag metadata into.
+ * @param command The transformation command to apply.
+ * @return Status code
+ */
+RFIDX_EXPORT RfidxStatus ntag215_transform_data_ctx(
+    RfidxContext *ctx,
+    Ntag215Data **ntag215,
+    Ntag21xMetadataHeader **header,
+    TransformCommand command
+);
+
 _Static_assert(sizeof(Ntag215Raw) == NTAG215_TOTAL_BYTES, "NTAG215 raw data size mismatch");
 _Static_assert(sizeof(Ntag215Structure) == NTAG215_TOTAL_BYTES, "NTAG215 structure size mismatch");
 _Static_assert(sizeof(Ntag215Data) == NTAG215_TOTAL_BYTES, "NTAG215 data size mismatch");
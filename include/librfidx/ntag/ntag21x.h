@@ -89,6 +89,7 @@ RFIDX_EXPORT RfidxStatus ntag21x_validate_manufacturer_data(const Ntag21xManufac
  * @return RfidxStatus indicating success or failure of the randomization.
  */
 RFIDX_EXPORT RfidxStatus ntag21x_randomize_uid(Ntag21xManufacturerData *manufacturer_data);
+RFIDX_EXPORT RfidxStatus ntag21x_randomize_uid_ctx(RfidxContext *ctx, Ntag21xManufacturerData *manufacturer_data);
 
 _Static_assert(sizeof(Ntag21xManufacturerData) == NTAG21X_PAGE_SIZE * 3, "NTAG21x manufacturer data size mismatch");
 _Static_assert(sizeof(Ntag21xConfiguration) == NTAG21X_PAGE_SIZE * 4, "NTAG21x configuration size mismatch");
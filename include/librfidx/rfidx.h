@@ -11,7 +11,13 @@
 #define RFIDX_H
 
 #include <stdio.h>
+#include <sys/uio.h>
 #include "librfidx/common.h"
+#include "librfidx/mapping.h"
+#include "librfidx/application/amiibo_core.h"
+
+#define RFIDX_MAX_OUTPUT_FORMATS 4
+#define WRITE_FILE_MAX_IOV 8
 
 #define transform_format(data, header, output_format, filename)     \
     _Generic((data),                                                \
@@ -31,7 +37,7 @@
         RfidxStatus rfidx__st = read_file((FILENAME), &rfidx__buf, NULL, ERR_CODE);             \
         if (rfidx__st != RFIDX_OK) return rfidx__st;                                            \
         RfidxStatus rfidx__pst = rfidx__pf(rfidx__buf, (OUT_PTR), (HDR_PTR));                   \
-        free(rfidx__buf);                                                                       \
+        rfidx_free(rfidx__buf);                                                                 \
         return rfidx__pst;                                                                      \
     } while (0)
 
@@ -40,16 +46,32 @@
         typedef RfidxStatus (*rfidx__parse_sig_t)(const uint8_t*, const size_t, OUT_TYPE*, HDR_TYPE*);  \
         rfidx__parse_sig_t rfidx__pf = (PARSE_FN);                                                      \
         (void)rfidx__pf;                                                                                \
-        char *rfidx__buf = NULL;                                                                        \
-        size_t rfidx__buf_len = 0;                                                                      \
-        RfidxStatus rfidx__st = read_file((FILENAME), &rfidx__buf, &rfidx__buf_len, ERR_CODE);          \
+        RfidxMapping rfidx__map;                                                                        \
+        RfidxStatus rfidx__st = rfidx_map_file((FILENAME), &rfidx__map);                                \
+        if (rfidx__st == RFIDX_BINARY_FILE_IO_ERROR) return ERR_CODE;                                   \
         if (rfidx__st != RFIDX_OK) return rfidx__st;                                                    \
         RfidxStatus rfidx__pst = rfidx__pf(                                                             \
-            (const uint8_t *)rfidx__buf, rfidx__buf_len, (OUT_PTR), (HDR_PTR));                         \
-        free(rfidx__buf);                                                                               \
+            (const uint8_t *)rfidx__map.base, rfidx__map.length, (OUT_PTR), (HDR_PTR));                 \
+        rfidx_unmap_file(&rfidx__map);                                                                  \
         return rfidx__pst;                                                                              \
     } while (0)
 
+/**
+ * @brief Result of a transform that saved to a file instead of returning the output
+ *
+ * Transforms return NULL on failure, so a successful save returns an empty string,
+ * which is freed like any other output.
+ * @param status Status of the save.
+ * @return An empty string if the save succeeded, otherwise NULL
+ */
+static inline char *transform_format_saved(const RfidxStatus status) {
+    if (status != RFIDX_OK) return NULL;
+
+    char *empty = rfidx_malloc(1);
+    if (empty) empty[0] = '\0';
+    return empty;
+}
+
 #define TRANSFORM_FORMAT(FILENAME, OUT_FMT, OUT_PTR, OUT_TYPE, HDR_PTR, HDR_TYPE, B_SIZE,   \
                          SB_FN, OB_FN, SJ_FN, OJ_FN, SN_FN, ON_FN)                          \
     do {                                                                                    \
@@ -66,27 +88,25 @@
                 if (save_to_file) {                                                         \
                     rfidx__save_sig_t rfidx__sf = (OB_FN);                                  \
                     (void)rfidx__sf;                                                        \
-                    rfidx__sf(FILENAME, OUT_PTR, HDR_PTR);                                  \
+                    return transform_format_saved(rfidx__sf(FILENAME, OUT_PTR, HDR_PTR));   \
                 } else {                                                                    \
                     rfidx__sb_sig_t rfidx__sf = (SB_FN);                                    \
                     (void)rfidx__sf;                                                        \
                     uint8_t *buffer = rfidx__sf(OUT_PTR, HDR_PTR);                          \
-                    char *hex_str = malloc((B_SIZE) * 2 + 1);                               \
+                    char *hex_str = rfidx_malloc((B_SIZE) * 2 + 1);                         \
                     if (!hex_str) {                                                         \
-                        free(buffer);                                                       \
+                        rfidx_free(buffer);                                                 \
                         return NULL;                                                        \
                     }                                                                       \
-                    for (size_t i = 0; i < (B_SIZE); i++) {                                 \
-                        sprintf(hex_str + i * 2, "%02X", buffer[i]);                        \
-                    }                                                                       \
-                    free(buffer);                                                           \
+                    bytes_to_hex(buffer, (B_SIZE), hex_str);                                \
+                    rfidx_free(buffer);                                                     \
                     return hex_str;                                                         \
                 }                                                                           \
             case FORMAT_JSON:                                                               \
                 if (save_to_file) {                                                         \
                     rfidx__save_sig_t rfidx__sf = (OJ_FN);                                  \
                     (void)rfidx__sf;                                                        \
-                    rfidx__sf(FILENAME, OUT_PTR, HDR_PTR);                                  \
+                    return transform_format_saved(rfidx__sf(FILENAME, OUT_PTR, HDR_PTR));   \
                 } else {                                                                    \
                     rfidx__st_sig_t rfidx__sf = (SJ_FN);                                    \
                     (void)rfidx__sf;                                                        \
@@ -96,7 +116,7 @@
                 if (save_to_file) {                                                         \
                     rfidx__save_sig_t rfidx__sf = (ON_FN);                                  \
                     (void)rfidx__sf;                                                        \
-                    rfidx__sf(FILENAME, OUT_PTR, HDR_PTR);                                  \
+                    return transform_format_saved(rfidx__sf(FILENAME, OUT_PTR, HDR_PTR));   \
                 } else {                                                                    \
                     rfidx__st_sig_t rfidx__sf = (SN_FN);                                    \
                     (void)rfidx__sf;                                                        \
@@ -126,6 +146,75 @@ char *unsupported_transform_format(
 
 RfidxStatus read_file(const char *filename, char **out_buf, size_t *out_len, uint32_t err_code);
 
+/**
+ * @brief Relative paths of the regular files under a directory tree
+ */
+typedef struct {
+    char **paths;
+    size_t count;
+    size_t cap;
+} RfidxFileList;
+
+/**
+ * @brief List every regular file under a directory tree, in name order
+ *
+ * Symbolic links are not followed.
+ * @param root The directory to walk.
+ * @param files Set to the paths, relative to root. Must be released with free_file_list.
+ * @return RFIDX_OK, RFIDX_BINARY_FILE_IO_ERROR if a directory cannot be read, or RFIDX_MEMORY_ERROR
+ */
+RfidxStatus list_files(const char *root, RfidxFileList *files);
+
+/**
+ * @brief Release a list made by list_files
+ * @param files The list.
+ */
+void free_file_list(RfidxFileList *files);
+
+/**
+ * @brief Create the missing directories of a path, but not the path itself
+ * @param path The path of a file. Changed while the directories are made, and restored after.
+ * @return RFIDX_OK, or RFIDX_BINARY_FILE_IO_ERROR if a directory cannot be created
+ */
+RfidxStatus make_parent_directories(char *path);
+
+/**
+ * @brief Length of a path without the extension of its file name
+ *
+ * Converted dumps keep the path of their input with the extension of the output format, so
+ * this is the part of the input path an output is named after.
+ * @param path The input path.
+ * @return The length of the path up to the last dot of its file name, or the whole length
+ * if the file name has no extension
+ */
+size_t output_stem_length(const char *path);
+
+/**
+ * @brief Find the inputs whose output would replace the output of another input
+ *
+ * Inputs that only differ in their extension, such as `a.json` and `a.nfc`, are converted to
+ * the same file. The first of them in the list keeps the output, the others are flagged.
+ * @param paths The input paths.
+ * @param count Number of paths.
+ * @param collides Set to true for every path whose output belongs to an earlier path, and to
+ * false for the others. Must hold count entries.
+ * @return RFIDX_OK or RFIDX_MEMORY_ERROR
+ */
+RfidxStatus find_output_collisions(const char *const *paths, size_t count, bool *collides);
+
+/**
+ * @brief Read everything from a file descriptor until end of file
+ *
+ * Used for pipes and other streams whose size is not known up front. The buffer is
+ * null-terminated so that text formats can be parsed from it directly.
+ * @param fd The file descriptor to read from.
+ * @param out_buf Set to the allocated buffer. Must be freed with rfidx_free.
+ * @param out_len Set to the number of bytes read, without the terminator. Can be NULL.
+ * @param err_code Error code to return on failure.
+ * @return RFIDX_OK, RFIDX_MEMORY_ERROR or err_code
+ */
+RfidxStatus read_fd(int fd, char **out_buf, size_t *out_len, uint32_t err_code);
+
 RfidxStatus write_file(
     const char *filename,
     const char *buffer,
@@ -134,13 +223,43 @@ RfidxStatus write_file(
     uint32_t err_code
 );
 
+/**
+ * @brief Write several buffers to a file with a single vectored write
+ *
+ * The file is written with open(2) and writev(2), without stdio buffering, so the buffers
+ * are copied straight from where they are. Used to save tag structures without first
+ * assembling them into one buffer.
+ * @param filename Path to the file, which is created or truncated.
+ * @param iov The buffers, written in order.
+ * @param count Number of buffers, at most WRITE_FILE_MAX_IOV.
+ * @param err_code Error code to return on failure.
+ * @return RFIDX_OK, or err_code
+ */
+RfidxStatus write_file_vectored(
+    const char *filename,
+    const struct iovec *iov,
+    int count,
+    uint32_t err_code
+);
+
+/**
+ * @brief Detect the tag type and format of a file from its content
+ *
+ * Reads at most RFIDX_DETECT_PREFIX_SIZE bytes and classifies them with rfidx_detect_tag.
+ * @param filename The file path to classify.
+ * @param tag_type Set to the detected tag type.
+ * @param format Set to the detected format.
+ * @return RFIDX_OK, RFIDX_BINARY_FILE_IO_ERROR, or RFIDX_FILE_FORMAT_ERROR if not recognised
+ */
+RfidxStatus rfidx_detect_file(const char *filename, TagType *tag_type, FileFormat *format);
+
 /**
  * @brief Read a tag from a given file path
  *
  * This function is the main utility function to read a tag from file system. If a tag type
  * is provided, it will respect that, and return an error if the type mismatch; if the type is
- * set to unspecified, it tries to determine the tag type from file, and return error if not
- * possible.
+ * set to unspecified, the tag type and the format are both detected from the content of the file
+ * with rfidx_detect_file, and TAG_UNKNOWN is returned if they cannot be.
  * @param filename The file path to read the tag data from.
  * @param input_type The specified tag type. Set to TAG_UNSPECIFIED (0) to detect.
  * @param data The pointer to pointer of tag data, memory will be allocated WITHIN THE FUNCTION
@@ -157,6 +276,227 @@ TagType read_tag_from_file(
     void **header
 );
 
+/**
+ * @brief Parse a tag held in memory
+ *
+ * Unlike read_tag_from_file, nothing is detected: the tag type and format must both be given.
+ * @param buffer The tag content. Text formats must be null-terminated.
+ * @param length Length of the content, without any terminator.
+ * @param input_type The tag type.
+ * @param format The format of the content, one of FORMAT_BINARY, FORMAT_JSON or FORMAT_NFC.
+ * @param data The pointer to pointer of tag data, allocated WITHIN THE FUNCTION. Must be freed
+ * after use, even if parsing failed.
+ * @param header The pointer to pointer of metadata header, allocated WITHIN THE FUNCTION. Must
+ * be freed after use, even if parsing failed.
+ * @return The type of the tag, TAG_UNKNOWN for an unsupported type, or TAG_ERROR
+ */
+TagType read_tag_from_buffer(
+    const char *buffer,
+    size_t length,
+    TagType input_type,
+    FileFormat format,
+    void **data,
+    void **header
+);
+
+/**
+ * @brief Parse a comma separated list of output formats
+ * @param list The list, e.g. "json,nfc,binary".
+ * @param formats Array of at least RFIDX_MAX_OUTPUT_FORMATS entries to fill.
+ * @param count Set to the number of formats in the list.
+ * @return RFIDX_OK, or RFIDX_FILE_FORMAT_ERROR for an unknown, repeated or empty entry
+ */
+RfidxStatus parse_file_format_list(const char *list, FileFormat *formats, size_t *count);
+
+/**
+ * @brief Name the output file for one format
+ *
+ * Every {ext} in the template is replaced by the usual extension of the format. A template
+ * without a placeholder gets the extension appended instead.
+ * @param template The output path template, e.g. "dumps/tag.{ext}".
+ * @param format The output format.
+ * @param out Buffer for the file name.
+ * @param cap Size of the buffer.
+ * @return RFIDX_OK, RFIDX_FILE_FORMAT_ERROR or RFIDX_BUFFER_SIZE_ERROR
+ */
+RfidxStatus expand_output_template(const char *template, FileFormat format, char *out, size_t cap);
+
+/**
+ * @brief Save a tag in several formats
+ *
+ * The same in-memory tag is handed to the serializer of each format in turn.
+ * @param data Pointer to the tag data.
+ * @param header Pointer to the metadata header.
+ * @param tag_type The type of the tag.
+ * @param formats The output formats.
+ * @param count Number of formats.
+ * @param template Output path template for expand_output_template, or NULL to print every format.
+ * @param output_stream Stream to print to when there is no template.
+ * @param error_stream Stream for error messages.
+ * @return RFIDX_OK, or the error of the first format that failed
+ */
+RfidxStatus save_tag_to_files(
+    const void *data,
+    const void *header,
+    TagType tag_type,
+    const FileFormat *formats,
+    size_t count,
+    const char *template,
+    FILE *output_stream,
+    FILE *error_stream
+);
+
+/**
+ * @brief Serialize a tag into memory in the given format
+ *
+ * The buffer holds exactly what write_tag_to_stream writes.
+ * @param data Pointer to the tag data.
+ * @param header Pointer to the metadata header.
+ * @param tag_type The type of the tag.
+ * @param format The output format, one of FORMAT_BINARY, FORMAT_JSON or FORMAT_NFC.
+ * @param buffer Set to the output, allocated WITHIN THE FUNCTION. Must be freed with rfidx_free.
+ * @param length Set to the size of the output.
+ * @return RfidxStatus indicating success or failure of the serialization.
+ */
+RfidxStatus serialize_tag(
+    const void *data,
+    const void *header,
+    TagType tag_type,
+    FileFormat format,
+    char **buffer,
+    size_t *length
+);
+
+/**
+ * @brief Write a tag to a stream in the given format
+ *
+ * Binary output is written as raw bytes, so the stream can be piped into another tool or
+ * redirected to a file. Text formats are written exactly as they would be saved to a file.
+ * @param data Pointer to the tag data.
+ * @param header Pointer to the metadata header.
+ * @param tag_type The type of the tag.
+ * @param format The output format, one of FORMAT_BINARY, FORMAT_JSON or FORMAT_NFC.
+ * @param stream The stream to write to.
+ * @return RfidxStatus indicating success or failure of the write.
+ */
+RfidxStatus write_tag_to_stream(
+    const void *data,
+    const void *header,
+    TagType tag_type,
+    FileFormat format,
+    FILE *stream
+);
+
+/**
+ * @brief Write a tag to a file that readers only ever see complete
+ *
+ * The tag is written to a temporary file next to the output, which is then renamed over it.
+ * @param output Path of the file to write.
+ * @param data The tag data.
+ * @param header The metadata header.
+ * @param tag_type The type of the tag.
+ * @param format The output format, one of FORMAT_BINARY, FORMAT_JSON or FORMAT_NFC.
+ * @return RfidxStatus indicating success or failure of the write.
+ */
+RfidxStatus write_tag_to_file_atomic(
+    const char *output,
+    const void *data,
+    const void *header,
+    TagType tag_type,
+    FileFormat format
+);
+
+/**
+ * @brief Write a buffer to a file that readers only ever see complete
+ *
+ * Same as write_tag_to_file_atomic(), for content that is already serialized.
+ * @param output Path of the file to write.
+ * @param buffer The bytes to write.
+ * @param length Number of bytes in the buffer.
+ * @return RfidxStatus indicating success or failure of the write.
+ */
+RfidxStatus write_file_atomic(const char *output, const void *buffer, size_t length);
+
+/**
+ * @brief Convert a transform name used on the command line to its command
+ * @param str "generate", "randomize-uid" or "wipe". Can be NULL.
+ * @return The command, or TRANSFORM_NONE if the name is NULL or unknown
+ */
+TransformCommand string_to_transform_command(const char *str);
+
+/**
+ * @brief Apply a transform command to a tag
+ *
+ * Randomness is drawn from the given context, whose generator is seeded on first use. Threads
+ * transforming tags in parallel must each pass their own context.
+ * @param ctx The context that owns the random generator.
+ * @param tag_type The type of the tag.
+ * @param command The transform command.
+ * @param data The pointer to pointer of tag data. Allocated within the function for TRANSFORM_GENERATE.
+ * @param header The pointer to pointer of metadata header. Allocated within the function for
+ * TRANSFORM_GENERATE.
+ * @param uuid Hex encoded Amiibo UUID, used when generating an Amiibo.
+ * @param retail_key Path to the Amiibo retail key, required for all Amiibo transforms.
+ * @return RfidxStatus indicating success or failure of the transform.
+ */
+RfidxStatus transform_tag_ctx(
+    RfidxContext *ctx,
+    TagType tag_type,
+    TransformCommand command,
+    void **data,
+    void **header,
+    const char *uuid,
+    const char *retail_key
+);
+
+/**
+ * @brief Apply a transform command to a tag, with retail keys that are already loaded
+ *
+ * Same as transform_tag_ctx(), for callers that transform many Amiibo with one key file and
+ * should not read it from disk for every tag.
+ * @param ctx The context that owns the random generator.
+ * @param tag_type The type of the tag.
+ * @param command The transform command.
+ * @param data The pointer to pointer of tag data.
+ * @param header The pointer to pointer of metadata header.
+ * @param uuid Hex encoded Amiibo UUID, used when generating an Amiibo.
+ * @param dumped_keys The Amiibo retail keys, required for all Amiibo transforms. Can be NULL for other tags.
+ * @return RfidxStatus indicating success or failure of the transform.
+ */
+RfidxStatus transform_tag_with_keys_ctx(
+    RfidxContext *ctx,
+    TagType tag_type,
+    TransformCommand command,
+    void **data,
+    void **header,
+    const char *uuid,
+    const DumpedKeys *dumped_keys
+);
+
+/**
+ * @brief Apply a transform command directly to a binary dump file
+ *
+ * The file is mapped for writing and transformed in place, and only the pages that changed
+ * are written back. If the transform fails, the file is left as it was. Only commands that
+ * modify an existing dump, wipe and randomize-uid, are supported.
+ * @param ctx The context that owns the random generator.
+ * @param tag_type The type of the tag. TAG_UNSPECIFIED picks NTAG215 or Mifare Classic 1K from
+ * the file size; Amiibo must be requested explicitly.
+ * @param command The transform command.
+ * @param filename Path to the binary dump.
+ * @param uuid Hex encoded Amiibo UUID. Unused by the supported commands.
+ * @param retail_key Path to the Amiibo retail key, required for Amiibo.
+ * @return RfidxStatus indicating success or failure of the transform.
+ */
+RfidxStatus transform_tag_in_place(
+    RfidxContext *ctx,
+    TagType tag_type,
+    TransformCommand command,
+    const char *filename,
+    const char *uuid,
+    const char *retail_key
+);
+
 /**
  * @brief Main function for rfidx CLI utility
  *
@@ -0,0 +1,123 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBRFIDX_STORE_H
+#define LIBRFIDX_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "librfidx/common.h"
+#include "librfidx/batch.h"
+
+/*
+ * Store layout:
+ *
+ *   objects/<2 hex digits>/<62 hex digits>
+ *            The binary tag data (Ntag215Data or Mfc1kData), named by the SHA-256 of its
+ *            bytes. Identical data is stored once, however many dumps hold it.
+ *   refs/<name>
+ *            One small file per dump, named like the original file: RFIDX_STORE_REF_MAGIC,
+ *            the version and tag type as 16-bit little-endian integers, the size of the
+ *            metadata header as a 32-bit little-endian integer, the key of the data object,
+ *            then the metadata header itself.
+ *
+ * The metadata header lives in the reference, so dumps that only differ in their header,
+ * such as the NTAG counters, still share their data object.
+ */
+#define RFIDX_STORE_KEY_SIZE 32
+#define RFIDX_STORE_REF_MAGIC "RFIDXREF"
+#define RFIDX_STORE_VERSION 1
+#define RFIDX_STORE_REF_HEADER_SIZE (16 + RFIDX_STORE_KEY_SIZE)
+
+/**
+ * @brief Outcome of adding dumps to a store
+ */
+typedef struct {
+    size_t added;                   /**< References written */
+    size_t deduplicated;            /**< References whose data was already stored, also counted as added */
+    size_t failed;                  /**< Dumps that could not be read or stored */
+} RfidxStoreSummary;
+
+/**
+ * @brief Add a parsed dump to a store
+ *
+ * The data object is only written if no dump with the same data was stored before. Objects and
+ * references are written to a temporary file and renamed into place, so a reader never sees a
+ * partial file. A reference that already exists is replaced.
+ * @param store_dir The store directory, created if missing.
+ * @param name Name of the reference, a relative path that must not leave the store.
+ * @param tag_type The type of the tag.
+ * @param data The tag data, Ntag215Data or Mfc1kData.
+ * @param header The metadata header.
+ * @param deduplicated Set to true if the data was already stored. Can be NULL.
+ * @return RFIDX_OK, RFIDX_UNKNOWN_ENUM_ERROR for an unsupported tag type,
+ * RFIDX_FILE_FORMAT_ERROR for an invalid name, or an I/O error
+ */
+RFIDX_EXPORT RfidxStatus rfidx_store_add(
+    const char *store_dir,
+    const char *name,
+    TagType tag_type,
+    const void *data,
+    const void *header,
+    bool *deduplicated
+);
+
+/**
+ * @brief Add every dump under a directory tree to a store
+ *
+ * Each dump is referenced by its path relative to the input directory. A dump that cannot be
+ * read is reported and skipped.
+ * @param store_dir The store directory, created if missing.
+ * @param input_dir The directory to read dumps from.
+ * @param tag_type Type of every dump, or TAG_UNSPECIFIED to detect each one.
+ * @param on_result Called once per file with its relative path and the reference. Can be NULL.
+ * @param user Passed to on_result.
+ * @param summary Set to the number of added, deduplicated and failed dumps. Can be NULL.
+ * @return RFIDX_OK if the directory was read, even if some dumps failed
+ */
+RFIDX_EXPORT RfidxStatus rfidx_store_add_tree(
+    const char *store_dir,
+    const char *input_dir,
+    TagType tag_type,
+    RfidxBatchCallback on_result,
+    void *user,
+    RfidxStoreSummary *summary
+);
+
+/**
+ * @brief Read a dump back from a store
+ * @param store_dir The store directory.
+ * @param name Name of the reference.
+ * @param tag_type Set to the type of the tag.
+ * @param data Set to the tag data, allocated WITHIN THE FUNCTION. Must be freed with rfidx_free.
+ * @param header Set to the metadata header, allocated WITHIN THE FUNCTION. Must be freed with rfidx_free.
+ * @return RFIDX_OK, RFIDX_BINARY_FILE_IO_ERROR if there is no such reference, RFIDX_FILE_FORMAT_ERROR
+ * for a damaged reference, or RFIDX_CHECKSUM_ERROR if the data object does not match its key
+ */
+RFIDX_EXPORT RfidxStatus rfidx_store_get(
+    const char *store_dir,
+    const char *name,
+    TagType *tag_type,
+    void **data,
+    void **header
+);
+
+/**
+ * @brief Delete the data objects no reference points to
+ *
+ * Objects are orphaned when a reference is replaced or deleted. Must not run while dumps are
+ * being added, as an object is written before the reference to it.
+ * @param store_dir The store directory.
+ * @param kept Set to the number of objects still referenced. Can be NULL.
+ * @param removed Set to the number of deleted objects. Can be NULL.
+ * @return RFIDX_OK, or an error if a reference could not be read, in which case nothing is deleted
+ */
+RFIDX_EXPORT RfidxStatus rfidx_store_gc(const char *store_dir, size_t *kept, size_t *removed);
+
+#endif //LIBRFIDX_STORE_H
@@ -0,0 +1,57 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBRFIDX_STREAM_H
+#define LIBRFIDX_STREAM_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "librfidx/common.h"
+
+#define RFIDX_STREAM_RECORDS_PER_BUFFER 64
+
+/**
+ * @brief How to convert a stream of binary dumps
+ *
+ * All records in a stream have the same size, as there is nothing in a binary dump to tell
+ * where one ends and the next begins.
+ */
+typedef struct {
+    TagType tag_type;               /**< Type of every record in the stream, must not be TAG_UNSPECIFIED */
+    size_t record_size;             /**< Size of each record, 0 for the largest binary dump of the tag type */
+    TransformCommand command;       /**< TRANSFORM_NONE, TRANSFORM_RANDOMIZE_UID or TRANSFORM_WIPE */
+    FileFormat output_format;       /**< FORMAT_BINARY, or FORMAT_JSON for one document per line */
+    const char *uuid;               /**< Hex encoded Amiibo UUID, can be NULL */
+    const char *retail_key;         /**< Path to the Amiibo retail key, required for Amiibo transforms */
+} RfidxStreamOptions;
+
+/**
+ * @brief Convert a stream of back-to-back binary dumps
+ *
+ * Records are read from the descriptor by a separate thread into one of two fixed buffers,
+ * while the records in the other buffer are parsed, transformed and written. Memory use does
+ * not depend on the length of the stream. Binary output keeps the input record size, so a
+ * stream with headers stays a stream with headers.
+ * @param ctx The context that owns the random generator.
+ * @param input_fd The descriptor to read records from, until end of file.
+ * @param output The stream to write converted records to.
+ * @param options How to convert the records.
+ * @param records Set to the number of records written. Can be NULL.
+ * @return RFIDX_OK, RFIDX_BINARY_FILE_SIZE_ERROR if the stream ends with a partial record,
+ * or the error of the first record that failed
+ */
+RFIDX_EXPORT RfidxStatus rfidx_convert_stream(
+    RfidxContext *ctx,
+    int input_fd,
+    FILE *output,
+    const RfidxStreamOptions *options,
+    size_t *records
+);
+
+#endif //LIBRFIDX_STREAM_H
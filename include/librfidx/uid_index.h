@@ -0,0 +1,157 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBRFIDX_UID_INDEX_H
+#define LIBRFIDX_UID_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "librfidx/common.h"
+#include "librfidx/mapping.h"
+
+/*
+ * Index layout, all integers little-endian:
+ *
+ *   header   RFIDX_UID_INDEX_HEADER_SIZE bytes
+ *   slots    slot_count * RFIDX_UID_INDEX_SLOT_SIZE bytes, an open-addressing table with
+ *            linear probing. A slot holds the key of a UID, 0 when empty, and the number
+ *            of the record it was found in.
+ *   names    (record_count + 1) offsets of 8 bytes, then the names of the records back to
+ *            back. Record i is named by the bytes from offset i to offset i + 1.
+ *
+ * The key of a UID is its bytes read big-endian, with its length in the top byte, so a
+ * 4-byte NUID never matches a 7-byte UID.
+ */
+#define RFIDX_UID_INDEX_MAGIC "RFIDXUID"
+#define RFIDX_UID_INDEX_VERSION 1
+#define RFIDX_UID_INDEX_HEADER_SIZE 64
+#define RFIDX_UID_INDEX_SLOT_SIZE 16
+#define RFIDX_UID_MAX_SIZE 7
+
+/**
+ * @brief Get the UID of a tag
+ *
+ * NTAG 215 and Amiibo always have a 7-byte UID. Mifare Classic has a 4-byte NUID when the
+ * fifth byte of block 0 is its BCC, and a 7-byte UID otherwise.
+ * @param tag_type The type of the tag.
+ * @param data The tag data, Ntag215Data or Mfc1kData.
+ * @param uid Set to the UID.
+ * @param uid_len Set to the number of bytes of the UID, 4 or 7.
+ * @return RFIDX_OK, or RFIDX_UNKNOWN_ENUM_ERROR for another tag type
+ */
+RFIDX_EXPORT RfidxStatus rfidx_tag_uid(
+    TagType tag_type,
+    const void *data,
+    uint8_t uid[RFIDX_UID_MAX_SIZE],
+    size_t *uid_len
+);
+
+/**
+ * @brief Called for every record whose UID is already in the index
+ * @param uid The UID.
+ * @param uid_len Number of bytes of the UID.
+ * @param first Name of the first record with this UID.
+ * @param duplicate Name of the record with the same UID.
+ * @param user The user pointer given to rfidx_uid_index_build().
+ */
+typedef void (*RfidxUidDuplicateCallback)(const uint8_t *uid, size_t uid_len, const char *first,
+                                          const char *duplicate, void *user);
+
+/**
+ * @brief Outcome of building an index
+ */
+typedef struct {
+    size_t indexed;                 /**< Records whose UID is in the index */
+    size_t duplicates;              /**< Records whose UID was already in the index */
+    size_t failed;                  /**< Dumps or records that could not be read */
+} RfidxUidIndexSummary;
+
+/**
+ * @brief Build the UID index of an archive or of a directory tree of dumps
+ *
+ * For an archive, record i of the index is record i of the archive, named as in the archive.
+ * For a directory, records are the readable dumps in name order, named by their relative path.
+ * The index is written to a temporary file and renamed into place.
+ * @param source Path of an archive, or of a directory.
+ * @param filename Path of the index to write.
+ * @param on_duplicate Called for every record whose UID was seen before. Can be NULL.
+ * @param user Passed to on_duplicate.
+ * @param summary Set to the number of indexed, duplicate and failed records. Can be NULL.
+ * @return RFIDX_OK if the index was written, even if some dumps failed
+ */
+RFIDX_EXPORT RfidxStatus rfidx_uid_index_build(
+    const char *source,
+    const char *filename,
+    RfidxUidDuplicateCallback on_duplicate,
+    void *user,
+    RfidxUidIndexSummary *summary
+);
+
+/**
+ * @brief A UID index mapped read-only
+ */
+typedef struct {
+    RfidxMapping mapping;
+    size_t slot_count;              /**< A power of two */
+    size_t record_count;
+    const uint8_t *slots;           /**< The slots, inside the mapping */
+    const uint8_t *name_offsets;    /**< The offsets of the names, inside the mapping */
+    const char *names;              /**< The names, inside the mapping */
+    size_t names_len;
+} RfidxUidIndex;
+
+/**
+ * @brief Map a UID index for lookups
+ * @param filename Path of the index.
+ * @param index Set to the mapped index.
+ * @return RFIDX_OK, RFIDX_FILE_FORMAT_ERROR if the file is not a valid index, or an I/O error
+ */
+RFIDX_EXPORT RfidxStatus rfidx_uid_index_map(const char *filename, RfidxUidIndex *index);
+
+/**
+ * @brief Find the records with a UID
+ *
+ * The cost does not depend on the number of records, only on how far the probe runs.
+ * @param index The mapped index.
+ * @param uid The UID.
+ * @param uid_len Number of bytes of the UID, from 1 to RFIDX_UID_MAX_SIZE.
+ * @param records Set to the numbers of up to max matching records. Can be NULL if max is 0.
+ * @param max Size of records.
+ * @return The number of records with the UID, which can be more than max
+ */
+RFIDX_EXPORT size_t rfidx_uid_index_lookup(
+    const RfidxUidIndex *index,
+    const uint8_t *uid,
+    size_t uid_len,
+    size_t *records,
+    size_t max
+);
+
+/**
+ * @brief Name of a record
+ * @param index The mapped index.
+ * @param record Number of the record.
+ * @param name Set to the name, inside the mapping and not null-terminated.
+ * @param name_len Set to the length of the name.
+ * @return RFIDX_OK, RFIDX_BUFFER_SIZE_ERROR past the last record, or RFIDX_FILE_FORMAT_ERROR
+ */
+RFIDX_EXPORT RfidxStatus rfidx_uid_index_name(
+    const RfidxUidIndex *index,
+    size_t record,
+    const char **name,
+    size_t *name_len
+);
+
+/**
+ * @brief Release a mapped index
+ * @param index The index.
+ */
+RFIDX_EXPORT void rfidx_uid_index_unmap(RfidxUidIndex *index);
+
+#endif //LIBRFIDX_UID_INDEX_H
@@ -0,0 +1,85 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef LIBRFIDX_WATCH_H
+#define LIBRFIDX_WATCH_H
+
+#include <signal.h>
+#include <stddef.h>
+#include "librfidx/common.h"
+
+/**
+ * @brief Name of the file, in the output directory, that records what has been converted
+ */
+#define RFIDX_WATCH_STATE_FILE ".rfidx-watch"
+
+/**
+ * @brief How often the stop flag is checked while no file arrives, in milliseconds
+ */
+#define RFIDX_WATCH_POLL_INTERVAL 200
+
+/**
+ * @brief Called once for every file that was converted or failed
+ *
+ * Calls are serialized. Files skipped because their content was already converted are not reported.
+ */
+typedef void (*RfidxWatchCallback)(const char *input, const char *output, RfidxStatus status, void *user);
+
+/**
+ * @brief How to convert the dumps arriving in a directory
+ */
+typedef struct {
+    TagType input_type;                 /**< Type of every input, or TAG_UNSPECIFIED to detect each one */
+    TransformCommand command;           /**< Transform applied to every input, or TRANSFORM_NONE */
+    FileFormat output_format;           /**< FORMAT_BINARY, FORMAT_JSON or FORMAT_NFC */
+    const char *uuid;                   /**< Hex encoded Amiibo UUID, can be NULL */
+    const char *retail_key;             /**< Path to the Amiibo retail key, required for Amiibo transforms */
+    unsigned int threads;               /**< Number of worker threads, 0 for one per online CPU */
+    const volatile sig_atomic_t *stop;  /**< Watching ends once this is non-zero, e.g. from a signal handler.
+                                             NULL to convert the files already there and return */
+    RfidxWatchCallback on_result;       /**< Per file report, can be NULL */
+    void *user;                         /**< Passed to on_result */
+} RfidxWatchOptions;
+
+/**
+ * @brief Outcome of a watch
+ */
+typedef struct {
+    size_t converted;                   /**< Files written */
+    size_t failed;                      /**< Files that could not be read, transformed or written */
+    size_t skipped;                     /**< Files whose content had already been converted */
+} RfidxWatchSummary;
+
+/**
+ * @brief Convert the dumps in a directory, and keep converting them as they arrive
+ *
+ * Every file already in the directory is converted first, then files that are closed after
+ * writing or moved into the directory are picked up as they come, until the stop flag is set.
+ * The work is spread over a pool of threads that lives as long as the watch.
+ *
+ * The SHA-256 of every converted file is appended to RFIDX_WATCH_STATE_FILE in the output
+ * directory. A file whose content is recorded under its name is skipped, so a restarted watch
+ * only converts what changed while it was down. Only the top level of the directory is watched,
+ * and names starting with a dot are ignored. A file that only differs in its extension from a
+ * file converted before, such as `a.json` after `a.nfc`, fails with RFIDX_OUTPUT_COLLISION_ERROR
+ * instead of replacing its output.
+ * @param input_dir The directory to watch. Must not be the output directory.
+ * @param output_dir The directory to write to, created if missing.
+ * @param options How to convert the files.
+ * @param summary Set to the number of converted, failed and skipped files. Can be NULL.
+ * @return RFIDX_OK once stopped, or an error if watching could not start
+ */
+RFIDX_EXPORT RfidxStatus rfidx_watch(
+    const char *input_dir,
+    const char *output_dir,
+    const RfidxWatchOptions *options,
+    RfidxWatchSummary *summary
+);
+
+#endif //LIBRFIDX_WATCH_H
@@ -257,28 +257,33 @@ RfidxStatus amiibo_generate(
     const uint8_t *uuid,
     AmiiboData *amiibo_data,
     Ntag21xMetadataHeader *header
+) {
+    return amiibo_generate_ctx(&rfidx_default_context, uuid, amiibo_data, header);
+}
+
+RfidxStatus amiibo_generate_ctx(
+    RfidxContext *ctx,
+    const uint8_t *uuid,
+    AmiiboData *amiibo_data,
+    Ntag21xMetadataHeader *header
 ) {
     // Re-initialize the memory space
     memset(amiibo_data, 0, sizeof(AmiiboData));
     memset(header, 0, sizeof(Ntag21xMetadataHeader));
 
-    if (!rfidx_rng_initialized) {
-        return RFIDX_DRNG_ERROR;
-    }
-
-    const int ret = mbedtls_ctr_drbg_random(
-        &rfidx_ctr_drbg,
+    const RfidxStatus status = rfidx_random_ctx(
+        ctx,
         amiibo_data->amiibo.keygen_salt,
         sizeof(amiibo_data->amiibo.keygen_salt)
     );
-    if (ret != 0) {
-        return RFIDX_DRNG_ERROR;
+    if (status != RFIDX_OK) {
+        return status;
     }
 
     // Set the UUID
     memcpy(amiibo_data->amiibo.model_info.bytes, uuid, 8);
 
-    ntag21x_randomize_uid(&amiibo_data->ntag215.structure.manufacturer_data);
+    ntag21x_randomize_uid_ctx(ctx, &amiibo_data->ntag215.structure.manufacturer_data);
 
     // Format the dump
     amiibo_format_dump(amiibo_data, header);
@@ -301,6 +306,17 @@ RfidxStatus amiibo_transform_data(
     const TransformCommand command,
     const uint8_t *uuid,
     const DumpedKeys *dumped_keys
+) {
+    return amiibo_transform_data_ctx(&rfidx_default_context, amiibo_data, header, command, uuid, dumped_keys);
+}
+
+RfidxStatus amiibo_transform_data_ctx(
+    RfidxContext *ctx,
+    AmiiboData **amiibo_data,
+    Ntag21xMetadataHeader **header,
+    const TransformCommand command,
+    const uint8_t *uuid,
+    const DumpedKeys *dumped_keys
 ) {
     if (command == TRANSFORM_NONE) {
         // Return early
@@ -309,22 +325,22 @@ RfidxStatus amiibo_transform_data(
 
     if (command == TRANSFORM_GENERATE) {
         // Prepare the data first due to no input
-        *amiibo_data = malloc(sizeof(AmiiboData));
+        *amiibo_data = rfidx_malloc(sizeof(AmiiboData));
         if (!*amiibo_data) {
             return RFIDX_MEMORY_ERROR;
         }
 
-        *header = malloc(sizeof(Ntag21xMetadataHeader));
+        *header = rfidx_malloc(sizeof(Ntag21xMetadataHeader));
         if (!*header) {
-            free(*amiibo_data);
+            rfidx_free(*amiibo_data);
             return RFIDX_MEMORY_ERROR;
         }
 
         // Generate the amiibo data
-        const RfidxStatus status = amiibo_generate(uuid, *amiibo_data, *header);
+        const RfidxStatus status = amiibo_generate_ctx(ctx, uuid, *amiibo_data, *header);
         if (status != RFIDX_OK) {
-            free(*amiibo_data);
-            free(*header);
+            rfidx_free(*amiibo_data);
+            rfidx_free(*header);
             return status;
         }
     }
@@ -369,7 +385,7 @@ RfidxStatus amiibo_transform_data(
             }
 
             // Randomize the UID
-            status = ntag21x_randomize_uid(&(*amiibo_data)->ntag215.structure.manufacturer_data);
+            status = ntag21x_randomize_uid_ctx(ctx, &(*amiibo_data)->ntag215.structure.manufacturer_data);
             if (status != RFIDX_OK) {
                 return status;
             }
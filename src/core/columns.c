@@ -0,0 +1,531 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "librfidx/columns.h"
+#include "librfidx/application/amiibo_core.h"
+#include "librfidx/mifare/mifare_classic_1k_core.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__) && defined(__GNUC__)
+#define RFIDX_COLUMNS_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Deepest nesting of parentheses and ! in a query
+ */
+#define QUERY_MAX_DEPTH 64
+
+static uint64_t read_be(const uint8_t *bytes, const size_t len) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < len; i++) value = value << 8 | bytes[i];
+    return value;
+}
+
+typedef uint64_t (*ColumnExtractor)(const void *data, const void *header, unsigned int arg);
+
+typedef struct {
+    const char *name;
+    ColumnExtractor extract;
+    unsigned int arg;
+} ColumnDef;
+
+static uint64_t ntag_uid(const void *data, const void *header, const unsigned int arg) {
+    (void) header;
+    (void) arg;
+    const Ntag21xManufacturerData *manufacturer = &((const Ntag215Data *) data)->structure.manufacturer_data;
+    return read_be(manufacturer->uid0, 3) << 32 | read_be(manufacturer->uid1, 4);
+}
+
+static uint64_t ntag_version(const void *data, const void *header, const unsigned int arg) {
+    (void) data;
+    (void) arg;
+    return read_be(((const Ntag21xMetadataHeader *) header)->version, 8);
+}
+
+/* arg is the offset of the field in the model information, and its size in the top byte */
+static uint64_t amiibo_model(const void *data, const void *header, const unsigned int arg) {
+    (void) header;
+    const AmiiboModelInfo *model = &((const AmiiboData *) data)->amiibo.model_info;
+    return read_be(model->bytes + (arg & 0xFF), arg >> 8);
+}
+
+#define MODEL_FIELD(field) (offsetof(AmiiboModelInfo, field) | sizeof(((AmiiboModelInfo *) 0)->field) << 8)
+
+/* Binary dumps carry no header, so the UID falls back to the one in block 0 */
+static uint64_t mfc_uid(const void *data, const void *header, const unsigned int arg) {
+    (void) arg;
+    const MfcMetadataHeader *metadata = header;
+    static const uint8_t none[3] = {0};
+    if (memcmp(metadata->uid + 4, none, 3) != 0) {
+        return read_be(metadata->uid, 7);
+    }
+    const uint64_t uid = read_be(metadata->uid, 4);
+    return uid ? uid : read_be(((const Mfc1kData *) data)->manufacturer_data_4b.nuid, 4);
+}
+
+static uint64_t mfc_atqa(const void *data, const void *header, const unsigned int arg) {
+    (void) data;
+    (void) arg;
+    return read_be(((const MfcMetadataHeader *) header)->atqa, 2);
+}
+
+static uint64_t mfc_sak(const void *data, const void *header, const unsigned int arg) {
+    (void) data;
+    (void) arg;
+    return ((const MfcMetadataHeader *) header)->sak;
+}
+
+static uint64_t mfc_key_a(const void *data, const void *header, const unsigned int arg) {
+    (void) header;
+    return read_be(((const Mfc1kData *) data)->structure.sector[arg].sector_trailer.key_a, 6);
+}
+
+static uint64_t mfc_key_b(const void *data, const void *header, const unsigned int arg) {
+    (void) header;
+    return read_be(((const Mfc1kData *) data)->structure.sector[arg].sector_trailer.key_b, 6);
+}
+
+static const ColumnDef ntag_columns[] = {
+    {"uid", ntag_uid, 0},
+    {"version", ntag_version, 0},
+    {"character_id", amiibo_model, MODEL_FIELD(character_id)},
+    {"variation", amiibo_model, MODEL_FIELD(variation)},
+    {"form", amiibo_model, MODEL_FIELD(form)},
+    {"amiibo_id", amiibo_model, MODEL_FIELD(amiibo_id)},
+    {"set", amiibo_model, MODEL_FIELD(set)},
+};
+
+#define MFC_SECTOR_KEYS(n) {"key_a" #n, mfc_key_a, n}, {"key_b" #n, mfc_key_b, n}
+
+static const ColumnDef mfc_columns[] = {
+    {"uid", mfc_uid, 0},
+    {"atqa", mfc_atqa, 0},
+    {"sak", mfc_sak, 0},
+    MFC_SECTOR_KEYS(0), MFC_SECTOR_KEYS(1), MFC_SECTOR_KEYS(2), MFC_SECTOR_KEYS(3),
+    MFC_SECTOR_KEYS(4), MFC_SECTOR_KEYS(5), MFC_SECTOR_KEYS(6), MFC_SECTOR_KEYS(7),
+    MFC_SECTOR_KEYS(8), MFC_SECTOR_KEYS(9), MFC_SECTOR_KEYS(10), MFC_SECTOR_KEYS(11),
+    MFC_SECTOR_KEYS(12), MFC_SECTOR_KEYS(13), MFC_SECTOR_KEYS(14), MFC_SECTOR_KEYS(15),
+};
+
+_Static_assert(sizeof(mfc_columns) / sizeof(mfc_columns[0]) <= RFIDX_COLUMNS_MAX, "Too many columns");
+
+static const ColumnDef *columns_layout(const TagType tag_type, size_t *count) {
+    switch (tag_type) {
+        case NTAG_215:
+        case AMIIBO:
+            *count = sizeof(ntag_columns) / sizeof(ntag_columns[0]);
+            return ntag_columns;
+        case MFC_1K:
+            *count = sizeof(mfc_columns) / sizeof(mfc_columns[0]);
+            return mfc_columns;
+        default:
+            *count = 0;
+            return NULL;
+    }
+}
+
+static RfidxStatus columns_reserve(RfidxColumnStore *store, const size_t cap) {
+    for (size_t i = 0; i < store->column_count; i++) {
+        uint64_t *column = rfidx_realloc(store->columns[i], cap * sizeof(uint64_t));
+        if (!column) {
+            return RFIDX_MEMORY_ERROR;
+        }
+        store->columns[i] = column;
+    }
+
+    store->cap = cap;
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_columns_init(RfidxColumnStore *store, const TagType tag_type, const size_t capacity) {
+    memset(store, 0, sizeof(*store));
+    if (!columns_layout(tag_type, &store->column_count)) {
+        return RFIDX_UNKNOWN_ENUM_ERROR;
+    }
+    store->tag_type = tag_type;
+
+    if (capacity == 0) {
+        return RFIDX_OK;
+    }
+    const RfidxStatus status = columns_reserve(store, capacity);
+    if (status != RFIDX_OK) {
+        rfidx_columns_free(store);
+    }
+    return status;
+}
+
+RfidxStatus rfidx_columns_append(RfidxColumnStore *store, const void *data, const void *header) {
+    size_t column_count;
+    const ColumnDef *layout = columns_layout(store->tag_type, &column_count);
+    if (!layout) {
+        return RFIDX_UNKNOWN_ENUM_ERROR;
+    }
+
+    if (store->count == store->cap) {
+        const RfidxStatus status = columns_reserve(store, store->cap ? store->cap * 2 : 1024);
+        if (status != RFIDX_OK) {
+            return status;
+        }
+    }
+
+    for (size_t i = 0; i < column_count; i++) {
+        store->columns[i][store->count] = layout[i].extract(data, header, layout[i].arg);
+    }
+    store->count++;
+    return RFIDX_OK;
+}
+
+const uint64_t *rfidx_columns_find(const RfidxColumnStore *store, const char *name) {
+    size_t column_count;
+    const ColumnDef *layout = columns_layout(store->tag_type, &column_count);
+    for (size_t i = 0; layout && i < column_count; i++) {
+        if (strcmp(layout[i].name, name) == 0) {
+            // An empty store has nothing allocated, but the column still exists
+            static const uint64_t empty[1];
+            return store->columns[i] ? store->columns[i] : empty;
+        }
+    }
+
+    return NULL;
+}
+
+const char *rfidx_columns_name(const RfidxColumnStore *store, const size_t column) {
+    size_t column_count;
+    const ColumnDef *layout = columns_layout(store->tag_type, &column_count);
+    return layout && column < column_count ? layout[column].name : NULL;
+}
+
+void rfidx_columns_free(RfidxColumnStore *store) {
+    for (size_t i = 0; i < RFIDX_COLUMNS_MAX; i++) {
+        rfidx_free(store->columns[i]);
+    }
+    memset(store, 0, sizeof(*store));
+}
+
+/*
+ * The kernels only compute ==, < and >. The other comparisons are their complement, which
+ * rfidx_filter_column() applies to whole words.
+ */
+static bool compare_scalar(const uint64_t a, const RfidxCompareOp op, const uint64_t b) {
+    switch (op) {
+        case RFIDX_COMPARE_LT:
+            return a < b;
+        case RFIDX_COMPARE_GT:
+            return a > b;
+        default:
+            return a == b;
+    }
+}
+
+static uint64_t filter_word_scalar(const uint64_t *column, const size_t count, const RfidxCompareOp op,
+                                   const uint64_t value) {
+    uint64_t word = 0;
+    for (size_t i = 0; i < count; i++) {
+        word |= (uint64_t) compare_scalar(column[i], op, value) << i;
+    }
+    return word;
+}
+
+#ifdef RFIDX_COLUMNS_X86
+
+/*
+ * SSE2 has no 64-bit compare. Each 64-bit result is built from the 32-bit compares of its
+ * halves: equal if both halves are, greater if the high half is, or it ties and the low half
+ * is. Biasing every half by 0x80000000 turns the signed 32-bit compare into an unsigned one.
+ */
+static inline __m128i compare_sse2(const __m128i a, const RfidxCompareOp op, const __m128i b) {
+    const __m128i eq = _mm_cmpeq_epi32(a, b);
+    if (op == RFIDX_COMPARE_EQ) {
+        return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+
+    const __m128i bias = _mm_set1_epi32((int) 0x80000000U);
+    const __m128i ua = _mm_xor_si128(a, bias);
+    const __m128i ub = _mm_xor_si128(b, bias);
+    const __m128i gt = op == RFIDX_COMPARE_GT ? _mm_cmpgt_epi32(ua, ub) : _mm_cmpgt_epi32(ub, ua);
+    const __m128i high_gt = _mm_shuffle_epi32(gt, _MM_SHUFFLE(3, 3, 1, 1));
+    const __m128i high_eq = _mm_shuffle_epi32(eq, _MM_SHUFFLE(3, 3, 1, 1));
+    const __m128i low_gt = _mm_shuffle_epi32(gt, _MM_SHUFFLE(2, 2, 0, 0));
+    return _mm_or_si128(high_gt, _mm_and_si128(high_eq, low_gt));
+}
+
+static uint64_t filter_word_sse2(const uint64_t *column, const RfidxCompareOp op, const uint64_t value) {
+    const __m128i constant = _mm_set1_epi64x((long long) value);
+    uint64_t word = 0;
+    for (unsigned int i = 0; i < 64; i += 2) {
+        const __m128i values = _mm_loadu_si128((const __m128i *) (column + i));
+        const __m128i mask = compare_sse2(values, op, constant);
+        word |= (uint64_t) _mm_movemask_pd(_mm_castsi128_pd(mask)) << i;
+    }
+    return word;
+}
+
+/* AVX2 compares 64-bit lanes directly, signed, so both sides are biased by 2^63 instead */
+__attribute__((target("avx2")))
+static uint64_t filter_word_avx2(const uint64_t *column, const RfidxCompareOp op, const uint64_t value) {
+    const __m256i bias = _mm256_set1_epi64x((long long) 0x8000000000000000ULL);
+    const __m256i constant = _mm256_set1_epi64x((long long) value);
+    const __m256i biased_constant = _mm256_xor_si256(constant, bias);
+    uint64_t word = 0;
+    for (unsigned int i = 0; i < 64; i += 4) {
+        const __m256i values = _mm256_loadu_si256((const __m256i *) (column + i));
+        __m256i mask;
+        if (op == RFIDX_COMPARE_EQ) {
+            mask = _mm256_cmpeq_epi64(values, constant);
+        } else if (op == RFIDX_COMPARE_GT) {
+            mask = _mm256_cmpgt_epi64(_mm256_xor_si256(values, bias), biased_constant);
+        } else {
+            mask = _mm256_cmpgt_epi64(biased_constant, _mm256_xor_si256(values, bias));
+        }
+        word |= (uint64_t) _mm256_movemask_pd(_mm256_castsi256_pd(mask)) << i;
+    }
+    return word;
+}
+
+static bool columns_cpu_has_avx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif
+
+void rfidx_filter_column(
+    const uint64_t *column,
+    const size_t count,
+    const RfidxCompareOp op,
+    const uint64_t value,
+    uint64_t *bitmap
+) {
+    RfidxCompareOp kernel_op = op;
+    bool complement = false;
+    switch (op) {
+        case RFIDX_COMPARE_NE:
+            kernel_op = RFIDX_COMPARE_EQ;
+            complement = true;
+            break;
+        case RFIDX_COMPARE_LE:
+            kernel_op = RFIDX_COMPARE_GT;
+            complement = true;
+            break;
+        case RFIDX_COMPARE_GE:
+            kernel_op = RFIDX_COMPARE_LT;
+            complement = true;
+            break;
+        default:
+            break;
+    }
+
+    const size_t full_words = count / 64;
+#ifdef RFIDX_COLUMNS_X86
+    const bool avx2 = columns_cpu_has_avx2();
+#endif
+    for (size_t w = 0; w < full_words; w++) {
+        const uint64_t *values = column + w * 64;
+        uint64_t word;
+#ifdef RFIDX_COLUMNS_X86
+        word = avx2 ? filter_word_avx2(values, kernel_op, value) : filter_word_sse2(values, kernel_op, value);
+#else
+        word = filter_word_scalar(values, 64, kernel_op, value);
+#endif
+        bitmap[w] = complement ? ~word : word;
+    }
+
+    const size_t tail = count % 64;
+    if (tail) {
+        const uint64_t word = filter_word_scalar(column + full_words * 64, tail, kernel_op, value);
+        bitmap[full_words] = (complement ? ~word : word) & ((UINT64_C(1) << tail) - 1);
+    }
+}
+
+/**
+ * @brief State of a query being evaluated
+ *
+ * The expression is evaluated while it is parsed, every node into a bitmap of its own.
+ */
+typedef struct {
+    const RfidxColumnStore *store;
+    const char *p;
+    size_t words;
+    unsigned int depth;
+} Query;
+
+static void query_skip_space(Query *q) {
+    while (isspace((unsigned char) *q->p)) q->p++;
+}
+
+static bool query_accept(Query *q, const char *token) {
+    query_skip_space(q);
+    const size_t len = strlen(token);
+    if (strncmp(q->p, token, len) != 0) {
+        return false;
+    }
+    q->p += len;
+    return true;
+}
+
+static RfidxStatus query_or(Query *q, uint64_t *out);
+
+static RfidxStatus query_comparison(Query *q, uint64_t *out) {
+    query_skip_space(q);
+    char name[32];
+    size_t len = 0;
+    while (isalnum((unsigned char) q->p[len]) || q->p[len] == '_') {
+        if (len + 1 >= sizeof(name)) return RFIDX_QUERY_ERROR;
+        name[len] = q->p[len];
+        len++;
+    }
+    name[len] = '\0';
+    q->p += len;
+
+    const uint64_t *column = len ? rfidx_columns_find(q->store, name) : NULL;
+    if (!column) {
+        return RFIDX_QUERY_ERROR;
+    }
+
+    // Two character operators first, so that <= is not read as <
+    static const struct {
+        const char *token;
+        RfidxCompareOp op;
+    } operators[] = {
+        {"==", RFIDX_COMPARE_EQ}, {"!=", RFIDX_COMPARE_NE}, {"<=", RFIDX_COMPARE_LE},
+        {">=", RFIDX_COMPARE_GE}, {"<", RFIDX_COMPARE_LT}, {">", RFIDX_COMPARE_GT},
+    };
+    size_t found = sizeof(operators) / sizeof(operators[0]);
+    for (size_t i = 0; i < sizeof(operators) / sizeof(operators[0]); i++) {
+        if (query_accept(q, operators[i].token)) {
+            found = i;
+            break;
+        }
+    }
+    if (found == sizeof(operators) / sizeof(operators[0])) {
+        return RFIDX_QUERY_ERROR;
+    }
+
+    query_skip_space(q);
+    if (!isdigit((unsigned char) *q->p)) {
+        return RFIDX_QUERY_ERROR;
+    }
+    char *end = NULL;
+    errno = 0;
+    const unsigned long long value = strtoull(q->p, &end, 0);
+    if (errno == ERANGE || end == q->p) {
+        return RFIDX_QUERY_ERROR;
+    }
+    q->p = end;
+
+    rfidx_filter_column(column, q->store->count, operators[found].op, (uint64_t) value, out);
+    return RFIDX_OK;
+}
+
+static RfidxStatus query_unary(Query *q, uint64_t *out) {
+    if (++q->depth > QUERY_MAX_DEPTH) {
+        return RFIDX_QUERY_ERROR;
+    }
+
+    RfidxStatus status;
+    if (query_accept(q, "!")) {
+        status = query_unary(q, out);
+        if (status == RFIDX_OK) {
+            for (size_t i = 0; i < q->words; i++) out[i] = ~out[i];
+            // Keep the bits past the last dump clear
+            if (q->store->count % 64) {
+                out[q->words - 1] &= (UINT64_C(1) << q->store->count % 64) - 1;
+            }
+        }
+    } else if (query_accept(q, "(")) {
+        status = query_or(q, out);
+        if (status == RFIDX_OK && !query_accept(q, ")")) {
+            status = RFIDX_QUERY_ERROR;
+        }
+    } else {
+        status = query_comparison(q, out);
+    }
+
+    q->depth--;
+    return status;
+}
+
+static RfidxStatus query_and(Query *q, uint64_t *out) {
+    RfidxStatus status = query_unary(q, out);
+    uint64_t *right = NULL;
+    while (status == RFIDX_OK && query_accept(q, "&&")) {
+        if (!right) {
+            right = rfidx_malloc(q->words * sizeof(uint64_t) + 1);
+            if (!right) {
+                status = RFIDX_MEMORY_ERROR;
+                break;
+            }
+        }
+        status = query_unary(q, right);
+        for (size_t i = 0; status == RFIDX_OK && i < q->words; i++) out[i] &= right[i];
+    }
+
+    rfidx_free(right);
+    return status;
+}
+
+static RfidxStatus query_or(Query *q, uint64_t *out) {
+    RfidxStatus status = query_and(q, out);
+    uint64_t *right = NULL;
+    while (status == RFIDX_OK && query_accept(q, "||")) {
+        if (!right) {
+            right = rfidx_malloc(q->words * sizeof(uint64_t) + 1);
+            if (!right) {
+                status = RFIDX_MEMORY_ERROR;
+                break;
+            }
+        }
+        status = query_and(q, right);
+        for (size_t i = 0; status == RFIDX_OK && i < q->words; i++) out[i] |= right[i];
+    }
+
+    rfidx_free(right);
+    return status;
+}
+
+RfidxStatus rfidx_query(
+    const RfidxColumnStore *store,
+    const char *expression,
+    uint64_t **bitmap,
+    size_t *matches
+) {
+    *bitmap = NULL;
+    if (matches) *matches = 0;
+    if (!expression) {
+        return RFIDX_QUERY_ERROR;
+    }
+
+    Query q = {store, expression, (store->count + 63) / 64, 0};
+    // One spare byte, so that an empty store still gets a bitmap to return
+    uint64_t *result = rfidx_malloc(q.words * sizeof(uint64_t) + 1);
+    if (!result) {
+        return RFIDX_MEMORY_ERROR;
+    }
+
+    RfidxStatus status = query_or(&q, result);
+    query_skip_space(&q);
+    if (status == RFIDX_OK && *q.p != '\0') {
+        status = RFIDX_QUERY_ERROR;
+    }
+    if (status != RFIDX_OK) {
+        rfidx_free(result);
+        return status;
+    }
+
+    if (matches) {
+        for (size_t i = 0; i < q.words; i++) {
+            for (uint64_t word = result[i]; word; word &= word - 1) (*matches)++;
+        }
+    }
+    *bitmap = result;
+    return RFIDX_OK;
+}
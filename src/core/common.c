@@ -15,43 +15,13 @@
 #include <ctype.h>
 #include "librfidx/common.h"
 
-mbedtls_ctr_drbg_context rfidx_ctr_drbg;
-mbedtls_entropy_context rfidx_entropy;
-bool rfidx_rng_initialized = false;
-
-RfidxStatus hex_to_bytes(const char *hex, uint8_t *out, const size_t len) {
-    if (!hex || !out) {
-        return RFIDX_NUMERICAL_OPERATION_FAILED;
-    }
-
-    for (size_t i = 0; i < len; i++) {
-        if (sscanf(hex + 2 * i, "%2hhx", &out[i]) != 1) {
-            return RFIDX_NUMERICAL_OPERATION_FAILED;
-        }
-    }
-
-    return RFIDX_OK;
-}
-
-RfidxStatus bytes_to_hex(const uint8_t *bytes, const size_t len, char *out) {
-    if (!bytes || !out) {
-        return RFIDX_NUMERICAL_OPERATION_FAILED;
-    }
-
-    for (size_t i = 0; i < len; i++) {
-        if (sprintf(out + i * 2, "%02X", bytes[i]) < 0) {
-            return RFIDX_NUMERICAL_OPERATION_FAILED;
-        }
-    }
-
-    return RFIDX_OK;
-}
+RfidxContext rfidx_default_context = {0};
 
 char *remove_whitespace(const char *str) {
     if (!str) return NULL;
 
     const size_t len = strlen(str);
-    char *result = malloc(len + 1);
+    char *result = rfidx_malloc(len + 1);
     if (!result) return NULL;
 
     const char *read = str;
@@ -91,6 +61,32 @@ FileFormat string_to_file_format(const char *str) {
     return FORMAT_UNKNOWN;
 }
 
+bool str_to_uint(const char *str, const size_t len, const unsigned int base, uint32_t *out) {
+    *out = 0;
+
+    size_t i = 0;
+    for (; i < len; i++) {
+        unsigned int digit;
+        const char c = str[i];
+        if (c >= '0' && c <= '9') {
+            digit = (unsigned int) (c - '0');
+        } else if (c >= 'a' && c <= 'z') {
+            digit = (unsigned int) (c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'Z') {
+            digit = (unsigned int) (c - 'A' + 10);
+        } else {
+            break;
+        }
+
+        if (digit >= base) break;
+        // A number that does not fit is rejected rather than wrapped to a small, valid-looking one
+        if (*out > (UINT32_MAX - digit) / base) return false;
+        *out = *out * base + digit;
+    }
+
+    return i > 0;
+}
+
 void uint_to_str(unsigned int val, char *out, const size_t out_size) {
     if (out_size == 0) return;
 
@@ -122,7 +118,7 @@ int appendf(char **buf, size_t *len, size_t *cap, const char *fmt, ...) {
         }
 
         const size_t new_cap = (*cap + needed + 1) * 2;
-        char *new_buf = realloc(*buf, new_cap);
+        char *new_buf = rfidx_realloc(*buf, new_cap);
         if (!new_buf) return -1;
 
         *buf = new_buf;
@@ -130,21 +126,116 @@ int appendf(char **buf, size_t *len, size_t *cap, const char *fmt, ...) {
     }
 }
 
-int rfidx_init_rng(
+void text_writer_init(TextWriter *writer, char *buf, const size_t cap) {
+    writer->buf = buf;
+    writer->cap = buf ? cap : 0;
+    writer->len = 0;
+}
+
+char *text_writer_reserve(TextWriter *writer, const size_t n) {
+    char *dst = NULL;
+    if (writer->buf && writer->len + n <= writer->cap) {
+        dst = writer->buf + writer->len;
+    }
+
+    writer->len += n;
+    return dst;
+}
+
+void text_writer_append(TextWriter *writer, const char *str, const size_t len) {
+    char *dst = text_writer_reserve(writer, len);
+    if (dst) memcpy(dst, str, len);
+}
+
+void text_writer_uint(TextWriter *writer, unsigned int value) {
+    char digits[12];
+    char *p = digits + sizeof(digits);
+    do {
+        *--p = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    text_writer_append(writer, p, (size_t) (digits + sizeof(digits) - p));
+}
+
+void text_writer_hex_spaced(TextWriter *writer, const uint8_t *bytes, const size_t len) {
+    static const char digits[] = "0123456789ABCDEF";
+    char *dst = text_writer_reserve(writer, 3 * len);
+    if (!dst) return;
+
+    for (size_t i = 0; i < len; i++) {
+        dst[3 * i] = ' ';
+        dst[3 * i + 1] = digits[bytes[i] >> 4];
+        dst[3 * i + 2] = digits[bytes[i] & 0x0F];
+    }
+}
+
+bool text_writer_finish(TextWriter *writer) {
+    char *dst = text_writer_reserve(writer, 1);
+    if (dst) *dst = '\0';
+
+    return writer->buf && writer->len <= writer->cap;
+}
+
+void rfidx_context_init(RfidxContext *ctx) {
+    memset(ctx, 0, sizeof(RfidxContext));
+}
+
+void rfidx_context_free(RfidxContext *ctx) {
+    rfidx_free_rng_ctx(ctx);
+    memset(ctx, 0, sizeof(RfidxContext));
+}
+
+static int rfidx_seed_ctx(
+    RfidxContext *ctx,
+    int (*entropy_func)(void *, unsigned char *, size_t),
+    void *entropy_param
+) {
+    const char *personalization = "rfidx_rng";
+    const int ret = mbedtls_ctr_drbg_seed(&ctx->ctr_drbg,
+                                          entropy_func,
+                                          entropy_param,
+                                          (const unsigned char *) personalization,
+                                          strlen(personalization)
+    );
+
+    if (ret == 0) {
+        ctx->rng_initialized = true;
+        ctx->pool_available = 0;
+    } else {
+        mbedtls_entropy_free(&ctx->entropy);
+        mbedtls_ctr_drbg_free(&ctx->ctr_drbg);
+    }
+
+    return ret;
+}
+
+static int rfidx_fixed_seed_entropy(void *param, unsigned char *output, const size_t len) {
+    // Repeat the seed for as many bytes as the DRBG asks for, on every (re)seed
+    const RfidxContext *ctx = param;
+    for (size_t i = 0; i < len; i++) {
+        output[i] = ctx->seed[i % ctx->seed_len];
+    }
+
+    return 0;
+}
+
+int rfidx_init_rng_ctx(
+    RfidxContext *ctx,
     const mbedtls_entropy_f_source_ptr custom_entropy_func,
     void *custom_entropy_param
 ) {
-    if (rfidx_rng_initialized) {
+    if (ctx->rng_initialized) {
         return 0; // Already initialized. DO NOT REINITIALIZE.
     }
 
-    const char *personalization = "rfidx_rng";
-    mbedtls_entropy_init(&rfidx_entropy);
-    mbedtls_ctr_drbg_init(&rfidx_ctr_drbg);
+    mbedtls_entropy_init(&ctx->entropy);
+    mbedtls_ctr_drbg_init(&ctx->ctr_drbg);
+    ctx->seed_len = 0;
 
     if (custom_entropy_func) {
         mbedtls_entropy_add_source(
-            &rfidx_entropy,
+            &ctx->entropy,
             custom_entropy_func,
             custom_entropy_param,
             32,
@@ -152,31 +243,89 @@ int rfidx_init_rng(
         );
     }
 
-    const int ret = mbedtls_ctr_drbg_seed(&rfidx_ctr_drbg,
-                                          mbedtls_entropy_func,
-                                          &rfidx_entropy,
-                                          (const unsigned char *) personalization,
-                                          strlen(personalization)
-    );
+    return rfidx_seed_ctx(ctx, mbedtls_entropy_func, &ctx->entropy);
+}
 
-    if (ret == 0) {
-        rfidx_rng_initialized = true;
-    } else {
-        mbedtls_entropy_free(&rfidx_entropy);
-        mbedtls_ctr_drbg_free(&rfidx_ctr_drbg);
+int rfidx_init_rng_seeded_ctx(RfidxContext *ctx, const uint8_t *seed, const size_t seed_len) {
+    if (ctx->rng_initialized) {
+        return 0;
     }
 
-    return ret;
+    if (!seed || seed_len == 0 || seed_len > RFIDX_RANDOM_SEED_MAX_LEN) {
+        return MBEDTLS_ERR_CTR_DRBG_ENTROPY_SOURCE_FAILED;
+    }
+
+    mbedtls_entropy_init(&ctx->entropy);
+    mbedtls_ctr_drbg_init(&ctx->ctr_drbg);
+    memcpy(ctx->seed, seed, seed_len);
+    ctx->seed_len = seed_len;
+
+    return rfidx_seed_ctx(ctx, rfidx_fixed_seed_entropy, ctx);
 }
 
-int rfidx_free_rng(void) {
-    if (!rfidx_rng_initialized) {
+int rfidx_free_rng_ctx(RfidxContext *ctx) {
+    if (!ctx->rng_initialized) {
         return RFIDX_DRNG_ERROR;
     }
 
-    mbedtls_entropy_free(&rfidx_entropy);
-    mbedtls_ctr_drbg_free(&rfidx_ctr_drbg);
-    rfidx_rng_initialized = false;
+    mbedtls_entropy_free(&ctx->entropy);
+    mbedtls_ctr_drbg_free(&ctx->ctr_drbg);
+    memset(ctx->seed, 0, sizeof(ctx->seed));
+    memset(ctx->pool, 0, sizeof(ctx->pool));
+    ctx->seed_len = 0;
+    ctx->pool_available = 0;
+    ctx->rng_initialized = false;
 
     return RFIDX_OK;
-}
\ No newline at end of file
+}
+
+static RfidxStatus rfidx_refill_pool(RfidxContext *ctx) {
+    // A single DRBG request is capped, so fill the pool in the largest chunks allowed
+    for (size_t offset = 0; offset < RFIDX_RANDOM_POOL_SIZE; offset += RFIDX_RANDOM_POOL_CHUNK) {
+        if (mbedtls_ctr_drbg_random(&ctx->ctr_drbg, ctx->pool + offset, RFIDX_RANDOM_POOL_CHUNK) != 0) {
+            ctx->pool_available = 0;
+            return RFIDX_DRNG_ERROR;
+        }
+    }
+
+    ctx->pool_available = RFIDX_RANDOM_POOL_SIZE;
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_random_ctx(RfidxContext *ctx, uint8_t *output, size_t len) {
+    if (!ctx->rng_initialized) {
+        return RFIDX_DRNG_ERROR;
+    }
+
+    while (len > 0) {
+        if (ctx->pool_available == 0) {
+            const RfidxStatus status = rfidx_refill_pool(ctx);
+            if (status != RFIDX_OK) {
+                return status;
+            }
+        }
+
+        const size_t offset = RFIDX_RANDOM_POOL_SIZE - ctx->pool_available;
+        const size_t count = len < ctx->pool_available ? len : ctx->pool_available;
+        memcpy(output, ctx->pool + offset, count);
+        // Bytes that have been handed out must not stay readable in the pool
+        memset(ctx->pool + offset, 0, count);
+
+        ctx->pool_available -= count;
+        output += count;
+        len -= count;
+    }
+
+    return RFIDX_OK;
+}
+
+int rfidx_init_rng(
+    const mbedtls_entropy_f_source_ptr custom_entropy_func,
+    void *custom_entropy_param
+) {
+    return rfidx_init_rng_ctx(&rfidx_default_context, custom_entropy_func, custom_entropy_param);
+}
+
+int rfidx_free_rng(void) {
+    return rfidx_free_rng_ctx(&rfidx_default_context);
+}
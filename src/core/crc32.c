@@ -0,0 +1,36 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "librfidx/common.h"
+
+/*
+ * Reflected polynomial 0xEDB88320, a nibble at a time. The 16 entry table stays in a
+ * single cache line, which suits embedded targets better than the usual 1 KiB one.
+ */
+static const uint32_t crc32_nibble_table[16] = {
+    0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU,
+    0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+    0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU,
+    0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU,
+};
+
+uint32_t rfidx_crc32(uint32_t crc, const void *data, const size_t len) {
+    const uint8_t *bytes = data;
+
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= bytes[i];
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+    }
+
+    return ~crc;
+}
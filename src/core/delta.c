@@ -0,0 +1,376 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdbool.h>
+#include <string.h>
+#include "librfidx/delta.h"
+#include "librfidx/ntag/ntag215_core.h"
+#include "librfidx/mifare/mifare_classic_1k_core.h"
+#include "layout.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__) && defined(__GNUC__)
+#define RFIDX_DELTA_X86 1
+#include <immintrin.h>
+#endif
+
+/* Offsets of the fields in the delta header */
+#define DELTA_VERSION_OFFSET 8
+#define DELTA_TAG_TYPE_OFFSET 10
+#define DELTA_UNIT_SIZE_OFFSET 12
+#define DELTA_CHANGED_OFFSET 14
+#define DELTA_BASE_CRC_OFFSET 16
+#define DELTA_RESULT_CRC_OFFSET 20
+
+/**
+ * @brief Largest dump a delta applies to, a Mifare Classic 1K
+ */
+#define DELTA_MAX_DATA_SIZE MFC_1K_TOTAL_BYTES
+
+/**
+ * @brief Words of the bitmap of changed units, enough for the 135 pages of an NTAG 215
+ */
+#define DELTA_MAX_WORDS 3
+
+static TagType delta_family(const TagType tag_type) {
+    return tag_type == AMIIBO ? NTAG_215 : tag_type;
+}
+
+static void delta_diff_scalar(const uint8_t *base, const uint8_t *target, size_t pos, const size_t size,
+                              const size_t unit_size, uint64_t *changed) {
+    for (; pos < size; pos += unit_size) {
+        if (memcmp(base + pos, target + pos, unit_size) != 0) {
+            const size_t unit = pos / unit_size;
+            changed[unit / 64] |= UINT64_C(1) << (unit % 64);
+        }
+    }
+}
+
+#ifdef RFIDX_DELTA_X86
+
+/*
+ * The vector kernels compare a whole chunk at once and turn the byte mask of the chunk into
+ * one bit per unit. A chunk holds a whole number of units, and never more than 8, so the bits
+ * of a chunk never straddle two words of the bitmap.
+ */
+
+/* Fold a mask of differing bytes into one bit per 4-byte page, for up to 8 pages */
+static inline uint32_t delta_fold_pages(uint32_t mask) {
+    mask |= mask >> 1;
+    mask |= mask >> 2;
+    mask &= 0x11111111U;
+    mask = (mask | mask >> 3) & 0x03030303U;
+    mask = (mask | mask >> 6) & 0x000F000FU;
+    return (mask | mask >> 12) & 0xFFU;
+}
+
+static size_t delta_diff_sse2(const uint8_t *base, const uint8_t *target, size_t pos, const size_t size,
+                              const size_t unit_size, uint64_t *changed) {
+    for (; pos + 16 <= size; pos += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i *) (base + pos));
+        const __m128i b = _mm_loadu_si128((const __m128i *) (target + pos));
+        const uint32_t mask = ~(uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) & 0xFFFFU;
+        if (!mask) continue;
+
+        const uint32_t bits = unit_size == 16 ? 1 : delta_fold_pages(mask);
+        const size_t unit = pos / unit_size;
+        changed[unit / 64] |= (uint64_t) bits << (unit % 64);
+    }
+    return pos;
+}
+
+__attribute__((target("avx2")))
+static size_t delta_diff_avx2(const uint8_t *base, const uint8_t *target, size_t pos, const size_t size,
+                              const size_t unit_size, uint64_t *changed) {
+    for (; pos + 32 <= size; pos += 32) {
+        const __m256i a = _mm256_loadu_si256((const __m256i *) (base + pos));
+        const __m256i b = _mm256_loadu_si256((const __m256i *) (target + pos));
+        const uint32_t mask = ~(uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+        if (!mask) continue;
+
+        const uint32_t bits = unit_size == 16
+                                  ? (uint32_t) ((mask & 0xFFFFU) != 0) | (uint32_t) ((mask >> 16) != 0) << 1
+                                  : delta_fold_pages(mask);
+        const size_t unit = pos / unit_size;
+        changed[unit / 64] |= (uint64_t) bits << (unit % 64);
+    }
+    return pos;
+}
+
+static bool delta_cpu_has_avx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif
+
+size_t rfidx_delta_diff(
+    const uint8_t *base,
+    const uint8_t *target,
+    const size_t size,
+    const size_t unit_size,
+    uint64_t *changed
+) {
+    const size_t units = unit_size ? size / unit_size : 0;
+    memset(changed, 0, (units + 63) / 64 * sizeof(uint64_t));
+    if (!units) return 0;
+
+    size_t pos = 0;
+#ifdef RFIDX_DELTA_X86
+    if (unit_size == 4 || unit_size == 16) {
+        if (delta_cpu_has_avx2()) {
+            pos = delta_diff_avx2(base, target, pos, size, unit_size, changed);
+        }
+        pos = delta_diff_sse2(base, target, pos, size, unit_size, changed);
+    }
+#endif
+    delta_diff_scalar(base, target, pos, units * unit_size, unit_size, changed);
+
+    size_t count = 0;
+    for (size_t w = 0; w < (units + 63) / 64; w++) {
+        for (uint64_t word = changed[w]; word; word &= word - 1) count++;
+    }
+    return count;
+}
+
+/**
+ * @brief A delta checked against its own layout
+ */
+typedef struct {
+    TagType tag_type;
+    size_t data_size;
+    size_t unit_size;
+    size_t changed;                 /**< Number of changed units */
+    uint32_t base_crc;
+    uint32_t result_crc;
+    const uint8_t *units;           /**< The changed units, each after its index */
+} DeltaView;
+
+static RfidxStatus delta_parse(const uint8_t *delta, const size_t delta_len, DeltaView *view) {
+    if (!delta || delta_len < RFIDX_DELTA_HEADER_SIZE || memcmp(delta, RFIDX_DELTA_MAGIC, 8) != 0 ||
+        get_u16(delta + DELTA_VERSION_OFFSET) != RFIDX_DELTA_VERSION) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    view->tag_type = (TagType) get_u16(delta + DELTA_TAG_TYPE_OFFSET);
+    TagLayout layout;
+    if (tag_layout(view->tag_type, &layout) != RFIDX_OK ||
+        get_u16(delta + DELTA_UNIT_SIZE_OFFSET) != layout.unit_size) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    view->data_size = layout.data_size;
+    view->unit_size = layout.unit_size;
+    view->changed = get_u16(delta + DELTA_CHANGED_OFFSET);
+    view->base_crc = get_u32(delta + DELTA_BASE_CRC_OFFSET);
+    view->result_crc = get_u32(delta + DELTA_RESULT_CRC_OFFSET);
+    view->units = delta + RFIDX_DELTA_HEADER_SIZE;
+
+    const size_t entry_size = 2 + view->unit_size;
+    if (delta_len != RFIDX_DELTA_HEADER_SIZE + view->changed * entry_size) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    // Increasing indices rule out both repeated units and units past the end
+    const size_t units = view->data_size / view->unit_size;
+    for (size_t i = 0; i < view->changed; i++) {
+        const size_t index = get_u16(view->units + i * entry_size);
+        if (index >= units || (i && index <= get_u16(view->units + (i - 1) * entry_size))) {
+            return RFIDX_FILE_FORMAT_ERROR;
+        }
+    }
+
+    return RFIDX_OK;
+}
+
+static void delta_encode_header(uint8_t *out, const TagType tag_type, const size_t unit_size, const size_t changed,
+                                const uint32_t base_crc, const uint32_t result_crc) {
+    memset(out, 0, RFIDX_DELTA_HEADER_SIZE);
+    memcpy(out, RFIDX_DELTA_MAGIC, 8);
+    put_u16(out + DELTA_VERSION_OFFSET, RFIDX_DELTA_VERSION);
+    put_u16(out + DELTA_TAG_TYPE_OFFSET, (uint16_t) tag_type);
+    put_u16(out + DELTA_UNIT_SIZE_OFFSET, (uint16_t) unit_size);
+    put_u16(out + DELTA_CHANGED_OFFSET, (uint16_t) changed);
+    put_u32(out + DELTA_BASE_CRC_OFFSET, base_crc);
+    put_u32(out + DELTA_RESULT_CRC_OFFSET, result_crc);
+}
+
+RfidxStatus rfidx_delta_encode(
+    const TagType tag_type,
+    const void *base,
+    const void *target,
+    uint8_t **delta,
+    size_t *delta_len
+) {
+    if (!base || !target || !delta || !delta_len) {
+        return RFIDX_MEMORY_ERROR;
+    }
+    *delta = NULL;
+    *delta_len = 0;
+
+    TagLayout layout;
+    const RfidxStatus status = tag_layout(tag_type, &layout);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+    const size_t data_size = layout.data_size;
+    const size_t unit_size = layout.unit_size;
+
+    uint64_t changed[DELTA_MAX_WORDS];
+    const size_t count = rfidx_delta_diff(base, target, data_size, unit_size, changed);
+
+    const size_t entry_size = 2 + unit_size;
+    const size_t length = RFIDX_DELTA_HEADER_SIZE + count * entry_size;
+    uint8_t *out = rfidx_malloc(length);
+    if (!out) {
+        return RFIDX_MEMORY_ERROR;
+    }
+    delta_encode_header(out, tag_type, unit_size, count, rfidx_crc32(0, base, data_size),
+                        rfidx_crc32(0, target, data_size));
+
+    uint8_t *entry = out + RFIDX_DELTA_HEADER_SIZE;
+    for (size_t unit = 0; unit < data_size / unit_size; unit++) {
+        if (!(changed[unit / 64] >> (unit % 64) & 1)) continue;
+        put_u16(entry, (uint16_t) unit);
+        memcpy(entry + 2, (const uint8_t *) target + unit * unit_size, unit_size);
+        entry += entry_size;
+    }
+
+    *delta = out;
+    *delta_len = length;
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_delta_apply(
+    const TagType tag_type,
+    const void *base,
+    const uint8_t *delta,
+    const size_t delta_len,
+    void *out
+) {
+    if (!base || !out) {
+        return RFIDX_MEMORY_ERROR;
+    }
+
+    DeltaView view;
+    const RfidxStatus status = delta_parse(delta, delta_len, &view);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+    if (delta_family(view.tag_type) != delta_family(tag_type)) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    if (rfidx_crc32(0, base, view.data_size) != view.base_crc) {
+        return RFIDX_CHECKSUM_ERROR;
+    }
+
+    // Built aside, so out is left alone if the result turns out wrong
+    uint8_t result[DELTA_MAX_DATA_SIZE];
+    memcpy(result, base, view.data_size);
+    const size_t entry_size = 2 + view.unit_size;
+    for (size_t i = 0; i < view.changed; i++) {
+        const uint8_t *entry = view.units + i * entry_size;
+        memcpy(result + get_u16(entry) * view.unit_size, entry + 2, view.unit_size);
+    }
+    if (rfidx_crc32(0, result, view.data_size) != view.result_crc) {
+        return RFIDX_CHECKSUM_ERROR;
+    }
+
+    memcpy(out, result, view.data_size);
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_delta_apply_chain(
+    const TagType tag_type,
+    const void *base,
+    const uint8_t *const *deltas,
+    const size_t *delta_lens,
+    const size_t count,
+    void *out
+) {
+    TagLayout layout;
+    const RfidxStatus status = tag_layout(tag_type, &layout);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+    const size_t data_size = layout.data_size;
+    if (!base || !out || (count && (!deltas || !delta_lens))) {
+        return RFIDX_MEMORY_ERROR;
+    }
+
+    if (out != base) {
+        memmove(out, base, data_size);
+    }
+    for (size_t i = 0; i < count; i++) {
+        const RfidxStatus result = rfidx_delta_apply(tag_type, out, deltas[i], delta_lens[i], out);
+        if (result != RFIDX_OK) {
+            return result;
+        }
+    }
+
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_delta_compose(
+    const uint8_t *first,
+    const size_t first_len,
+    const uint8_t *second,
+    const size_t second_len,
+    uint8_t **delta,
+    size_t *delta_len
+) {
+    if (!delta || !delta_len) {
+        return RFIDX_MEMORY_ERROR;
+    }
+    *delta = NULL;
+    *delta_len = 0;
+
+    DeltaView a;
+    DeltaView b;
+    RfidxStatus status = delta_parse(first, first_len, &a);
+    if (status == RFIDX_OK) {
+        status = delta_parse(second, second_len, &b);
+    }
+    if (status != RFIDX_OK) {
+        return status;
+    }
+    if (delta_family(a.tag_type) != delta_family(b.tag_type)) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    if (b.base_crc != a.result_crc) {
+        return RFIDX_CHECKSUM_ERROR;
+    }
+
+    // Both lists are sorted, so merge them, the later content winning a unit both changed
+    const size_t entry_size = 2 + a.unit_size;
+    uint8_t *out = rfidx_malloc(RFIDX_DELTA_HEADER_SIZE + (a.changed + b.changed) * entry_size);
+    if (!out) {
+        return RFIDX_MEMORY_ERROR;
+    }
+    uint8_t *entry = out + RFIDX_DELTA_HEADER_SIZE;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a.changed || j < b.changed) {
+        const uint8_t *from_a = i < a.changed ? a.units + i * entry_size : NULL;
+        const uint8_t *from_b = j < b.changed ? b.units + j * entry_size : NULL;
+        const uint8_t *next;
+        if (!from_b || (from_a && get_u16(from_a) < get_u16(from_b))) {
+            next = from_a;
+            i++;
+        } else {
+            if (from_a && get_u16(from_a) == get_u16(from_b)) i++;
+            next = from_b;
+            j++;
+        }
+        memcpy(entry, next, entry_size);
+        entry += entry_size;
+    }
+
+    const size_t changed = (size_t) (entry - out - RFIDX_DELTA_HEADER_SIZE) / entry_size;
+    delta_encode_header(out, a.tag_type, a.unit_size, changed, a.base_crc, b.result_crc);
+    *delta = out;
+    *delta_len = RFIDX_DELTA_HEADER_SIZE + changed * entry_size;
+    return RFIDX_OK;
+}
@@ -0,0 +1,240 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "librfidx/detect.h"
+#include "librfidx/application/amiibo_core.h"
+#include "librfidx/mifare/mifare_classic_1k_core.h"
+
+/**
+ * @brief Bytes that amiibo_format_dump() sets, and every retail Amiibo carries
+ */
+static const struct {
+    size_t offset;              /**< Offset in the NTAG215 memory */
+    size_t len;                 /**< Number of bytes, all within one page */
+    uint8_t bytes[4];
+} amiibo_signature[] = {
+    {offsetof(AmiiboStructure, capability), 4, {0xF1, 0x10, 0xFF, 0xEE}},
+    {offsetof(AmiiboStructure, fixed_a5), 1, {0xA5}},
+    {offsetof(AmiiboStructure, dynamic_lock), 4, {0x01, 0x00, 0x0F, 0xBD}},
+    {offsetof(AmiiboStructure, configuration.cfg0), 4, {0x00, 0x00, 0x00, 0x04}},
+    {offsetof(AmiiboStructure, configuration.cfg1), 4, {0x5F, 0x00, 0x00, 0x00}},
+};
+
+/**
+ * @brief The number of leading signature entries that must be present in the prefix
+ *
+ * The capability container and the 0xA5 byte are in the first pages of every format.
+ * The last pages may fall outside the prefix of a text dump, and are then not checked.
+ */
+#define AMIIBO_SIGNATURE_REQUIRED 2
+
+static const char *detect_find(const char *start, const char *end, const char *needle) {
+    const size_t needle_len = strlen(needle);
+    while ((size_t) (end - start) >= needle_len) {
+        const char *hit = memchr(start, needle[0], (size_t) (end - start) - needle_len + 1);
+        if (!hit) return NULL;
+        if (memcmp(hit, needle, needle_len) == 0) return hit;
+        start = hit + 1;
+    }
+
+    return NULL;
+}
+
+static const char *detect_skip_spaces(const char *pos, const char *end) {
+    while (pos < end && (*pos == ' ' || *pos == '\t')) pos++;
+    return pos;
+}
+
+static const char *detect_line_end(const char *pos, const char *end) {
+    const char *newline = memchr(pos, '\n', (size_t) (end - pos));
+    return newline ? newline : end;
+}
+
+static void detect_page_key(char *key, const char *before, const uint32_t page, const char *after) {
+    char idx[12];
+    uint_to_str(page, idx, sizeof(idx));
+
+    // Callers size the key for the longest prefix and suffix they use
+    strcpy(key, before);
+    strcat(key, idx);
+    strcat(key, after);
+}
+
+/**
+ * @brief Find one NTAG215 page in a text dump
+ * @return true if the page is in the prefix and well-formed
+ */
+static bool detect_text_page(const char *start, const char *end, const FileFormat format, const uint32_t page,
+                             uint8_t out[NTAG215_PAGE_SIZE]) {
+    char key[24];
+    if (format == FORMAT_JSON) {
+        // Block keys live inside "blocks", after the "Card" object that reuses small numbers
+        const char *blocks = detect_find(start, end, "\"blocks\"");
+        if (!blocks) return false;
+        detect_page_key(key, "\"", page, "\"");
+        const char *hit = detect_find(blocks, end, key);
+        if (!hit) return false;
+
+        const char *pos = detect_skip_spaces(hit + strlen(key), end);
+        if (pos >= end || *pos != ':') return false;
+        pos = detect_skip_spaces(pos + 1, end);
+        if (pos >= end || *pos != '"') return false;
+        pos++;
+        const char *close = memchr(pos, '"', (size_t) (end - pos));
+        if (!close) return false;
+
+        return hex_span_to_bytes(pos, (size_t) (close - pos), out, NTAG215_PAGE_SIZE) == RFIDX_OK;
+    }
+
+    detect_page_key(key, "\nPage ", page, ":");
+    const char *hit = detect_find(start, end, key);
+    if (!hit) return false;
+
+    const char *pos = hit + strlen(key);
+    const char *line_end = detect_line_end(pos, end);
+    if (line_end == end) return false;
+
+    return hex_span_to_bytes(pos, (size_t) (line_end - pos), out, NTAG215_PAGE_SIZE) == RFIDX_OK;
+}
+
+static bool detect_amiibo_binary(const uint8_t *memory, const size_t available) {
+    for (size_t i = 0; i < sizeof(amiibo_signature) / sizeof(amiibo_signature[0]); i++) {
+        if (amiibo_signature[i].offset + amiibo_signature[i].len > available) {
+            if (i < AMIIBO_SIGNATURE_REQUIRED) return false;
+            continue;
+        }
+        if (memcmp(memory + amiibo_signature[i].offset, amiibo_signature[i].bytes, amiibo_signature[i].len) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool detect_amiibo_text(const char *start, const char *end, const FileFormat format) {
+    for (size_t i = 0; i < sizeof(amiibo_signature) / sizeof(amiibo_signature[0]); i++) {
+        uint8_t page[NTAG215_PAGE_SIZE];
+        const size_t offset = amiibo_signature[i].offset;
+        if (!detect_text_page(start, end, format, (uint32_t) (offset / NTAG215_PAGE_SIZE), page)) {
+            if (i < AMIIBO_SIGNATURE_REQUIRED) return false;
+            continue;
+        }
+        if (memcmp(page + offset % NTAG215_PAGE_SIZE, amiibo_signature[i].bytes, amiibo_signature[i].len) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool detect_value_equals(const char *value, const char *end, const char *expected) {
+    const size_t len = strlen(expected);
+    return (size_t) (end - value) >= len && memcmp(value, expected, len) == 0;
+}
+
+static TagType detect_json(const char *start, const char *end) {
+    const char *hit = detect_find(start, end, "\"FileType\"");
+    if (!hit) return TAG_UNKNOWN;
+
+    const char *pos = detect_skip_spaces(hit + strlen("\"FileType\""), end);
+    if (pos >= end || *pos != ':') return TAG_UNKNOWN;
+    pos = detect_skip_spaces(pos + 1, end);
+
+    if (detect_value_equals(pos, end, "\"mfu\"")) return NTAG_215;
+    if (detect_value_equals(pos, end, "\"mfc v2\"")) return MFC_1K;
+    return TAG_UNKNOWN;
+}
+
+static TagType detect_nfc(const char *start, const char *end) {
+    const char *hit = detect_find(start, end, "\nDevice type:");
+    if (!hit) return TAG_UNKNOWN;
+
+    const char *value = detect_skip_spaces(hit + strlen("\nDevice type:"), end);
+    const char *line_end = detect_line_end(value, end);
+    while (line_end > value && (line_end[-1] == '\r' || line_end[-1] == ' ')) line_end--;
+
+    if (detect_value_equals(value, line_end, "NTAG215") && line_end - value == 7) {
+        return NTAG_215;
+    }
+    if (detect_value_equals(value, line_end, "NTAG/Ultralight")) {
+        // Newer files name the exact chip on a separate line
+        const char *type = detect_find(line_end, end, "\nNTAG/Ultralight type:");
+        if (!type) return TAG_UNKNOWN;
+        type = detect_skip_spaces(type + strlen("\nNTAG/Ultralight type:"), end);
+        return detect_value_equals(type, end, "NTAG215") ? NTAG_215 : TAG_UNKNOWN;
+    }
+    if (detect_value_equals(value, line_end, "Mifare Classic")) {
+        const char *type = detect_find(line_end, end, "\nMifare Classic type:");
+        if (!type) return MFC_1K;
+        type = detect_skip_spaces(type + strlen("\nMifare Classic type:"), end);
+        return detect_value_equals(type, end, "1K") ? MFC_1K : TAG_UNKNOWN;
+    }
+
+    return TAG_UNKNOWN;
+}
+
+RfidxStatus rfidx_detect_tag(
+    const uint8_t *prefix,
+    size_t prefix_len,
+    const size_t size,
+    TagType *tag_type,
+    FileFormat *format
+) {
+    *tag_type = TAG_UNKNOWN;
+    *format = FORMAT_UNKNOWN;
+    if (prefix_len > size) prefix_len = size;
+
+    const char *start = (const char *) prefix;
+    const char *end = start + prefix_len;
+
+    // Text formats first: a binary dump never starts with either signature
+    const char *first = start;
+    while (first < end && (*first == ' ' || *first == '\t' || *first == '\r' || *first == '\n')) first++;
+
+    TagType detected = TAG_UNKNOWN;
+    FileFormat detected_format = FORMAT_UNKNOWN;
+    if (first < end && *first == '{') {
+        detected = detect_json(first, end);
+        detected_format = FORMAT_JSON;
+    } else if (detect_value_equals(first, end, "Filetype: Flipper NFC device")) {
+        detected = detect_nfc(first, end);
+        detected_format = FORMAT_NFC;
+    }
+
+    if (detected_format != FORMAT_UNKNOWN) {
+        if (detected == TAG_UNKNOWN) {
+            return RFIDX_FILE_FORMAT_ERROR;
+        }
+        if (detected == NTAG_215 && detect_amiibo_text(first, end, detected_format)) {
+            detected = AMIIBO;
+        }
+
+        *tag_type = detected;
+        *format = detected_format;
+        return RFIDX_OK;
+    }
+
+    if (size == sizeof(Ntag215Data) || size == sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data)) {
+        const size_t skip = size == sizeof(Ntag215Data) ? 0 : sizeof(Ntag21xMetadataHeader);
+        const size_t available = prefix_len > skip ? prefix_len - skip : 0;
+
+        *tag_type = detect_amiibo_binary(prefix + skip, available) ? AMIIBO : NTAG_215;
+        *format = FORMAT_BINARY;
+        return RFIDX_OK;
+    }
+    if (size == sizeof(Mfc1kData)) {
+        *tag_type = MFC_1K;
+        *format = FORMAT_BINARY;
+        return RFIDX_OK;
+    }
+
+    return RFIDX_FILE_FORMAT_ERROR;
+}
@@ -0,0 +1,276 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include "librfidx/common.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__) && defined(__GNUC__)
+#define RFIDX_HEX_X86 1
+#include <immintrin.h>
+#endif
+
+static const char hex_digits[16] = {
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+};
+
+/*
+ * Nibble value plus one for every valid hex character, 0 for everything else.
+ * The offset keeps the zero-initialised entries invalid.
+ */
+static const uint8_t hex_nibble_table[256] = {
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5,
+    ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+    ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+};
+
+static bool hex_decode_scalar(const char *hex, const size_t len, uint8_t *out) {
+    for (size_t i = 0; i < len; i++) {
+        const uint8_t hi = hex_nibble_table[(uint8_t) hex[2 * i]];
+        const uint8_t lo = hex_nibble_table[(uint8_t) hex[2 * i + 1]];
+        if (!hi || !lo) {
+            return false;
+        }
+        out[i] = (uint8_t) (((hi - 1) << 4) | (lo - 1));
+    }
+
+    return true;
+}
+
+static void hex_encode_scalar(const uint8_t *bytes, const size_t len, char *out) {
+    for (size_t i = 0; i < len; i++) {
+        out[2 * i] = hex_digits[bytes[i] >> 4];
+        out[2 * i + 1] = hex_digits[bytes[i] & 0x0F];
+    }
+}
+
+#ifdef RFIDX_HEX_X86
+
+/*
+ * Convert 16 ASCII characters into their nibble values. Returns a lane mask
+ * with every bit set if all characters were valid hex digits.
+ */
+static inline __m128i hex_nibbles_sse2(const __m128i chars, int *valid_mask) {
+    const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+    const __m128i is_digit = _mm_and_si128(
+        _mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)),
+        _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+    const __m128i is_alpha = _mm_and_si128(
+        _mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+        _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+    *valid_mask = _mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha));
+
+    return _mm_or_si128(
+        _mm_and_si128(is_digit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+        _mm_and_si128(is_alpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+}
+
+/* Fold pairs of nibbles (high nibble first) into 16-bit lanes holding one byte each */
+static inline __m128i hex_fold_pairs_sse2(const __m128i nibbles) {
+    return _mm_or_si128(
+        _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4),
+        _mm_srli_epi16(nibbles, 8));
+}
+
+static inline __m128i hex_ascii_sse2(const __m128i nibbles) {
+    const __m128i letters = _mm_and_si128(
+        _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)),
+        _mm_set1_epi8('A' - '0' - 10));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+static bool hex_decode_sse2(const char *hex, const size_t len, uint8_t *out) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        int mask_a;
+        int mask_b;
+        const __m128i a = hex_nibbles_sse2(_mm_loadu_si128((const __m128i *) (hex + 2 * i)), &mask_a);
+        const __m128i b = hex_nibbles_sse2(_mm_loadu_si128((const __m128i *) (hex + 2 * i + 16)), &mask_b);
+        if ((mask_a & mask_b) != 0xFFFF) {
+            return false;
+        }
+
+        _mm_storeu_si128((__m128i *) (out + i),
+                         _mm_packus_epi16(hex_fold_pairs_sse2(a), hex_fold_pairs_sse2(b)));
+    }
+
+    return hex_decode_scalar(hex + 2 * i, len - i, out + i);
+}
+
+static void hex_encode_sse2(const uint8_t *bytes, const size_t len, char *out) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *) (bytes + i));
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+        const __m128i lo = _mm_and_si128(v, _mm_set1_epi8(0x0F));
+
+        _mm_storeu_si128((__m128i *) (out + 2 * i), hex_ascii_sse2(_mm_unpacklo_epi8(hi, lo)));
+        _mm_storeu_si128((__m128i *) (out + 2 * i + 16), hex_ascii_sse2(_mm_unpackhi_epi8(hi, lo)));
+    }
+
+    hex_encode_scalar(bytes + i, len - i, out + 2 * i);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i hex_nibbles_avx2(const __m256i chars, uint32_t *valid_mask) {
+    const __m256i lower = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+    const __m256i is_digit = _mm256_and_si256(
+        _mm256_cmpgt_epi8(chars, _mm256_set1_epi8('0' - 1)),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chars));
+    const __m256i is_alpha = _mm256_and_si256(
+        _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+
+    *valid_mask = (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(is_digit, is_alpha));
+
+    return _mm256_or_si256(
+        _mm256_and_si256(is_digit, _mm256_sub_epi8(chars, _mm256_set1_epi8('0'))),
+        _mm256_and_si256(is_alpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i hex_fold_pairs_avx2(const __m256i nibbles) {
+    return _mm256_or_si256(
+        _mm256_slli_epi16(_mm256_and_si256(nibbles, _mm256_set1_epi16(0x00FF)), 4),
+        _mm256_srli_epi16(nibbles, 8));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i hex_ascii_avx2(const __m256i nibbles) {
+    const __m256i letters = _mm256_and_si256(
+        _mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9)),
+        _mm256_set1_epi8('A' - '0' - 10));
+    return _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), letters);
+}
+
+__attribute__((target("avx2")))
+static bool hex_decode_avx2(const char *hex, const size_t len, uint8_t *out) {
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        uint32_t mask_a;
+        uint32_t mask_b;
+        const __m256i a = hex_nibbles_avx2(_mm256_loadu_si256((const __m256i *) (hex + 2 * i)), &mask_a);
+        const __m256i b = hex_nibbles_avx2(_mm256_loadu_si256((const __m256i *) (hex + 2 * i + 32)), &mask_b);
+        if ((mask_a & mask_b) != 0xFFFFFFFFU) {
+            return false;
+        }
+
+        // packus works per 128-bit lane, restore the byte order afterwards
+        const __m256i packed = _mm256_packus_epi16(hex_fold_pairs_avx2(a), hex_fold_pairs_avx2(b));
+        _mm256_storeu_si256((__m256i *) (out + i), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+
+    return hex_decode_sse2(hex + 2 * i, len - i, out + i);
+}
+
+__attribute__((target("avx2")))
+static void hex_encode_avx2(const uint8_t *bytes, const size_t len, char *out) {
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        const __m256i v = _mm256_loadu_si256((const __m256i *) (bytes + i));
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+        const __m256i lo = _mm256_and_si256(v, _mm256_set1_epi8(0x0F));
+        const __m256i first = hex_ascii_avx2(_mm256_unpacklo_epi8(hi, lo));
+        const __m256i second = hex_ascii_avx2(_mm256_unpackhi_epi8(hi, lo));
+
+        // unpack interleaves per 128-bit lane, so stitch the lanes back in order
+        _mm256_storeu_si256((__m256i *) (out + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256((__m256i *) (out + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+
+    hex_encode_sse2(bytes + i, len - i, out + 2 * i);
+}
+
+static bool hex_cpu_has_avx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+
+#endif
+
+bool hex_decode(const char *hex, const size_t len, uint8_t *out) {
+#ifdef RFIDX_HEX_X86
+    if (len >= 32 && hex_cpu_has_avx2()) {
+        return hex_decode_avx2(hex, len, out);
+    }
+    if (len >= 16) {
+        return hex_decode_sse2(hex, len, out);
+    }
+#endif
+    return hex_decode_scalar(hex, len, out);
+}
+
+void hex_encode(const uint8_t *bytes, const size_t len, char *out) {
+#ifdef RFIDX_HEX_X86
+    if (len >= 32 && hex_cpu_has_avx2()) {
+        hex_encode_avx2(bytes, len, out);
+        return;
+    }
+    if (len >= 16) {
+        hex_encode_sse2(bytes, len, out);
+        return;
+    }
+#endif
+    hex_encode_scalar(bytes, len, out);
+}
+
+RfidxStatus hex_to_bytes(const char *hex, uint8_t *out, const size_t len) {
+    if (!hex || !out) {
+        return RFIDX_NUMERICAL_OPERATION_FAILED;
+    }
+
+    // The vector kernels read whole blocks, so make sure the string really is that long
+    if (strnlen(hex, 2 * len) != 2 * len) {
+        return RFIDX_NUMERICAL_OPERATION_FAILED;
+    }
+
+    return hex_decode(hex, len, out) ? RFIDX_OK : RFIDX_NUMERICAL_OPERATION_FAILED;
+}
+
+RfidxStatus hex_span_to_bytes(const char *src, const size_t src_len, uint8_t *out, const size_t len) {
+    if (!src || !out) {
+        return RFIDX_NUMERICAL_OPERATION_FAILED;
+    }
+
+    size_t pos = 0;
+    for (size_t i = 0; i < len; i++) {
+        uint8_t nibbles[2];
+        for (int n = 0; n < 2; n++) {
+            while (pos < src_len && isspace((unsigned char) src[pos])) {
+                pos++;
+            }
+            if (pos >= src_len) {
+                return RFIDX_NUMERICAL_OPERATION_FAILED;
+            }
+
+            const uint8_t value = hex_nibble_table[(uint8_t) src[pos++]];
+            if (!value) {
+                return RFIDX_NUMERICAL_OPERATION_FAILED;
+            }
+            nibbles[n] = (uint8_t) (value - 1);
+        }
+        out[i] = (uint8_t) ((nibbles[0] << 4) | nibbles[1]);
+    }
+
+    return RFIDX_OK;
+}
+
+RfidxStatus bytes_to_hex(const uint8_t *bytes, const size_t len, char *out) {
+    if (!bytes || !out) {
+        return RFIDX_NUMERICAL_OPERATION_FAILED;
+    }
+
+    hex_encode(bytes, len, out);
+    out[2 * len] = '\0';
+
+    return RFIDX_OK;
+}
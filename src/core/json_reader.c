@@ -0,0 +1,205 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+#include <ctype.h>
+#include "json_reader.h"
+
+static void json_reader_skip_whitespace(JsonReader *reader) {
+    // Same definition of whitespace as cJSON: every control character and space
+    while (reader->pos < reader->end && (unsigned char) *reader->pos <= 32) {
+        reader->pos++;
+    }
+}
+
+static bool json_reader_consume(JsonReader *reader, const char c) {
+    json_reader_skip_whitespace(reader);
+    if (reader->pos < reader->end && *reader->pos == c) {
+        reader->pos++;
+        return true;
+    }
+
+    return false;
+}
+
+static bool json_reader_literal(JsonReader *reader, const char *literal, const size_t len) {
+    if ((size_t) (reader->end - reader->pos) < len || memcmp(reader->pos, literal, len) != 0) {
+        return false;
+    }
+
+    reader->pos += len;
+    return true;
+}
+
+static size_t json_reader_digits(JsonReader *reader) {
+    const char *start = reader->pos;
+    while (reader->pos < reader->end && *reader->pos >= '0' && *reader->pos <= '9') {
+        reader->pos++;
+    }
+
+    return (size_t) (reader->pos - start);
+}
+
+static bool json_reader_number(JsonReader *reader) {
+    if (reader->pos < reader->end && *reader->pos == '-') reader->pos++;
+
+    const char *int_start = reader->pos;
+    const size_t int_digits = json_reader_digits(reader);
+    if (int_digits == 0 || (int_digits > 1 && *int_start == '0')) {
+        return false;
+    }
+
+    if (reader->pos < reader->end && *reader->pos == '.') {
+        reader->pos++;
+        if (json_reader_digits(reader) == 0) return false;
+    }
+
+    if (reader->pos < reader->end && (*reader->pos == 'e' || *reader->pos == 'E')) {
+        reader->pos++;
+        if (reader->pos < reader->end && (*reader->pos == '+' || *reader->pos == '-')) reader->pos++;
+        if (json_reader_digits(reader) == 0) return false;
+    }
+
+    return true;
+}
+
+static bool json_reader_skip_nested(JsonReader *reader, const int depth) {
+    if (depth > JSON_READER_MAX_DEPTH) {
+        return false;
+    }
+
+    json_reader_skip_whitespace(reader);
+    if (reader->pos >= reader->end) {
+        return false;
+    }
+
+    const char *str;
+    size_t len;
+
+    switch (*reader->pos) {
+        case '"':
+            return json_reader_string(reader, &str, &len);
+        case '{':
+            reader->pos++;
+            if (json_reader_consume(reader, '}')) return true;
+            do {
+                json_reader_skip_whitespace(reader);
+                if (!json_reader_string(reader, &str, &len) || !json_reader_consume(reader, ':')) {
+                    return false;
+                }
+                if (!json_reader_skip_nested(reader, depth + 1)) return false;
+            } while (json_reader_consume(reader, ','));
+            return json_reader_consume(reader, '}');
+        case '[':
+            reader->pos++;
+            if (json_reader_consume(reader, ']')) return true;
+            do {
+                if (!json_reader_skip_nested(reader, depth + 1)) return false;
+            } while (json_reader_consume(reader, ','));
+            return json_reader_consume(reader, ']');
+        case 't':
+            return json_reader_literal(reader, "true", 4);
+        case 'f':
+            return json_reader_literal(reader, "false", 5);
+        case 'n':
+            return json_reader_literal(reader, "null", 4);
+        default:
+            return json_reader_number(reader);
+    }
+}
+
+void json_reader_init(JsonReader *reader, const char *json, const size_t len) {
+    reader->pos = json;
+    reader->end = json + len;
+    reader->first = true;
+}
+
+bool json_reader_enter_object(JsonReader *reader) {
+    if (!json_reader_consume(reader, '{')) {
+        return false;
+    }
+
+    reader->first = true;
+    return true;
+}
+
+JsonReaderResult json_reader_next_member(JsonReader *reader, const char **key, size_t *key_len) {
+    json_reader_skip_whitespace(reader);
+
+    if (reader->first) {
+        if (json_reader_consume(reader, '}')) {
+            reader->first = false;
+            return JSON_READER_END;
+        }
+    } else {
+        if (json_reader_consume(reader, '}')) {
+            return JSON_READER_END;
+        }
+        if (!json_reader_consume(reader, ',')) {
+            return JSON_READER_FALLBACK;
+        }
+        json_reader_skip_whitespace(reader);
+    }
+
+    if (!json_reader_string(reader, key, key_len) || !json_reader_consume(reader, ':')) {
+        return JSON_READER_FALLBACK;
+    }
+    json_reader_skip_whitespace(reader);
+
+    // The enclosing object expects a comma after this member's value
+    reader->first = false;
+    return JSON_READER_MEMBER;
+}
+
+bool json_reader_string(JsonReader *reader, const char **str, size_t *len) {
+    json_reader_skip_whitespace(reader);
+    if (reader->pos >= reader->end || *reader->pos != '"') {
+        return false;
+    }
+
+    const char *start = reader->pos + 1;
+    const char *close = memchr(start, '"', (size_t) (reader->end - start));
+    if (!close || memchr(start, '\\', (size_t) (close - start))) {
+        return false;
+    }
+
+    *str = start;
+    *len = (size_t) (close - start);
+    reader->pos = close + 1;
+    return true;
+}
+
+bool json_reader_skip_value(JsonReader *reader) {
+    return json_reader_skip_nested(reader, 0);
+}
+
+bool json_key_equals(const char *key, const size_t key_len, const char *name) {
+    for (size_t i = 0; i < key_len; i++) {
+        if (name[i] == '\0' || tolower((unsigned char) key[i]) != tolower((unsigned char) name[i])) {
+            return false;
+        }
+    }
+
+    return name[key_len] == '\0';
+}
+
+bool json_key_index(const char *key, const size_t key_len, uint32_t *index) {
+    if (key_len == 0 || key_len > 9 || (key_len > 1 && key[0] == '0')) {
+        return false;
+    }
+
+    uint32_t value = 0;
+    for (size_t i = 0; i < key_len; i++) {
+        if (key[i] < '0' || key[i] > '9') return false;
+        value = value * 10 + (uint32_t) (key[i] - '0');
+    }
+
+    *index = value;
+    return true;
+}
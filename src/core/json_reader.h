@@ -0,0 +1,103 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Pull reader over JSON documents, shared by the JSON parsers of the tag formats. Internal
+ * to the library; not installed with the public headers.
+ */
+
+#ifndef LIBRFIDX_JSON_READER_H
+#define LIBRFIDX_JSON_READER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define JSON_READER_MAX_DEPTH 64
+
+/**
+ * @brief Pull reader over a JSON document held in memory
+ *
+ * The reader walks objects member by member without building a tree or allocating.
+ * It only accepts a strict subset of what cJSON accepts: strings with escape
+ * sequences, or nesting deeper than JSON_READER_MAX_DEPTH, make it give up. Callers
+ * treat any failure as "parse this document with cJSON instead", so the reader never
+ * has to reproduce cJSON's error reporting, only never accept what cJSON rejects.
+ */
+typedef struct {
+    const char *pos;            /**< Next character to read */
+    const char *end;            /**< End of the document */
+    bool first;                 /**< No member has been read from the current object yet */
+} JsonReader;
+
+/**
+ * @brief Result of advancing to the next member of an object
+ */
+typedef enum {
+    JSON_READER_MEMBER,         /**< A member was read, the reader is positioned at its value */
+    JSON_READER_END,            /**< The closing brace of the object was consumed */
+    JSON_READER_FALLBACK,       /**< Malformed or unsupported input */
+} JsonReaderResult;
+
+void json_reader_init(JsonReader *reader, const char *json, size_t len);
+
+/**
+ * @brief Consume the opening brace of an object value
+ * @param reader The reader.
+ * @return true if the next value is an object
+ */
+bool json_reader_enter_object(JsonReader *reader);
+
+/**
+ * @brief Advance to the next member of the object being read
+ * @param reader The reader.
+ * @param key Set to the start of the member name, which is not null-terminated.
+ * @param key_len Set to the length of the member name.
+ * @return Whether a member was read, the object ended, or the input is unsupported
+ */
+JsonReaderResult json_reader_next_member(JsonReader *reader, const char **key, size_t *key_len);
+
+/**
+ * @brief Read a string value
+ * @param reader The reader.
+ * @param str Set to the start of the string content, which is not null-terminated.
+ * @param len Set to the length of the string content.
+ * @return true if the next value is a string without escape sequences
+ */
+bool json_reader_string(JsonReader *reader, const char **str, size_t *len);
+
+/**
+ * @brief Validate and skip the next value, including nested objects and arrays
+ * @param reader The reader.
+ * @return true if the value is well-formed
+ */
+bool json_reader_skip_value(JsonReader *reader);
+
+/**
+ * @brief Compare a member name with a key the way cJSON_GetObjectItem does
+ * @param key Start of the member name.
+ * @param key_len Length of the member name.
+ * @param name Null-terminated key to compare with.
+ * @return true if they are equal ignoring case
+ */
+bool json_key_equals(const char *key, size_t key_len, const char *name);
+
+/**
+ * @brief Interpret a member name as a block or page index
+ *
+ * Only the canonical decimal form matches, the same as looking the index up by the
+ * string produced with uint_to_str(): "7" is index 7 but "07" and "+7" are not.
+ * @param key Start of the member name.
+ * @param key_len Length of the member name.
+ * @param index Set to the index.
+ * @return true if the name is a canonical decimal index
+ */
+bool json_key_index(const char *key, size_t key_len, uint32_t *index);
+
+#endif //LIBRFIDX_JSON_READER_H
@@ -0,0 +1,90 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+#include "librfidx/common.h"
+#include "json_writer.h"
+
+static void json_writer_char(JsonWriter *writer, const char c) {
+    char *dst = text_writer_reserve(&writer->out, 1);
+    if (dst) *dst = c;
+}
+
+static void json_writer_newline(JsonWriter *writer) {
+    char *dst = text_writer_reserve(&writer->out, 1 + (size_t) writer->depth);
+    if (dst) {
+        dst[0] = '\n';
+        memset(dst + 1, '\t', (size_t) writer->depth);
+    }
+}
+
+static void json_writer_key(JsonWriter *writer, const char *key, const size_t key_len) {
+    if (!writer->first) json_writer_char(writer, ',');
+    if (writer->format) json_writer_newline(writer);
+    writer->first = false;
+
+    json_writer_char(writer, '"');
+    text_writer_append(&writer->out, key, key_len);
+    text_writer_append(&writer->out, "\":\t", writer->format ? 3 : 2);
+}
+
+static void json_writer_hex_value(JsonWriter *writer, const uint8_t *bytes, const size_t len) {
+    json_writer_char(writer, '"');
+    char *dst = text_writer_reserve(&writer->out, 2 * len);
+    if (dst) hex_encode(bytes, len, dst);
+    json_writer_char(writer, '"');
+}
+
+void json_writer_init(JsonWriter *writer, char *buf, const size_t cap, const bool format) {
+    text_writer_init(&writer->out, buf, cap);
+    writer->depth = 0;
+    writer->format = format;
+    writer->first = true;
+}
+
+void json_writer_begin_object(JsonWriter *writer, const char *key) {
+    if (key) json_writer_key(writer, key, strlen(key));
+
+    json_writer_char(writer, '{');
+    writer->depth++;
+    writer->first = true;
+}
+
+void json_writer_end_object(JsonWriter *writer) {
+    writer->depth--;
+    if (writer->format) json_writer_newline(writer);
+    json_writer_char(writer, '}');
+
+    // The enclosing object now has at least this member
+    writer->first = false;
+}
+
+void json_writer_string(JsonWriter *writer, const char *key, const char *value) {
+    json_writer_key(writer, key, strlen(key));
+    json_writer_char(writer, '"');
+    text_writer_append(&writer->out, value, strlen(value));
+    json_writer_char(writer, '"');
+}
+
+void json_writer_hex(JsonWriter *writer, const char *key, const uint8_t *bytes, const size_t len) {
+    json_writer_key(writer, key, strlen(key));
+    json_writer_hex_value(writer, bytes, len);
+}
+
+void json_writer_hex_indexed(JsonWriter *writer, const unsigned int index, const uint8_t *bytes, const size_t len) {
+    char idx[12];
+    uint_to_str(index, idx, sizeof(idx));
+
+    json_writer_key(writer, idx, strlen(idx));
+    json_writer_hex_value(writer, bytes, len);
+}
+
+bool json_writer_finish(JsonWriter *writer) {
+    return text_writer_finish(&writer->out);
+}
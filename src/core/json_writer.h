@@ -0,0 +1,76 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Streaming JSON writer, shared by the JSON serializers of the tag formats. Internal
+ * to the library; not installed with the public headers.
+ */
+
+#ifndef LIBRFIDX_JSON_WRITER_H
+#define LIBRFIDX_JSON_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "librfidx/common.h"
+
+/**
+ * @brief Writer that emits JSON objects straight into a caller provided buffer
+ *
+ * The output is byte-identical to cJSON_Print (or cJSON_PrintUnformatted when format
+ * is false) for a tree built from the same calls. Keys and string values are written
+ * as they are, so they must not contain characters that need escaping.
+ *
+ * Output goes through a TextWriter, so running the same calls with a NULL buffer
+ * first gives the exact size to allocate.
+ */
+typedef struct {
+    TextWriter out;             /**< Output buffer */
+    int depth;                  /**< Nesting depth of the current object */
+    bool format;                /**< Indent with tabs and newlines like cJSON_Print */
+    bool first;                 /**< No member has been written to the current object yet */
+} JsonWriter;
+
+void json_writer_init(JsonWriter *writer, char *buf, size_t cap, bool format);
+
+/**
+ * @brief Open an object
+ * @param writer The writer.
+ * @param key Member name in the enclosing object, or NULL for the root object.
+ */
+void json_writer_begin_object(JsonWriter *writer, const char *key);
+void json_writer_end_object(JsonWriter *writer);
+void json_writer_string(JsonWriter *writer, const char *key, const char *value);
+
+/**
+ * @brief Write bytes as an upper case hex string member
+ * @param writer The writer.
+ * @param key Member name.
+ * @param bytes Bytes to encode.
+ * @param len Number of bytes.
+ */
+void json_writer_hex(JsonWriter *writer, const char *key, const uint8_t *bytes, size_t len);
+
+/**
+ * @brief Write bytes as an upper case hex string member named by a decimal index
+ * @param writer The writer.
+ * @param index Block or page index used as the member name.
+ * @param bytes Bytes to encode.
+ * @param len Number of bytes.
+ */
+void json_writer_hex_indexed(JsonWriter *writer, unsigned int index, const uint8_t *bytes, size_t len);
+
+/**
+ * @brief Terminate the output with a null character
+ * @param writer The writer.
+ * @return true if the whole output, including the terminator, fitted in the buffer
+ */
+bool json_writer_finish(JsonWriter *writer);
+
+#endif //LIBRFIDX_JSON_WRITER_H
@@ -0,0 +1,30 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "layout.h"
+#include "librfidx/ntag/ntag215_core.h"
+#include "librfidx/mifare/mifare_classic_1k_core.h"
+
+RfidxStatus tag_layout(const TagType tag_type, TagLayout *layout) {
+    switch (tag_type) {
+        case NTAG_215:
+        case AMIIBO:
+            layout->header_size = sizeof(Ntag21xMetadataHeader);
+            layout->data_size = sizeof(Ntag215Data);
+            layout->unit_size = NTAG215_PAGE_SIZE;
+            return RFIDX_OK;
+        case MFC_1K:
+            layout->header_size = sizeof(MfcMetadataHeader);
+            layout->data_size = sizeof(Mfc1kData);
+            layout->unit_size = MFC_1K_BLOCK_SIZE;
+            return RFIDX_OK;
+        default:
+            return RFIDX_UNKNOWN_ENUM_ERROR;
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Little-endian field codecs and the sizes of the stored tag structures, shared by the
+ * library's own file formats. Internal to the library; not installed with the public headers.
+ */
+
+#ifndef LIBRFIDX_LAYOUT_H
+#define LIBRFIDX_LAYOUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "librfidx/common.h"
+
+/**
+ * @brief Sizes of the structures stored for a tag type
+ */
+typedef struct {
+    size_t header_size;         /**< Size of the metadata header */
+    size_t data_size;           /**< Size of the tag data */
+    size_t unit_size;           /**< Size of a page or block of the tag data */
+} TagLayout;
+
+/**
+ * @brief Look up the layout of a tag type
+ *
+ * Amiibo dumps are NTAG 215 dumps, so they share a layout.
+ * @param tag_type The type of the tag.
+ * @param layout Set to the sizes of its structures.
+ * @return RFIDX_OK, or RFIDX_UNKNOWN_ENUM_ERROR for an unsupported tag type
+ */
+RfidxStatus tag_layout(TagType tag_type, TagLayout *layout);
+
+static inline void put_u16(uint8_t *p, const uint16_t v) {
+    p[0] = (uint8_t) v;
+    p[1] = (uint8_t) (v >> 8);
+}
+
+static inline void put_u32(uint8_t *p, const uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t) (v >> (8 * i));
+}
+
+static inline void put_u64(uint8_t *p, const uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (uint8_t) (v >> (8 * i));
+}
+
+static inline uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t) (p[0] | p[1] << 8);
+}
+
+static inline uint32_t get_u32(const uint8_t *p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; i--) v = v << 8 | p[i];
+    return v;
+}
+
+static inline uint64_t get_u64(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) v = v << 8 | p[i];
+    return v;
+}
+
+#endif //LIBRFIDX_LAYOUT_H
@@ -0,0 +1,169 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cJSON.h>
+#include "librfidx/common.h"
+
+#define RFIDX_ARENA_ALIGN _Alignof(max_align_t)
+#define RFIDX_ARENA_ROUND(n) (((n) + RFIDX_ARENA_ALIGN - 1) & ~(RFIDX_ARENA_ALIGN - 1))
+
+static void *rfidx_default_malloc(const size_t size, void *ctx) {
+    (void) ctx;
+    return malloc(size);
+}
+
+static void *rfidx_default_realloc(void *ptr, const size_t size, void *ctx) {
+    (void) ctx;
+    return realloc(ptr, size);
+}
+
+static void rfidx_default_free(void *ptr, void *ctx) {
+    (void) ctx;
+    free(ptr);
+}
+
+static struct {
+    rfidx_malloc_fn malloc_fn;
+    rfidx_realloc_fn realloc_fn;
+    rfidx_free_fn free_fn;
+    void *ctx;
+} rfidx_allocator = {
+    rfidx_default_malloc,
+    rfidx_default_realloc,
+    rfidx_default_free,
+    NULL,
+};
+
+// cJSON hooks carry no context, so they go through the global allocator
+static void *rfidx_cjson_malloc(const size_t size) {
+    return rfidx_malloc(size);
+}
+
+static void rfidx_cjson_free(void *ptr) {
+    rfidx_free(ptr);
+}
+
+void rfidx_set_allocator(
+    const rfidx_malloc_fn malloc_fn,
+    const rfidx_realloc_fn realloc_fn,
+    const rfidx_free_fn free_fn,
+    void *ctx
+) {
+    if (!malloc_fn || !realloc_fn || !free_fn) {
+        rfidx_allocator.malloc_fn = rfidx_default_malloc;
+        rfidx_allocator.realloc_fn = rfidx_default_realloc;
+        rfidx_allocator.free_fn = rfidx_default_free;
+        rfidx_allocator.ctx = NULL;
+        cJSON_InitHooks(NULL);
+        return;
+    }
+
+    rfidx_allocator.malloc_fn = malloc_fn;
+    rfidx_allocator.realloc_fn = realloc_fn;
+    rfidx_allocator.free_fn = free_fn;
+    rfidx_allocator.ctx = ctx;
+
+    cJSON_Hooks hooks = {
+        .malloc_fn = rfidx_cjson_malloc,
+        .free_fn = rfidx_cjson_free,
+    };
+    cJSON_InitHooks(&hooks);
+}
+
+void *rfidx_malloc(const size_t size) {
+    return rfidx_allocator.malloc_fn(size, rfidx_allocator.ctx);
+}
+
+void *rfidx_realloc(void *ptr, const size_t size) {
+    return rfidx_allocator.realloc_fn(ptr, size, rfidx_allocator.ctx);
+}
+
+void rfidx_free(void *ptr) {
+    rfidx_allocator.free_fn(ptr, rfidx_allocator.ctx);
+}
+
+void rfidx_arena_init(RfidxArena *arena, void *buffer, const size_t size) {
+    // Align the start, so every block handed out is aligned for any type
+    const uintptr_t start = (uintptr_t) buffer;
+    const size_t skip = RFIDX_ARENA_ROUND(start) - start;
+
+    arena->base = (uint8_t *) buffer + (skip < size ? skip : size);
+    arena->size = skip < size ? (size - skip) & ~(RFIDX_ARENA_ALIGN - 1) : 0;
+    arena->used = 0;
+    arena->last = SIZE_MAX;
+}
+
+void *rfidx_arena_alloc(RfidxArena *arena, const size_t size) {
+    // Each block is preceded by a header holding its size, which realloc needs
+    if (size > arena->size) {
+        return NULL;
+    }
+    const size_t block = RFIDX_ARENA_ALIGN + RFIDX_ARENA_ROUND(size);
+    if (block > arena->size - arena->used) {
+        return NULL;
+    }
+
+    uint8_t *header = arena->base + arena->used;
+    memcpy(header, &size, sizeof(size));
+    arena->last = arena->used;
+    arena->used += block;
+
+    return header + RFIDX_ARENA_ALIGN;
+}
+
+void rfidx_arena_reset(RfidxArena *arena) {
+    arena->used = 0;
+    arena->last = SIZE_MAX;
+}
+
+static void *rfidx_arena_malloc_cb(const size_t size, void *ctx) {
+    return rfidx_arena_alloc(ctx, size);
+}
+
+static void *rfidx_arena_realloc_cb(void *ptr, const size_t size, void *ctx) {
+    RfidxArena *arena = ctx;
+    if (!ptr) {
+        return rfidx_arena_alloc(arena, size);
+    }
+
+    uint8_t *header = (uint8_t *) ptr - RFIDX_ARENA_ALIGN;
+    size_t old_size;
+    memcpy(&old_size, header, sizeof(old_size));
+
+    // The most recent block can grow or shrink in place
+    const size_t offset = (size_t) (header - arena->base);
+    if (offset == arena->last && size <= arena->size - offset - RFIDX_ARENA_ALIGN) {
+        memcpy(header, &size, sizeof(size));
+        arena->used = offset + RFIDX_ARENA_ALIGN + RFIDX_ARENA_ROUND(size);
+        return ptr;
+    }
+
+    void *moved = rfidx_arena_alloc(arena, size);
+    if (moved) {
+        memcpy(moved, ptr, old_size < size ? old_size : size);
+    }
+    return moved;
+}
+
+static void rfidx_arena_free_cb(void *ptr, void *ctx) {
+    (void) ptr;
+    (void) ctx;
+}
+
+void rfidx_use_arena(RfidxArena *arena) {
+    if (!arena) {
+        rfidx_set_allocator(NULL, NULL, NULL, NULL);
+        return;
+    }
+
+    rfidx_set_allocator(rfidx_arena_malloc_cb, rfidx_arena_realloc_cb, rfidx_arena_free_cb, arena);
+}
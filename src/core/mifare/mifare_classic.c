@@ -70,7 +70,11 @@ RfidxStatus mfc_validate_manufacturer_data(const uint8_t *manufacturer_data) {
 }
 
 RfidxStatus mfc_randomize_uid(uint8_t *manufacturer_data) {
-    if (!rfidx_rng_initialized) {
+    return mfc_randomize_uid_ctx(&rfidx_default_context, manufacturer_data);
+}
+
+RfidxStatus mfc_randomize_uid_ctx(RfidxContext *ctx, uint8_t *manufacturer_data) {
+    if (!ctx->rng_initialized) {
         return RFIDX_DRNG_ERROR;
     }
 
@@ -79,17 +83,17 @@ RfidxStatus mfc_randomize_uid(uint8_t *manufacturer_data) {
     if (bcc == manufacturer_data[4]) {
         // 4-byte NUID
         uint8_t buffer[4];
-        const int ret = mbedtls_ctr_drbg_random(&rfidx_ctr_drbg, buffer, sizeof(buffer));
-        if (ret != 0) {
-            return RFIDX_DRNG_ERROR;
+        const RfidxStatus status = rfidx_random_ctx(ctx, buffer, sizeof(buffer));
+        if (status != RFIDX_OK) {
+            return status;
         }
         memcpy(manufacturer_data, buffer, sizeof(buffer));
     } else {
         // 7-byte UID
         uint8_t buffer[7];
-        const int ret = mbedtls_ctr_drbg_random(&rfidx_ctr_drbg, buffer, sizeof(buffer));
-        if (ret != 0) {
-            return RFIDX_DRNG_ERROR;
+        const RfidxStatus status = rfidx_random_ctx(ctx, buffer, sizeof(buffer));
+        if (status != RFIDX_OK) {
+            return status;
         }
         memcpy(manufacturer_data, buffer, sizeof(buffer));
     }
@@ -13,12 +13,19 @@
 #include <cJSON.h>
 #include "librfidx/common.h"
 #include "librfidx/mifare/mifare_classic_1k_core.h"
+#include "../json_reader.h"
+#include "../json_writer.h"
+#include "../nfc_reader.h"
 
 RfidxStatus mfc1k_parse_binary(
     const uint8_t *buffer,
     const size_t len,
     Mfc1kData *mfc1k,
     MfcMetadataHeader *header) {
+    if (len != sizeof(Mfc1kData)) {
+        return RFIDX_BINARY_FILE_SIZE_ERROR;
+    }
+
     memcpy(mfc1k, buffer, sizeof(Mfc1kData));
 
     // Headers are not present in binary dumps, but all bytes are known
@@ -35,11 +42,28 @@ RfidxStatus mfc1k_parse_binary(
     return RFIDX_OK;
 }
 
+RfidxStatus mfc1k_serialize_binary_into(
+    const Mfc1kData *mfc1k,
+    const MfcMetadataHeader *header,
+    uint8_t *out,
+    const size_t cap,
+    size_t *written
+) {
+    if (!out || cap < sizeof(Mfc1kData)) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+
+    memcpy(out, mfc1k, sizeof(Mfc1kData));
+    if (written) *written = sizeof(Mfc1kData);
+
+    return RFIDX_OK;
+}
+
 uint8_t *mfc1k_serialize_binary(const Mfc1kData *mfc1k, const MfcMetadataHeader *header) {
-    uint8_t *buffer = malloc(sizeof(Mfc1kData));
+    uint8_t *buffer = rfidx_malloc(sizeof(Mfc1kData));
     if (!buffer) return NULL;
 
-    memcpy(buffer, mfc1k, sizeof(Mfc1kData));
+    mfc1k_serialize_binary_into(mfc1k, header, buffer, sizeof(Mfc1kData), NULL);
     return buffer;
 }
 
@@ -109,7 +133,146 @@ RfidxStatus mfc1k_parse_data_from_json(const cJSON *blocks_obj, Mfc1kData *mfc1k
     return RFIDX_OK;
 }
 
+enum {
+    MFC1K_JSON_CARD_UID = 1 << 0,
+    MFC1K_JSON_CARD_ATQA = 1 << 1,
+    MFC1K_JSON_CARD_SAK = 1 << 2,
+    MFC1K_JSON_CARD_ALL = MFC1K_JSON_CARD_UID | MFC1K_JSON_CARD_ATQA | MFC1K_JSON_CARD_SAK,
+};
+
+static bool mfc1k_read_json_card(JsonReader *reader, MfcMetadataHeader *header) {
+    unsigned int seen = 0;
+    const char *key;
+    size_t key_len;
+    JsonReaderResult result;
+
+    while ((result = json_reader_next_member(reader, &key, &key_len)) == JSON_READER_MEMBER) {
+        unsigned int field = 0;
+        if (json_key_equals(key, key_len, "UID")) {
+            field = MFC1K_JSON_CARD_UID;
+        } else if (json_key_equals(key, key_len, "ATQA")) {
+            field = MFC1K_JSON_CARD_ATQA;
+        } else if (json_key_equals(key, key_len, "SAK")) {
+            field = MFC1K_JSON_CARD_SAK;
+        }
+
+        // cJSON_GetObjectItem returns the first match, so later duplicates are ignored
+        if (!field || (seen & field)) {
+            if (!json_reader_skip_value(reader)) return false;
+            continue;
+        }
+
+        const char *value;
+        size_t value_len;
+        if (!json_reader_string(reader, &value, &value_len)) {
+            return false;
+        }
+
+        bool ok;
+        if (field == MFC1K_JSON_CARD_UID) {
+            // 4-byte NUID or 7-byte UID, decided by the length of the string
+            if (value_len == 8) {
+                ok = hex_decode(value, 4, header->uid);
+                header->uid[4] = 0x00;
+                header->uid[5] = 0x00;
+                header->uid[6] = 0x00;
+            } else {
+                ok = value_len == 14 && hex_decode(value, 7, header->uid);
+            }
+        } else if (field == MFC1K_JSON_CARD_ATQA) {
+            ok = value_len >= 4 && hex_decode(value, 2, header->atqa);
+        } else {
+            ok = value_len >= 2 && hex_decode(value, 1, &header->sak);
+        }
+
+        if (!ok) return false;
+        seen |= field;
+    }
+
+    return result == JSON_READER_END && seen == MFC1K_JSON_CARD_ALL;
+}
+
+static bool mfc1k_read_json_blocks(JsonReader *reader, Mfc1kData *mfc1k) {
+    uint64_t seen = 0;
+    const char *key;
+    size_t key_len;
+    JsonReaderResult result;
+
+    _Static_assert(MFC_1K_NUM_SECTOR * MFC_1K_NUM_BLOCK_PER_SECTOR == 64, "One bit per block");
+
+    while ((result = json_reader_next_member(reader, &key, &key_len)) == JSON_READER_MEMBER) {
+        uint32_t block;
+        if (!json_key_index(key, key_len, &block) || block >= MFC_1K_NUM_SECTOR * MFC_1K_NUM_BLOCK_PER_SECTOR ||
+            (seen >> block) & 1) {
+            if (!json_reader_skip_value(reader)) return false;
+            continue;
+        }
+
+        const char *value;
+        size_t value_len;
+        uint8_t *dst = mfc1k->blocks[block / MFC_1K_NUM_BLOCK_PER_SECTOR][block % MFC_1K_NUM_BLOCK_PER_SECTOR];
+        if (!json_reader_string(reader, &value, &value_len) || value_len < 2 * MFC_1K_BLOCK_SIZE ||
+            !hex_decode(value, MFC_1K_BLOCK_SIZE, dst)) {
+            return false;
+        }
+        seen |= (uint64_t) 1 << block;
+    }
+
+    return result == JSON_READER_END && seen == UINT64_MAX;
+}
+
+/**
+ * @brief Parse a Proxmark3 "mfc v2" dump in one pass, without building a cJSON tree
+ *
+ * Like ntag215_read_json(), anything the reader does not accept is left to cJSON.
+ * @return true if the document was parsed
+ */
+static bool mfc1k_read_json(const char *json_str, Mfc1kData *mfc1k, MfcMetadataHeader *header) {
+    if (!json_str) {
+        return false;
+    }
+
+    Mfc1kData data = *mfc1k;
+    MfcMetadataHeader card = *header;
+    bool has_card = false;
+    bool has_blocks = false;
+
+    JsonReader reader;
+    json_reader_init(&reader, json_str, strlen(json_str));
+    if (!json_reader_enter_object(&reader)) {
+        return false;
+    }
+
+    const char *key;
+    size_t key_len;
+    JsonReaderResult result;
+    while ((result = json_reader_next_member(&reader, &key, &key_len)) == JSON_READER_MEMBER) {
+        if (!has_card && json_key_equals(key, key_len, "Card")) {
+            if (!json_reader_enter_object(&reader) || !mfc1k_read_json_card(&reader, &card)) return false;
+            has_card = true;
+        } else if (!has_blocks && json_key_equals(key, key_len, "blocks")) {
+            if (!json_reader_enter_object(&reader) || !mfc1k_read_json_blocks(&reader, &data)) return false;
+            has_blocks = true;
+        } else if (!json_reader_skip_value(&reader)) {
+            return false;
+        }
+    }
+
+    if (result != JSON_READER_END || !has_card || !has_blocks) {
+        return false;
+    }
+
+    *mfc1k = data;
+    *header = card;
+
+    return true;
+}
+
 RfidxStatus mfc1k_parse_json(const char *json_str, Mfc1kData *mfc1k, MfcMetadataHeader *header) {
+    if (mfc1k_read_json(json_str, mfc1k, header)) {
+        return RFIDX_OK;
+    }
+
     cJSON *root = cJSON_Parse(json_str);
     if (!root) {
         return RFIDX_JSON_PARSE_ERROR;
@@ -219,164 +382,281 @@ cJSON *mfc1k_dump_keys_to_json(const Mfc1kData *mfc1k) {
     return keys_obj;
 }
 
-char *mfc1k_serialize_json(const Mfc1kData *mfc1k, const MfcMetadataHeader *header) {
-    cJSON *root = cJSON_CreateObject();
-    cJSON_AddStringToObject(root, "Created", JSON_FORMAT_CREATOR);
-    cJSON_AddStringToObject(root, "FileType", "mfc v2");
+static void mfc1k_write_json(JsonWriter *writer, const Mfc1kData *mfc1k, const MfcMetadataHeader *header) {
+    json_writer_begin_object(writer, NULL);
+    json_writer_string(writer, "Created", JSON_FORMAT_CREATOR);
+    json_writer_string(writer, "FileType", "mfc v2");
 
-    cJSON_AddItemToObject(root, "Card", mfc1k_dump_header_to_json(header));
-    cJSON_AddItemToObject(root, "blocks", mfc1k_dump_data_to_json(mfc1k));
-    cJSON_AddItemToObject(root, "SectorKeys", mfc1k_dump_keys_to_json(mfc1k));
+    json_writer_begin_object(writer, "Card");
+    // Check the size of UID to determine if it's 4-byte NUID or 7-byte UID
+    if (header->uid[4] == 0x00 && header->uid[5] == 0x00 && header->uid[6] == 0x00) {
+        json_writer_hex(writer, "UID", header->uid, 4);
+    } else {
+        json_writer_hex(writer, "UID", header->uid, 7);
+    }
+    json_writer_hex(writer, "ATQA", header->atqa, 2);
+    json_writer_hex(writer, "SAK", &header->sak, 1);
+    json_writer_end_object(writer);
+
+    json_writer_begin_object(writer, "blocks");
+    for (unsigned int i = 0; i < MFC_1K_NUM_SECTOR; i++) {
+        for (unsigned int j = 0; j < MFC_1K_NUM_BLOCK_PER_SECTOR; j++) {
+            json_writer_hex_indexed(writer, i * MFC_1K_NUM_BLOCK_PER_SECTOR + j, mfc1k->blocks[i][j], MFC_1K_BLOCK_SIZE);
+        }
+    }
+    json_writer_end_object(writer);
 
-    char *output = cJSON_Print(root);
-    cJSON_Delete(root);
+    json_writer_begin_object(writer, "SectorKeys");
+    for (unsigned int i = 0; i < MFC_1K_NUM_SECTOR; i++) {
+        char idx[8];
+        uint_to_str(i, idx, sizeof(idx));
+        const MfcSectorTrailer *trailer = &mfc1k->structure.sector[i].sector_trailer;
+
+        // AccessConditions has always been written as the access bits followed by the user data byte twice
+        uint8_t access_conditions[5];
+        memcpy(access_conditions, trailer->access_bits, 3);
+        access_conditions[3] = trailer->user_data;
+        access_conditions[4] = trailer->user_data;
+
+        json_writer_begin_object(writer, idx);
+        json_writer_hex(writer, "KeyA", trailer->key_a, 6);
+        json_writer_hex(writer, "KeyB", trailer->key_b, 6);
+        json_writer_hex(writer, "AccessConditions", access_conditions, 5);
+        json_writer_end_object(writer);
+    }
+    json_writer_end_object(writer);
+
+    json_writer_end_object(writer);
+}
+
+static char *mfc1k_print_json(const Mfc1kData *mfc1k, const MfcMetadataHeader *header, const bool format) {
+    // Measure first, so the output is allocated once at its final size
+    JsonWriter writer;
+    json_writer_init(&writer, NULL, 0, format);
+    mfc1k_write_json(&writer, mfc1k, header);
+    json_writer_finish(&writer);
+
+    const size_t size = writer.out.len;
+    char *output = rfidx_malloc(size);
+    if (!output) return NULL;
+
+    json_writer_init(&writer, output, size, format);
+    mfc1k_write_json(&writer, mfc1k, header);
+    json_writer_finish(&writer);
 
     return output;
 }
 
-RfidxStatus mfc1k_parse_nfc(const char *nfc_str, Mfc1kData *mfc1k, MfcMetadataHeader *header) {
-    const char *start = nfc_str;
-    const char *end;
+RfidxStatus mfc1k_serialize_json_into(
+    const Mfc1kData *mfc1k,
+    const MfcMetadataHeader *header,
+    char *out,
+    const size_t cap,
+    size_t *written
+) {
+    JsonWriter writer;
+    json_writer_init(&writer, out, cap, true);
+    mfc1k_write_json(&writer, mfc1k, header);
+    if (!json_writer_finish(&writer)) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
 
-    while ((end = strchr(start, '\n')) != NULL) {
-        const size_t line_length = end - start;
-        char *line = malloc(line_length + 1);
-        if (!line) {
+    if (written) *written = writer.out.len - 1;
+    return RFIDX_OK;
+}
+
+char *mfc1k_serialize_json(const Mfc1kData *mfc1k, const MfcMetadataHeader *header) {
+    return mfc1k_print_json(mfc1k, header, true);
+}
+
+char *mfc1k_serialize_json_unformatted(const Mfc1kData *mfc1k, const MfcMetadataHeader *header) {
+    return mfc1k_print_json(mfc1k, header, false);
+}
+
+enum {
+    MFC1K_NFC_KEY_UID = 1,
+    MFC1K_NFC_KEY_ATQA,
+    MFC1K_NFC_KEY_SAK,
+};
+
+// Slots follow nfc_keyword_hash()
+static const NfcKeyword mfc1k_nfc_keywords[NFC_KEYWORD_TABLE_SIZE] = {
+    [0] = {"UID", 3, MFC1K_NFC_KEY_UID},
+    [7] = {"ATQA", 4, MFC1K_NFC_KEY_ATQA},
+    [12] = {"SAK", 3, MFC1K_NFC_KEY_SAK},
+};
+
+static RfidxStatus mfc1k_parse_nfc_uid(const NfcLine *line, MfcMetadataHeader *header) {
+    // Count the hex digits first to determine if it's 4-byte NUID or 7-byte UID
+    size_t uid_len = 0;
+    for (size_t i = 0; i < line->value_len && uid_len < 15; i++) {
+        if (!isspace((unsigned char) line->value[i])) uid_len++;
+    }
+
+    if (uid_len == 8) {
+        // 4-byte NUID
+        if (hex_span_to_bytes(line->value, line->value_len, header->uid, 4) != RFIDX_OK) {
             return RFIDX_NFC_PARSE_ERROR;
         }
-        strncpy(line, start, line_length);
-        line[line_length] = '\0';
-
-        if (line[0] != '#' && line[0] != '\0') {
-            char *sep = strchr(line, ':');
-            if (sep) {
-                *sep = '\0';
-                const char *key = line;
-                const char *val = sep + 1;
-                while (*val && isspace((unsigned char)*val)) val++;
-
-                char *clean = remove_whitespace(val);
-                if (!clean) {
-                    free(line);
-                    return RFIDX_NFC_PARSE_ERROR;
-                }
+        header->uid[4] = 0x00;
+        header->uid[5] = 0x00;
+        header->uid[6] = 0x00;
+    } else if (uid_len == 14) {
+        // 7-byte UID
+        if (hex_span_to_bytes(line->value, line->value_len, header->uid, 7) != RFIDX_OK) {
+            return RFIDX_NFC_PARSE_ERROR;
+        }
+    } else {
+        return RFIDX_NFC_PARSE_ERROR;
+    }
 
-                if (strncmp(key, "UID", 3) == 0) {
-                    // Check the length of the string first to determine if it's 4-byte NUID or 7-byte UID
-                    const size_t uid_len = strnlen(clean, 15);
-                    if (uid_len == 8) {
-                        // 4-byte NUID
-                        if (hex_to_bytes(clean, header->uid, 4) != RFIDX_OK) {
-                            free(line);
-                            return RFIDX_NFC_PARSE_ERROR;
-                        }
-                        header->uid[4] = 0x00;
-                        header->uid[5] = 0x00;
-                        header->uid[6] = 0x00;
-                    } else if (uid_len == 14) {
-                        // 7-byte UID
-                        if (hex_to_bytes(clean, header->uid, 7) != RFIDX_OK) {
-                            free(line);
-                            return RFIDX_NFC_PARSE_ERROR;
-                        }
-                    } else {
-                        free(line);
-                        return RFIDX_NFC_PARSE_ERROR;
-                    }
-                } else if (strncmp(key, "ATQA", 4) == 0) {
-                    if (hex_to_bytes(clean, header->atqa, 2) != RFIDX_OK) {
-                        free(line);
-                        return RFIDX_NFC_PARSE_ERROR;
-                    }
-                } else if (strncmp(key, "SAK", 3) == 0) {
-                    if (hex_to_bytes(clean, &header->sak, 1) != RFIDX_OK) {
-                        free(line);
-                        return RFIDX_NFC_PARSE_ERROR;
-                    }
-                } else if (strncmp(key, "Block ", 6) == 0) {
-                    char *endptr;
-                    const uint32_t page = (uint32_t) strtoul(key + 5, &endptr, 10);
-                    if (val == endptr) {
-                        free(line);
+    return RFIDX_OK;
+}
+
+RfidxStatus mfc1k_parse_nfc(const char *nfc_str, Mfc1kData *mfc1k, MfcMetadataHeader *header) {
+    const char *cursor = nfc_str;
+    const char *end = nfc_str + strlen(nfc_str);
+    NfcLine line;
+
+    while (nfc_next_line(&cursor, end, &line)) {
+        RfidxStatus status = RFIDX_OK;
+
+        switch (nfc_keyword_lookup(mfc1k_nfc_keywords, line.key, line.key_len)) {
+            case MFC1K_NFC_KEY_UID:
+                status = mfc1k_parse_nfc_uid(&line, header);
+                break;
+            case MFC1K_NFC_KEY_ATQA:
+                status = hex_span_to_bytes(line.value, line.value_len, header->atqa, 2);
+                break;
+            case MFC1K_NFC_KEY_SAK:
+                status = hex_span_to_bytes(line.value, line.value_len, &header->sak, 1);
+                break;
+            default:
+                if (line.key_len > 6 && memcmp(line.key, "Block ", 6) == 0) {
+                    uint32_t block;
+                    if (!str_to_uint(line.key + 6, line.key_len - 6, 10, &block)) {
                         return RFIDX_NFC_PARSE_ERROR;
                     }
-                    if (page < MFC_1K_NUM_BLOCK_PER_SECTOR * MFC_1K_NUM_SECTOR) {
-                        const uint32_t idx_sector = page / MFC_1K_NUM_BLOCK_PER_SECTOR;
-                        const uint32_t idx_block = page % MFC_1K_NUM_BLOCK_PER_SECTOR;
-
-                        if (hex_to_bytes(clean, mfc1k->blocks[idx_sector][idx_block], MFC_1K_BLOCK_SIZE) != RFIDX_OK) {
-                            free(line);
-                            return RFIDX_NFC_PARSE_ERROR;
-                        }
+                    if (block < MFC_1K_NUM_BLOCK_PER_SECTOR * MFC_1K_NUM_SECTOR) {
+                        const uint32_t idx_sector = block / MFC_1K_NUM_BLOCK_PER_SECTOR;
+                        const uint32_t idx_block = block % MFC_1K_NUM_BLOCK_PER_SECTOR;
+
+                        status = hex_span_to_bytes(line.value, line.value_len,
+                                                   mfc1k->blocks[idx_sector][idx_block], MFC_1K_BLOCK_SIZE);
                     }
                 }
-
-                free(clean);
-            }
+                break;
         }
 
-        free(line);
-        start = end + 1;
+        if (status != RFIDX_OK) {
+            return RFIDX_NFC_PARSE_ERROR;
+        }
     }
 
     return RFIDX_OK;
 }
 
-char *mfc1k_serialize_nfc(const Mfc1kData *mfc1k, const MfcMetadataHeader *header) {
-    size_t cap = 1024;
-    size_t len = 0;
-    char *buf = malloc(cap);
-    if (!buf) return NULL;
-    buf[0] = '\0';
-
-    appendf(&buf, &len, &cap, "Filetype: Flipper NFC device\n");
-    appendf(&buf, &len, &cap, "Version: 4\n");
-    appendf(&buf, &len, &cap, "Device type: Mifare Classic\n");
+static void mfc1k_write_nfc(TextWriter *writer, const Mfc1kData *mfc1k, const MfcMetadataHeader *header) {
+    static const char preamble[] =
+        "Filetype: Flipper NFC device\n"
+        "Version: 4\n"
+        "Device type: Mifare Classic\n";
+    text_writer_append(writer, preamble, sizeof(preamble) - 1);
 
+    text_writer_append(writer, "UID:", 4);
     if (header->uid[4] == 0x00 && header->uid[5] == 0x00 && header->uid[6] == 0x00) {
         // 4-byte NUID
-        appendf(&buf, &len, &cap, "UID: %02X %02X %02X %02X\n",
-                header->uid[0], header->uid[1], header->uid[2], header->uid[3]);
+        text_writer_hex_spaced(writer, header->uid, 4);
     } else {
         // 7-byte UID
-        appendf(&buf, &len, &cap, "UID: %02X %02X %02X %02X %02X %02X %02X\n",
-                header->uid[0], header->uid[1], header->uid[2],
-                header->uid[3], header->uid[4], header->uid[5], header->uid[6]);
+        text_writer_hex_spaced(writer, header->uid, 7);
     }
 
-    appendf(&buf, &len, &cap, "ATQA: %02X %02X\n", header->atqa[0], header->atqa[1]);
-    appendf(&buf, &len, &cap, "SAK: %02X\n", header->sak);
+    text_writer_append(writer, "\nATQA:", 6);
+    text_writer_hex_spaced(writer, header->atqa, 2);
+    text_writer_append(writer, "\nSAK:", 5);
+    text_writer_hex_spaced(writer, &header->sak, 1);
+
+    static const char type[] =
+        "\nMifare Classic type: 1K\n"
+        "Data format version: 2\n";
+    text_writer_append(writer, type, sizeof(type) - 1);
+
+    for (unsigned int i = 0; i < MFC_1K_NUM_SECTOR; i++) {
+        for (unsigned int j = 0; j < MFC_1K_NUM_BLOCK_PER_SECTOR; j++) {
+            text_writer_append(writer, "Block ", 6);
+            text_writer_uint(writer, i * MFC_1K_NUM_BLOCK_PER_SECTOR + j);
+            text_writer_append(writer, ":", 1);
+            text_writer_hex_spaced(writer, mfc1k->blocks[i][j], MFC_1K_BLOCK_SIZE);
+            text_writer_append(writer, "\n", 1);
+        }
+    }
 
-    appendf(&buf, &len, &cap, "Mifare Classic type: 1K\nData format version: 2\n");
+    static const char trailer[] = "Failed authentication attempts: 0\n";
+    text_writer_append(writer, trailer, sizeof(trailer) - 1);
+}
 
-    for (int i = 0; i < MFC_1K_NUM_SECTOR; i++) {
-        for (int j = 0; j < MFC_1K_NUM_BLOCK_PER_SECTOR; j++) {
-            appendf(&buf, &len, &cap,
-                    "Block %d: %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X %02X\n",
-                    i * MFC_1K_NUM_BLOCK_PER_SECTOR + j,
-                    mfc1k->blocks[i][j][0], mfc1k->blocks[i][j][1],
-                    mfc1k->blocks[i][j][2], mfc1k->blocks[i][j][3],
-                    mfc1k->blocks[i][j][4], mfc1k->blocks[i][j][5],
-                    mfc1k->blocks[i][j][6], mfc1k->blocks[i][j][7],
-                    mfc1k->blocks[i][j][8], mfc1k->blocks[i][j][9],
-                    mfc1k->blocks[i][j][10], mfc1k->blocks[i][j][11],
-                    mfc1k->blocks[i][j][12], mfc1k->blocks[i][j][13],
-                    mfc1k->blocks[i][j][14], mfc1k->blocks[i][j][15]);
-        }
+RfidxStatus mfc1k_serialize_nfc_into(
+    const Mfc1kData *mfc1k,
+    const MfcMetadataHeader *header,
+    char *out,
+    const size_t cap,
+    size_t *written
+) {
+    TextWriter writer;
+    text_writer_init(&writer, out, cap);
+    mfc1k_write_nfc(&writer, mfc1k, header);
+    if (!text_writer_finish(&writer)) {
+        return RFIDX_BUFFER_SIZE_ERROR;
     }
 
-    appendf(&buf, &len, &cap, "Failed authentication attempts: 0\n");
+    if (written) *written = writer.len - 1;
+    return RFIDX_OK;
+}
 
+char *mfc1k_serialize_nfc(const Mfc1kData *mfc1k, const MfcMetadataHeader *header) {
+    const size_t size = mfc1k_serialized_size(FORMAT_NFC, mfc1k, header);
+    char *buf = rfidx_malloc(size);
+    if (!buf) return NULL;
+
+    mfc1k_serialize_nfc_into(mfc1k, header, buf, size, NULL);
     return buf;
 }
 
+size_t mfc1k_serialized_size(const FileFormat format, const Mfc1kData *mfc1k, const MfcMetadataHeader *header) {
+    switch (format) {
+        case FORMAT_BINARY:
+            return sizeof(Mfc1kData);
+        case FORMAT_JSON: {
+            JsonWriter writer;
+            json_writer_init(&writer, NULL, 0, true);
+            mfc1k_write_json(&writer, mfc1k, header);
+            json_writer_finish(&writer);
+            return writer.out.len;
+        }
+        case FORMAT_NFC: {
+            TextWriter writer;
+            text_writer_init(&writer, NULL, 0);
+            mfc1k_write_nfc(&writer, mfc1k, header);
+            text_writer_finish(&writer);
+            return writer.len;
+        }
+        default:
+            return 0;
+    }
+}
+
 RfidxStatus mfc1k_generate(Mfc1kData *mfc1k, MfcMetadataHeader *header) {
+    return mfc1k_generate_ctx(&rfidx_default_context, mfc1k, header);
+}
+
+RfidxStatus mfc1k_generate_ctx(RfidxContext *ctx, Mfc1kData *mfc1k, MfcMetadataHeader *header) {
     // Re-initialize the memory space
     memset(mfc1k, 0, sizeof(Mfc1kData));
     memset(header, 0, sizeof(MfcMetadataHeader));
 
     // Generate UID
-    mfc_randomize_uid(mfc1k->blocks[0][0]);
+    mfc_randomize_uid_ctx(ctx, mfc1k->blocks[0][0]);
 
     return RFIDX_OK;
 }
@@ -408,6 +688,15 @@ RfidxStatus mfc1k_transform_data(
     Mfc1kData **mfc1k,
     MfcMetadataHeader **header,
     const TransformCommand command
+) {
+    return mfc1k_transform_data_ctx(&rfidx_default_context, mfc1k, header, command);
+}
+
+RfidxStatus mfc1k_transform_data_ctx(
+    RfidxContext *ctx,
+    Mfc1kData **mfc1k,
+    MfcMetadataHeader **header,
+    const TransformCommand command
 ) {
     switch (command) {
         case TRANSFORM_NONE:
@@ -415,18 +704,18 @@ RfidxStatus mfc1k_transform_data(
         case TRANSFORM_WIPE:
             return mfc1k_wipe(*mfc1k);
         case TRANSFORM_GENERATE:
-            *mfc1k = malloc(sizeof(Mfc1kData));
+            *mfc1k = rfidx_malloc(sizeof(Mfc1kData));
             if (!*mfc1k) return RFIDX_MEMORY_ERROR;
 
-            *header = malloc(sizeof(MfcMetadataHeader));
+            *header = rfidx_malloc(sizeof(MfcMetadataHeader));
             if (!*header) {
-                free(*mfc1k);
+                rfidx_free(*mfc1k);
                 return RFIDX_MEMORY_ERROR;
             }
 
-            return mfc1k_generate(*mfc1k, *header);
+            return mfc1k_generate_ctx(ctx, *mfc1k, *header);
         case TRANSFORM_RANDOMIZE_UID:
-            return mfc_randomize_uid((*mfc1k)->blocks[0][0]);
+            return mfc_randomize_uid_ctx(ctx, (*mfc1k)->blocks[0][0]);
         default:
             return RFIDX_UNKNOWN_ENUM_ERROR;
     }
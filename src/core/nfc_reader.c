@@ -0,0 +1,59 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <ctype.h>
+#include <stdint.h>
+#include <string.h>
+#include "nfc_reader.h"
+
+bool nfc_next_line(const char **cursor, const char *end, NfcLine *line) {
+    while (*cursor < end) {
+        const char *start = *cursor;
+        const char *eol = memchr(start, '\n', (size_t) (end - start));
+        const char *stop = eol ? eol : end;
+        *cursor = eol ? eol + 1 : end;
+
+        if (start == stop || *start == '#') continue;
+
+        const char *sep = memchr(start, ':', (size_t) (stop - start));
+        if (!sep) continue;
+
+        const char *key_end = sep;
+        while (key_end > start && isspace((unsigned char) key_end[-1])) key_end--;
+
+        const char *value = sep + 1;
+        while (value < stop && isspace((unsigned char) *value)) value++;
+        const char *value_end = stop;
+        while (value_end > value && isspace((unsigned char) value_end[-1])) value_end--;
+
+        line->key = start;
+        line->key_len = (size_t) (key_end - start);
+        line->value = value;
+        line->value_len = (size_t) (value_end - value);
+        return true;
+    }
+
+    return false;
+}
+
+size_t nfc_keyword_hash(const char *key, const size_t len) {
+    // Collision free for the keywords of every NFC parser in this library
+    return ((uint8_t) key[0] + 2u * (uint8_t) key[len - 1] + len) & (NFC_KEYWORD_TABLE_SIZE - 1);
+}
+
+int nfc_keyword_lookup(const NfcKeyword *table, const char *key, const size_t len) {
+    if (len == 0) return 0;
+
+    const NfcKeyword *entry = &table[nfc_keyword_hash(key, len)];
+    if (entry->name && entry->len == len && memcmp(entry->name, key, len) == 0) {
+        return entry->id;
+    }
+
+    return 0;
+}
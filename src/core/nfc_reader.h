@@ -0,0 +1,77 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * Line splitter and keyword tables shared by the Flipper NFC parsers. Internal to the
+ * library; not installed with the public headers.
+ */
+
+#ifndef LIBRFIDX_NFC_READER_H
+#define LIBRFIDX_NFC_READER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define NFC_KEYWORD_TABLE_SIZE 16
+
+/**
+ * @brief One key/value line of a Flipper NFC file
+ *
+ * Both spans point into the parsed buffer and are not null-terminated. Surrounding
+ * whitespace, including a trailing carriage return, is already stripped.
+ */
+typedef struct {
+    const char *key;            /**< Start of the key, the text before the first colon */
+    size_t key_len;             /**< Length of the key */
+    const char *value;          /**< Start of the value, the text after the first colon */
+    size_t value_len;           /**< Length of the value */
+} NfcLine;
+
+/**
+ * @brief Entry of a perfect hash table of NFC keywords
+ *
+ * Each parser keeps a table of NFC_KEYWORD_TABLE_SIZE entries, with every keyword stored
+ * at the slot given by nfc_keyword_hash(). Empty slots have a NULL name.
+ */
+typedef struct {
+    const char *name;           /**< Keyword as it appears before the colon */
+    size_t len;                 /**< Length of the keyword */
+    int id;                     /**< Parser specific identifier, must not be 0 */
+} NfcKeyword;
+
+/**
+ * @brief Fetch the next key/value line from a Flipper NFC buffer
+ *
+ * Splits the buffer in place without copying or allocating. Comments, blank lines and
+ * lines without a colon are skipped.
+ * @param cursor Current position, advanced past the returned line.
+ * @param end End of the buffer.
+ * @param line The line to fill.
+ * @return true if a line was found, false at the end of the buffer
+ */
+bool nfc_next_line(const char **cursor, const char *end, NfcLine *line);
+
+/**
+ * @brief Hash an NFC keyword into a slot of a keyword table
+ * @param key Start of the keyword.
+ * @param len Length of the keyword, must not be 0.
+ * @return Slot index below NFC_KEYWORD_TABLE_SIZE
+ */
+size_t nfc_keyword_hash(const char *key, size_t len);
+
+/**
+ * @brief Look up an NFC keyword in a perfect hash table
+ * @param table Keyword table of NFC_KEYWORD_TABLE_SIZE entries.
+ * @param key Start of the keyword.
+ * @param len Length of the keyword.
+ * @return The id of the keyword, or 0 if it is not in the table
+ */
+int nfc_keyword_lookup(const NfcKeyword *table, const char *key, size_t len);
+
+#endif //LIBRFIDX_NFC_READER_H
@@ -7,12 +7,16 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <cJSON.h>
 #include "librfidx/common.h"
 #include "librfidx/ntag/ntag215_core.h"
+#include "../json_reader.h"
+#include "../json_writer.h"
+#include "../nfc_reader.h"
 
 RfidxStatus ntag215_parse_binary(const uint8_t *buffer, const size_t len, Ntag215Data *ntag215,
                                  Ntag21xMetadataHeader *header) {
@@ -30,12 +34,29 @@ RfidxStatus ntag215_parse_binary(const uint8_t *buffer, const size_t len, Ntag21
     return RFIDX_BINARY_FILE_SIZE_ERROR;
 }
 
+RfidxStatus ntag215_serialize_binary_into(
+    const Ntag215Data *ntag215,
+    const Ntag21xMetadataHeader *header,
+    uint8_t *out,
+    const size_t cap,
+    size_t *written
+) {
+    if (!out || cap < sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data)) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+
+    memcpy(out, header, sizeof(Ntag21xMetadataHeader));
+    memcpy(out + sizeof(Ntag21xMetadataHeader), ntag215, sizeof(Ntag215Data));
+    if (written) *written = sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data);
+
+    return RFIDX_OK;
+}
+
 uint8_t *ntag215_serialize_binary(const Ntag215Data *ntag215, const Ntag21xMetadataHeader *header) {
-    uint8_t *buffer = malloc(sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data));
+    uint8_t *buffer = rfidx_malloc(sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data));
     if (!buffer) return NULL;
 
-    memcpy(buffer, header, sizeof(Ntag21xMetadataHeader));
-    memcpy(buffer + sizeof(Ntag21xMetadataHeader), ntag215, sizeof(Ntag215Data));
+    ntag215_serialize_binary_into(ntag215, header, buffer, sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data), NULL);
     return buffer;
 }
 
@@ -145,7 +166,139 @@ RfidxStatus ntag215_parse_data_from_json(const cJSON *blocks_obj, Ntag215Data *n
     return RFIDX_OK;
 }
 
+static const struct {
+    const char *name;
+    size_t offset;
+    size_t len;
+} ntag215_json_card_fields[] = {
+    {"Version", offsetof(Ntag21xMetadataHeader, version), 8},
+    {"TBO_0", offsetof(Ntag21xMetadataHeader, tbo0), 2},
+    {"TBO_1", offsetof(Ntag21xMetadataHeader, tbo1), 1},
+    {"Signature", offsetof(Ntag21xMetadataHeader, signature), 32},
+    {"Counter0", offsetof(Ntag21xMetadataHeader, counter0), 3},
+    {"Tearing0", offsetof(Ntag21xMetadataHeader, tearing0), 1},
+    {"Counter1", offsetof(Ntag21xMetadataHeader, counter1), 3},
+    {"Tearing1", offsetof(Ntag21xMetadataHeader, tearing1), 1},
+    {"Counter2", offsetof(Ntag21xMetadataHeader, counter2), 3},
+    {"Tearing2", offsetof(Ntag21xMetadataHeader, tearing2), 1},
+};
+
+#define NTAG215_JSON_CARD_FIELD_COUNT (sizeof(ntag215_json_card_fields) / sizeof(ntag215_json_card_fields[0]))
+
+static bool ntag215_read_json_card(JsonReader *reader, Ntag21xMetadataHeader *header) {
+    uint32_t seen = 0;
+    const char *key;
+    size_t key_len;
+    JsonReaderResult result;
+
+    while ((result = json_reader_next_member(reader, &key, &key_len)) == JSON_READER_MEMBER) {
+        size_t i = 0;
+        while (i < NTAG215_JSON_CARD_FIELD_COUNT && !json_key_equals(key, key_len, ntag215_json_card_fields[i].name)) {
+            i++;
+        }
+
+        // cJSON_GetObjectItem returns the first match, so later duplicates are ignored
+        if (i == NTAG215_JSON_CARD_FIELD_COUNT || (seen & (1u << i))) {
+            if (!json_reader_skip_value(reader)) return false;
+            continue;
+        }
+
+        const char *value;
+        size_t value_len;
+        const size_t len = ntag215_json_card_fields[i].len;
+        if (!json_reader_string(reader, &value, &value_len) || value_len < 2 * len ||
+            !hex_decode(value, len, (uint8_t *) header + ntag215_json_card_fields[i].offset)) {
+            return false;
+        }
+        seen |= 1u << i;
+    }
+
+    return result == JSON_READER_END && seen == (1u << NTAG215_JSON_CARD_FIELD_COUNT) - 1;
+}
+
+static bool ntag215_read_json_blocks(JsonReader *reader, Ntag215Data *ntag215) {
+    uint64_t seen[2] = {0};
+    size_t count = 0;
+    const char *key;
+    size_t key_len;
+    JsonReaderResult result;
+
+    while ((result = json_reader_next_member(reader, &key, &key_len)) == JSON_READER_MEMBER) {
+        uint32_t page;
+        if (!json_key_index(key, key_len, &page) || page >= NTAG215_NUM_USER_PAGES ||
+            (seen[page / 64] >> (page % 64)) & 1) {
+            if (!json_reader_skip_value(reader)) return false;
+            continue;
+        }
+
+        const char *value;
+        size_t value_len;
+        if (!json_reader_string(reader, &value, &value_len) || value_len < 8 ||
+            !hex_decode(value, 4, ntag215->pages[page])) {
+            return false;
+        }
+        seen[page / 64] |= (uint64_t) 1 << (page % 64);
+        count++;
+    }
+
+    return result == JSON_READER_END && count == NTAG215_NUM_USER_PAGES;
+}
+
+/**
+ * @brief Parse a Proxmark3 "mfu" dump in one pass, without building a cJSON tree
+ *
+ * Decodes into copies and only writes the output once the whole document has been
+ * read. Any input the reader does not accept, including every malformed document, is
+ * left to the cJSON parser, which keeps deciding what is an error.
+ * @return true if the document was parsed
+ */
+static bool ntag215_read_json(const char *json_str, Ntag215Data *ntag215, Ntag21xMetadataHeader *header) {
+    if (!json_str) {
+        return false;
+    }
+
+    Ntag215Data data = *ntag215;
+    Ntag21xMetadataHeader card = *header;
+    bool has_card = false;
+    bool has_blocks = false;
+
+    JsonReader reader;
+    json_reader_init(&reader, json_str, strlen(json_str));
+    if (!json_reader_enter_object(&reader)) {
+        return false;
+    }
+
+    const char *key;
+    size_t key_len;
+    JsonReaderResult result;
+    while ((result = json_reader_next_member(&reader, &key, &key_len)) == JSON_READER_MEMBER) {
+        if (!has_card && json_key_equals(key, key_len, "Card")) {
+            if (!json_reader_enter_object(&reader) || !ntag215_read_json_card(&reader, &card)) return false;
+            has_card = true;
+        } else if (!has_blocks && json_key_equals(key, key_len, "blocks")) {
+            if (!json_reader_enter_object(&reader) || !ntag215_read_json_blocks(&reader, &data)) return false;
+            has_blocks = true;
+        } else if (!json_reader_skip_value(&reader)) {
+            return false;
+        }
+    }
+
+    if (result != JSON_READER_END || !has_card || !has_blocks) {
+        return false;
+    }
+
+    card.memory_max = NTAG215_NUM_PAGES - 1;
+    *ntag215 = data;
+    *header = card;
+
+    return true;
+}
+
 RfidxStatus ntag215_parse_json(const char *json_str, Ntag215Data *ntag215, Ntag21xMetadataHeader *header) {
+    if (ntag215_read_json(json_str, ntag215, header)) {
+        return RFIDX_OK;
+    }
+
     cJSON *root = cJSON_Parse(json_str);
     if (!root) {
         return RFIDX_JSON_PARSE_ERROR;
@@ -237,185 +390,302 @@ cJSON *ntag215_dump_data_to_json(const Ntag215Data *ntag215) {
     return blocks_obj;
 }
 
-char *ntag215_serialize_json(const Ntag215Data *ntag215, const Ntag21xMetadataHeader *header) {
-    cJSON *root = cJSON_CreateObject();
-    cJSON_AddStringToObject(root, "Created", JSON_FORMAT_CREATOR);
-    cJSON_AddStringToObject(root, "FileType", "mfu");
+static void ntag215_write_json(JsonWriter *writer, const Ntag215Data *ntag215, const Ntag21xMetadataHeader *header) {
+    json_writer_begin_object(writer, NULL);
+    json_writer_string(writer, "Created", JSON_FORMAT_CREATOR);
+    json_writer_string(writer, "FileType", "mfu");
+
+    json_writer_begin_object(writer, "Card");
+    json_writer_hex(writer, "Version", header->version, 8);
+    json_writer_hex(writer, "TBO_0", header->tbo0, 2);
+    json_writer_hex(writer, "TBO_1", &header->tbo1, 1);
+    json_writer_hex(writer, "Signature", header->signature, 32);
+    json_writer_hex(writer, "Counter0", header->counter0, 3);
+    json_writer_hex(writer, "Tearing0", &header->tearing0, 1);
+    json_writer_hex(writer, "Counter1", header->counter1, 3);
+    json_writer_hex(writer, "Tearing1", &header->tearing1, 1);
+    json_writer_hex(writer, "Counter2", header->counter2, 3);
+    json_writer_hex(writer, "Tearing2", &header->tearing2, 1);
+    json_writer_end_object(writer);
+
+    json_writer_begin_object(writer, "blocks");
+    for (unsigned int i = 0; i < NTAG215_NUM_PAGES; i++) {
+        json_writer_hex_indexed(writer, i, ntag215->pages[i], 4);
+    }
+    json_writer_end_object(writer);
+
+    json_writer_end_object(writer);
+}
 
-    cJSON_AddItemToObject(root, "Card", ntag215_dump_header_to_json(header));
-    cJSON_AddItemToObject(root, "blocks", ntag215_dump_data_to_json(ntag215));
+static char *ntag215_print_json(const Ntag215Data *ntag215, const Ntag21xMetadataHeader *header, const bool format) {
+    // Measure first, so the output is allocated once at its final size
+    JsonWriter writer;
+    json_writer_init(&writer, NULL, 0, format);
+    ntag215_write_json(&writer, ntag215, header);
+    json_writer_finish(&writer);
 
-    char *output = cJSON_Print(root);
-    cJSON_Delete(root);
+    const size_t size = writer.out.len;
+    char *output = rfidx_malloc(size);
+    if (!output) return NULL;
+
+    json_writer_init(&writer, output, size, format);
+    ntag215_write_json(&writer, ntag215, header);
+    json_writer_finish(&writer);
 
     return output;
 }
 
-RfidxStatus ntag215_parse_nfc(const char *nfc_str, Ntag215Data *ntag215, Ntag21xMetadataHeader *header) {
-    const char *start = nfc_str;
-    const char *end;
+RfidxStatus ntag215_serialize_json_into(
+    const Ntag215Data *ntag215,
+    const Ntag21xMetadataHeader *header,
+    char *out,
+    const size_t cap,
+    size_t *written
+) {
+    JsonWriter writer;
+    json_writer_init(&writer, out, cap, true);
+    ntag215_write_json(&writer, ntag215, header);
+    if (!json_writer_finish(&writer)) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
 
-    while ((end = strchr(start, '\n')) != NULL) {
-        const size_t line_length = end - start;
-        char *line = malloc(line_length + 1);
-        if (!line) {
-            return RFIDX_NFC_PARSE_ERROR;
-        }
-        strncpy(line, start, line_length);
-        line[line_length] = '\0';
-
-        if (line[0] != '#' && line[0] != '\0') {
-            char *sep = strchr(line, ':');
-            if (sep) {
-                *sep = '\0';
-                const char *key = line;
-                const char *val = sep + 1;
-                while (*val && isspace((unsigned char)*val)) val++;
-
-                char *clean = remove_whitespace(val);
-                if (!clean) {
-                    free(line);
-                    return RFIDX_NFC_PARSE_ERROR;
-                }
+    if (written) *written = writer.out.len - 1;
+    return RFIDX_OK;
+}
 
-                if (strncmp(key, "Signature", 9) == 0) {
-                    if (hex_to_bytes(clean, header->signature, 32) != RFIDX_OK) {
-                        free(line);
-                        return RFIDX_NFC_PARSE_ERROR;
-                    }
-                } else if (strncmp(key, "Mifare version", 14) == 0) {
-                    if (hex_to_bytes(clean, header->version, 8) != RFIDX_OK) {
-                        free(line);
-                        return RFIDX_NFC_PARSE_ERROR;
-                    }
-                } else if (strncmp(key, "Counter 0", 9) == 0) {
-                    char *endptr;
-                    uint32_t c = (uint32_t) strtoul(val, &endptr, 10);
-                    if (val == endptr) {
-                        free(line);
-                        return RFIDX_NFC_PARSE_ERROR;
-                    }
-                    header->counter0[0] = (c >> 16) & 0xFF;
-                    header->counter0[1] = (c >> 8) & 0xFF;
-                    header->counter0[2] = c & 0xFF;
-                } else if (strncmp(key, "Tearing 0", 9) == 0) {
-                    header->tearing0 = (uint8_t) strtol(val, NULL, 16);
-                } else if (strncmp(key, "Counter 1", 9) == 0) {
-                    char *endptr;
-                    uint32_t c = (uint32_t) strtoul(val, &endptr, 10);
-                    if (val == endptr) {
-                        free(line);
-                        return RFIDX_NFC_PARSE_ERROR;
-                    }
-                    header->counter1[0] = (c >> 16) & 0xFF;
-                    header->counter1[1] = (c >> 8) & 0xFF;
-                    header->counter1[2] = c & 0xFF;
-                } else if (strncmp(key, "Tearing 1", 9) == 0) {
-                    header->tearing1 = (uint8_t) strtol(val, NULL, 16);
-                } else if (strncmp(key, "Counter 2", 9) == 0) {
-                    char *endptr;
-                    uint32_t c = (uint32_t) strtoul(val, &endptr, 10);
-                    if (val == endptr) {
-                        free(line);
-                        return RFIDX_NFC_PARSE_ERROR;
-                    }
-                    header->counter2[0] = (c >> 16) & 0xFF;
-                    header->counter2[1] = (c >> 8) & 0xFF;
-                    header->counter2[2] = c & 0xFF;
-                } else if (strncmp(key, "Tearing 2", 9) == 0) {
-                    header->tearing2 = (uint8_t) strtol(val, NULL, 16);
-                } else if (strncmp(key, "Pages total", 11) == 0) {
-                    header->memory_max = (uint8_t) strtol(val, NULL, 10) - 1;
-                } else if (strncmp(key, "Page ", 5) == 0) {
-                    char *endptr;
-                    const uint32_t page = (uint32_t) strtoul(key + 5, &endptr, 10);
-                    if (val == endptr) {
-                        free(line);
+char *ntag215_serialize_json(const Ntag215Data *ntag215, const Ntag21xMetadataHeader *header) {
+    return ntag215_print_json(ntag215, header, true);
+}
+
+char *ntag215_serialize_json_unformatted(const Ntag215Data *ntag215, const Ntag21xMetadataHeader *header) {
+    return ntag215_print_json(ntag215, header, false);
+}
+
+enum {
+    NTAG215_NFC_KEY_SIGNATURE = 1,
+    NTAG215_NFC_KEY_VERSION,
+    NTAG215_NFC_KEY_COUNTER_0,
+    NTAG215_NFC_KEY_TEARING_0,
+    NTAG215_NFC_KEY_COUNTER_1,
+    NTAG215_NFC_KEY_TEARING_1,
+    NTAG215_NFC_KEY_COUNTER_2,
+    NTAG215_NFC_KEY_TEARING_2,
+    NTAG215_NFC_KEY_PAGES_TOTAL,
+};
+
+// Slots follow nfc_keyword_hash()
+static const NfcKeyword ntag215_nfc_keywords[NFC_KEYWORD_TABLE_SIZE] = {
+    [0] = {"Counter 2", 9, NTAG215_NFC_KEY_COUNTER_2},
+    [1] = {"Tearing 2", 9, NTAG215_NFC_KEY_TEARING_2},
+    [3] = {"Pages total", 11, NTAG215_NFC_KEY_PAGES_TOTAL},
+    [6] = {"Signature", 9, NTAG215_NFC_KEY_SIGNATURE},
+    [7] = {"Mifare version", 14, NTAG215_NFC_KEY_VERSION},
+    [12] = {"Counter 0", 9, NTAG215_NFC_KEY_COUNTER_0},
+    [13] = {"Tearing 0", 9, NTAG215_NFC_KEY_TEARING_0},
+    [14] = {"Counter 1", 9, NTAG215_NFC_KEY_COUNTER_1},
+    [15] = {"Tearing 1", 9, NTAG215_NFC_KEY_TEARING_1},
+};
+
+static bool ntag215_parse_nfc_counter(const NfcLine *line, uint8_t counter[3]) {
+    uint32_t c;
+    if (!str_to_uint(line->value, line->value_len, 10, &c)) {
+        return false;
+    }
+
+    counter[0] = (c >> 16) & 0xFF;
+    counter[1] = (c >> 8) & 0xFF;
+    counter[2] = c & 0xFF;
+    return true;
+}
+
+static uint8_t ntag215_parse_nfc_tearing(const NfcLine *line) {
+    uint32_t t;
+    str_to_uint(line->value, line->value_len, 16, &t);
+    return (uint8_t) t;
+}
+
+RfidxStatus ntag215_parse_nfc(const char *nfc_str, Ntag215Data *ntag215, Ntag21xMetadataHeader *header) {
+    const char *cursor = nfc_str;
+    const char *end = nfc_str + strlen(nfc_str);
+    NfcLine line;
+
+    while (nfc_next_line(&cursor, end, &line)) {
+        bool ok = true;
+
+        switch (nfc_keyword_lookup(ntag215_nfc_keywords, line.key, line.key_len)) {
+            case NTAG215_NFC_KEY_SIGNATURE:
+                ok = hex_span_to_bytes(line.value, line.value_len, header->signature, 32) == RFIDX_OK;
+                break;
+            case NTAG215_NFC_KEY_VERSION:
+                ok = hex_span_to_bytes(line.value, line.value_len, header->version, 8) == RFIDX_OK;
+                break;
+            case NTAG215_NFC_KEY_COUNTER_0:
+                ok = ntag215_parse_nfc_counter(&line, header->counter0);
+                break;
+            case NTAG215_NFC_KEY_TEARING_0:
+                header->tearing0 = ntag215_parse_nfc_tearing(&line);
+                break;
+            case NTAG215_NFC_KEY_COUNTER_1:
+                ok = ntag215_parse_nfc_counter(&line, header->counter1);
+                break;
+            case NTAG215_NFC_KEY_TEARING_1:
+                header->tearing1 = ntag215_parse_nfc_tearing(&line);
+                break;
+            case NTAG215_NFC_KEY_COUNTER_2:
+                ok = ntag215_parse_nfc_counter(&line, header->counter2);
+                break;
+            case NTAG215_NFC_KEY_TEARING_2:
+                header->tearing2 = ntag215_parse_nfc_tearing(&line);
+                break;
+            case NTAG215_NFC_KEY_PAGES_TOTAL: {
+                uint32_t total;
+                str_to_uint(line.value, line.value_len, 10, &total);
+                header->memory_max = (uint8_t) total - 1;
+                break;
+            }
+            default:
+                if (line.key_len > 5 && memcmp(line.key, "Page ", 5) == 0) {
+                    uint32_t page;
+                    if (!str_to_uint(line.key + 5, line.key_len - 5, 10, &page)) {
                         return RFIDX_NFC_PARSE_ERROR;
                     }
                     if (page < NTAG215_NUM_USER_PAGES) {
-                        if (hex_to_bytes(clean, ntag215->pages[page], 4) != RFIDX_OK) {
-                            free(line);
-                            return RFIDX_NFC_PARSE_ERROR;
-                        }
+                        ok = hex_span_to_bytes(line.value, line.value_len, ntag215->pages[page], 4) == RFIDX_OK;
                     }
                 }
-
-                free(clean);
-            }
+                break;
         }
 
-        free(line);
-        start = end + 1;
+        if (!ok) {
+            return RFIDX_NFC_PARSE_ERROR;
+        }
     }
 
     return RFIDX_OK;
 }
 
-char *ntag215_serialize_nfc(const Ntag215Data *ntag215, const Ntag21xMetadataHeader *header) {
-    size_t cap = 1024;
-    size_t len = 0;
-    char *buf = malloc(cap);
-    if (!buf) return NULL;
-    buf[0] = '\0';
-
-    appendf(&buf, &len, &cap, "Filetype: Flipper NFC device\n");
-    appendf(&buf, &len, &cap, "Version: 2\n");
-    appendf(&buf, &len, &cap, "Device type: NTAG215\n");
-    appendf(&buf, &len, &cap, "UID: %02X %02X %02X %02X %02X %02X %02X\n",
-            ntag215->structure.manufacturer_data.uid0[0],
-            ntag215->structure.manufacturer_data.uid0[1],
-            ntag215->structure.manufacturer_data.uid0[2],
-            ntag215->structure.manufacturer_data.uid1[0],
-            ntag215->structure.manufacturer_data.uid1[1],
-            ntag215->structure.manufacturer_data.uid1[2],
-            ntag215->structure.manufacturer_data.uid1[3]);
-
-    appendf(&buf, &len, &cap, "ATQA: 00 44\n");
-    appendf(&buf, &len, &cap, "SAK: 00\n");
+static void ntag215_write_nfc_counter(TextWriter *writer, const char *key, const uint8_t counter[3]) {
+    text_writer_append(writer, key, strlen(key));
+    text_writer_uint(writer, (counter[0] << 16) | (counter[1] << 8) | counter[2]);
+    text_writer_append(writer, "\n", 1);
+}
 
-    appendf(&buf, &len, &cap, "Signature:");
-    for (int i = 0; i < 32; i++) appendf(&buf, &len, &cap, " %02X", header->signature[i]);
-    appendf(&buf, &len, &cap, "\n");
+static void ntag215_write_nfc_hex(TextWriter *writer, const char *key, const uint8_t *bytes, const size_t len) {
+    text_writer_append(writer, key, strlen(key));
+    text_writer_hex_spaced(writer, bytes, len);
+    text_writer_append(writer, "\n", 1);
+}
 
-    appendf(&buf, &len, &cap, "Mifare version:");
-    for (int i = 0; i < 8; i++) appendf(&buf, &len, &cap, " %02X", header->version[i]);
-    appendf(&buf, &len, &cap, "\n");
+static void ntag215_write_nfc(TextWriter *writer, const Ntag215Data *ntag215, const Ntag21xMetadataHeader *header) {
+    static const char preamble[] =
+        "Filetype: Flipper NFC device\n"
+        "Version: 2\n"
+        "Device type: NTAG215\n";
+    text_writer_append(writer, preamble, sizeof(preamble) - 1);
+
+    const uint8_t uid[7] = {
+        ntag215->structure.manufacturer_data.uid0[0],
+        ntag215->structure.manufacturer_data.uid0[1],
+        ntag215->structure.manufacturer_data.uid0[2],
+        ntag215->structure.manufacturer_data.uid1[0],
+        ntag215->structure.manufacturer_data.uid1[1],
+        ntag215->structure.manufacturer_data.uid1[2],
+        ntag215->structure.manufacturer_data.uid1[3],
+    };
+    ntag215_write_nfc_hex(writer, "UID:", uid, sizeof(uid));
+
+    static const char fixed[] =
+        "ATQA: 00 44\n"
+        "SAK: 00\n";
+    text_writer_append(writer, fixed, sizeof(fixed) - 1);
+
+    ntag215_write_nfc_hex(writer, "Signature:", header->signature, 32);
+    ntag215_write_nfc_hex(writer, "Mifare version:", header->version, 8);
+
+    ntag215_write_nfc_counter(writer, "Counter 0: ", header->counter0);
+    ntag215_write_nfc_hex(writer, "Tearing 0:", &header->tearing0, 1);
+    ntag215_write_nfc_counter(writer, "Counter 1: ", header->counter1);
+    ntag215_write_nfc_hex(writer, "Tearing 1:", &header->tearing1, 1);
+    ntag215_write_nfc_counter(writer, "Counter 2: ", header->counter2);
+    ntag215_write_nfc_hex(writer, "Tearing 2:", &header->tearing2, 1);
+
+    text_writer_append(writer, "Pages total: ", 13);
+    text_writer_uint(writer, header->memory_max + 1u);
+    text_writer_append(writer, "\n", 1);
+
+    for (unsigned int i = 0; i < NTAG215_NUM_PAGES; i++) {
+        text_writer_append(writer, "Page ", 5);
+        text_writer_uint(writer, i);
+        text_writer_append(writer, ":", 1);
+        text_writer_hex_spaced(writer, ntag215->pages[i], 4);
+        text_writer_append(writer, "\n", 1);
+    }
+
+    static const char trailer[] = "Failed authentication attempts: 0\n";
+    text_writer_append(writer, trailer, sizeof(trailer) - 1);
+}
 
-    const uint32_t c0 = (header->counter0[0] << 16) | (header->counter0[1] << 8) | header->counter0[2];
-    appendf(&buf, &len, &cap, "Counter 0: %u\n", c0);
-    appendf(&buf, &len, &cap, "Tearing 0: %02X\n", header->tearing0);
+RfidxStatus ntag215_serialize_nfc_into(
+    const Ntag215Data *ntag215,
+    const Ntag21xMetadataHeader *header,
+    char *out,
+    const size_t cap,
+    size_t *written
+) {
+    TextWriter writer;
+    text_writer_init(&writer, out, cap);
+    ntag215_write_nfc(&writer, ntag215, header);
+    if (!text_writer_finish(&writer)) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
 
-    const uint32_t c1 = (header->counter1[0] << 16) | (header->counter1[1] << 8) | header->counter1[2];
-    appendf(&buf, &len, &cap, "Counter 1: %u\n", c1);
-    appendf(&buf, &len, &cap, "Tearing 1: %02X\n", header->tearing1);
+    if (written) *written = writer.len - 1;
+    return RFIDX_OK;
+}
 
-    const uint32_t c2 = (header->counter2[0] << 16) | (header->counter2[1] << 8) | header->counter2[2];
-    appendf(&buf, &len, &cap, "Counter 2: %u\n", c2);
-    appendf(&buf, &len, &cap, "Tearing 2: %02X\n", header->tearing2);
+char *ntag215_serialize_nfc(const Ntag215Data *ntag215, const Ntag21xMetadataHeader *header) {
+    const size_t size = ntag215_serialized_size(FORMAT_NFC, ntag215, header);
+    char *buf = rfidx_malloc(size);
+    if (!buf) return NULL;
 
-    appendf(&buf, &len, &cap, "Pages total: %d\n", header->memory_max + 1);
+    ntag215_serialize_nfc_into(ntag215, header, buf, size, NULL);
+    return buf;
+}
 
-    for (int i = 0; i < NTAG215_NUM_PAGES; i++) {
-        appendf(&buf, &len, &cap, "Page %d: %02X %02X %02X %02X\n", i,
-                ntag215->pages[i][0],
-                ntag215->pages[i][1],
-                ntag215->pages[i][2],
-                ntag215->pages[i][3]);
+size_t ntag215_serialized_size(const FileFormat format, const Ntag215Data *ntag215, const Ntag21xMetadataHeader *header) {
+    switch (format) {
+        case FORMAT_BINARY:
+            return sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data);
+        case FORMAT_JSON: {
+            JsonWriter writer;
+            json_writer_init(&writer, NULL, 0, true);
+            ntag215_write_json(&writer, ntag215, header);
+            json_writer_finish(&writer);
+            return writer.out.len;
+        }
+        case FORMAT_NFC: {
+            TextWriter writer;
+            text_writer_init(&writer, NULL, 0);
+            ntag215_write_nfc(&writer, ntag215, header);
+            text_writer_finish(&writer);
+            return writer.len;
+        }
+        default:
+            return 0;
     }
-
-    appendf(&buf, &len, &cap, "Failed authentication attempts: 0\n");
-
-    return buf;
 }
 
 RfidxStatus ntag215_generate(Ntag215Data *ntag215, Ntag21xMetadataHeader *header) {
+    return ntag215_generate_ctx(&rfidx_default_context, ntag215, header);
+}
+
+RfidxStatus ntag215_generate_ctx(RfidxContext *ctx, Ntag215Data *ntag215, Ntag21xMetadataHeader *header) {
     // Re-initialize the memory space
     memset(ntag215, 0, sizeof(Ntag215Data));
     memset(header, 0, sizeof(Ntag21xMetadataHeader));
 
     // Generate UID
-    ntag21x_randomize_uid(&ntag215->structure.manufacturer_data);
+    ntag21x_randomize_uid_ctx(ctx, &ntag215->structure.manufacturer_data);
 
     return RFIDX_OK;
 }
@@ -438,6 +708,15 @@ RfidxStatus ntag215_transform_data(
     Ntag215Data **ntag215,
     Ntag21xMetadataHeader **header,
     const TransformCommand command
+) {
+    return ntag215_transform_data_ctx(&rfidx_default_context, ntag215, header, command);
+}
+
+RfidxStatus ntag215_transform_data_ctx(
+    RfidxContext *ctx,
+    Ntag215Data **ntag215,
+    Ntag21xMetadataHeader **header,
+    const TransformCommand command
 ) {
     switch (command) {
         case TRANSFORM_NONE:
@@ -445,18 +724,18 @@ RfidxStatus ntag215_transform_data(
         case TRANSFORM_WIPE:
             return ntag215_wipe(*ntag215);
         case TRANSFORM_GENERATE:
-            *ntag215 = malloc(sizeof(Ntag215Data));
+            *ntag215 = rfidx_malloc(sizeof(Ntag215Data));
             if (!*ntag215) return RFIDX_MEMORY_ERROR;
 
-            *header = malloc(sizeof(Ntag21xMetadataHeader));
+            *header = rfidx_malloc(sizeof(Ntag21xMetadataHeader));
             if (!*header) {
-                free(*ntag215);
+                rfidx_free(*ntag215);
                 return RFIDX_MEMORY_ERROR;
             }
 
-            return ntag215_generate(*ntag215, *header);
+            return ntag215_generate_ctx(ctx, *ntag215, *header);
         case TRANSFORM_RANDOMIZE_UID:
-            return ntag21x_randomize_uid(&(*ntag215)->structure.manufacturer_data);
+            return ntag21x_randomize_uid_ctx(ctx, &(*ntag215)->structure.manufacturer_data);
         default:
             return RFIDX_UNKNOWN_ENUM_ERROR;
     }
@@ -38,16 +38,16 @@ RfidxStatus ntag21x_validate_manufacturer_data(const Ntag21xManufacturerData *ma
 }
 
 RfidxStatus ntag21x_randomize_uid(Ntag21xManufacturerData *manufacturer_data) {
-    manufacturer_data->uid0[0] = 0x04;
+    return ntag21x_randomize_uid_ctx(&rfidx_default_context, manufacturer_data);
+}
 
-    if (!rfidx_rng_initialized) {
-        return RFIDX_DRNG_ERROR;
-    }
+RfidxStatus ntag21x_randomize_uid_ctx(RfidxContext *ctx, Ntag21xManufacturerData *manufacturer_data) {
+    manufacturer_data->uid0[0] = 0x04;
 
     uint8_t buffer[6];
-    const int ret = mbedtls_ctr_drbg_random(&rfidx_ctr_drbg, buffer, sizeof(buffer));
-    if (ret != 0) {
-        return RFIDX_DRNG_ERROR;
+    const RfidxStatus status = rfidx_random_ctx(ctx, buffer, sizeof(buffer));
+    if (status != RFIDX_OK) {
+        return status;
     }
 
     manufacturer_data->uid0[1] = buffer[0];
@@ -0,0 +1,637 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "librfidx/archive.h"
+#include "librfidx/rfidx.h"
+#include "librfidx/ntag/ntag215.h"
+#include "librfidx/mifare/mifare_classic_1k.h"
+#include "../core/layout.h"
+
+/* Offsets of the fields in the archive header */
+#define ARCHIVE_VERSION_OFFSET 8
+#define ARCHIVE_TAG_TYPE_OFFSET 10
+#define ARCHIVE_RECORD_SIZE_OFFSET 12
+#define ARCHIVE_COUNT_OFFSET 16
+#define ARCHIVE_INDEX_OFFSET 24
+#define ARCHIVE_NAMES_LEN_OFFSET 32
+
+static size_t archive_record_size(const size_t header_size, const size_t data_size) {
+    return RFIDX_ARCHIVE_CRC_SIZE + header_size + data_size;
+}
+
+static void archive_encode_header(uint8_t out[RFIDX_ARCHIVE_HEADER_SIZE], const TagType tag_type,
+                                  const size_t record_size, const uint64_t count, const uint64_t index_offset,
+                                  const uint64_t names_len) {
+    memset(out, 0, RFIDX_ARCHIVE_HEADER_SIZE);
+    memcpy(out, RFIDX_ARCHIVE_MAGIC, 8);
+    put_u16(out + ARCHIVE_VERSION_OFFSET, RFIDX_ARCHIVE_VERSION);
+    put_u16(out + ARCHIVE_TAG_TYPE_OFFSET, (uint16_t) tag_type);
+    put_u32(out + ARCHIVE_RECORD_SIZE_OFFSET, (uint32_t) record_size);
+    put_u64(out + ARCHIVE_COUNT_OFFSET, count);
+    put_u64(out + ARCHIVE_INDEX_OFFSET, index_offset);
+    put_u64(out + ARCHIVE_NAMES_LEN_OFFSET, names_len);
+}
+
+/**
+ * @brief Check an archive header against the size of the file
+ *
+ * Every record, the index and the names must lie inside the file, so that readers only need
+ * to check the fields of one entry.
+ */
+static RfidxStatus archive_decode_header(const uint8_t *in, const uint64_t file_size, TagType *tag_type,
+                                         size_t *header_size, size_t *data_size, uint64_t *count,
+                                         uint64_t *names_len) {
+    if (file_size < RFIDX_ARCHIVE_HEADER_SIZE || memcmp(in, RFIDX_ARCHIVE_MAGIC, 8) != 0 ||
+        get_u16(in + ARCHIVE_VERSION_OFFSET) != RFIDX_ARCHIVE_VERSION) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    *tag_type = (TagType) get_u16(in + ARCHIVE_TAG_TYPE_OFFSET);
+    TagLayout layout;
+    if (tag_layout(*tag_type, &layout) != RFIDX_OK) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    *header_size = layout.header_size;
+    *data_size = layout.data_size;
+    const size_t record_size = archive_record_size(*header_size, *data_size);
+    if (get_u32(in + ARCHIVE_RECORD_SIZE_OFFSET) != record_size) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    *count = get_u64(in + ARCHIVE_COUNT_OFFSET);
+    *names_len = get_u64(in + ARCHIVE_NAMES_LEN_OFFSET);
+    const uint64_t index_offset = get_u64(in + ARCHIVE_INDEX_OFFSET);
+    const uint64_t room = file_size - RFIDX_ARCHIVE_HEADER_SIZE;
+    if (index_offset == 0 || *count > room / (record_size + RFIDX_ARCHIVE_INDEX_ENTRY_SIZE) ||
+        index_offset != RFIDX_ARCHIVE_HEADER_SIZE + *count * record_size) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    if (*names_len != file_size - index_offset - *count * RFIDX_ARCHIVE_INDEX_ENTRY_SIZE) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    return RFIDX_OK;
+}
+
+static RfidxStatus archive_writer_init(RfidxArchiveWriter *writer, FILE *file, const TagType tag_type) {
+    memset(writer, 0, sizeof(*writer));
+    writer->file = file;
+    writer->tag_type = tag_type;
+    TagLayout layout;
+    const RfidxStatus status = tag_layout(tag_type, &layout);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+    writer->header_size = layout.header_size;
+    writer->data_size = layout.data_size;
+
+    writer->record = rfidx_malloc(archive_record_size(writer->header_size, writer->data_size));
+    return writer->record ? RFIDX_OK : RFIDX_MEMORY_ERROR;
+}
+
+static void archive_writer_release(RfidxArchiveWriter *writer) {
+    if (writer->file) fclose(writer->file);
+    rfidx_free(writer->record);
+    rfidx_free(writer->offsets);
+    rfidx_free(writer->name_offsets);
+    rfidx_free(writer->names);
+    memset(writer, 0, sizeof(*writer));
+}
+
+static RfidxStatus archive_add_entry(RfidxArchiveWriter *writer, const uint64_t offset, const char *name,
+                                     const size_t name_len) {
+    if (writer->names_len + name_len > UINT32_MAX) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+    if (writer->names_len + name_len > writer->names_cap) {
+        size_t cap = writer->names_cap ? writer->names_cap * 2 : 4096;
+        while (cap < writer->names_len + name_len) cap *= 2;
+        char *names = rfidx_realloc(writer->names, cap);
+        if (!names) return RFIDX_MEMORY_ERROR;
+        writer->names = names;
+        writer->names_cap = cap;
+    }
+    if (writer->count == writer->cap) {
+        const size_t cap = writer->cap ? writer->cap * 2 : 256;
+        uint64_t *offsets = rfidx_realloc(writer->offsets, cap * sizeof(uint64_t));
+        if (!offsets) return RFIDX_MEMORY_ERROR;
+        writer->offsets = offsets;
+        uint32_t *name_offsets = rfidx_realloc(writer->name_offsets, cap * sizeof(uint32_t));
+        if (!name_offsets) return RFIDX_MEMORY_ERROR;
+        writer->name_offsets = name_offsets;
+        writer->cap = cap;
+    }
+
+    if (name_len) memcpy(writer->names + writer->names_len, name, name_len);
+    writer->offsets[writer->count] = offset;
+    writer->name_offsets[writer->count] = (uint32_t) writer->names_len;
+    writer->count++;
+    writer->names_len += name_len;
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_archive_create(const char *filename, const TagType tag_type, RfidxArchiveWriter *writer) {
+    TagLayout layout;
+    if (tag_layout(tag_type, &layout) != RFIDX_OK) {
+        memset(writer, 0, sizeof(*writer));
+        return RFIDX_UNKNOWN_ENUM_ERROR;
+    }
+
+    FILE *file = fopen(filename, "w+b");
+    if (!file) {
+        memset(writer, 0, sizeof(*writer));
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    RfidxStatus status = archive_writer_init(writer, file, tag_type);
+
+    // Written with no index, so that an archive left unclosed is not mistaken for an empty one
+    uint8_t header[RFIDX_ARCHIVE_HEADER_SIZE];
+    archive_encode_header(header, tag_type, archive_record_size(layout.header_size, layout.data_size), 0, 0, 0);
+    if (status == RFIDX_OK && fwrite(header, 1, sizeof(header), file) != sizeof(header)) {
+        status = RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    if (status != RFIDX_OK) {
+        archive_writer_release(writer);
+    }
+    return status;
+}
+
+RfidxStatus rfidx_archive_open(const char *filename, RfidxArchiveWriter *writer) {
+    memset(writer, 0, sizeof(*writer));
+
+    RfidxArchive archive;
+    RfidxStatus status = rfidx_archive_map(filename, &archive);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    FILE *file = fopen(filename, "r+b");
+    if (!file) {
+        rfidx_archive_unmap(&archive);
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    status = archive_writer_init(writer, file, archive.tag_type);
+
+    for (size_t i = 0; status == RFIDX_OK && i < archive.count; i++) {
+        const uint8_t *entry = archive.index + i * RFIDX_ARCHIVE_INDEX_ENTRY_SIZE;
+        const uint32_t name_offset = get_u32(entry + 8);
+        const uint32_t name_len = get_u32(entry + 12);
+        if ((uint64_t) name_offset + name_len > archive.names_len) {
+            status = RFIDX_FILE_FORMAT_ERROR;
+            break;
+        }
+        status = archive_add_entry(writer, get_u64(entry), archive.names + name_offset, name_len);
+    }
+    const uint64_t index_offset = RFIDX_ARCHIVE_HEADER_SIZE + (uint64_t) archive.count * archive.record_size;
+    rfidx_archive_unmap(&archive);
+
+    // New records go over the index, which is rewritten on close
+    uint8_t header[RFIDX_ARCHIVE_HEADER_SIZE];
+    archive_encode_header(header, writer->tag_type, archive_record_size(writer->header_size, writer->data_size),
+                          0, 0, 0);
+    if (status == RFIDX_OK && (fwrite(header, 1, sizeof(header), file) != sizeof(header) || fflush(file) != 0 ||
+                               ftruncate(fileno(file), (off_t) index_offset) != 0 ||
+                               fseeko(file, (off_t) index_offset, SEEK_SET) != 0)) {
+        status = RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    if (status != RFIDX_OK) {
+        archive_writer_release(writer);
+    }
+    return status;
+}
+
+RfidxStatus rfidx_archive_append(
+    RfidxArchiveWriter *writer,
+    const void *data,
+    const void *header,
+    const char *name
+) {
+    if (!writer->file || !data) {
+        return RFIDX_MEMORY_ERROR;
+    }
+
+    uint8_t *payload = writer->record + RFIDX_ARCHIVE_CRC_SIZE;
+    if (header) {
+        memcpy(payload, header, writer->header_size);
+    } else {
+        memset(payload, 0, writer->header_size);
+    }
+    memcpy(payload + writer->header_size, data, writer->data_size);
+    put_u32(writer->record, rfidx_crc32(0, payload, writer->header_size + writer->data_size));
+
+    const size_t record_size = archive_record_size(writer->header_size, writer->data_size);
+    const uint64_t offset = RFIDX_ARCHIVE_HEADER_SIZE + (uint64_t) writer->count * record_size;
+    const RfidxStatus status = archive_add_entry(writer, offset, name, name ? strlen(name) : 0);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+    if (fwrite(writer->record, 1, record_size, writer->file) != record_size) {
+        // Keep the index in step with what is in the file
+        writer->count--;
+        writer->names_len = writer->name_offsets[writer->count];
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_archive_close(RfidxArchiveWriter *writer) {
+    if (!writer->file) {
+        return RFIDX_MEMORY_ERROR;
+    }
+
+    RfidxStatus status = RFIDX_OK;
+    for (size_t i = 0; status == RFIDX_OK && i < writer->count; i++) {
+        const uint32_t end = i + 1 < writer->count ? writer->name_offsets[i + 1] : (uint32_t) writer->names_len;
+        uint8_t entry[RFIDX_ARCHIVE_INDEX_ENTRY_SIZE];
+        put_u64(entry, writer->offsets[i]);
+        put_u32(entry + 8, writer->name_offsets[i]);
+        put_u32(entry + 12, end - writer->name_offsets[i]);
+        if (fwrite(entry, 1, sizeof(entry), writer->file) != sizeof(entry)) {
+            status = RFIDX_BINARY_FILE_IO_ERROR;
+        }
+    }
+    if (status == RFIDX_OK && writer->names_len &&
+        fwrite(writer->names, 1, writer->names_len, writer->file) != writer->names_len) {
+        status = RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    // The header goes last, so the archive only becomes readable once the index is complete
+    const size_t record_size = archive_record_size(writer->header_size, writer->data_size);
+    uint8_t header[RFIDX_ARCHIVE_HEADER_SIZE];
+    archive_encode_header(header, writer->tag_type, record_size, writer->count,
+                          RFIDX_ARCHIVE_HEADER_SIZE + (uint64_t) writer->count * record_size, writer->names_len);
+    if (status == RFIDX_OK && (fflush(writer->file) != 0 || fseeko(writer->file, 0, SEEK_SET) != 0 ||
+                               fwrite(header, 1, sizeof(header), writer->file) != sizeof(header))) {
+        status = RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    FILE *file = writer->file;
+    writer->file = NULL;
+    if (fclose(file) != 0 && status == RFIDX_OK) {
+        status = RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    archive_writer_release(writer);
+    return status;
+}
+
+RfidxStatus rfidx_archive_map(const char *filename, RfidxArchive *archive) {
+    memset(archive, 0, sizeof(*archive));
+
+    RfidxStatus status = rfidx_map_file(filename, &archive->mapping);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    uint64_t count = 0;
+    uint64_t names_len = 0;
+    const uint8_t *base = archive->mapping.base;
+    status = archive_decode_header(base, archive->mapping.length, &archive->tag_type, &archive->header_size,
+                                   &archive->data_size, &count, &names_len);
+    if (status != RFIDX_OK) {
+        rfidx_archive_unmap(archive);
+        return status;
+    }
+
+    archive->record_size = archive_record_size(archive->header_size, archive->data_size);
+    archive->count = (size_t) count;
+    archive->index = base + RFIDX_ARCHIVE_HEADER_SIZE + archive->count * archive->record_size;
+    archive->names = (const char *) archive->index + archive->count * RFIDX_ARCHIVE_INDEX_ENTRY_SIZE;
+    archive->names_len = (size_t) names_len;
+    return RFIDX_OK;
+}
+
+/**
+ * @brief Check the index entry of a record and read its offset and name
+ */
+static RfidxStatus archive_index_entry(const RfidxArchive *archive, const size_t number, uint64_t *offset,
+                                       const char **name, size_t *name_len) {
+    if (number >= archive->count) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+
+    const uint8_t *entry = archive->index + number * RFIDX_ARCHIVE_INDEX_ENTRY_SIZE;
+    *offset = get_u64(entry);
+    const uint32_t name_offset = get_u32(entry + 8);
+    *name_len = get_u32(entry + 12);
+    const uint64_t records_end = (uint64_t) (archive->index - (const uint8_t *) archive->mapping.base);
+    if (*offset < RFIDX_ARCHIVE_HEADER_SIZE || *offset > records_end || records_end - *offset < archive->record_size ||
+        (uint64_t) name_offset + *name_len > archive->names_len) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    *name = archive->names + name_offset;
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_archive_get(const RfidxArchive *archive, const size_t number, RfidxArchiveRecord *record) {
+    uint64_t offset;
+    const char *name;
+    size_t name_len;
+    const RfidxStatus status = archive_index_entry(archive, number, &offset, &name, &name_len);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    const uint8_t *bytes = (const uint8_t *) archive->mapping.base + offset;
+    const uint8_t *payload = bytes + RFIDX_ARCHIVE_CRC_SIZE;
+    if (rfidx_crc32(0, payload, archive->header_size + archive->data_size) != get_u32(bytes)) {
+        return RFIDX_CHECKSUM_ERROR;
+    }
+
+    record->header = payload;
+    record->data = payload + archive->header_size;
+    record->name = name;
+    record->name_len = name_len;
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_archive_iterate(const RfidxArchive *archive, const RfidxArchiveVisitor visit, void *user) {
+    for (size_t i = 0; i < archive->count; i++) {
+        RfidxArchiveRecord record;
+        RfidxStatus status = rfidx_archive_get(archive, i, &record);
+        if (status == RFIDX_OK) {
+            status = visit(i, &record, user);
+        }
+        if (status != RFIDX_OK) {
+            return status;
+        }
+    }
+
+    return RFIDX_OK;
+}
+
+void rfidx_archive_unmap(RfidxArchive *archive) {
+    rfidx_unmap_file(&archive->mapping);
+    memset(archive, 0, sizeof(*archive));
+}
+
+RfidxStatus rfidx_archive_load_columns(const RfidxArchive *archive, RfidxColumnStore *store) {
+    RfidxStatus status = rfidx_columns_init(store, archive->tag_type, archive->count);
+    for (size_t i = 0; status == RFIDX_OK && i < archive->count; i++) {
+        RfidxArchiveRecord record;
+        status = rfidx_archive_get(archive, i, &record);
+        if (status == RFIDX_OK) {
+            status = rfidx_columns_append(store, record.data, record.header);
+        }
+    }
+
+    if (status != RFIDX_OK) {
+        rfidx_columns_free(store);
+    }
+    return status;
+}
+
+static RfidxStatus archive_pack_one(RfidxArchiveWriter *writer, const char *filename, const char *input,
+                                    const char *relative, const TagType tag_type) {
+    void *data = NULL;
+    void *header = NULL;
+    RfidxStatus status = RFIDX_OK;
+    const TagType read_type = read_tag_from_file(input, tag_type, &data, &header);
+    if (read_type == TAG_UNKNOWN || read_type == TAG_ERROR) {
+        status = read_type == TAG_UNKNOWN ? RFIDX_FILE_FORMAT_ERROR : RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    if (status == RFIDX_OK && !writer->file) {
+        status = rfidx_archive_create(filename, read_type, writer);
+    }
+    if (status == RFIDX_OK) {
+        TagLayout layout;
+        status = tag_layout(read_type, &layout);
+        if (status == RFIDX_OK &&
+            (layout.header_size != writer->header_size || layout.data_size != writer->data_size)) {
+            status = RFIDX_FILE_FORMAT_ERROR;
+        }
+    }
+    if (status == RFIDX_OK) {
+        status = rfidx_archive_append(writer, data, header, relative);
+    }
+
+    rfidx_free(data);
+    rfidx_free(header);
+    return status;
+}
+
+RfidxStatus rfidx_archive_pack(
+    const char *input_dir,
+    const char *filename,
+    const TagType tag_type,
+    const RfidxBatchCallback on_result,
+    void *user,
+    RfidxBatchSummary *summary
+) {
+    if (summary) memset(summary, 0, sizeof(*summary));
+
+    RfidxFileList files;
+    RfidxStatus status = list_files(input_dir, &files);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    // Without a type, the archive is created from the first dump that can be read
+    RfidxArchiveWriter writer = {0};
+    if (tag_type != TAG_UNSPECIFIED) {
+        status = rfidx_archive_create(filename, tag_type, &writer);
+    }
+
+    for (size_t i = 0; status == RFIDX_OK && i < files.count; i++) {
+        char input[PATH_MAX];
+        RfidxStatus result = RFIDX_BUFFER_SIZE_ERROR;
+        if (snprintf(input, sizeof(input), "%s/%s", input_dir, files.paths[i]) < (int) sizeof(input)) {
+            result = archive_pack_one(&writer, filename, input, files.paths[i], tag_type);
+        }
+        // Running out of space to write is fatal, unlike a dump that cannot be read
+        if (result == RFIDX_BINARY_FILE_IO_ERROR && writer.file && ferror(writer.file)) {
+            status = result;
+        }
+
+        if (summary) {
+            if (result == RFIDX_OK) {
+                summary->converted++;
+            } else {
+                summary->failed++;
+            }
+        }
+        if (on_result) {
+            on_result(files.paths[i], filename, result, user);
+        }
+    }
+    free_file_list(&files);
+
+    if (!writer.file) {
+        return status == RFIDX_OK ? RFIDX_FILE_FORMAT_ERROR : status;
+    }
+    if (status != RFIDX_OK) {
+        archive_writer_release(&writer);
+        return status;
+    }
+    return rfidx_archive_close(&writer);
+}
+
+/**
+ * @brief Output path of a record
+ *
+ * The name comes from the archive, so one that could leave the output directory is refused.
+ */
+static RfidxStatus archive_output_path(const char *output_dir, const char *record_name, const size_t record_name_len,
+                                       const size_t number, const FileFormat format, char *out, const size_t cap) {
+    char name[PATH_MAX];
+    if (record_name_len == 0) {
+        snprintf(name, sizeof(name), "%zu", number);
+    } else {
+        if (record_name_len >= sizeof(name) || memchr(record_name, '\0', record_name_len)) {
+            return RFIDX_FILE_FORMAT_ERROR;
+        }
+        memcpy(name, record_name, record_name_len);
+        name[record_name_len] = '\0';
+    }
+    if (name[0] == '/' || strcmp(name, "..") == 0 || strncmp(name, "../", 3) == 0 || strstr(name, "/../") ||
+        (strlen(name) >= 3 && strcmp(name + strlen(name) - 3, "/..") == 0)) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    char template[PATH_MAX];
+    if (snprintf(template, sizeof(template), "%s/%.*s.{ext}", output_dir, (int) output_stem_length(name), name) >=
+        (int) sizeof(template)) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+    return expand_output_template(template, format, out, cap);
+}
+
+typedef struct {
+    const RfidxArchive *archive;
+    const char *output_dir;
+    FileFormat format;
+    RfidxBatchCallback on_result;
+    void *user;
+    RfidxBatchSummary *summary;
+    const bool *collides;       /**< Records whose output belongs to an earlier record */
+} ArchiveUnpack;
+
+/**
+ * @brief Find the records whose output would replace the output of an earlier record
+ *
+ * Only the index is read, so the records are not checked twice. A record that cannot be named
+ * gets an empty output. Such records fail when they are unpacked, so it does not matter that
+ * their outputs are the same.
+ */
+static RfidxStatus archive_find_collisions(const RfidxArchive *archive, const char *output_dir,
+                                           const FileFormat format, bool *collides) {
+    char **outputs = rfidx_malloc(sizeof(char *) * archive->count);
+    if (!outputs) {
+        return RFIDX_MEMORY_ERROR;
+    }
+
+    RfidxStatus status = RFIDX_OK;
+    size_t named = 0;
+    for (; named < archive->count; named++) {
+        char output[PATH_MAX];
+        uint64_t offset;
+        const char *name;
+        size_t name_len;
+        if (archive_index_entry(archive, named, &offset, &name, &name_len) != RFIDX_OK ||
+            archive_output_path(output_dir, name, name_len, named, format, output, sizeof(output)) != RFIDX_OK) {
+            output[0] = '\0';
+        }
+
+        const size_t len = strlen(output) + 1;
+        outputs[named] = rfidx_malloc(len);
+        if (!outputs[named]) {
+            status = RFIDX_MEMORY_ERROR;
+            break;
+        }
+        memcpy(outputs[named], output, len);
+    }
+
+    if (status == RFIDX_OK) {
+        status = find_output_collisions((const char *const *) outputs, archive->count, collides);
+    }
+
+    for (size_t i = 0; i < named; i++) rfidx_free(outputs[i]);
+    rfidx_free(outputs);
+    return status;
+}
+
+static void archive_unpack_one(const ArchiveUnpack *unpack, const size_t number) {
+    char output[PATH_MAX];
+    output[0] = '\0';
+
+    RfidxArchiveRecord record = {0};
+    RfidxStatus status = rfidx_archive_get(unpack->archive, number, &record);
+    if (status == RFIDX_OK) {
+        status = archive_output_path(unpack->output_dir, record.name, record.name_len, number, unpack->format, output,
+                                     sizeof(output));
+    }
+    // Records named the same but for their extension would be written over each other
+    if (status == RFIDX_OK && unpack->collides[number]) {
+        status = RFIDX_OUTPUT_COLLISION_ERROR;
+    }
+    if (status == RFIDX_OK) {
+        status = make_parent_directories(output);
+    }
+    if (status == RFIDX_OK) {
+        status = write_tag_to_file_atomic(output, record.data, record.header, unpack->archive->tag_type,
+                                          unpack->format);
+    }
+
+    if (unpack->summary) {
+        if (status == RFIDX_OK) {
+            unpack->summary->converted++;
+        } else {
+            unpack->summary->failed++;
+        }
+    }
+    if (unpack->on_result) {
+        char input[64];
+        snprintf(input, sizeof(input), "#%zu", number);
+        unpack->on_result(input, output[0] ? output : NULL, status, unpack->user);
+    }
+}
+
+RfidxStatus rfidx_archive_unpack(
+    const char *filename,
+    const char *output_dir,
+    const FileFormat format,
+    const RfidxBatchCallback on_result,
+    void *user,
+    RfidxBatchSummary *summary
+) {
+    if (summary) memset(summary, 0, sizeof(*summary));
+
+    RfidxArchive archive;
+    RfidxStatus status = rfidx_archive_map(filename, &archive);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    bool *collides = rfidx_malloc(sizeof(bool) * (archive.count ? archive.count : 1));
+    status = collides ? archive_find_collisions(&archive, output_dir, format, collides) : RFIDX_MEMORY_ERROR;
+    if (status == RFIDX_OK && mkdir(output_dir, 0777) != 0 && errno != EEXIST) {
+        status = RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    // A damaged record is reported and skipped, unlike in rfidx_archive_iterate()
+    const ArchiveUnpack unpack = {&archive, output_dir, format, on_result, user, summary, collides};
+    for (size_t i = 0; status == RFIDX_OK && i < archive.count; i++) {
+        archive_unpack_one(&unpack, i);
+    }
+
+    rfidx_free(collides);
+    rfidx_archive_unmap(&archive);
+    return status;
+}
@@ -0,0 +1,283 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "librfidx/batch.h"
+#include "librfidx/rfidx.h"
+#include "librfidx/cache.h"
+
+/**
+ * @brief Work queue of one worker
+ *
+ * All jobs are known before the workers start, so a deque is a slice of the job list. The
+ * owner takes jobs from the bottom and other workers steal from the top, which keeps the
+ * owner and a thief apart until the slice is almost empty.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    size_t top;                 /**< Next job to steal */
+    size_t bottom;              /**< One past the next job for the owner */
+} BatchDeque;
+
+typedef struct {
+    const char *input_dir;
+    const char *output_dir;
+    const RfidxBatchOptions *options;
+    const RfidxFileList *jobs;
+    const bool *collides;       /**< Jobs whose output belongs to an earlier job */
+    BatchDeque *deques;
+    unsigned int threads;
+    pthread_mutex_t report_lock;
+    RfidxBatchSummary summary;
+} BatchShared;
+
+typedef struct {
+    BatchShared *shared;
+    unsigned int id;
+    RfidxContext ctx;
+} BatchWorker;
+
+static bool batch_next_job(BatchWorker *worker, size_t *job) {
+    BatchShared *shared = worker->shared;
+
+    BatchDeque *own = &shared->deques[worker->id];
+    pthread_mutex_lock(&own->lock);
+    const bool found = own->top < own->bottom;
+    if (found) *job = --own->bottom;
+    pthread_mutex_unlock(&own->lock);
+    if (found) return true;
+
+    // No job is ever added, so once every deque is empty the worker is done
+    for (unsigned int i = 1; i < shared->threads; i++) {
+        BatchDeque *victim = &shared->deques[(worker->id + i) % shared->threads];
+        pthread_mutex_lock(&victim->lock);
+        const bool stolen = victim->top < victim->bottom;
+        if (stolen) *job = victim->top++;
+        pthread_mutex_unlock(&victim->lock);
+        if (stolen) return true;
+    }
+
+    return false;
+}
+
+static RfidxStatus batch_output_path(const BatchShared *shared, const char *relative, char *out, const size_t cap) {
+    const char *extension = NULL;
+    switch (shared->options->output_format) {
+        case FORMAT_BINARY:
+            extension = "bin";
+            break;
+        case FORMAT_JSON:
+            extension = "json";
+            break;
+        case FORMAT_NFC:
+            extension = "nfc";
+            break;
+        default:
+            return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    const int stem_len = (int) output_stem_length(relative);
+    if (snprintf(out, cap, "%s/%.*s.%s", shared->output_dir, stem_len, relative, extension) >= (int) cap) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+    return RFIDX_OK;
+}
+
+static RfidxStatus batch_convert_one(BatchWorker *worker, const size_t job, char *output, const size_t cap,
+                                     bool *cached) {
+    const BatchShared *shared = worker->shared;
+    const RfidxBatchOptions *options = shared->options;
+    const char *relative = shared->jobs->paths[job];
+
+    char input[PATH_MAX];
+    if (snprintf(input, sizeof(input), "%s/%s", shared->input_dir, relative) >= (int) sizeof(input)) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+    RfidxStatus status = batch_output_path(shared, relative, output, cap);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+    // Converting it would replace the output of another input, named the same but for its extension
+    if (shared->collides[job]) {
+        return RFIDX_OUTPUT_COLLISION_ERROR;
+    }
+
+    if (options->cache_dir && rfidx_cache_applies(options->command)) {
+        status = make_parent_directories(output);
+        if (status != RFIDX_OK) {
+            return status;
+        }
+        return rfidx_convert_cached(&worker->ctx, options->cache_dir, input, options->input_type, options->command,
+                                    options->output_format, options->retail_key, output, cached);
+    }
+
+    void *data = NULL;
+    void *header = NULL;
+    const TagType tag_type = read_tag_from_file(input, options->input_type, &data, &header);
+    if (tag_type == TAG_UNKNOWN || tag_type == TAG_ERROR) {
+        status = tag_type == TAG_UNKNOWN ? RFIDX_FILE_FORMAT_ERROR : RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    if (status == RFIDX_OK && options->command != TRANSFORM_NONE) {
+        status = transform_tag_ctx(
+            &worker->ctx, tag_type, options->command, &data, &header, options->uuid, options->retail_key);
+    }
+    if (status == RFIDX_OK) {
+        status = make_parent_directories(output);
+    }
+    if (status == RFIDX_OK) {
+        status = write_tag_to_file_atomic(output, data, header, tag_type, options->output_format);
+    }
+
+    rfidx_free(data);
+    rfidx_free(header);
+    return status;
+}
+
+static void *batch_worker_main(void *arg) {
+    BatchWorker *worker = arg;
+    BatchShared *shared = worker->shared;
+
+    size_t job;
+    while (batch_next_job(worker, &job)) {
+        const char *relative = shared->jobs->paths[job];
+        char output[PATH_MAX];
+        output[0] = '\0';
+        bool cached = false;
+        const RfidxStatus status = batch_convert_one(worker, job, output, sizeof(output), &cached);
+
+        pthread_mutex_lock(&shared->report_lock);
+        if (status == RFIDX_OK) {
+            shared->summary.converted++;
+            if (cached) shared->summary.cached++;
+        } else {
+            shared->summary.failed++;
+        }
+        if (shared->options->on_result) {
+            shared->options->on_result(relative, output[0] ? output : NULL, status, shared->options->user);
+        }
+        pthread_mutex_unlock(&shared->report_lock);
+    }
+
+    return NULL;
+}
+
+RfidxStatus rfidx_batch_convert(
+    const char *input_dir,
+    const char *output_dir,
+    const RfidxBatchOptions *options,
+    RfidxBatchSummary *summary
+) {
+    if (summary) {
+        summary->converted = 0;
+        summary->failed = 0;
+        summary->cached = 0;
+    }
+    if (options->output_format != FORMAT_BINARY && options->output_format != FORMAT_JSON &&
+        options->output_format != FORMAT_NFC) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    // Generating would replace every input with the same blank tag
+    if (options->command == TRANSFORM_GENERATE) {
+        return RFIDX_UNKNOWN_ENUM_ERROR;
+    }
+
+    unsigned int threads = options->threads;
+    if (threads == 0) {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (unsigned int) online : 1;
+    }
+    if (threads > RFIDX_BATCH_MAX_THREADS) threads = RFIDX_BATCH_MAX_THREADS;
+
+    RfidxFileList jobs;
+    RfidxStatus status = list_files(input_dir, &jobs);
+    if (status != RFIDX_OK || jobs.count == 0) {
+        free_file_list(&jobs);
+        return status;
+    }
+    if (threads > jobs.count) threads = (unsigned int) jobs.count;
+
+    bool *collides = rfidx_malloc(sizeof(bool) * jobs.count);
+    status = collides ? find_output_collisions((const char *const *) jobs.paths, jobs.count, collides)
+                      : RFIDX_MEMORY_ERROR;
+    if (status == RFIDX_OK && mkdir(output_dir, 0777) != 0 && errno != EEXIST) {
+        status = RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    if (status != RFIDX_OK) {
+        rfidx_free(collides);
+        free_file_list(&jobs);
+        return status;
+    }
+
+    BatchShared shared = {
+        .input_dir = input_dir,
+        .output_dir = output_dir,
+        .options = options,
+        .jobs = &jobs,
+        .collides = collides,
+        .threads = threads,
+    };
+    shared.deques = rfidx_malloc(sizeof(BatchDeque) * threads);
+    BatchWorker *workers = rfidx_malloc(sizeof(BatchWorker) * threads);
+    pthread_t *handles = rfidx_malloc(sizeof(pthread_t) * threads);
+    if (!shared.deques || !workers || !handles) {
+        rfidx_free(shared.deques);
+        rfidx_free(workers);
+        rfidx_free(handles);
+        rfidx_free(collides);
+        free_file_list(&jobs);
+        return RFIDX_MEMORY_ERROR;
+    }
+    pthread_mutex_init(&shared.report_lock, NULL);
+
+    // Contiguous slices keep a worker on neighbouring files, which tend to share directories
+    for (unsigned int i = 0; i < threads; i++) {
+        pthread_mutex_init(&shared.deques[i].lock, NULL);
+        shared.deques[i].top = jobs.count * i / threads;
+        shared.deques[i].bottom = jobs.count * (i + 1) / threads;
+
+        workers[i].shared = &shared;
+        workers[i].id = i;
+        rfidx_context_init(&workers[i].ctx);
+    }
+
+    unsigned int started = 0;
+    for (; started < threads; started++) {
+        if (pthread_create(&handles[started], NULL, batch_worker_main, &workers[started]) != 0) break;
+    }
+    if (started == 0) {
+        status = RFIDX_MEMORY_ERROR;
+    }
+    // Jobs queued for a worker that did not start are stolen by the others
+    for (unsigned int i = 0; i < started; i++) {
+        pthread_join(handles[i], NULL);
+    }
+
+    for (unsigned int i = 0; i < threads; i++) {
+        rfidx_context_free(&workers[i].ctx);
+        pthread_mutex_destroy(&shared.deques[i].lock);
+    }
+    pthread_mutex_destroy(&shared.report_lock);
+
+    if (summary) *summary = shared.summary;
+
+    rfidx_free(shared.deques);
+    rfidx_free(workers);
+    rfidx_free(handles);
+    rfidx_free(collides);
+    free_file_list(&jobs);
+    return status;
+}
@@ -0,0 +1,208 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "mbedtls/sha256.h"
+#include "librfidx/cache.h"
+#include "librfidx/rfidx.h"
+#include "librfidx/detect.h"
+
+bool rfidx_cache_applies(const TransformCommand command) {
+    return command == TRANSFORM_NONE || command == TRANSFORM_WIPE;
+}
+
+void rfidx_cache_key(
+    const uint8_t *input,
+    const size_t length,
+    const TagType tag_type,
+    const TransformCommand command,
+    const FileFormat format,
+    uint8_t key[RFIDX_CACHE_KEY_SIZE]
+) {
+    // Fixed width, so the parameters cannot be confused with the end of the input
+    const uint8_t parameters[4] = {
+        (uint8_t) tag_type,
+        (uint8_t) command,
+        (uint8_t) format,
+        RFIDX_CACHE_VERSION,
+    };
+
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    mbedtls_sha256_update(&sha, input, length);
+    mbedtls_sha256_update(&sha, parameters, sizeof(parameters));
+    mbedtls_sha256_finish(&sha, key);
+    mbedtls_sha256_free(&sha);
+}
+
+/**
+ * @brief Path of an entry
+ *
+ * Entries are spread over 256 subdirectories by the first byte of their key, which keeps
+ * directories small enough to scan for a corpus of millions of dumps.
+ */
+static RfidxStatus cache_entry_path(const char *cache_dir, const uint8_t key[RFIDX_CACHE_KEY_SIZE], char *out,
+                                    const size_t cap, const bool create) {
+    char hex[RFIDX_CACHE_KEY_SIZE * 2 + 1];
+    bytes_to_hex(key, RFIDX_CACHE_KEY_SIZE, hex);
+
+    if (snprintf(out, cap, "%s/%.2s", cache_dir, hex) >= (int) cap) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+    if (create) {
+        if ((mkdir(cache_dir, 0777) != 0 && errno != EEXIST) || (mkdir(out, 0777) != 0 && errno != EEXIST)) {
+            return RFIDX_BINARY_FILE_IO_ERROR;
+        }
+    }
+    if (snprintf(out, cap, "%s/%.2s/%s", cache_dir, hex, hex + 2) >= (int) cap) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_cache_lookup(
+    const char *cache_dir,
+    const uint8_t key[RFIDX_CACHE_KEY_SIZE],
+    char **output,
+    size_t *length
+) {
+    char path[PATH_MAX];
+    const RfidxStatus status = cache_entry_path(cache_dir, key, path, sizeof(path), false);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    return read_file(path, output, length, RFIDX_BINARY_FILE_IO_ERROR);
+}
+
+RfidxStatus rfidx_cache_store(
+    const char *cache_dir,
+    const uint8_t key[RFIDX_CACHE_KEY_SIZE],
+    const void *output,
+    const size_t length
+) {
+    char path[PATH_MAX];
+    const RfidxStatus status = cache_entry_path(cache_dir, key, path, sizeof(path), true);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    return write_file_atomic(path, output, length);
+}
+
+/**
+ * @brief Parse, transform and serialize a tag held in memory
+ * @param serialized Set to the output, allocated WITHIN THE FUNCTION. Must be freed with rfidx_free.
+ * @param cacheable Set to false if the output must not be cached.
+ */
+static RfidxStatus cache_convert_buffer(
+    RfidxContext *ctx,
+    const char *buffer,
+    const size_t length,
+    TagType tag_type,
+    const TransformCommand command,
+    const FileFormat format,
+    const char *retail_key,
+    char **serialized,
+    size_t *serialized_len,
+    bool *cacheable
+) {
+    FileFormat input_format;
+    TagType detected;
+    if (rfidx_detect_tag((const uint8_t *) buffer, length, length, &detected, &input_format) != RFIDX_OK) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    if (tag_type == TAG_UNSPECIFIED) {
+        tag_type = detected;
+    }
+    // The output of an Amiibo transform depends on the retail key, which is not part of the key
+    *cacheable = tag_type != AMIIBO || command == TRANSFORM_NONE;
+
+    void *data = NULL;
+    void *header = NULL;
+    RfidxStatus status = RFIDX_OK;
+    tag_type = read_tag_from_buffer(buffer, length, tag_type, input_format, &data, &header);
+    if (tag_type == TAG_UNKNOWN || tag_type == TAG_ERROR) {
+        status = tag_type == TAG_UNKNOWN ? RFIDX_FILE_FORMAT_ERROR : RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    if (status == RFIDX_OK && command != TRANSFORM_NONE) {
+        status = transform_tag_ctx(ctx, tag_type, command, &data, &header, NULL, retail_key);
+    }
+
+    if (status == RFIDX_OK) {
+        status = serialize_tag(data, header, tag_type, format, serialized, serialized_len);
+    }
+
+    rfidx_free(data);
+    rfidx_free(header);
+    return status;
+}
+
+RfidxStatus rfidx_convert_cached(
+    RfidxContext *ctx,
+    const char *cache_dir,
+    const char *input,
+    const TagType tag_type,
+    const TransformCommand command,
+    const FileFormat format,
+    const char *retail_key,
+    const char *output,
+    bool *hit
+) {
+    if (hit) *hit = false;
+    if (!rfidx_cache_applies(command)) {
+        return RFIDX_UNKNOWN_ENUM_ERROR;
+    }
+
+    char *buffer = NULL;
+    size_t length = 0;
+    RfidxStatus status = read_file(input, &buffer, &length, RFIDX_BINARY_FILE_IO_ERROR);
+    if (status != RFIDX_OK) {
+        rfidx_free(buffer);
+        return status;
+    }
+
+    uint8_t key[RFIDX_CACHE_KEY_SIZE];
+    rfidx_cache_key((const uint8_t *) buffer, length, tag_type, command, format, key);
+
+    char *cached = NULL;
+    size_t cached_len = 0;
+    if (rfidx_cache_lookup(cache_dir, key, &cached, &cached_len) == RFIDX_OK) {
+        rfidx_free(buffer);
+        status = write_file_atomic(output, cached, cached_len);
+        rfidx_free(cached);
+        if (hit) *hit = status == RFIDX_OK;
+        return status;
+    }
+    rfidx_free(cached);
+
+    char *serialized = NULL;
+    size_t serialized_len = 0;
+    bool cacheable = true;
+    status = cache_convert_buffer(
+        ctx, buffer, length, tag_type, command, format, retail_key, &serialized, &serialized_len, &cacheable);
+    rfidx_free(buffer);
+
+    if (status == RFIDX_OK) {
+        status = write_file_atomic(output, serialized, serialized_len);
+    }
+    // A cache that cannot be written only costs the next run its hit
+    if (status == RFIDX_OK && cacheable) {
+        rfidx_cache_store(cache_dir, key, serialized, serialized_len);
+    }
+    rfidx_free(serialized);
+
+    return status;
+}
@@ -0,0 +1,323 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <cJSON.h>
+#include "librfidx/manifest.h"
+#include "librfidx/rfidx.h"
+#include "librfidx/application/amiibo.h"
+
+/**
+ * @brief Stage a job has reached
+ *
+ * Each stage owns the slots at its own stage, and hands a slot on by advancing it.
+ */
+typedef enum {
+    MANIFEST_SLOT_FREE,         /**< Owned by the reader */
+    MANIFEST_SLOT_READ,         /**< Owned by the transformer */
+    MANIFEST_SLOT_TRANSFORMED,  /**< Owned by the writer */
+} ManifestSlotStage;
+
+typedef struct {
+    ManifestSlotStage stage;
+    bool end;                   /**< The manifest has no more jobs */
+    size_t line;
+    cJSON *tree;                /**< The parsed line, which the job strings point into */
+    const char *input;
+    const char *output;
+    const char *uuid;
+    TagType tag_type;
+    TransformCommand command;
+    FileFormat output_format;
+    void *data;
+    void *header;
+    RfidxStatus status;
+} ManifestSlot;
+
+typedef struct {
+    RfidxContext *ctx;
+    FILE *manifest;
+    const DumpedKeys *dumped_keys;
+    RfidxStatus read_status;    /**< Set by the reader if the manifest itself could not be read */
+    ManifestSlot slots[RFIDX_MANIFEST_PIPELINE_DEPTH];
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} ManifestPipeline;
+
+static ManifestSlot *manifest_wait(ManifestPipeline *pipeline, const size_t index, const ManifestSlotStage stage) {
+    ManifestSlot *slot = &pipeline->slots[index];
+
+    pthread_mutex_lock(&pipeline->lock);
+    while (slot->stage != stage) {
+        pthread_cond_wait(&pipeline->cond, &pipeline->lock);
+    }
+    pthread_mutex_unlock(&pipeline->lock);
+
+    return slot;
+}
+
+static void manifest_advance(ManifestPipeline *pipeline, ManifestSlot *slot, const ManifestSlotStage stage) {
+    pthread_mutex_lock(&pipeline->lock);
+    slot->stage = stage;
+    pthread_cond_broadcast(&pipeline->cond);
+    pthread_mutex_unlock(&pipeline->lock);
+}
+
+/**
+ * @brief Clear a written slot and hand it back to the reader
+ *
+ * The reset happens under the lock, as the reader is waiting on the stage of the slot.
+ */
+static void manifest_release(ManifestPipeline *pipeline, ManifestSlot *slot) {
+    pthread_mutex_lock(&pipeline->lock);
+    memset(slot, 0, sizeof(ManifestSlot));
+    slot->stage = MANIFEST_SLOT_FREE;
+    pthread_cond_broadcast(&pipeline->cond);
+    pthread_mutex_unlock(&pipeline->lock);
+}
+
+static const char *manifest_string(const cJSON *tree, const char *name, RfidxStatus *status) {
+    const cJSON *item = cJSON_GetObjectItem(tree, name);
+    if (!item) {
+        return NULL;
+    }
+    if (!cJSON_IsString(item)) {
+        *status = RFIDX_JSON_PARSE_ERROR;
+        return NULL;
+    }
+
+    return item->valuestring;
+}
+
+static RfidxStatus manifest_parse_job(ManifestSlot *slot, const char *line) {
+    slot->tree = cJSON_Parse(line);
+    if (!slot->tree) {
+        return RFIDX_JSON_PARSE_ERROR;
+    }
+
+    RfidxStatus status = RFIDX_OK;
+    slot->input = manifest_string(slot->tree, "input", &status);
+    slot->output = manifest_string(slot->tree, "output", &status);
+    slot->uuid = manifest_string(slot->tree, "uuid", &status);
+    const char *input_type = manifest_string(slot->tree, "input_type", &status);
+    const char *transform = manifest_string(slot->tree, "transform", &status);
+    const char *output_format = manifest_string(slot->tree, "output_format", &status);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    slot->tag_type = input_type ? string_to_tag_type(input_type) : TAG_UNSPECIFIED;
+    slot->command = string_to_transform_command(transform);
+    slot->output_format = output_format ? string_to_file_format(output_format) : FORMAT_UNKNOWN;
+    if (slot->tag_type == TAG_UNKNOWN || (transform && slot->command == TRANSFORM_NONE)) {
+        return RFIDX_UNKNOWN_ENUM_ERROR;
+    }
+    if (slot->output_format != FORMAT_BINARY && slot->output_format != FORMAT_JSON &&
+        slot->output_format != FORMAT_NFC) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    if (!slot->output) {
+        return RFIDX_JSON_PARSE_ERROR;
+    }
+    // Only a generated tag needs no input, and then its type must be given
+    if (!slot->input && (slot->command != TRANSFORM_GENERATE || !input_type)) {
+        return RFIDX_JSON_PARSE_ERROR;
+    }
+
+    return RFIDX_OK;
+}
+
+static RfidxStatus manifest_read_job(ManifestSlot *slot, const char *line) {
+    const RfidxStatus status = manifest_parse_job(slot, line);
+    if (status != RFIDX_OK || !slot->input) {
+        return status;
+    }
+
+    const TagType tag_type = read_tag_from_file(slot->input, slot->tag_type, &slot->data, &slot->header);
+    if (tag_type == TAG_UNKNOWN || tag_type == TAG_ERROR) {
+        return tag_type == TAG_UNKNOWN ? RFIDX_FILE_FORMAT_ERROR : RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    slot->tag_type = tag_type;
+
+    return RFIDX_OK;
+}
+
+static bool manifest_blank(const char *line) {
+    for (; *line; line++) {
+        if (*line != ' ' && *line != '\t' && *line != '\r' && *line != '\n') return false;
+    }
+    return true;
+}
+
+static void *manifest_reader_main(void *arg) {
+    ManifestPipeline *pipeline = arg;
+    char *line = NULL;
+    size_t line_cap = 0;
+    size_t line_number = 0;
+    size_t index = 0;
+
+    while (getline(&line, &line_cap, pipeline->manifest) >= 0) {
+        line_number++;
+        if (manifest_blank(line)) continue;
+
+        ManifestSlot *slot = manifest_wait(pipeline, index, MANIFEST_SLOT_FREE);
+        slot->line = line_number;
+        slot->status = manifest_read_job(slot, line);
+        manifest_advance(pipeline, slot, MANIFEST_SLOT_READ);
+        index = (index + 1) % RFIDX_MANIFEST_PIPELINE_DEPTH;
+    }
+    if (ferror(pipeline->manifest)) {
+        pipeline->read_status = RFIDX_JSON_FILE_IO_ERROR;
+    }
+    // getline() allocates with the C library
+    free(line);
+
+    ManifestSlot *slot = manifest_wait(pipeline, index, MANIFEST_SLOT_FREE);
+    slot->end = true;
+    manifest_advance(pipeline, slot, MANIFEST_SLOT_READ);
+
+    return NULL;
+}
+
+static void manifest_transform_job(const ManifestPipeline *pipeline, ManifestSlot *slot) {
+    if (!slot->end && slot->status == RFIDX_OK && slot->command != TRANSFORM_NONE) {
+        slot->status = transform_tag_with_keys_ctx(
+            pipeline->ctx, slot->tag_type, slot->command, &slot->data, &slot->header, slot->uuid,
+            pipeline->dumped_keys);
+    }
+}
+
+static void *manifest_transformer_main(void *arg) {
+    ManifestPipeline *pipeline = arg;
+
+    for (size_t index = 0;; index = (index + 1) % RFIDX_MANIFEST_PIPELINE_DEPTH) {
+        ManifestSlot *slot = manifest_wait(pipeline, index, MANIFEST_SLOT_READ);
+        const bool end = slot->end;
+        manifest_transform_job(pipeline, slot);
+        manifest_advance(pipeline, slot, MANIFEST_SLOT_TRANSFORMED);
+        if (end) break;
+    }
+
+    return NULL;
+}
+
+static RfidxStatus manifest_write_job(const ManifestSlot *slot) {
+    char output[PATH_MAX];
+    if (snprintf(output, sizeof(output), "%s", slot->output) >= (int) sizeof(output)) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+
+    const RfidxStatus status = make_parent_directories(output);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+    return write_tag_to_file_atomic(output, slot->data, slot->header, slot->tag_type, slot->output_format);
+}
+
+/**
+ * @brief The last stage, run on the calling thread
+ * @param transform Also run the transform stage, when it has no thread of its own.
+ */
+static void manifest_write_all(ManifestPipeline *pipeline, const bool transform, const RfidxManifestOptions *options,
+                               RfidxBatchSummary *summary) {
+    for (size_t index = 0;; index = (index + 1) % RFIDX_MANIFEST_PIPELINE_DEPTH) {
+        ManifestSlot *slot = manifest_wait(pipeline, index,
+                                           transform ? MANIFEST_SLOT_READ : MANIFEST_SLOT_TRANSFORMED);
+        if (slot->end) break;
+        if (transform) {
+            manifest_transform_job(pipeline, slot);
+        }
+
+        if (slot->status == RFIDX_OK) {
+            slot->status = manifest_write_job(slot);
+        }
+        if (slot->status == RFIDX_OK) {
+            summary->converted++;
+        } else {
+            summary->failed++;
+        }
+        if (options->on_result) {
+            const bool parsed = slot->output != NULL;
+            options->on_result(slot->line, parsed ? slot->input : NULL, parsed ? slot->output : NULL, slot->status,
+                               options->user);
+        }
+
+        rfidx_free(slot->data);
+        rfidx_free(slot->header);
+        cJSON_Delete(slot->tree);
+        manifest_release(pipeline, slot);
+    }
+}
+
+RfidxStatus rfidx_run_manifest(
+    RfidxContext *ctx,
+    FILE *manifest,
+    const RfidxManifestOptions *options,
+    RfidxBatchSummary *summary
+) {
+    RfidxBatchSummary counts = {0};
+    if (summary) *summary = counts;
+
+    // Every Amiibo job shares the key, so it is read once rather than per job
+    DumpedKeys *dumped_keys = NULL;
+    if (options->retail_key) {
+        dumped_keys = rfidx_malloc(sizeof(DumpedKeys));
+        if (!dumped_keys) {
+            return RFIDX_MEMORY_ERROR;
+        }
+        if (amiibo_load_dumped_keys(options->retail_key, dumped_keys) != RFIDX_OK) {
+            rfidx_free(dumped_keys);
+            return RFIDX_NUMERICAL_OPERATION_FAILED;
+        }
+    }
+
+    ManifestPipeline *pipeline = rfidx_malloc(sizeof(ManifestPipeline));
+    if (!pipeline) {
+        rfidx_free(dumped_keys);
+        return RFIDX_MEMORY_ERROR;
+    }
+    memset(pipeline, 0, sizeof(ManifestPipeline));
+    pipeline->ctx = ctx;
+    pipeline->manifest = manifest;
+    pipeline->dumped_keys = dumped_keys;
+    pipeline->read_status = RFIDX_OK;
+    pthread_mutex_init(&pipeline->lock, NULL);
+    pthread_cond_init(&pipeline->cond, NULL);
+
+    RfidxStatus status = RFIDX_OK;
+    pthread_t reader;
+    pthread_t transformer;
+    if (pthread_create(&reader, NULL, manifest_reader_main, pipeline) != 0) {
+        status = RFIDX_MEMORY_ERROR;
+    } else {
+        // Without a thread for it, the transforms run between the writes
+        const bool separate = pthread_create(&transformer, NULL, manifest_transformer_main, pipeline) == 0;
+        manifest_write_all(pipeline, !separate, options, &counts);
+        if (separate) {
+            pthread_join(transformer, NULL);
+        }
+        pthread_join(reader, NULL);
+        status = pipeline->read_status;
+    }
+
+    pthread_cond_destroy(&pipeline->cond);
+    pthread_mutex_destroy(&pipeline->lock);
+    rfidx_free(pipeline);
+    if (dumped_keys) {
+        memset(dumped_keys, 0, sizeof(DumpedKeys));
+        rfidx_free(dumped_keys);
+    }
+    if (summary) *summary = counts;
+
+    return status;
+}
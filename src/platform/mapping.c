@@ -0,0 +1,91 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "librfidx/mapping.h"
+
+static RfidxStatus rfidx_map(const char *filename, const bool writable, RfidxMapping *mapping) {
+    mapping->base = NULL;
+    mapping->length = 0;
+    mapping->writable = false;
+
+    const int fd = open(filename, (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+    if (fd < 0) {
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    if (st.st_size == 0) {
+        // Zero-length mappings are not allowed, and no dump is empty anyway
+        close(fd);
+        return RFIDX_BINARY_FILE_SIZE_ERROR;
+    }
+
+    void *base = mmap(
+        NULL,
+        (size_t) st.st_size,
+        writable ? PROT_READ | PROT_WRITE : PROT_READ,
+        writable ? MAP_SHARED : MAP_PRIVATE,
+        fd,
+        0
+    );
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if (base == MAP_FAILED) {
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    mapping->base = base;
+    mapping->length = (size_t) st.st_size;
+    mapping->writable = writable;
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_map_file(const char *filename, RfidxMapping *mapping) {
+    return rfidx_map(filename, false, mapping);
+}
+
+RfidxStatus rfidx_map_file_writable(const char *filename, RfidxMapping *mapping) {
+    return rfidx_map(filename, true, mapping);
+}
+
+RfidxStatus rfidx_sync_mapping(const RfidxMapping *mapping, const size_t offset, const size_t length) {
+    if (!mapping->writable || offset > mapping->length || length > mapping->length - offset) {
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    if (length == 0) {
+        return RFIDX_OK;
+    }
+
+    // msync works on whole pages, starting at a page boundary
+    const size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    const size_t start = offset - offset % page_size;
+    if (msync((uint8_t *) mapping->base + start, offset + length - start, MS_SYNC) != 0) {
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    return RFIDX_OK;
+}
+
+void rfidx_unmap_file(RfidxMapping *mapping) {
+    if (mapping->base) {
+        munmap(mapping->base, mapping->length);
+    }
+
+    mapping->base = NULL;
+    mapping->length = 0;
+    mapping->writable = false;
+}
@@ -30,17 +30,28 @@ RfidxStatus mfc1k_load_from_binary(const char *filename, Mfc1kData *mfc1k, MfcMe
 
 RfidxStatus mfc1k_save_to_binary(const char *filename, const Mfc1kData *mfc1k,
                                  const MfcMetadataHeader *header) {
-    uint8_t *buffer = mfc1k_serialize_binary(mfc1k, header);
-    const size_t length = sizeof(Mfc1kData);
+    // Binary dumps carry no header, so the data is the whole file
+    const struct iovec iov = {
+        .iov_base = (void *) mfc1k,
+        .iov_len = sizeof(Mfc1kData),
+    };
 
-    const RfidxStatus status = write_file(
-        filename,
-        (const char *) buffer,
-        length,
-        true,
-        RFIDX_BINARY_FILE_IO_ERROR);
-    free(buffer);
-    return status;
+    return write_file_vectored(filename, &iov, 1, RFIDX_BINARY_FILE_IO_ERROR);
+}
+
+RfidxStatus mfc1k_map_binary(const char *filename, RfidxMapping *mapping, const Mfc1kData **mfc1k) {
+    const RfidxStatus status = rfidx_map_file(filename, mapping);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    if (mapping->length != sizeof(Mfc1kData)) {
+        rfidx_unmap_file(mapping);
+        return RFIDX_BINARY_FILE_SIZE_ERROR;
+    }
+
+    *mfc1k = (const Mfc1kData *) mapping->base;
+    return RFIDX_OK;
 }
 
 RfidxStatus mfc1k_load_from_json(const char *filename, Mfc1kData *mfc1k, MfcMetadataHeader *header) {
@@ -68,7 +79,7 @@ RfidxStatus mfc1k_save_to_json(const char *filename, const Mfc1kData *mfc1k,
         false,
         RFIDX_JSON_FILE_IO_ERROR);
 
-    free(json_str);
+    rfidx_free(json_str);
     return status;
 }
 
@@ -99,7 +110,7 @@ RfidxStatus mfc1k_save_to_nfc(
         -1,
         false,
         RFIDX_NFC_FILE_IO_ERROR);
-    free(nfc_str);
+    rfidx_free(nfc_str);
     return status;
 }
 
@@ -137,20 +148,20 @@ RfidxStatus mfc1k_read_from_file(
         return RFIDX_FILE_FORMAT_ERROR;
     }
     if (strcmp(suffix, ".bin") == 0) {
-        *mfc1k = malloc(sizeof(Mfc1kData));
-        *header = malloc(sizeof(MfcMetadataHeader));
+        *mfc1k = rfidx_malloc(sizeof(Mfc1kData));
+        *header = rfidx_malloc(sizeof(MfcMetadataHeader));
         return mfc1k_load_from_binary(filename, *mfc1k, *header);
     }
 
     if (strcmp(suffix, ".json") == 0) {
-        *mfc1k = malloc(sizeof(Mfc1kData));
-        *header = malloc(sizeof(MfcMetadataHeader));
+        *mfc1k = rfidx_malloc(sizeof(Mfc1kData));
+        *header = rfidx_malloc(sizeof(MfcMetadataHeader));
         return mfc1k_load_from_json(filename, *mfc1k, *header);
     }
 
     if (strcmp(suffix, ".nfc") == 0) {
-        *mfc1k = malloc(sizeof(Mfc1kData));
-        *header = malloc(sizeof(MfcMetadataHeader));
+        *mfc1k = rfidx_malloc(sizeof(Mfc1kData));
+        *header = rfidx_malloc(sizeof(MfcMetadataHeader));
         return mfc1k_load_from_nfc(filename, *mfc1k, *header);
     }
 
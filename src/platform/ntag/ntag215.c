@@ -31,30 +31,48 @@ RfidxStatus ntag215_load_from_binary(const char *filename, Ntag215Data *ntag215,
 RfidxStatus ntag215_save_to_binary(const char *filename, const Ntag215Data *ntag215,
                                    const Ntag21xMetadataHeader *header) {
     const uint8_t empty_header[sizeof(Ntag21xMetadataHeader)] = {0};
-    uint8_t *buffer;
-    size_t length;
+    struct iovec iov[2];
+    int count = 0;
 
+    // Same layout as ntag215_serialize_binary, written straight from the structures
     if (header && memcmp(header, empty_header, sizeof(Ntag21xMetadataHeader)) != 0) {
-        buffer = ntag215_serialize_binary(ntag215, header);
-        length = sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data);
-    } else {
-        buffer = malloc(sizeof(Ntag215Data));
-        if (!buffer) {
-            return RFIDX_MEMORY_ERROR;
-        }
-        memcpy(buffer, ntag215, sizeof(Ntag215Data));
-        length = sizeof(Ntag215Data);
+        iov[count].iov_base = (void *) header;
+        iov[count].iov_len = sizeof(Ntag21xMetadataHeader);
+        count++;
     }
+    iov[count].iov_base = (void *) ntag215;
+    iov[count].iov_len = sizeof(Ntag215Data);
+    count++;
 
-    const RfidxStatus status = write_file(
-        filename,
-        (const char *) buffer,
-        length,
-        true,
-        RFIDX_BINARY_FILE_IO_ERROR);
+    return write_file_vectored(filename, iov, count, RFIDX_BINARY_FILE_IO_ERROR);
+}
 
-    free(buffer);
-    return status;
+RfidxStatus ntag215_map_binary(
+    const char *filename,
+    RfidxMapping *mapping,
+    const Ntag215Data **ntag215,
+    const Ntag21xMetadataHeader **header
+) {
+    const RfidxStatus status = rfidx_map_file(filename, mapping);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    const uint8_t *base = mapping->base;
+    if (mapping->length == sizeof(Ntag215Data)) {
+        *ntag215 = (const Ntag215Data *) base;
+        *header = NULL;
+        return RFIDX_OK;
+    }
+
+    if (mapping->length == sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data)) {
+        *header = (const Ntag21xMetadataHeader *) base;
+        *ntag215 = (const Ntag215Data *) (base + sizeof(Ntag21xMetadataHeader));
+        return RFIDX_OK;
+    }
+
+    rfidx_unmap_file(mapping);
+    return RFIDX_BINARY_FILE_SIZE_ERROR;
 }
 
 RfidxStatus ntag215_load_from_json(const char *filename, Ntag215Data *ntag215, Ntag21xMetadataHeader *header) {
@@ -81,7 +99,7 @@ RfidxStatus ntag215_save_to_json(const char *filename, const Ntag215Data *ntag21
         -1,
         false,
         RFIDX_JSON_FILE_IO_ERROR);
-    free(json_str);
+    rfidx_free(json_str);
     return status;
 }
 
@@ -108,7 +126,7 @@ RfidxStatus ntag215_save_to_nfc(const char *filename, const Ntag215Data *ntag215
         -1,
         false,
         RFIDX_NFC_FILE_IO_ERROR);
-    free(nfc_str);
+    rfidx_free(nfc_str);
     return status;
 }
 
@@ -138,20 +156,20 @@ RfidxStatus ntag215_read_from_file(const char *filename, Ntag215Data **data, Nta
         return RFIDX_FILE_FORMAT_ERROR;
     }
     if (strcmp(suffix, ".bin") == 0) {
-        *data = malloc(sizeof(Ntag215Data));
-        *header = malloc(sizeof(Ntag21xMetadataHeader));
+        *data = rfidx_malloc(sizeof(Ntag215Data));
+        *header = rfidx_malloc(sizeof(Ntag21xMetadataHeader));
         return ntag215_load_from_binary(filename, *data, *header);
     }
 
     if (strcmp(suffix, ".json") == 0) {
-        *data = malloc(sizeof(Ntag215Data));
-        *header = malloc(sizeof(Ntag21xMetadataHeader));
+        *data = rfidx_malloc(sizeof(Ntag215Data));
+        *header = rfidx_malloc(sizeof(Ntag21xMetadataHeader));
         return ntag215_load_from_json(filename, *data, *header);
     }
 
     if (strcmp(suffix, ".nfc") == 0) {
-        *data = malloc(sizeof(Ntag215Data));
-        *header = malloc(sizeof(Ntag21xMetadataHeader));
+        *data = rfidx_malloc(sizeof(Ntag215Data));
+        *header = rfidx_malloc(sizeof(Ntag21xMetadataHeader));
         return ntag215_load_from_nfc(filename, *data, *header);
     }
 
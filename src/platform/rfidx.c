@@ -12,10 +12,27 @@
 #include <stdint.h>
 #include <string.h>
 #include <getopt.h>
+#include <errno.h>
+#include <dirent.h>
+#include <limits.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include "librfidx/ntag/ntag215.h"
 #include "librfidx/mifare/mifare_classic_1k.h"
 #include "librfidx/application/amiibo.h"
 #include "librfidx/rfidx.h"
+#include "librfidx/detect.h"
+#include "librfidx/stream.h"
+#include "librfidx/batch.h"
+#include "librfidx/manifest.h"
+#include "librfidx/watch.h"
+#include "librfidx/archive.h"
+#include "librfidx/cache.h"
+#include "librfidx/uid_index.h"
+#include "librfidx/store.h"
 
 RfidxStatus read_file(const char *filename, char **out_buf, size_t *out_len, const uint32_t err_code) {
     *out_buf = NULL;
@@ -42,7 +59,7 @@ RfidxStatus read_file(const char *filename, char **out_buf, size_t *out_len, con
     }
 
     const size_t len = (size_t) file_length;
-    char *buf = malloc(len + 1);
+    char *buf = rfidx_malloc(len + 1);
     if (!buf) {
         fclose(file);
         return RFIDX_MEMORY_ERROR;
@@ -52,7 +69,7 @@ RfidxStatus read_file(const char *filename, char **out_buf, size_t *out_len, con
     fclose(file);
 
     if (rd != len) {
-        free(buf);
+        rfidx_free(buf);
         return err_code;
     }
     buf[len] = '\0';
@@ -63,6 +80,47 @@ RfidxStatus read_file(const char *filename, char **out_buf, size_t *out_len, con
     return RFIDX_OK;
 }
 
+RfidxStatus read_fd(const int fd, char **out_buf, size_t *out_len, const uint32_t err_code) {
+    *out_buf = NULL;
+    if (out_len) *out_len = 0;
+
+    // Pipes have no size to ask for up front, so grow the buffer until end of file
+    size_t cap = 4096;
+    size_t len = 0;
+    char *buf = rfidx_malloc(cap);
+    if (!buf) {
+        return RFIDX_MEMORY_ERROR;
+    }
+
+    for (;;) {
+        if (cap - len < 2) {
+            char *grown = rfidx_realloc(buf, cap * 2);
+            if (!grown) {
+                rfidx_free(buf);
+                return RFIDX_MEMORY_ERROR;
+            }
+            buf = grown;
+            cap *= 2;
+        }
+
+        // Leave room for the terminator
+        const ssize_t rd = read(fd, buf + len, cap - len - 1);
+        if (rd < 0) {
+            if (errno == EINTR) continue;
+            rfidx_free(buf);
+            return err_code;
+        }
+        if (rd == 0) break;
+        len += (size_t) rd;
+    }
+
+    buf[len] = '\0';
+    *out_buf = buf;
+    if (out_len) *out_len = len;
+
+    return RFIDX_OK;
+}
+
 RfidxStatus write_file(
     const char *filename,
     const char *buffer,
@@ -70,214 +128,1781 @@ RfidxStatus write_file(
     const bool binary,
     const uint32_t err_code
 ) {
-    FILE *file;
-    if (binary) {
-        file = fopen(filename, "wb");
+    FILE *file;
+    if (binary) {
+        file = fopen(filename, "wb");
+
+        if (!file) {
+            return err_code;
+        }
+
+        if (fwrite(buffer, 1, length, file) != length) {
+            fclose(file);
+            return RFIDX_BINARY_FILE_IO_ERROR;
+        }
+    } else {
+        file = fopen(filename, "w");
+
+        if (!file) {
+            return err_code;
+        }
+
+        if (fputs(buffer, file) == EOF) {
+            fclose(file);
+            return err_code;
+        }
+    }
+
+    fclose(file);
+    return RFIDX_OK;
+}
+
+RfidxStatus write_file_vectored(
+    const char *filename,
+    const struct iovec *iov,
+    const int count,
+    const uint32_t err_code
+) {
+    if (count <= 0 || count > WRITE_FILE_MAX_IOV) {
+        return err_code;
+    }
+
+    const int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd < 0) {
+        return err_code;
+    }
+
+    // writev may stop short; resume from the first byte that was not written
+    struct iovec pending[WRITE_FILE_MAX_IOV];
+    memcpy(pending, iov, sizeof(struct iovec) * (size_t) count);
+    struct iovec *next = pending;
+    int remaining = count;
+
+    while (remaining > 0) {
+        const ssize_t written = writev(fd, next, remaining);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            close(fd);
+            return err_code;
+        }
+
+        size_t consumed = (size_t) written;
+        while (remaining > 0 && consumed >= next->iov_len) {
+            consumed -= next->iov_len;
+            next++;
+            remaining--;
+        }
+        if (remaining > 0) {
+            next->iov_base = (uint8_t *) next->iov_base + consumed;
+            next->iov_len -= consumed;
+        }
+    }
+
+    if (close(fd) != 0) {
+        return err_code;
+    }
+
+    return RFIDX_OK;
+}
+
+void free_file_list(RfidxFileList *files) {
+    for (size_t i = 0; i < files->count; i++) rfidx_free(files->paths[i]);
+    rfidx_free(files->paths);
+    memset(files, 0, sizeof(*files));
+}
+
+static RfidxStatus list_files_under(const char *root, const char *relative, RfidxFileList *files) {
+    char path[PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s%s%s", root, *relative ? "/" : "", relative) >= (int) sizeof(path)) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+
+    DIR *dir = opendir(path);
+    if (!dir) {
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    RfidxStatus status = RFIDX_OK;
+    const struct dirent *entry;
+    while (status == RFIDX_OK && (entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+
+        char child[PATH_MAX];
+        if (snprintf(child, sizeof(child), "%s%s%s", relative, *relative ? "/" : "", entry->d_name) >=
+            (int) sizeof(child)) {
+            status = RFIDX_BUFFER_SIZE_ERROR;
+            break;
+        }
+
+        // Symbolic links are not followed, so a link back up the tree cannot loop the walk
+        bool is_dir = entry->d_type == DT_DIR;
+        bool is_file = entry->d_type == DT_REG;
+        if (entry->d_type == DT_UNKNOWN) {
+            struct stat st;
+            if (fstatat(dirfd(dir), entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) continue;
+            is_dir = S_ISDIR(st.st_mode);
+            is_file = S_ISREG(st.st_mode);
+        }
+
+        if (is_dir) {
+            status = list_files_under(root, child, files);
+        } else if (is_file) {
+            if (files->count == files->cap) {
+                const size_t cap = files->cap ? files->cap * 2 : 256;
+                char **paths = rfidx_realloc(files->paths, cap * sizeof(char *));
+                if (!paths) {
+                    status = RFIDX_MEMORY_ERROR;
+                    break;
+                }
+                files->paths = paths;
+                files->cap = cap;
+            }
+            const size_t len = strlen(child) + 1;
+            files->paths[files->count] = rfidx_malloc(len);
+            if (!files->paths[files->count]) {
+                status = RFIDX_MEMORY_ERROR;
+                break;
+            }
+            memcpy(files->paths[files->count++], child, len);
+        }
+    }
+
+    closedir(dir);
+    return status;
+}
+
+static int compare_file_paths(const void *a, const void *b) {
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+RfidxStatus list_files(const char *root, RfidxFileList *files) {
+    memset(files, 0, sizeof(*files));
+    const RfidxStatus status = list_files_under(root, "", files);
+    if (status != RFIDX_OK) {
+        free_file_list(files);
+        return status;
+    }
+
+    if (files->count) {
+        qsort(files->paths, files->count, sizeof(char *), compare_file_paths);
+    }
+    return RFIDX_OK;
+}
+
+RfidxStatus make_parent_directories(char *path) {
+    for (char *slash = strchr(path + 1, '/'); slash; slash = strchr(slash + 1, '/')) {
+        *slash = '\0';
+        const int result = mkdir(path, 0777);
+        const int saved_errno = errno;
+        *slash = '/';
+        if (result != 0 && saved_errno != EEXIST) {
+            return RFIDX_BINARY_FILE_IO_ERROR;
+        }
+    }
+
+    return RFIDX_OK;
+}
+
+size_t output_stem_length(const char *path) {
+    // Drop the extension of the file name, not a dot in a directory name
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    const char *dot = strrchr(base, '.');
+    return dot && dot != base ? (size_t) (dot - path) : strlen(path);
+}
+
+typedef struct {
+    const char *path;
+    size_t stem_len;
+    size_t index;
+} OutputStem;
+
+static int compare_output_stems(const void *a, const void *b) {
+    const OutputStem *x = a;
+    const OutputStem *y = b;
+    const int order = memcmp(x->path, y->path, x->stem_len < y->stem_len ? x->stem_len : y->stem_len);
+    if (order != 0) return order;
+    if (x->stem_len != y->stem_len) return x->stem_len < y->stem_len ? -1 : 1;
+    return x->index < y->index ? -1 : x->index > y->index;
+}
+
+RfidxStatus find_output_collisions(const char *const *paths, const size_t count, bool *collides) {
+    if (count == 0) {
+        return RFIDX_OK;
+    }
+
+    // Paths in name order are not enough, as "a.c.bin" sorts between "a.bin" and "a.json"
+    OutputStem *stems = rfidx_malloc(sizeof(OutputStem) * count);
+    if (!stems) {
+        return RFIDX_MEMORY_ERROR;
+    }
+    for (size_t i = 0; i < count; i++) {
+        stems[i].path = paths[i];
+        stems[i].stem_len = output_stem_length(paths[i]);
+        stems[i].index = i;
+    }
+    qsort(stems, count, sizeof(OutputStem), compare_output_stems);
+
+    collides[stems[0].index] = false;
+    for (size_t i = 1; i < count; i++) {
+        collides[stems[i].index] = stems[i].stem_len == stems[i - 1].stem_len &&
+                                   memcmp(stems[i].path, stems[i - 1].path, stems[i].stem_len) == 0;
+    }
+
+    rfidx_free(stems);
+    return RFIDX_OK;
+}
+
+static RfidxStatus parse_tag_buffer(
+    const TagType tag_type,
+    const FileFormat format,
+    const char *buffer,
+    const size_t length,
+    void *data,
+    void *header
+) {
+    switch (tag_type) {
+        case NTAG_215:
+        case AMIIBO:
+            switch (format) {
+                case FORMAT_BINARY:
+                    return ntag215_parse_binary((const uint8_t *) buffer, length, data, header);
+                case FORMAT_JSON:
+                    return ntag215_parse_json(buffer, data, header);
+                case FORMAT_NFC:
+                    return ntag215_parse_nfc(buffer, data, header);
+                default:
+                    return RFIDX_FILE_FORMAT_ERROR;
+            }
+        case MFC_1K:
+            switch (format) {
+                case FORMAT_BINARY:
+                    return mfc1k_parse_binary((const uint8_t *) buffer, length, data, header);
+                case FORMAT_JSON:
+                    return mfc1k_parse_json(buffer, data, header);
+                case FORMAT_NFC:
+                    return mfc1k_parse_nfc(buffer, data, header);
+                default:
+                    return RFIDX_FILE_FORMAT_ERROR;
+            }
+        default:
+            return RFIDX_FILE_FORMAT_ERROR;
+    }
+}
+
+TagType read_tag_from_buffer(
+    const char *buffer,
+    const size_t length,
+    const TagType input_type,
+    const FileFormat format,
+    void **data,
+    void **header
+) {
+    size_t data_size;
+    size_t header_size;
+    switch (input_type) {
+        case NTAG_215:
+        case AMIIBO:
+            data_size = sizeof(Ntag215Data);
+            header_size = sizeof(Ntag21xMetadataHeader);
+            break;
+        case MFC_1K:
+            data_size = sizeof(Mfc1kData);
+            header_size = sizeof(MfcMetadataHeader);
+            break;
+        default:
+            return TAG_UNKNOWN;
+    }
+
+    *data = rfidx_malloc(data_size);
+    *header = rfidx_malloc(header_size);
+    if (!*data || !*header) {
+        return TAG_ERROR;
+    }
+    // Formats that carry no header leave it blank
+    memset(*data, 0, data_size);
+    memset(*header, 0, header_size);
+
+    if (parse_tag_buffer(input_type, format, buffer, length, *data, *header) != RFIDX_OK) {
+        return TAG_ERROR;
+    }
+
+    return input_type;
+}
+
+RfidxStatus rfidx_detect_file(const char *filename, TagType *tag_type, FileFormat *format) {
+    *tag_type = TAG_UNKNOWN;
+    *format = FORMAT_UNKNOWN;
+
+    const int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    // Only the prefix is read, so classifying a large corpus costs one small read per file
+    uint8_t prefix[RFIDX_DETECT_PREFIX_SIZE];
+    size_t filled = 0;
+    while (filled < sizeof(prefix)) {
+        const ssize_t rd = pread(fd, prefix + filled, sizeof(prefix) - filled, (off_t) filled);
+        if (rd < 0) {
+            if (errno == EINTR) continue;
+            close(fd);
+            return RFIDX_BINARY_FILE_IO_ERROR;
+        }
+        if (rd == 0) break;
+        filled += (size_t) rd;
+    }
+    close(fd);
+
+    return rfidx_detect_tag(prefix, filled, (size_t) st.st_size, tag_type, format);
+}
+
+TagType read_tag_from_file(const char *filename, const TagType input_type, void **data, void **header) {
+    switch (input_type) {
+        case NTAG_215:
+            if (ntag215_read_from_file(filename, (Ntag215Data **) data, (Ntag21xMetadataHeader **) header) !=
+                RFIDX_OK) {
+                fprintf(stderr, "NTAG215 data reading failed.\n");
+                return TAG_ERROR;
+            }
+            return NTAG_215;
+        case MFC_1K:
+            if (mfc1k_read_from_file(filename, (Mfc1kData **) data, (MfcMetadataHeader **) header) !=
+                RFIDX_OK) {
+                fprintf(stderr, "Mfc1k data reading failed.\n");
+                return TAG_ERROR;
+            }
+            return MFC_1K;
+        case AMIIBO:
+            if (ntag215_read_from_file(filename, (Ntag215Data **) data, (Ntag21xMetadataHeader **) header) !=
+                RFIDX_OK) {
+                fprintf(stderr, "Amiibo data reading failed.\n");
+                return TAG_ERROR;
+            }
+            return AMIIBO;
+        case TAG_UNSPECIFIED: {
+            TagType detected;
+            FileFormat format;
+            if (rfidx_detect_file(filename, &detected, &format) != RFIDX_OK) {
+                return TAG_UNKNOWN;
+            }
+
+            // The content decides the format, whatever the file is called
+            char *buffer = NULL;
+            size_t length = 0;
+            if (read_file(filename, &buffer, &length, RFIDX_BINARY_FILE_IO_ERROR) != RFIDX_OK) {
+                return TAG_ERROR;
+            }
+            const TagType type = read_tag_from_buffer(buffer, length, detected, format, data, header);
+            rfidx_free(buffer);
+            return type;
+        }
+        default:
+            return TAG_UNKNOWN;
+    }
+}
+
+static uint32_t stream_io_error(const FileFormat format) {
+    switch (format) {
+        case FORMAT_JSON:
+            return RFIDX_JSON_FILE_IO_ERROR;
+        case FORMAT_NFC:
+            return RFIDX_NFC_FILE_IO_ERROR;
+        default:
+            return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+}
+
+RfidxStatus serialize_tag(
+    const void *data,
+    const void *header,
+    const TagType tag_type,
+    const FileFormat format,
+    char **buffer,
+    size_t *length
+) {
+    *buffer = NULL;
+    *length = 0;
+
+    if (format == FORMAT_BINARY) {
+        // Raw bytes straight from the structures, in the same layout as *_save_to_binary
+        switch (tag_type) {
+            case NTAG_215:
+            case AMIIBO: {
+                const uint8_t empty_header[sizeof(Ntag21xMetadataHeader)] = {0};
+                const size_t header_size = header && memcmp(header, empty_header, sizeof(Ntag21xMetadataHeader)) != 0
+                                               ? sizeof(Ntag21xMetadataHeader)
+                                               : 0;
+                *buffer = rfidx_malloc(header_size + sizeof(Ntag215Data));
+                if (!*buffer) {
+                    return RFIDX_MEMORY_ERROR;
+                }
+                memcpy(*buffer, header, header_size);
+                memcpy(*buffer + header_size, data, sizeof(Ntag215Data));
+                *length = header_size + sizeof(Ntag215Data);
+                return RFIDX_OK;
+            }
+            case MFC_1K:
+                *buffer = rfidx_malloc(sizeof(Mfc1kData));
+                if (!*buffer) {
+                    return RFIDX_MEMORY_ERROR;
+                }
+                memcpy(*buffer, data, sizeof(Mfc1kData));
+                *length = sizeof(Mfc1kData);
+                return RFIDX_OK;
+            default:
+                return RFIDX_FILE_FORMAT_ERROR;
+        }
+    }
+
+    size_t size;
+    switch (tag_type) {
+        case NTAG_215:
+        case AMIIBO:
+            size = ntag215_serialized_size(format, data, header);
+            break;
+        case MFC_1K:
+            size = mfc1k_serialized_size(format, data, header);
+            break;
+        default:
+            return RFIDX_FILE_FORMAT_ERROR;
+    }
+    if (size == 0) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    *buffer = rfidx_malloc(size);
+    if (!*buffer) {
+        return RFIDX_MEMORY_ERROR;
+    }
+
+    RfidxStatus status;
+    if (tag_type == MFC_1K) {
+        status = format == FORMAT_JSON
+                     ? mfc1k_serialize_json_into(data, header, *buffer, size, length)
+                     : mfc1k_serialize_nfc_into(data, header, *buffer, size, length);
+    } else {
+        status = format == FORMAT_JSON
+                     ? ntag215_serialize_json_into(data, header, *buffer, size, length)
+                     : ntag215_serialize_nfc_into(data, header, *buffer, size, length);
+    }
+    if (status != RFIDX_OK) {
+        rfidx_free(*buffer);
+        *buffer = NULL;
+        *length = 0;
+    }
+    return status;
+}
+
+RfidxStatus write_tag_to_stream(
+    const void *data,
+    const void *header,
+    const TagType tag_type,
+    const FileFormat format,
+    FILE *stream
+) {
+    char *buffer;
+    size_t length;
+    RfidxStatus status = serialize_tag(data, header, tag_type, format, &buffer, &length);
+    if (status == RFIDX_OK && (fwrite(buffer, 1, length, stream) != length || fflush(stream) != 0)) {
+        status = stream_io_error(format);
+    }
+
+    rfidx_free(buffer);
+    return status;
+}
+
+static RfidxStatus open_temporary(const char *output, char temporary[PATH_MAX], FILE **stream) {
+    if (snprintf(temporary, PATH_MAX, "%s.tmp-XXXXXX", output) >= PATH_MAX) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+
+    const int fd = mkstemp(temporary);
+    if (fd < 0) {
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    *stream = fdopen(fd, "wb");
+    if (!*stream) {
+        close(fd);
+        unlink(temporary);
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    return RFIDX_OK;
+}
+
+/**
+ * @brief Close a temporary file and, if it was written completely, rename it over the output
+ */
+static RfidxStatus commit_temporary(FILE *stream, const char *temporary, const char *output, RfidxStatus status) {
+    if (fclose(stream) != 0 && status == RFIDX_OK) {
+        status = RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    // mkstemp creates the file readable by the owner only
+    if (status == RFIDX_OK && chmod(temporary, 0644) != 0) {
+        status = RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    if (status == RFIDX_OK && rename(temporary, output) != 0) {
+        status = RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    if (status != RFIDX_OK) {
+        unlink(temporary);
+    }
+
+    return status;
+}
+
+RfidxStatus write_tag_to_file_atomic(
+    const char *output,
+    const void *data,
+    const void *header,
+    const TagType tag_type,
+    const FileFormat format
+) {
+    char temporary[PATH_MAX];
+    FILE *stream;
+    const RfidxStatus status = open_temporary(output, temporary, &stream);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    return commit_temporary(stream, temporary, output, write_tag_to_stream(data, header, tag_type, format, stream));
+}
+
+RfidxStatus write_file_atomic(const char *output, const void *buffer, const size_t length) {
+    char temporary[PATH_MAX];
+    FILE *stream;
+    const RfidxStatus status = open_temporary(output, temporary, &stream);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    return commit_temporary(stream, temporary, output,
+                            fwrite(buffer, 1, length, stream) == length ? RFIDX_OK : RFIDX_BINARY_FILE_IO_ERROR);
+}
+
+RfidxStatus save_tag_to_file(
+    const void *data,
+    const void *header,
+    const TagType tag_type,
+    const FileFormat output_format,
+    const char *filename,
+    FILE *output_stream,
+    FILE *error_stream
+) {
+    char *buffer;
+    switch (tag_type) {
+        case NTAG_215:
+            buffer = transform_format((Ntag215Data*)data, (Ntag21xMetadataHeader*)header, output_format, filename);
+            if (buffer == NULL) {
+                fprintf(error_stream, "Failed to transform NTAG215 data to %s format.\n", filename);
+                return RFIDX_NUMERICAL_OPERATION_FAILED;
+            }
+            // When saved to a file, the buffer is empty
+            if (filename == NULL || strlen(filename) == 0) {
+                fprintf(output_stream, "Tag data: \n%s\n", buffer);
+            }
+            rfidx_free(buffer);
+            return RFIDX_OK;
+        case MFC_1K:
+            buffer = transform_format((Mfc1kData*)data, (MfcMetadataHeader*)header, output_format, filename);
+            if (buffer == NULL) {
+                fprintf(error_stream, "Failed to transform Mfc1k data to %s format.\n", filename);
+                return RFIDX_NUMERICAL_OPERATION_FAILED;
+            }
+            // When saved to a file, the buffer is empty
+            if (filename == NULL || strlen(filename) == 0) {
+                fprintf(output_stream, "Tag data: \n%s\n", buffer);
+            }
+            rfidx_free(buffer);
+            return RFIDX_OK;
+        case AMIIBO:
+            buffer = transform_format((Ntag215Data*)data, (Ntag21xMetadataHeader*)header, output_format, filename);
+            if (buffer == NULL) {
+                fprintf(error_stream, "Failed to transform Amiibo data to %s format.\n", filename);
+                return RFIDX_NUMERICAL_OPERATION_FAILED;
+            }
+            // When saved to a file, the buffer is empty
+            if (filename == NULL || strlen(filename) == 0) {
+                fprintf(output_stream, "Tag data: \n%s\n", buffer);
+            }
+            rfidx_free(buffer);
+            return RFIDX_OK;
+        default:
+            return RFIDX_FILE_FORMAT_ERROR;
+    }
+}
+
+static const char *file_format_extension(const FileFormat format) {
+    switch (format) {
+        case FORMAT_BINARY:
+            return "bin";
+        case FORMAT_JSON:
+            return "json";
+        case FORMAT_NFC:
+            return "nfc";
+        case FORMAT_EML:
+            return "eml";
+        default:
+            return NULL;
+    }
+}
+
+RfidxStatus parse_file_format_list(const char *list, FileFormat *formats, size_t *count) {
+    *count = 0;
+
+    const char *pos = list;
+    for (;;) {
+        const char *comma = strchr(pos, ',');
+        const size_t len = comma ? (size_t) (comma - pos) : strlen(pos);
+
+        char name[16];
+        if (len == 0 || len >= sizeof(name) || *count == RFIDX_MAX_OUTPUT_FORMATS) {
+            return RFIDX_FILE_FORMAT_ERROR;
+        }
+        memcpy(name, pos, len);
+        name[len] = '\0';
+
+        const FileFormat format = string_to_file_format(name);
+        if (format == FORMAT_UNKNOWN) {
+            return RFIDX_FILE_FORMAT_ERROR;
+        }
+        for (size_t i = 0; i < *count; i++) {
+            if (formats[i] == format) return RFIDX_FILE_FORMAT_ERROR;
+        }
+        formats[(*count)++] = format;
+
+        if (!comma) break;
+        pos = comma + 1;
+    }
+
+    return RFIDX_OK;
+}
+
+RfidxStatus expand_output_template(const char *template, const FileFormat format, char *out, const size_t cap) {
+    const char *extension = file_format_extension(format);
+    if (!extension) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    const size_t extension_len = strlen(extension);
+
+    size_t len = 0;
+    bool replaced = false;
+    for (const char *pos = template; *pos;) {
+        const char *chunk = pos;
+        size_t chunk_len = 1;
+        if (strncmp(pos, "{ext}", 5) == 0) {
+            chunk = extension;
+            chunk_len = extension_len;
+            replaced = true;
+            pos += 5;
+        } else {
+            pos++;
+        }
+
+        if (len + chunk_len >= cap) return RFIDX_BUFFER_SIZE_ERROR;
+        memcpy(out + len, chunk, chunk_len);
+        len += chunk_len;
+    }
+
+    // Without a placeholder the extension is appended, so outputs never overwrite each other
+    if (!replaced) {
+        if (len + 1 + extension_len >= cap) return RFIDX_BUFFER_SIZE_ERROR;
+        out[len++] = '.';
+        memcpy(out + len, extension, extension_len);
+        len += extension_len;
+    }
+    out[len] = '\0';
+
+    return RFIDX_OK;
+}
+
+RfidxStatus save_tag_to_files(
+    const void *data,
+    const void *header,
+    const TagType tag_type,
+    const FileFormat *formats,
+    const size_t count,
+    const char *template,
+    FILE *output_stream,
+    FILE *error_stream
+) {
+    for (size_t i = 0; i < count; i++) {
+        // The tag was parsed and transformed once; every format serializes the same structures
+        char filename[4096];
+        const char *target = NULL;
+        if (template != NULL) {
+            if (expand_output_template(template, formats[i], filename, sizeof(filename)) != RFIDX_OK) {
+                fprintf(error_stream, "Cannot name the %s output from %s\n", file_format_extension(formats[i]),
+                        template);
+                return RFIDX_FILE_FORMAT_ERROR;
+            }
+            target = filename;
+        }
+
+        const RfidxStatus status = save_tag_to_file(
+            data, header, tag_type, formats[i], target, output_stream, error_stream);
+        if (status != RFIDX_OK) {
+            return status;
+        }
+    }
+
+    return RFIDX_OK;
+}
+
+RfidxStatus transform_tag_with_keys_ctx(
+    RfidxContext *ctx,
+    const TagType tag_type,
+    const TransformCommand command,
+    void **data,
+    void **header,
+    const char *uuid,
+    const DumpedKeys *dumped_keys
+) {
+    // Seeding the DRNG gathers entropy, which dominates the run time of a single conversion.
+    // Only pay for it when the transform actually consumes random bytes.
+    if (command == TRANSFORM_GENERATE || command == TRANSFORM_RANDOMIZE_UID) {
+        if (rfidx_init_rng_ctx(ctx, NULL, NULL) != 0) {
+            return RFIDX_DRNG_ERROR;
+        }
+    }
+
+    switch (tag_type) {
+        case NTAG_215:
+            return ntag215_transform_data_ctx(ctx, (Ntag215Data **) data, (Ntag21xMetadataHeader **) header, command);
+        case MFC_1K:
+            return mfc1k_transform_data_ctx(ctx, (Mfc1kData **) data, (MfcMetadataHeader **) header, command);
+        case AMIIBO:
+            // Convert the uuid to uint8_t array
+            uint8_t uuid_bytes[8] = {0};
+            if (uuid) {
+                if (hex_to_bytes(uuid, uuid_bytes, 8) != RFIDX_OK) {
+                    fprintf(stderr, "Failed to convert UUID to bytes.\n");
+                    return RFIDX_NUMERICAL_OPERATION_FAILED;
+                }
+            }
+
+            if (!dumped_keys) {
+                fprintf(stderr, "Retail key is required for Amiibo transformation.\n");
+                return RFIDX_NUMERICAL_OPERATION_FAILED;
+            }
+
+            return amiibo_transform_data_ctx(
+                ctx,
+                (AmiiboData **) data,
+                (Ntag21xMetadataHeader **) header,
+                command,
+                uuid_bytes,
+                dumped_keys
+            );
+        default:
+            return RFIDX_FILE_FORMAT_ERROR;
+    }
+}
+
+RfidxStatus transform_tag_ctx(
+    RfidxContext *ctx,
+    const TagType tag_type,
+    const TransformCommand command,
+    void **data,
+    void **header,
+    const char *uuid,
+    const char *retail_key
+) {
+    if (tag_type != AMIIBO || !retail_key) {
+        return transform_tag_with_keys_ctx(ctx, tag_type, command, data, header, uuid, NULL);
+    }
+
+    // Load the retail key
+    DumpedKeys dumped_keys = {0};
+    if (amiibo_load_dumped_keys(retail_key, &dumped_keys) != RFIDX_OK) {
+        fprintf(stderr, "Failed to load retail key.\n");
+        return RFIDX_NUMERICAL_OPERATION_FAILED;
+    }
+
+    const RfidxStatus status = transform_tag_with_keys_ctx(
+        ctx, tag_type, command, data, header, uuid, &dumped_keys);
+    memset(&dumped_keys, 0, sizeof(dumped_keys));
+    return status;
+}
+
+RfidxStatus transform_tag(
+    const TagType tag_type,
+    const TransformCommand command,
+    void **data,
+    void **header,
+    const char *uuid,
+    const char *retail_key
+) {
+    return transform_tag_ctx(&rfidx_default_context, tag_type, command, data, header, uuid, retail_key);
+}
+
+RfidxStatus transform_tag_in_place(
+    RfidxContext *ctx,
+    TagType tag_type,
+    const TransformCommand command,
+    const char *filename,
+    const char *uuid,
+    const char *retail_key
+) {
+    // Generating replaces the whole dump rather than changing it
+    if (command != TRANSFORM_WIPE && command != TRANSFORM_RANDOMIZE_UID) {
+        return RFIDX_UNKNOWN_ENUM_ERROR;
+    }
+
+    RfidxMapping mapping;
+    RfidxStatus status = rfidx_map_file_writable(filename, &mapping);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    uint8_t *base = mapping.base;
+    const bool ntag_size = mapping.length == sizeof(Ntag215Data) ||
+                           mapping.length == sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data);
+    if (tag_type == TAG_UNSPECIFIED) {
+        // Binary dumps carry no type information, but the sizes of the supported ones differ
+        tag_type = ntag_size ? NTAG_215 : mapping.length == sizeof(Mfc1kData) ? MFC_1K : TAG_UNKNOWN;
+    }
+
+    // Dumps without a header get a scratch one, which is not written back
+    union {
+        Ntag21xMetadataHeader ntag;
+        MfcMetadataHeader mfc;
+    } scratch_header = {0};
+    void *data;
+    void *header = &scratch_header;
+
+    switch (tag_type) {
+        case NTAG_215:
+        case AMIIBO:
+            if (!ntag_size) {
+                rfidx_unmap_file(&mapping);
+                return RFIDX_BINARY_FILE_SIZE_ERROR;
+            }
+            if (mapping.length == sizeof(Ntag215Data)) {
+                data = base;
+            } else {
+                header = base;
+                data = base + sizeof(Ntag21xMetadataHeader);
+            }
+            break;
+        case MFC_1K:
+            if (mapping.length != sizeof(Mfc1kData)) {
+                rfidx_unmap_file(&mapping);
+                return RFIDX_BINARY_FILE_SIZE_ERROR;
+            }
+            data = base;
+            break;
+        default:
+            rfidx_unmap_file(&mapping);
+            return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    // Keep the original to find what changed, and to roll back if the transform fails halfway
+    uint8_t original[sizeof(Mfc1kData)];
+    _Static_assert(sizeof(Mfc1kData) >= sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data),
+                   "In-place snapshot buffer too small");
+    memcpy(original, base, mapping.length);
+
+    status = transform_tag_ctx(ctx, tag_type, command, &data, &header, uuid, retail_key);
+    if (status != RFIDX_OK) {
+        memcpy(base, original, mapping.length);
+        rfidx_unmap_file(&mapping);
+        return status;
+    }
+
+    // Flush only the pages between the first and the last changed byte
+    size_t first = 0;
+    while (first < mapping.length && base[first] == original[first]) first++;
+    size_t end = mapping.length;
+    while (end > first && base[end - 1] == original[end - 1]) end--;
+
+    status = rfidx_sync_mapping(&mapping, first, end - first);
+    rfidx_unmap_file(&mapping);
+    return status;
+}
+
+static void usage(const char *executable_name, FILE *stream) {
+    fprintf(stream,
+            "rfidx by Firefox2100\n\n"
+            "Usage: %s [-i <input-file-name>] [-I <input-type>] [-o <output-file-name> -F <output-format>] "
+            "[-t <transform-command>] [-h]\n"
+            "       %s batch <input-dir> <output-dir> -F <output-format> [-j <threads>] [-I <input-type>] "
+            "[-t <transform-command>]\n"
+            "       %s watch <input-dir> <output-dir> -F <output-format> [-j <threads>] [-I <input-type>] "
+            "[-t <transform-command>]\n"
+            "       %s manifest <manifest-file> [--retail-key <path>]\n"
+            "       %s pack <input-dir> <archive> [-I <input-type>]\n"
+            "       %s unpack <archive> <output-dir> -F <output-format>\n"
+            "       %s query <archive> <expression>\n"
+            "       %s uid-index <archive-or-input-dir> <index> [--check-duplicates]\n"
+            "       %s uid-lookup <index> [<uid>...] [-i <input-file-name>]\n"
+            "       %s store add <store> <input-dir> [-I <input-type>]\n"
+            "       %s store get <store> <name> <output-file-name> -F <output-format>\n"
+            "       %s store gc <store>\n\n"
+            "Standard options:\n"
+            "   -i/--input <path> Input file path. If not needed (e.g. synthesising dump), can be omitted. "
+            "Use - to read from stdin.\n"
+            "   -o/--output <path> Output file path. Omit to print to stdout; use - to write the raw "
+            "output to stdout.\n"
+            "   -I/--input-type <type> Input tag type. Omit to automatically detect.\n"
+            "   -f/--input-format <format> Input format. Omit to detect from the file name; required when "
+            "reading from stdin.\n"
+            "   -F/--output-format <format> Output format. Must be specified with -o option. Give several "
+            "formats separated by commas to write them all from one parse; {ext} in the output path is "
+            "replaced by the extension of each format.\n"
+            "   -t/--transform <command> Transform command.\n"
+            "   --in-place Apply the transform directly to the input file. Only for binary dumps, "
+            "with the wipe and randomize-uid commands.\n"
+            "   --stream Treat the input as back-to-back binary dumps of the input type, and convert "
+            "them one by one. Output is binary by default, or one JSON document per line.\n"
+            "   --record-size <bytes> Size of each dump in the stream. Defaults to the largest binary "
+            "dump of the input type.\n"
+            "   --cache <dir> Reuse the outputs of earlier conversions of the same content, and store new "
+            "ones in <dir>. Also applies to batch mode, but not to watch mode. Transforms that draw random bytes are never cached.\n"
+            "   -h/--help Show this help message.\n\n"
+            "Batch mode converts every file under <input-dir> into the same relative path under "
+            "<output-dir>, using -j worker threads (default: one per CPU). Failed files are reported "
+            "one by one and do not stop the batch.\n\n"
+            "Manifest mode runs the jobs of a newline-delimited JSON file (- for stdin), one object per "
+            "line with \"input\", \"input_type\", \"transform\", \"uuid\", \"output\" and "
+            "\"output_format\". The retail key is loaded once for all jobs.\n\n"
+            "Watch mode converts the files in <input-dir>, then every file written or moved into it, "
+            "until interrupted. Files whose content was already converted are skipped, also across "
+            "restarts.\n\n"
+            "Pack mode stores every dump under <input-dir> as a fixed-size, checksummed record of one "
+            "archive file, named by its relative path. Unpack mode writes the records back out, one "
+            "file per record.\n\n"
+            "UID index mode records the UID of every dump of an archive or directory in a hash table "
+            "file; --check-duplicates lists the dumps sharing a UID and fails if there are any. UID "
+            "lookup mode prints the dumps holding each UID (hex, or taken from -i), and succeeds only if "
+            "none of them is in the index.\n\n"
+            "Store mode keeps one copy of the data of identical dumps in <store>, with a reference named "
+            "by the relative path of each dump that also holds its metadata header. Get writes a dump "
+            "back out, and gc deletes the data no reference points to any more.\n\n"
+            "Special parameters for different modes:\n"
+            "   --uuid <UUID> Specify a UUID for the tag. This is used for generating a new "
+            "Amiibo with given character information.\n"
+            "   --retail-key <path> Specify a retail key for the tag. This is used for all "
+            "Amiibo operations that require manipulation of the data.\n",
+            executable_name,
+            executable_name,
+            executable_name,
+            executable_name,
+            executable_name,
+            executable_name,
+            executable_name,
+            executable_name,
+            executable_name,
+            executable_name,
+            executable_name,
+            executable_name
+    );
+}
+
+TransformCommand string_to_transform_command(const char *str) {
+    if (!str) return TRANSFORM_NONE;
+    if (strcmp(str, "generate") == 0) return TRANSFORM_GENERATE;
+    if (strcmp(str, "randomize-uid") == 0) return TRANSFORM_RANDOMIZE_UID;
+    if (strcmp(str, "wipe") == 0) return TRANSFORM_WIPE;
+    return TRANSFORM_NONE;
+}
+
+static RfidxStatus run_stream(
+    const TagType tag_type,
+    const char *input_file,
+    const char *output_file,
+    const char *output_format,
+    const char *transform_command,
+    const char *record_size,
+    const char *uuid,
+    const char *retail_key,
+    FILE *output_stream,
+    FILE *error_stream
+) {
+    RfidxStreamOptions options = {
+        .tag_type = tag_type,
+        .record_size = 0,
+        .command = string_to_transform_command(transform_command),
+        .output_format = output_format ? string_to_file_format(output_format) : FORMAT_BINARY,
+        .uuid = uuid,
+        .retail_key = retail_key,
+    };
+    if (transform_command != NULL && options.command == TRANSFORM_NONE) {
+        fprintf(error_stream, "Invalid transform_command specified.\n");
+        return EXIT_FAILURE;
+    }
+    if (record_size != NULL) {
+        char *end = NULL;
+        options.record_size = strtoul(record_size, &end, 10);
+        if (end == record_size || *end != '\0' || options.record_size == 0) {
+            fprintf(error_stream, "Invalid record size: %s\n", record_size);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const bool from_stdin = strcmp(input_file, "-") == 0;
+    const int input_fd = from_stdin ? STDIN_FILENO : open(input_file, O_RDONLY | O_CLOEXEC);
+    if (input_fd < 0) {
+        fprintf(error_stream, "Failed to open %s\n", input_file);
+        return EXIT_FAILURE;
+    }
+
+    FILE *output = output_stream;
+    if (output_file != NULL && strcmp(output_file, "-") != 0) {
+        output = fopen(output_file, "wb");
+        if (!output) {
+            fprintf(error_stream, "Failed to open %s\n", output_file);
+            if (!from_stdin) close(input_fd);
+            return EXIT_FAILURE;
+        }
+    }
+
+    size_t records = 0;
+    RfidxStatus status = rfidx_convert_stream(&rfidx_default_context, input_fd, output, &options, &records);
+
+    if (output != output_stream && fclose(output) != 0 && status == RFIDX_OK) {
+        status = RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    if (!from_stdin) close(input_fd);
+
+    if (status != RFIDX_OK) {
+        fprintf(error_stream, "Stream conversion failed after %zu records.\n", records);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+static void report_batch_result(const char *input, const char *output, const RfidxStatus status, void *user) {
+    (void) output;
+    if (status != RFIDX_OK) {
+        fprintf((FILE *) user, "%s: failed with error 0x%08X\n", input, (unsigned int) status);
+    }
+}
+
+static volatile sig_atomic_t watch_stop_requested;
+
+static void request_watch_stop(const int signum) {
+    (void) signum;
+    watch_stop_requested = 1;
+}
+
+static RfidxStatus run_watch(
+    const char *input_dir,
+    const char *output_dir,
+    const RfidxBatchOptions *batch_options,
+    FILE *output_stream,
+    FILE *error_stream
+) {
+    const RfidxWatchOptions options = {
+        .input_type = batch_options->input_type,
+        .command = batch_options->command,
+        .output_format = batch_options->output_format,
+        .uuid = batch_options->uuid,
+        .retail_key = batch_options->retail_key,
+        .threads = batch_options->threads,
+        .stop = &watch_stop_requested,
+        .on_result = report_batch_result,
+        .user = error_stream,
+    };
+
+    // Ctrl-C finishes the files already picked up, then prints the summary
+    struct sigaction action = {0};
+    struct sigaction old_int;
+    struct sigaction old_term;
+    action.sa_handler = request_watch_stop;
+    sigemptyset(&action.sa_mask);
+    watch_stop_requested = 0;
+    sigaction(SIGINT, &action, &old_int);
+    sigaction(SIGTERM, &action, &old_term);
+
+    RfidxWatchSummary summary;
+    const RfidxStatus status = rfidx_watch(input_dir, output_dir, &options, &summary);
+
+    sigaction(SIGINT, &old_int, NULL);
+    sigaction(SIGTERM, &old_term, NULL);
+    if (status != RFIDX_OK) {
+        fprintf(error_stream, "Watching %s failed with error 0x%08X\n", input_dir, (unsigned int) status);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(output_stream, "Converted %zu files, %zu failed, %zu unchanged.\n", summary.converted, summary.failed,
+            summary.skipped);
+    return summary.failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Command line of the batch and watch modes, which take the same options
+ */
+static RfidxStatus batch_main(
+    const char *executable_name,
+    const bool watch,
+    const int argc,
+    char **argv,
+    FILE *output_stream,
+    FILE *error_stream
+) {
+    const char *input_type = NULL;
+    const char *output_format = NULL;
+    const char *transform_command = NULL;
+    const char *threads = NULL;
+    const char *uuid = NULL;
+    const char *retail_key = NULL;
+    const char *cache_dir = NULL;
+
+    static struct option long_options[] = {
+        {"input-type", required_argument, 0, 'I'},
+        {"output-format", required_argument, 0, 'F'},
+        {"transform", required_argument, 0, 't'},
+        {"jobs", required_argument, 0, 'j'},
+        {"uuid", required_argument, 0, 1000},
+        {"retail-key", required_argument, 0, 1001},
+        {"cache", required_argument, 0, 1005},
+        {0, 0, 0, 0}
+    };
+
+    int opt;
+    int long_index = 0;
+    optind = 1;
+
+    while ((opt = getopt_long(argc, argv, "I:F:t:j:", long_options, &long_index)) != -1) {
+        switch (opt) {
+            case 'I':
+                input_type = optarg;
+                break;
+            case 'F':
+                output_format = optarg;
+                break;
+            case 't':
+                transform_command = optarg;
+                break;
+            case 'j':
+                threads = optarg;
+                break;
+            case 1000:
+                uuid = optarg;
+                break;
+            case 1001:
+                retail_key = optarg;
+                break;
+            case 1005:
+                cache_dir = optarg;
+                break;
+            default:
+                usage(executable_name, error_stream);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind != 2 || output_format == NULL) {
+        fprintf(error_stream, "%s mode needs an input directory, an output directory and an output format.\n",
+                watch ? "Watch" : "Batch");
+        usage(executable_name, error_stream);
+        return EXIT_FAILURE;
+    }
+    // The watch workers always convert directly, so accepting the option would silently ignore it
+    if (watch && cache_dir != NULL) {
+        fprintf(error_stream, "--cache is not supported in watch mode.\n");
+        return EXIT_FAILURE;
+    }
+
+    RfidxBatchOptions options = {
+        .input_type = TAG_UNSPECIFIED,
+        .command = string_to_transform_command(transform_command),
+        .output_format = string_to_file_format(output_format),
+        .uuid = uuid,
+        .retail_key = retail_key,
+        .threads = 0,
+        .cache_dir = cache_dir,
+        .on_result = report_batch_result,
+        .user = error_stream,
+    };
+    if (input_type != NULL) {
+        options.input_type = string_to_tag_type(input_type);
+        if (options.input_type == TAG_UNKNOWN) {
+            fprintf(error_stream, "Unknown input type: %s\n", input_type);
+            return EXIT_FAILURE;
+        }
+    }
+    if (transform_command != NULL && options.command == TRANSFORM_NONE) {
+        fprintf(error_stream, "Invalid transform_command specified.\n");
+        return EXIT_FAILURE;
+    }
+    if (threads != NULL) {
+        char *end = NULL;
+        const unsigned long count = strtoul(threads, &end, 10);
+        if (end == threads || *end != '\0' || count == 0 || count > RFIDX_BATCH_MAX_THREADS) {
+            fprintf(error_stream, "Invalid number of threads: %s\n", threads);
+            return EXIT_FAILURE;
+        }
+        options.threads = (unsigned int) count;
+    }
+
+    if (watch) {
+        return run_watch(argv[optind], argv[optind + 1], &options, output_stream, error_stream);
+    }
+
+    RfidxBatchSummary summary;
+    const RfidxStatus status = rfidx_batch_convert(argv[optind], argv[optind + 1], &options, &summary);
+    if (status != RFIDX_OK) {
+        fprintf(error_stream, "Batch conversion of %s failed with error 0x%08X\n", argv[optind],
+                (unsigned int) status);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(output_stream, "Converted %zu files, %zu failed.\n", summary.converted, summary.failed);
+    if (cache_dir) {
+        fprintf(output_stream, "%zu files were served from the cache.\n", summary.cached);
+    }
+    return summary.failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void report_manifest_result(const size_t line, const char *input, const char *output,
+                                   const RfidxStatus status, void *user) {
+    (void) output;
+    if (status != RFIDX_OK) {
+        fprintf((FILE *) user, "Line %zu (%s): failed with error 0x%08X\n", line, input ? input : "invalid job",
+                (unsigned int) status);
+    }
+}
+
+static RfidxStatus manifest_main(
+    const char *executable_name,
+    const int argc,
+    char **argv,
+    FILE *output_stream,
+    FILE *error_stream
+) {
+    const char *retail_key = NULL;
+
+    static struct option long_options[] = {
+        {"retail-key", required_argument, 0, 1001},
+        {0, 0, 0, 0}
+    };
+
+    int opt;
+    int long_index = 0;
+    optind = 1;
+
+    while ((opt = getopt_long(argc, argv, "", long_options, &long_index)) != -1) {
+        switch (opt) {
+            case 1001:
+                retail_key = optarg;
+                break;
+            default:
+                usage(executable_name, error_stream);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind != 1) {
+        fprintf(error_stream, "Manifest mode needs exactly one manifest file.\n");
+        usage(executable_name, error_stream);
+        return EXIT_FAILURE;
+    }
+
+    const char *path = argv[optind];
+    const bool from_stdin = strcmp(path, "-") == 0;
+    FILE *manifest = from_stdin ? stdin : fopen(path, "r");
+    if (!manifest) {
+        fprintf(error_stream, "Failed to open %s\n", path);
+        return EXIT_FAILURE;
+    }
+
+    const RfidxManifestOptions options = {
+        .retail_key = retail_key,
+        .on_result = report_manifest_result,
+        .user = error_stream,
+    };
+    RfidxBatchSummary summary;
+    const RfidxStatus status = rfidx_run_manifest(&rfidx_default_context, manifest, &options, &summary);
+    if (!from_stdin) fclose(manifest);
+    if (status != RFIDX_OK) {
+        fprintf(error_stream, "Running manifest %s failed with error 0x%08X\n", path, (unsigned int) status);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(output_stream, "Completed %zu jobs, %zu failed.\n", summary.converted, summary.failed);
+    return summary.failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Command line of the pack and unpack modes
+ */
+static RfidxStatus archive_main(
+    const char *executable_name,
+    const bool unpack,
+    const int argc,
+    char **argv,
+    FILE *output_stream,
+    FILE *error_stream
+) {
+    const char *input_type = NULL;
+    const char *output_format = NULL;
+
+    static struct option long_options[] = {
+        {"input-type", required_argument, 0, 'I'},
+        {"output-format", required_argument, 0, 'F'},
+        {0, 0, 0, 0}
+    };
+
+    int opt;
+    int long_index = 0;
+    optind = 1;
+
+    while ((opt = getopt_long(argc, argv, unpack ? "F:" : "I:", long_options, &long_index)) != -1) {
+        switch (opt) {
+            case 'I':
+                input_type = optarg;
+                break;
+            case 'F':
+                output_format = optarg;
+                break;
+            default:
+                usage(executable_name, error_stream);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind != 2 || (unpack && output_format == NULL)) {
+        fprintf(error_stream, unpack
+                                  ? "Unpack mode needs an archive, an output directory and an output format.\n"
+                                  : "Pack mode needs an input directory and an archive.\n");
+        usage(executable_name, error_stream);
+        return EXIT_FAILURE;
+    }
+
+    RfidxBatchSummary summary;
+    RfidxStatus status;
+    if (unpack) {
+        status = rfidx_archive_unpack(argv[optind], argv[optind + 1], string_to_file_format(output_format),
+                                      report_batch_result, error_stream, &summary);
+    } else {
+        TagType tag_type = TAG_UNSPECIFIED;
+        if (input_type != NULL) {
+            tag_type = string_to_tag_type(input_type);
+            if (tag_type == TAG_UNKNOWN) {
+                fprintf(error_stream, "Unknown input type: %s\n", input_type);
+                return EXIT_FAILURE;
+            }
+        }
+        status = rfidx_archive_pack(argv[optind], argv[optind + 1], tag_type, report_batch_result, error_stream,
+                                    &summary);
+    }
+    if (status != RFIDX_OK) {
+        fprintf(error_stream, "%s %s failed with error 0x%08X\n", unpack ? "Unpacking" : "Packing", argv[optind],
+                (unsigned int) status);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(output_stream, "%s %zu dumps, %zu failed.\n", unpack ? "Unpacked" : "Packed", summary.converted,
+            summary.failed);
+    return summary.failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * @brief Command line of the query mode
+ *
+ * Prints the name of every matching record, and the number of matches to the error stream
+ * so the names can be piped on.
+ */
+static RfidxStatus query_main(
+    const char *executable_name,
+    const int argc,
+    char **argv,
+    FILE *output_stream,
+    FILE *error_stream
+) {
+    if (argc != 3) {
+        fprintf(error_stream, "Query mode needs an archive and an expression.\n");
+        usage(executable_name, error_stream);
+        return EXIT_FAILURE;
+    }
+
+    RfidxArchive archive;
+    RfidxStatus status = rfidx_archive_map(argv[1], &archive);
+    if (status != RFIDX_OK) {
+        fprintf(error_stream, "Failed to open archive %s with error 0x%08X\n", argv[1], (unsigned int) status);
+        return EXIT_FAILURE;
+    }
+
+    RfidxColumnStore store;
+    status = rfidx_archive_load_columns(&archive, &store);
+    if (status != RFIDX_OK) {
+        fprintf(error_stream, "Failed to read archive %s with error 0x%08X\n", argv[1], (unsigned int) status);
+        rfidx_archive_unmap(&archive);
+        return EXIT_FAILURE;
+    }
+
+    uint64_t *bitmap = NULL;
+    size_t matches = 0;
+    status = rfidx_query(&store, argv[2], &bitmap, &matches);
+    if (status != RFIDX_OK) {
+        fprintf(error_stream, "Invalid query: %s\nColumns:", argv[2]);
+        for (size_t i = 0; i < store.column_count; i++) {
+            fprintf(error_stream, "%s %s", i ? "," : "", rfidx_columns_name(&store, i));
+        }
+        fprintf(error_stream, "\n");
+    } else {
+        for (size_t i = 0; i < store.count; i++) {
+            if (!(bitmap[i / 64] >> (i % 64) & 1)) continue;
+            RfidxArchiveRecord record;
+            if (rfidx_archive_get(&archive, i, &record) == RFIDX_OK && record.name_len) {
+                fprintf(output_stream, "%.*s\n", (int) record.name_len, record.name);
+            } else {
+                fprintf(output_stream, "#%zu\n", i);
+            }
+        }
+        fprintf(error_stream, "%zu of %zu records match.\n", matches, store.count);
+    }
+
+    rfidx_free(bitmap);
+    rfidx_columns_free(&store);
+    rfidx_archive_unmap(&archive);
+    return status == RFIDX_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void report_uid_duplicate(const uint8_t *uid, const size_t uid_len, const char *first,
+                                 const char *duplicate, void *user) {
+    FILE *stream = user;
+    char hex[2 * RFIDX_UID_MAX_SIZE + 1];
+    bytes_to_hex(uid, uid_len, hex);
+    fprintf(stream, "Duplicate UID %s: %s and %s\n", hex, first, duplicate);
+}
+
+/**
+ * @brief Command line of the uid-index mode
+ */
+static RfidxStatus uid_index_main(
+    const char *executable_name,
+    const int argc,
+    char **argv,
+    FILE *output_stream,
+    FILE *error_stream
+) {
+    bool check_duplicates = false;
+
+    static struct option long_options[] = {
+        {"check-duplicates", no_argument, 0, 'd'},
+        {0, 0, 0, 0}
+    };
+
+    int opt;
+    int long_index = 0;
+    optind = 1;
+
+    while ((opt = getopt_long(argc, argv, "", long_options, &long_index)) != -1) {
+        switch (opt) {
+            case 'd':
+                check_duplicates = true;
+                break;
+            default:
+                usage(executable_name, error_stream);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (argc - optind != 2) {
+        fprintf(error_stream, "UID index mode needs an archive or input directory, and an index.\n");
+        usage(executable_name, error_stream);
+        return EXIT_FAILURE;
+    }
+
+    RfidxUidIndexSummary summary;
+    const RfidxStatus status = rfidx_uid_index_build(argv[optind], argv[optind + 1],
+                                                     check_duplicates ? report_uid_duplicate : NULL,
+                                                     output_stream, &summary);
+    if (status != RFIDX_OK) {
+        fprintf(error_stream, "Indexing %s failed with error 0x%08X\n", argv[optind], (unsigned int) status);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(output_stream, "Indexed %zu dumps, %zu duplicate UIDs, %zu failed.\n", summary.indexed,
+            summary.duplicates, summary.failed);
+    if (summary.failed != 0 || (check_duplicates && summary.duplicates != 0)) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Command line of the uid-lookup mode
+ *
+ * Prints every record holding each UID. Succeeds only if none of the UIDs is in the index,
+ * so a script can check that a new UID is free before issuing it.
+ */
+static RfidxStatus uid_lookup_main(
+    const char *executable_name,
+    const int argc,
+    char **argv,
+    FILE *output_stream,
+    FILE *error_stream
+) {
+    const char *input = NULL;
 
-        if (!file) {
-            return err_code;
-        }
+    static struct option long_options[] = {
+        {"input", required_argument, 0, 'i'},
+        {0, 0, 0, 0}
+    };
 
-        if (fwrite(buffer, 1, length, file) != length) {
-            fclose(file);
-            return RFIDX_BINARY_FILE_IO_ERROR;
+    int opt;
+    int long_index = 0;
+    optind = 1;
+
+    while ((opt = getopt_long(argc, argv, "i:", long_options, &long_index)) != -1) {
+        switch (opt) {
+            case 'i':
+                input = optarg;
+                break;
+            default:
+                usage(executable_name, error_stream);
+                return EXIT_FAILURE;
         }
-    } else {
-        file = fopen(filename, "w");
+    }
 
-        if (!file) {
-            return err_code;
+    if (argc - optind < 1 || (argc - optind == 1 && input == NULL)) {
+        fprintf(error_stream, "UID lookup mode needs an index, and UIDs or an input file.\n");
+        usage(executable_name, error_stream);
+        return EXIT_FAILURE;
+    }
+
+    // Parse every UID before opening the index, so a typo does not give a partial answer
+    const size_t uid_count = (size_t) (argc - optind - 1) + (input ? 1 : 0);
+    uint8_t (*uids)[RFIDX_UID_MAX_SIZE] = rfidx_malloc(uid_count * RFIDX_UID_MAX_SIZE);
+    size_t *uid_lens = rfidx_malloc(uid_count * sizeof(size_t));
+    if (!uids || !uid_lens) {
+        rfidx_free(uids);
+        rfidx_free(uid_lens);
+        return EXIT_FAILURE;
+    }
+
+    RfidxStatus result = EXIT_SUCCESS;
+    for (size_t i = 0; i + (input ? 1 : 0) < uid_count; i++) {
+        const char *hex = argv[optind + 1 + i];
+        const size_t hex_len = strlen(hex);
+        if ((hex_len != 8 && hex_len != 14) || hex_to_bytes(hex, uids[i], hex_len / 2) != RFIDX_OK) {
+            fprintf(error_stream, "Invalid UID %s: expected 8 or 14 hex digits.\n", hex);
+            result = EXIT_FAILURE;
+        }
+        uid_lens[i] = hex_len / 2;
+    }
+    if (input && result == EXIT_SUCCESS) {
+        void *data = NULL;
+        void *header = NULL;
+        const TagType tag_type = read_tag_from_file(input, TAG_UNSPECIFIED, &data, &header);
+        if (tag_type == TAG_UNKNOWN || tag_type == TAG_ERROR ||
+            rfidx_tag_uid(tag_type, data, uids[uid_count - 1], &uid_lens[uid_count - 1]) != RFIDX_OK) {
+            fprintf(error_stream, "Failed to read the UID of %s\n", input);
+            result = EXIT_FAILURE;
         }
+        rfidx_free(data);
+        rfidx_free(header);
+    }
 
-        if (fputs(buffer, file) == EOF) {
-            fclose(file);
-            return err_code;
+    RfidxUidIndex index;
+    if (result == EXIT_SUCCESS) {
+        const RfidxStatus status = rfidx_uid_index_map(argv[optind], &index);
+        if (status != RFIDX_OK) {
+            fprintf(error_stream, "Failed to open index %s with error 0x%08X\n", argv[optind], (unsigned int) status);
+            result = EXIT_FAILURE;
         }
     }
 
-    fclose(file);
-    return RFIDX_OK;
-}
+    if (result == EXIT_SUCCESS) {
+        for (size_t i = 0; i < uid_count; i++) {
+            char hex[2 * RFIDX_UID_MAX_SIZE + 1];
+            bytes_to_hex(uids[i], uid_lens[i], hex);
 
-TagType read_tag_from_file(const char *filename, const TagType input_type, void **data, void **header) {
-    switch (input_type) {
-        case NTAG_215:
-            if (ntag215_read_from_file(filename, (Ntag215Data **) data, (Ntag21xMetadataHeader **) header) !=
-                RFIDX_OK) {
-                fprintf(stderr, "NTAG215 data reading failed.\n");
-                return TAG_ERROR;
+            size_t records[16];
+            const size_t found = rfidx_uid_index_lookup(&index, uids[i], uid_lens[i], records, 16);
+            if (found == 0) {
+                fprintf(output_stream, "%s: not found\n", hex);
+                continue;
             }
-            return NTAG_215;
-        case MFC_1K:
-            if (mfc1k_read_from_file(filename, (Mfc1kData **) data, (MfcMetadataHeader **) header) !=
-                RFIDX_OK) {
-                fprintf(stderr, "Mfc1k data reading failed.\n");
-                return TAG_ERROR;
+            result = EXIT_FAILURE;
+            for (size_t j = 0; j < found && j < 16; j++) {
+                const char *name;
+                size_t name_len;
+                if (rfidx_uid_index_name(&index, records[j], &name, &name_len) == RFIDX_OK && name_len) {
+                    fprintf(output_stream, "%s: %.*s\n", hex, (int) name_len, name);
+                } else {
+                    fprintf(output_stream, "%s: #%zu\n", hex, records[j]);
+                }
             }
-            return MFC_1K;
-        case AMIIBO:
-            if (ntag215_read_from_file(filename, (Ntag215Data **) data, (Ntag21xMetadataHeader **) header) !=
-                RFIDX_OK) {
-                fprintf(stderr, "Amiibo data reading failed.\n");
-                return TAG_ERROR;
+            if (found > 16) {
+                fprintf(output_stream, "%s: and %zu more\n", hex, found - 16);
             }
-            return AMIIBO;
-        default:
-            return TAG_UNKNOWN;
+        }
+        rfidx_uid_index_unmap(&index);
     }
+
+    rfidx_free(uids);
+    rfidx_free(uid_lens);
+    return result;
 }
 
-RfidxStatus save_tag_to_file(
-    const void *data,
-    const void *header,
-    const TagType tag_type,
-    const FileFormat output_format,
-    const char *filename,
+/**
+ * @brief Command line of the store mode and its add, get and gc commands
+ */
+static RfidxStatus store_main(
+    const char *executable_name,
+    const int argc,
+    char **argv,
     FILE *output_stream,
     FILE *error_stream
 ) {
-    char *buffer;
-    switch (tag_type) {
-        case NTAG_215:
-            buffer = transform_format((Ntag215Data*)data, (Ntag21xMetadataHeader*)header, output_format, filename);
-            if (filename == NULL || strlen(filename) > 0) {
-                if (buffer == NULL) {
-                    fprintf(error_stream, "Failed to transform NTAG215 data to %s format.\n", filename);
-                    return RFIDX_NUMERICAL_OPERATION_FAILED;
-                }
+    const char *input_type = NULL;
+    const char *output_format = NULL;
 
-                fprintf(output_stream, "Tag data: \n%s\n", buffer);
-            }
-            if (buffer) free(buffer);
-            return RFIDX_OK;
-        case MFC_1K:
-            buffer = transform_format((Mfc1kData*)data, (MfcMetadataHeader*)header, output_format, filename);
-            if (filename == NULL || strlen(filename) > 0) {
-                if (buffer == NULL) {
-                    fprintf(error_stream, "Failed to transform Mfc1k data to %s format.\n", filename);
-                    return RFIDX_NUMERICAL_OPERATION_FAILED;
-                }
+    static struct option long_options[] = {
+        {"input-type", required_argument, 0, 'I'},
+        {"output-format", required_argument, 0, 'F'},
+        {0, 0, 0, 0}
+    };
 
-                fprintf(output_stream, "Tag data: \n%s\n", buffer);
-            }
-            if (buffer) free(buffer);
-            return RFIDX_OK;
-        case AMIIBO:
-            buffer = transform_format((Ntag215Data*)data, (Ntag21xMetadataHeader*)header, output_format, filename);
-            if (filename == NULL || strlen(filename) > 0) {
-                if (buffer == NULL) {
-                    fprintf(error_stream, "Failed to transform Amiibo data to %s format.\n", filename);
-                    return RFIDX_NUMERICAL_OPERATION_FAILED;
-                }
+    int opt;
+    int long_index = 0;
+    optind = 1;
 
-                fprintf(output_stream, "Tag data: \n%s\n", buffer);
-            }
-            if (buffer) free(buffer);
-            return RFIDX_OK;
-        default:
-            return RFIDX_FILE_FORMAT_ERROR;
+    while ((opt = getopt_long(argc, argv, "I:F:", long_options, &long_index)) != -1) {
+        switch (opt) {
+            case 'I':
+                input_type = optarg;
+                break;
+            case 'F':
+                output_format = optarg;
+                break;
+            default:
+                usage(executable_name, error_stream);
+                return EXIT_FAILURE;
+        }
     }
-}
-
-RfidxStatus transform_tag(
-    const TagType tag_type,
-    const TransformCommand command,
-    void **data,
-    void **header,
-    const char *uuid,
-    const char *retail_key
-) {
-    // Initialize the DRNG first
-    rfidx_init_rng(NULL, NULL);
 
-    switch (tag_type) {
-        case NTAG_215:
-            return ntag215_transform_data((Ntag215Data **) data, (Ntag21xMetadataHeader **) header, command);
-        case MFC_1K:
-            return mfc1k_transform_data((Mfc1kData **) data, (MfcMetadataHeader **) header, command);
-        case AMIIBO:
-            // Convert the uuid to uint8_t array
-            uint8_t uuid_bytes[8] = {0};
-            if (uuid) {
-                if (hex_to_bytes(uuid, uuid_bytes, 8) != RFIDX_OK) {
-                    fprintf(stderr, "Failed to convert UUID to bytes.\n");
-                    return RFIDX_NUMERICAL_OPERATION_FAILED;
-                }
+    const char *command = optind < argc ? argv[optind] : "";
+    const int operands = argc - optind - 1;
+    if (strcmp(command, "add") == 0 && operands == 2) {
+        TagType tag_type = TAG_UNSPECIFIED;
+        if (input_type != NULL) {
+            tag_type = string_to_tag_type(input_type);
+            if (tag_type == TAG_UNKNOWN) {
+                fprintf(error_stream, "Unknown input type: %s\n", input_type);
+                return EXIT_FAILURE;
             }
+        }
 
-            // Load the retail key
-            DumpedKeys dumped_keys = {0};
-            if (retail_key) {
-                if (amiibo_load_dumped_keys(retail_key, &dumped_keys) != RFIDX_OK) {
-                    fprintf(stderr, "Failed to load retail key.\n");
-                    return RFIDX_NUMERICAL_OPERATION_FAILED;
-                }
-            } else {
-                fprintf(stderr, "Retail key is required for Amiibo transformation.\n");
-                return RFIDX_NUMERICAL_OPERATION_FAILED;
-            }
+        RfidxStoreSummary summary;
+        const RfidxStatus status = rfidx_store_add_tree(argv[optind + 1], argv[optind + 2], tag_type,
+                                                        report_batch_result, error_stream, &summary);
+        if (status != RFIDX_OK) {
+            fprintf(error_stream, "Adding %s failed with error 0x%08X\n", argv[optind + 2], (unsigned int) status);
+            return EXIT_FAILURE;
+        }
+        fprintf(output_stream, "Added %zu dumps, %zu already stored, %zu failed.\n", summary.added,
+                summary.deduplicated, summary.failed);
+        return summary.failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
 
-            return amiibo_transform_data(
-                (AmiiboData **) data,
-                (Ntag21xMetadataHeader **) header,
-                command,
-                uuid_bytes,
-                &dumped_keys
-            );
-        default:
-            return RFIDX_FILE_FORMAT_ERROR;
+    if (strcmp(command, "get") == 0 && operands == 3 && output_format != NULL) {
+        TagType tag_type;
+        void *data = NULL;
+        void *header = NULL;
+        RfidxStatus status = rfidx_store_get(argv[optind + 1], argv[optind + 2], &tag_type, &data, &header);
+        if (status == RFIDX_OK) {
+            status = write_tag_to_file_atomic(argv[optind + 3], data, header, tag_type,
+                                              string_to_file_format(output_format));
+        }
+        rfidx_free(data);
+        rfidx_free(header);
+        if (status != RFIDX_OK) {
+            fprintf(error_stream, "Getting %s failed with error 0x%08X\n", argv[optind + 2], (unsigned int) status);
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
     }
-}
 
-static void usage(const char *executable_name, FILE *stream) {
-    fprintf(stream,
-            "rfidx by Firefox2100\n\n"
-            "Usage: %s [-i <input-file-name>] [-I <input-type>] [-o <output-file-name> -F <output-format>] "
-            "[-t <transform-command>] [-h]\n\n"
-            "Standard options:\n"
-            "   -i/--input <path> Input file path. If not needed (e.g. synthesising dump), can be omitted.\n"
-            "   -o/--output <path> Output file path. Omit to use stdout.\n"
-            "   -I/--input-type <type> Input tag type. Omit to automatically detect.\n"
-            "   -F/--output-format <format> Output format. Must be specified with -o option.\n"
-            "   -t/--transform <command> Transform command.\n"
-            "   -h/--help Show this help message.\n\n"
-            "Special parameters for different modes:\n"
-            "   --uuid <UUID> Specify a UUID for the tag. This is used for generating a new "
-            "Amiibo with given character information.\n"
-            "   --retail-key <path> Specify a retail key for the tag. This is used for all "
-            "Amiibo operations that require manipulation of the data.\n",
-            executable_name
-    );
-}
+    if (strcmp(command, "gc") == 0 && operands == 1) {
+        size_t kept;
+        size_t removed;
+        const RfidxStatus status = rfidx_store_gc(argv[optind + 1], &kept, &removed);
+        if (status != RFIDX_OK) {
+            fprintf(error_stream, "Collecting %s failed with error 0x%08X\n", argv[optind + 1], (unsigned int) status);
+            return EXIT_FAILURE;
+        }
+        fprintf(output_stream, "Kept %zu objects, removed %zu.\n", kept, removed);
+        return EXIT_SUCCESS;
+    }
 
-TransformCommand string_to_transform_command(const char *str) {
-    if (!str) return TRANSFORM_NONE;
-    if (strcmp(str, "generate") == 0) return TRANSFORM_GENERATE;
-    if (strcmp(str, "randomize-uid") == 0) return TRANSFORM_RANDOMIZE_UID;
-    if (strcmp(str, "wipe") == 0) return TRANSFORM_WIPE;
-    return TRANSFORM_NONE;
+    fprintf(error_stream, "Store mode needs add <store> <input-dir>, get <store> <name> <output> -F <format>, "
+                          "or gc <store>.\n");
+    usage(executable_name, error_stream);
+    return EXIT_FAILURE;
 }
 
 RfidxStatus rfidx_main(const int argc, char **argv, FILE *output_stream, FILE *error_stream) {
     const char *executable_name = argv[0];
 
+    if (argc > 1 && strcmp(argv[1], "batch") == 0) {
+        return batch_main(executable_name, false, argc - 1, argv + 1, output_stream, error_stream);
+    }
+    if (argc > 1 && strcmp(argv[1], "watch") == 0) {
+        return batch_main(executable_name, true, argc - 1, argv + 1, output_stream, error_stream);
+    }
+    if (argc > 1 && strcmp(argv[1], "manifest") == 0) {
+        return manifest_main(executable_name, argc - 1, argv + 1, output_stream, error_stream);
+    }
+    if (argc > 1 && strcmp(argv[1], "pack") == 0) {
+        return archive_main(executable_name, false, argc - 1, argv + 1, output_stream, error_stream);
+    }
+    if (argc > 1 && strcmp(argv[1], "unpack") == 0) {
+        return archive_main(executable_name, true, argc - 1, argv + 1, output_stream, error_stream);
+    }
+    if (argc > 1 && strcmp(argv[1], "query") == 0) {
+        return query_main(executable_name, argc - 1, argv + 1, output_stream, error_stream);
+    }
+    if (argc > 1 && strcmp(argv[1], "uid-index") == 0) {
+        return uid_index_main(executable_name, argc - 1, argv + 1, output_stream, error_stream);
+    }
+    if (argc > 1 && strcmp(argv[1], "uid-lookup") == 0) {
+        return uid_lookup_main(executable_name, argc - 1, argv + 1, output_stream, error_stream);
+    }
+    if (argc > 1 && strcmp(argv[1], "store") == 0) {
+        return store_main(executable_name, argc - 1, argv + 1, output_stream, error_stream);
+    }
+
     const char *input_file = NULL;
     const char *output_file = NULL;
     const char *input_type = NULL;
     const char *output_format = NULL;
+    const char *input_format = NULL;
     const char *transform_command = NULL;
     const char *uuid = NULL;
     const char *retail_key = NULL;
+    bool in_place = false;
+    bool stream = false;
+    const char *record_size = NULL;
+    const char *cache_dir = NULL;
 
     static struct option long_options[] = {
         {"input", required_argument, 0, 'i'},
         {"input-type", required_argument, 0, 'I'},
         {"output", required_argument, 0, 'o'},
+        {"input-format", required_argument, 0, 'f'},
         {"output-format", required_argument, 0, 'F'},
         {"transform", required_argument, 0, 't'},
         {"help", no_argument, 0, 'h'},
         {"uuid", required_argument, 0, 1000},
         {"retail-key", required_argument, 0, 1001},
+        {"in-place", no_argument, 0, 1002},
+        {"stream", no_argument, 0, 1003},
+        {"record-size", required_argument, 0, 1004},
+        {"cache", required_argument, 0, 1005},
         {0, 0, 0, 0}
     };
 
@@ -285,7 +1910,7 @@ RfidxStatus rfidx_main(const int argc, char **argv, FILE *output_stream, FILE *e
     int long_index = 0;
     optind = 1; // Reset the index for getopt_long in case it's called multiple times
 
-    while ((opt = getopt_long(argc, argv, "i:o:I:F:t:h", long_options, &long_index)) != -1) {
+    while ((opt = getopt_long(argc, argv, "i:o:I:f:F:t:h", long_options, &long_index)) != -1) {
         switch (opt) {
             case 'i':
                 input_file = optarg;
@@ -296,6 +1921,9 @@ RfidxStatus rfidx_main(const int argc, char **argv, FILE *output_stream, FILE *e
             case 'I':
                 input_type = optarg;
                 break;
+            case 'f':
+                input_format = optarg;
+                break;
             case 'F':
                 output_format = optarg;
                 break;
@@ -311,6 +1939,18 @@ RfidxStatus rfidx_main(const int argc, char **argv, FILE *output_stream, FILE *e
             case 1001:
                 retail_key = optarg;
                 break;
+            case 1002:
+                in_place = true;
+                break;
+            case 1003:
+                stream = true;
+                break;
+            case 1004:
+                record_size = optarg;
+                break;
+            case 1005:
+                cache_dir = optarg;
+                break;
             default:
                 usage(executable_name, error_stream);
                 return EXIT_FAILURE;
@@ -318,7 +1958,8 @@ RfidxStatus rfidx_main(const int argc, char **argv, FILE *output_stream, FILE *e
     }
 
     // Validate the input parameters
-    if (output_file != NULL && output_format == NULL) {
+    // Streams are binary in and, unless told otherwise, binary out
+    if (output_file != NULL && output_format == NULL && !stream) {
         fprintf(error_stream, "Output format must be specified with -o option.\n");
         usage(executable_name, error_stream);
         return EXIT_FAILURE;
@@ -353,26 +1994,118 @@ RfidxStatus rfidx_main(const int argc, char **argv, FILE *output_stream, FILE *e
         }
     }
 
+    FileFormat in_format = FORMAT_UNKNOWN;
+    if (input_format != NULL) {
+        in_format = string_to_file_format(input_format);
+        if (in_format != FORMAT_BINARY && in_format != FORMAT_JSON && in_format != FORMAT_NFC) {
+            fprintf(error_stream, "Unsupported input format: %s\n", input_format);
+            usage(executable_name, error_stream);
+            return EXIT_FAILURE;
+        }
+    }
+    const bool input_from_stdin = input_file != NULL && strcmp(input_file, "-") == 0;
+    const bool output_to_stdout = output_file != NULL && strcmp(output_file, "-") == 0;
+    if (input_from_stdin && !stream && (input_format == NULL || input_type == NULL)) {
+        fprintf(error_stream, "Reading from stdin needs both the input type and the input format.\n");
+        usage(executable_name, error_stream);
+        return EXIT_FAILURE;
+    }
+    if (input_file != NULL && !input_from_stdin && input_format != NULL && input_type == NULL) {
+        fprintf(error_stream, "The input format can only be overridden together with the input type.\n");
+        usage(executable_name, error_stream);
+        return EXIT_FAILURE;
+    }
+
+    if (in_place) {
+        if (input_file == NULL || input_from_stdin || transform_command == NULL || output_file != NULL ||
+            output_format != NULL) {
+            fprintf(error_stream, "In-place mode needs an input file and a transform command, and no output.\n");
+            usage(executable_name, error_stream);
+            return EXIT_FAILURE;
+        }
+
+        const TransformCommand command = string_to_transform_command(transform_command);
+        if (command != TRANSFORM_WIPE && command != TRANSFORM_RANDOMIZE_UID) {
+            fprintf(error_stream, "Only wipe and randomize-uid can be applied in place.\n");
+            usage(executable_name, error_stream);
+            return EXIT_FAILURE;
+        }
+
+        if (transform_tag_in_place(
+            &rfidx_default_context, tag_type, command, input_file, uuid, retail_key) != RFIDX_OK) {
+            fprintf(error_stream, "Failed to transform %s in place.\n", input_file);
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    if (stream) {
+        if (input_file == NULL || input_type == NULL ||
+            (in_format != FORMAT_UNKNOWN && in_format != FORMAT_BINARY)) {
+            fprintf(error_stream, "Stream mode needs a binary input file and the input type.\n");
+            usage(executable_name, error_stream);
+            return EXIT_FAILURE;
+        }
+
+        return run_stream(
+            tag_type, input_file, output_file, output_format, transform_command, record_size, uuid, retail_key,
+            output_stream, error_stream
+        );
+    }
+
+    // Only a conversion from one file to another, without randomness, can come from the cache
+    const FileFormat cached_format = output_format != NULL ? string_to_file_format(output_format) : FORMAT_UNKNOWN;
+    const TransformCommand cached_command = string_to_transform_command(transform_command);
+    if (cache_dir != NULL && input_file != NULL && !input_from_stdin && input_format == NULL &&
+        output_file != NULL && !output_to_stdout &&
+        (cached_format == FORMAT_BINARY || cached_format == FORMAT_JSON || cached_format == FORMAT_NFC) &&
+        (transform_command == NULL || cached_command != TRANSFORM_NONE) && rfidx_cache_applies(cached_command)) {
+        bool hit = false;
+        const RfidxStatus status = rfidx_convert_cached(
+            &rfidx_default_context, cache_dir, input_file, tag_type, cached_command, cached_format, retail_key,
+            output_file, &hit);
+        if (status != RFIDX_OK) {
+            fprintf(error_stream, "Failed to convert %s: error 0x%08X\n", input_file, (unsigned int) status);
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
     void *data = NULL;
     void *header = NULL;
 
     if (input_file != NULL) {
-        tag_type = read_tag_from_file(input_file, tag_type, &data, &header);
+        if (input_format != NULL) {
+            // The format is given explicitly, so the content does not need a file name to go by
+            char *buffer = NULL;
+            size_t length = 0;
+            const RfidxStatus status = input_from_stdin
+                                           ? read_fd(STDIN_FILENO, &buffer, &length, RFIDX_BINARY_FILE_IO_ERROR)
+                                           : read_file(input_file, &buffer, &length, RFIDX_BINARY_FILE_IO_ERROR);
+            tag_type = status == RFIDX_OK
+                           ? read_tag_from_buffer(buffer, length, tag_type, in_format, &data, &header)
+                           : TAG_ERROR;
+            if (buffer) rfidx_free(buffer);
+        } else {
+            tag_type = read_tag_from_file(input_file, tag_type, &data, &header);
+        }
         if (tag_type == TAG_UNKNOWN) {
             fprintf(error_stream,
                     "Tag type not recognized or not supported; try again by manually specifying the type.\n");
             usage(executable_name, error_stream);
 
-            if (data) free(data);
-            if (header) free(header);
+            if (data) rfidx_free(data);
+            if (header) rfidx_free(header);
             return EXIT_FAILURE;
         }
         if (tag_type == TAG_ERROR) {
             fprintf(error_stream, "Failed to read tag data from file: %s\n", input_file);
             usage(executable_name, error_stream);
 
-            if (data) free(data);
-            if (header) free(header);
+            if (data) rfidx_free(data);
+            if (header) rfidx_free(header);
             return EXIT_FAILURE;
         }
     }
@@ -384,8 +2117,8 @@ RfidxStatus rfidx_main(const int argc, char **argv, FILE *output_stream, FILE *e
         if (command == TRANSFORM_NONE) {
             fprintf(error_stream, "Invalid transform_command specified.\n");
             usage(executable_name, error_stream);
-            if (data) free(data);
-            if (header) free(header);
+            if (data) rfidx_free(data);
+            if (header) rfidx_free(header);
             return EXIT_FAILURE;
         }
 
@@ -393,23 +2126,55 @@ RfidxStatus rfidx_main(const int argc, char **argv, FILE *output_stream, FILE *e
             fprintf(error_stream, "Failed to transform tag data.\n");
             usage(executable_name, error_stream);
 
-            if (data) free(data);
-            if (header) free(header);
+            if (data) rfidx_free(data);
+            if (header) rfidx_free(header);
             return EXIT_FAILURE;
         }
     }
 
     if (output_format != NULL) {
-        const FileFormat format = string_to_file_format(output_format);
-        if (format == FORMAT_UNKNOWN) {
+        FileFormat formats[RFIDX_MAX_OUTPUT_FORMATS];
+        size_t format_count = 0;
+        if (parse_file_format_list(output_format, formats, &format_count) != RFIDX_OK) {
             fprintf(error_stream, "Unknown output format: %s\n", output_format);
             usage(executable_name, error_stream);
 
-            if (data) free(data);
-            if (header) free(header);
+            if (data) rfidx_free(data);
+            if (header) rfidx_free(header);
             return EXIT_FAILURE;
         }
 
+        // A single format still goes through the template when the path has a placeholder
+        if (format_count > 1 || (output_file && strstr(output_file, "{ext}"))) {
+            if (output_to_stdout) {
+                fprintf(error_stream, "Only one output format can be written to stdout.\n");
+                usage(executable_name, error_stream);
+
+                rfidx_free(data);
+                rfidx_free(header);
+                return EXIT_FAILURE;
+            }
+
+            const RfidxStatus status = save_tag_to_files(
+                data, header, tag_type, formats, format_count, output_file, output_stream, error_stream);
+
+            rfidx_free(data);
+            rfidx_free(header);
+            return status == RFIDX_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        const FileFormat format = formats[0];
+        if (output_to_stdout) {
+            const RfidxStatus status = write_tag_to_stream(data, header, tag_type, format, output_stream);
+            if (status != RFIDX_OK) {
+                fprintf(error_stream, "Failed to write tag data to stdout.\n");
+            }
+
+            rfidx_free(data);
+            rfidx_free(header);
+            return status == RFIDX_OK ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
         return save_tag_to_file(data, header, tag_type, format, output_file, output_stream, error_stream);
     }
 
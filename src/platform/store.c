@@ -0,0 +1,400 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "mbedtls/sha256.h"
+#include "librfidx/store.h"
+#include "librfidx/rfidx.h"
+#include "librfidx/ntag/ntag215.h"
+#include "librfidx/mifare/mifare_classic_1k.h"
+#include "../core/layout.h"
+
+/* Offsets of the fields in a reference */
+#define STORE_VERSION_OFFSET 8
+#define STORE_TAG_TYPE_OFFSET 10
+#define STORE_HEADER_SIZE_OFFSET 12
+#define STORE_KEY_OFFSET 16
+
+static void store_key(const void *data, const size_t data_size, uint8_t key[RFIDX_STORE_KEY_SIZE]) {
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    mbedtls_sha256_update(&sha, data, data_size);
+    mbedtls_sha256_finish(&sha, key);
+    mbedtls_sha256_free(&sha);
+}
+
+/**
+ * @brief Path of a data object
+ *
+ * Objects are spread over 256 subdirectories by the first byte of their key, like the
+ * entries of the conversion cache.
+ */
+static RfidxStatus store_object_path(const char *store_dir, const uint8_t key[RFIDX_STORE_KEY_SIZE], char *out,
+                                     const size_t cap) {
+    char hex[RFIDX_STORE_KEY_SIZE * 2 + 1];
+    bytes_to_hex(key, RFIDX_STORE_KEY_SIZE, hex);
+
+    if (snprintf(out, cap, "%s/objects/%.2s/%s", store_dir, hex, hex + 2) >= (int) cap) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+    return RFIDX_OK;
+}
+
+/**
+ * @brief Path of a reference
+ *
+ * The name comes from the caller, so one that is absolute or has an empty, . or .. component
+ * is refused rather than allowed to point outside the refs directory.
+ */
+static RfidxStatus store_ref_path(const char *store_dir, const char *name, char *out, const size_t cap) {
+    if (!name || name[0] == '\0' || name[0] == '/') {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    for (const char *part = name; part; ) {
+        const char *slash = strchr(part, '/');
+        const size_t len = slash ? (size_t) (slash - part) : strlen(part);
+        if (len == 0 || (len == 1 && part[0] == '.') || (len == 2 && part[0] == '.' && part[1] == '.')) {
+            return RFIDX_FILE_FORMAT_ERROR;
+        }
+        part = slash ? slash + 1 : NULL;
+    }
+
+    if (snprintf(out, cap, "%s/refs/%s", store_dir, name) >= (int) cap) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+    return RFIDX_OK;
+}
+
+/**
+ * @brief Parse a reference
+ * @param layout Set to the sizes of the structures. The metadata header follows the fixed fields.
+ */
+static RfidxStatus store_parse_ref(const uint8_t *ref, const size_t length, TagType *tag_type,
+                                   uint8_t key[RFIDX_STORE_KEY_SIZE], TagLayout *layout) {
+    if (length < RFIDX_STORE_REF_HEADER_SIZE || memcmp(ref, RFIDX_STORE_REF_MAGIC, 8) != 0 ||
+        get_u16(ref + STORE_VERSION_OFFSET) != RFIDX_STORE_VERSION) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    *tag_type = (TagType) get_u16(ref + STORE_TAG_TYPE_OFFSET);
+    if (tag_layout(*tag_type, layout) != RFIDX_OK ||
+        get_u32(ref + STORE_HEADER_SIZE_OFFSET) != layout->header_size ||
+        length != RFIDX_STORE_REF_HEADER_SIZE + layout->header_size) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    memcpy(key, ref + STORE_KEY_OFFSET, RFIDX_STORE_KEY_SIZE);
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_store_add(
+    const char *store_dir,
+    const char *name,
+    const TagType tag_type,
+    const void *data,
+    const void *header,
+    bool *deduplicated
+) {
+    if (deduplicated) *deduplicated = false;
+    if (!store_dir || !data || !header) {
+        return RFIDX_MEMORY_ERROR;
+    }
+
+    TagLayout layout;
+    RfidxStatus status = tag_layout(tag_type, &layout);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    char ref_path[PATH_MAX];
+    status = store_ref_path(store_dir, name, ref_path, sizeof(ref_path));
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    uint8_t key[RFIDX_STORE_KEY_SIZE];
+    store_key(data, layout.data_size, key);
+
+    // An object is only ever written under the hash of its content, so an existing one is reused
+    char object_path[PATH_MAX];
+    status = store_object_path(store_dir, key, object_path, sizeof(object_path));
+    if (status != RFIDX_OK) {
+        return status;
+    }
+    struct stat st;
+    if (stat(object_path, &st) == 0 && S_ISREG(st.st_mode) && (size_t) st.st_size == layout.data_size) {
+        if (deduplicated) *deduplicated = true;
+    } else {
+        status = make_parent_directories(object_path);
+        if (status == RFIDX_OK) {
+            status = write_file_atomic(object_path, data, layout.data_size);
+        }
+        if (status != RFIDX_OK) {
+            return status;
+        }
+    }
+
+    uint8_t ref[RFIDX_STORE_REF_HEADER_SIZE +
+                (sizeof(Ntag21xMetadataHeader) > sizeof(MfcMetadataHeader)
+                     ? sizeof(Ntag21xMetadataHeader)
+                     : sizeof(MfcMetadataHeader))];
+    memset(ref, 0, RFIDX_STORE_REF_HEADER_SIZE);
+    memcpy(ref, RFIDX_STORE_REF_MAGIC, 8);
+    put_u16(ref + STORE_VERSION_OFFSET, RFIDX_STORE_VERSION);
+    put_u16(ref + STORE_TAG_TYPE_OFFSET, (uint16_t) tag_type);
+    put_u32(ref + STORE_HEADER_SIZE_OFFSET, (uint32_t) layout.header_size);
+    memcpy(ref + STORE_KEY_OFFSET, key, RFIDX_STORE_KEY_SIZE);
+    memcpy(ref + RFIDX_STORE_REF_HEADER_SIZE, header, layout.header_size);
+
+    status = make_parent_directories(ref_path);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+    return write_file_atomic(ref_path, ref, RFIDX_STORE_REF_HEADER_SIZE + layout.header_size);
+}
+
+RfidxStatus rfidx_store_add_tree(
+    const char *store_dir,
+    const char *input_dir,
+    const TagType tag_type,
+    const RfidxBatchCallback on_result,
+    void *user,
+    RfidxStoreSummary *summary
+) {
+    if (summary) memset(summary, 0, sizeof(*summary));
+
+    RfidxFileList files;
+    const RfidxStatus status = list_files(input_dir, &files);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    for (size_t i = 0; i < files.count; i++) {
+        char input[PATH_MAX];
+        RfidxStatus result = RFIDX_BUFFER_SIZE_ERROR;
+        bool deduplicated = false;
+        if (snprintf(input, sizeof(input), "%s/%s", input_dir, files.paths[i]) < (int) sizeof(input)) {
+            void *data = NULL;
+            void *header = NULL;
+            const TagType read_type = read_tag_from_file(input, tag_type, &data, &header);
+            if (read_type == TAG_UNKNOWN || read_type == TAG_ERROR) {
+                result = read_type == TAG_UNKNOWN ? RFIDX_FILE_FORMAT_ERROR : RFIDX_BINARY_FILE_IO_ERROR;
+            } else {
+                result = rfidx_store_add(store_dir, files.paths[i], read_type, data, header, &deduplicated);
+            }
+            rfidx_free(data);
+            rfidx_free(header);
+        }
+
+        if (summary) {
+            if (result == RFIDX_OK) {
+                summary->added++;
+                if (deduplicated) summary->deduplicated++;
+            } else {
+                summary->failed++;
+            }
+        }
+        if (on_result) {
+            on_result(files.paths[i], result == RFIDX_OK ? files.paths[i] : NULL, result, user);
+        }
+    }
+
+    free_file_list(&files);
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_store_get(
+    const char *store_dir,
+    const char *name,
+    TagType *tag_type,
+    void **data,
+    void **header
+) {
+    if (!store_dir || !tag_type || !data || !header) {
+        return RFIDX_MEMORY_ERROR;
+    }
+    *data = NULL;
+    *header = NULL;
+
+    char path[PATH_MAX];
+    RfidxStatus status = store_ref_path(store_dir, name, path, sizeof(path));
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    char *ref = NULL;
+    size_t ref_len = 0;
+    status = read_file(path, &ref, &ref_len, RFIDX_BINARY_FILE_IO_ERROR);
+    uint8_t key[RFIDX_STORE_KEY_SIZE];
+    TagLayout layout = {0};
+    if (status == RFIDX_OK) {
+        status = store_parse_ref((const uint8_t *) ref, ref_len, tag_type, key, &layout);
+    }
+
+    char *object = NULL;
+    size_t object_len = 0;
+    if (status == RFIDX_OK) {
+        status = store_object_path(store_dir, key, path, sizeof(path));
+    }
+    if (status == RFIDX_OK) {
+        status = read_file(path, &object, &object_len, RFIDX_BINARY_FILE_IO_ERROR);
+    }
+    if (status == RFIDX_OK) {
+        // The key doubles as a checksum of the object
+        uint8_t actual[RFIDX_STORE_KEY_SIZE];
+        store_key(object, object_len, actual);
+        if (object_len != layout.data_size || memcmp(actual, key, RFIDX_STORE_KEY_SIZE) != 0) {
+            status = RFIDX_CHECKSUM_ERROR;
+        }
+    }
+
+    if (status == RFIDX_OK) {
+        *data = rfidx_malloc(layout.data_size);
+        *header = rfidx_malloc(layout.header_size);
+        if (!*data || !*header) {
+            rfidx_free(*data);
+            rfidx_free(*header);
+            *data = NULL;
+            *header = NULL;
+            status = RFIDX_MEMORY_ERROR;
+        } else {
+            memcpy(*data, object, layout.data_size);
+            memcpy(*header, ref + RFIDX_STORE_REF_HEADER_SIZE, layout.header_size);
+        }
+    }
+
+    rfidx_free(ref);
+    rfidx_free(object);
+    return status;
+}
+
+static int compare_keys(const void *a, const void *b) {
+    return memcmp(a, b, RFIDX_STORE_KEY_SIZE);
+}
+
+/**
+ * @brief List the files of a store subdirectory, which may not exist yet
+ */
+static RfidxStatus store_list(const char *store_dir, const char *subdir, char *root, const size_t cap,
+                              RfidxFileList *files) {
+    memset(files, 0, sizeof(*files));
+    if (snprintf(root, cap, "%s/%s", store_dir, subdir) >= (int) cap) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+
+    struct stat st;
+    if (stat(root, &st) != 0 && errno == ENOENT) {
+        return RFIDX_OK;
+    }
+    return list_files(root, files);
+}
+
+/**
+ * @brief Collect the keys of every reference, sorted
+ */
+static RfidxStatus store_collect_keys(const char *store_dir, uint8_t **keys, size_t *count) {
+    char root[PATH_MAX];
+    RfidxFileList refs;
+    RfidxStatus status = store_list(store_dir, "refs", root, sizeof(root), &refs);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    *count = 0;
+    *keys = rfidx_malloc(refs.count ? refs.count * RFIDX_STORE_KEY_SIZE : 1);
+    if (!*keys) {
+        free_file_list(&refs);
+        return RFIDX_MEMORY_ERROR;
+    }
+
+    for (size_t i = 0; status == RFIDX_OK && i < refs.count; i++) {
+        char path[PATH_MAX];
+        if (snprintf(path, sizeof(path), "%s/%s", root, refs.paths[i]) >= (int) sizeof(path)) {
+            status = RFIDX_BUFFER_SIZE_ERROR;
+            break;
+        }
+
+        char *ref = NULL;
+        size_t ref_len = 0;
+        status = read_file(path, &ref, &ref_len, RFIDX_BINARY_FILE_IO_ERROR);
+        TagType tag_type;
+        TagLayout layout;
+        if (status == RFIDX_OK) {
+            status = store_parse_ref((const uint8_t *) ref, ref_len, &tag_type, *keys + *count * RFIDX_STORE_KEY_SIZE,
+                                     &layout);
+        }
+        if (status == RFIDX_OK) {
+            (*count)++;
+        }
+        rfidx_free(ref);
+    }
+    free_file_list(&refs);
+
+    if (status != RFIDX_OK) {
+        rfidx_free(*keys);
+        *keys = NULL;
+        return status;
+    }
+    qsort(*keys, *count, RFIDX_STORE_KEY_SIZE, compare_keys);
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_store_gc(const char *store_dir, size_t *kept, size_t *removed) {
+    if (kept) *kept = 0;
+    if (removed) *removed = 0;
+
+    // Every reference has to be read before anything is deleted, or a damaged one would lose its data
+    uint8_t *keys = NULL;
+    size_t key_count = 0;
+    RfidxStatus status = store_collect_keys(store_dir, &keys, &key_count);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    char root[PATH_MAX];
+    RfidxFileList objects;
+    status = store_list(store_dir, "objects", root, sizeof(root), &objects);
+
+    for (size_t i = 0; status == RFIDX_OK && i < objects.count; i++) {
+        // Only touch files named like an object, which leaves anything else in place
+        const char *name = objects.paths[i];
+        char hex[RFIDX_STORE_KEY_SIZE * 2 + 1];
+        uint8_t key[RFIDX_STORE_KEY_SIZE];
+        if (strlen(name) != RFIDX_STORE_KEY_SIZE * 2 + 1 || name[2] != '/') continue;
+        memcpy(hex, name, 2);
+        memcpy(hex + 2, name + 3, RFIDX_STORE_KEY_SIZE * 2 - 2);
+        hex[RFIDX_STORE_KEY_SIZE * 2] = '\0';
+        if (hex_to_bytes(hex, key, RFIDX_STORE_KEY_SIZE) != RFIDX_OK) continue;
+
+        if (bsearch(key, keys, key_count, RFIDX_STORE_KEY_SIZE, compare_keys)) {
+            if (kept) (*kept)++;
+            continue;
+        }
+
+        char path[PATH_MAX];
+        if (snprintf(path, sizeof(path), "%s/%s", root, name) >= (int) sizeof(path)) {
+            status = RFIDX_BUFFER_SIZE_ERROR;
+        } else if (unlink(path) != 0 && errno != ENOENT) {
+            status = RFIDX_BINARY_FILE_IO_ERROR;
+        } else if (removed) {
+            (*removed)++;
+        }
+    }
+
+    free_file_list(&objects);
+    rfidx_free(keys);
+    return status;
+}
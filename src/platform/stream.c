@@ -0,0 +1,311 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "librfidx/stream.h"
+#include "librfidx/rfidx.h"
+#include "librfidx/ntag/ntag215.h"
+#include "librfidx/mifare/mifare_classic_1k.h"
+#include "librfidx/application/amiibo.h"
+
+/**
+ * @brief Reader thread state shared with the converting thread
+ *
+ * The reader fills buffers[i] while the converter drains buffers[i ^ 1]. A buffer is owned by
+ * the reader while full[i] is false, and by the converter while it is true.
+ */
+typedef struct {
+    int fd;
+    size_t chunk;               /**< Bytes per buffer, a whole number of records */
+    uint8_t *buffers[2];
+    size_t lengths[2];
+    bool full[2];
+    bool stop;                  /**< The converter gave up, the reader must not wait for it */
+    RfidxStatus status;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} StreamReader;
+
+static size_t stream_fill(const int fd, uint8_t *buffer, const size_t chunk, RfidxStatus *status) {
+    size_t filled = 0;
+    while (filled < chunk) {
+        const ssize_t rd = read(fd, buffer + filled, chunk - filled);
+        if (rd < 0) {
+            if (errno == EINTR) continue;
+            *status = RFIDX_BINARY_FILE_IO_ERROR;
+            break;
+        }
+        if (rd == 0) break;
+        filled += (size_t) rd;
+    }
+
+    return filled;
+}
+
+static void *stream_reader_main(void *arg) {
+    StreamReader *reader = arg;
+
+    for (int i = 0;; i ^= 1) {
+        pthread_mutex_lock(&reader->lock);
+        while (reader->full[i] && !reader->stop) {
+            pthread_cond_wait(&reader->cond, &reader->lock);
+        }
+        const bool stop = reader->stop;
+        pthread_mutex_unlock(&reader->lock);
+        if (stop) break;
+
+        RfidxStatus status = RFIDX_OK;
+        const size_t filled = stream_fill(reader->fd, reader->buffers[i], reader->chunk, &status);
+
+        pthread_mutex_lock(&reader->lock);
+        reader->lengths[i] = filled;
+        reader->full[i] = true;
+        if (status != RFIDX_OK) reader->status = status;
+        pthread_cond_broadcast(&reader->cond);
+        pthread_mutex_unlock(&reader->lock);
+
+        // A short buffer is the last one
+        if (filled < reader->chunk) break;
+    }
+
+    return NULL;
+}
+
+typedef struct {
+    RfidxContext *ctx;
+    const RfidxStreamOptions *options;
+    uint8_t uuid[8];
+    DumpedKeys dumped_keys;
+    union {
+        Ntag215Data ntag215;
+        Mfc1kData mfc1k;
+    } data;
+    union {
+        Ntag21xMetadataHeader ntag21x;
+        MfcMetadataHeader mfc;
+    } header;
+} StreamRecord;
+
+static RfidxStatus stream_transform(StreamRecord *record) {
+    const RfidxStreamOptions *options = record->options;
+    void *data = &record->data;
+    void *header = &record->header;
+
+    switch (options->tag_type) {
+        case NTAG_215:
+            return ntag215_transform_data_ctx(
+                record->ctx, (Ntag215Data **) &data, (Ntag21xMetadataHeader **) &header, options->command);
+        case MFC_1K:
+            return mfc1k_transform_data_ctx(
+                record->ctx, (Mfc1kData **) &data, (MfcMetadataHeader **) &header, options->command);
+        case AMIIBO:
+            // The keys were loaded once for the whole stream
+            return amiibo_transform_data_ctx(
+                record->ctx,
+                (AmiiboData **) &data,
+                (Ntag21xMetadataHeader **) &header,
+                options->command,
+                record->uuid,
+                &record->dumped_keys
+            );
+        default:
+            return RFIDX_FILE_FORMAT_ERROR;
+    }
+}
+
+static RfidxStatus stream_write(const StreamRecord *record, FILE *output) {
+    const RfidxStreamOptions *options = record->options;
+    const bool mfc = options->tag_type == MFC_1K;
+
+    if (options->output_format == FORMAT_BINARY) {
+        // Keep the input layout, even when the header is blank
+        if (!mfc && options->record_size > sizeof(Ntag215Data) &&
+            fwrite(&record->header.ntag21x, sizeof(Ntag21xMetadataHeader), 1, output) != 1) {
+            return RFIDX_BINARY_FILE_IO_ERROR;
+        }
+        const size_t size = mfc ? sizeof(Mfc1kData) : sizeof(Ntag215Data);
+        return fwrite(&record->data, size, 1, output) == 1 ? RFIDX_OK : RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    char *json = mfc
+                     ? mfc1k_serialize_json_unformatted(&record->data.mfc1k, &record->header.mfc)
+                     : ntag215_serialize_json_unformatted(&record->data.ntag215, &record->header.ntag21x);
+    if (!json) {
+        return RFIDX_MEMORY_ERROR;
+    }
+
+    // One document per line, so the output can be split again without a JSON parser
+    const RfidxStatus status = fputs(json, output) >= 0 && fputc('\n', output) != EOF
+                                   ? RFIDX_OK
+                                   : RFIDX_JSON_FILE_IO_ERROR;
+    rfidx_free(json);
+    return status;
+}
+
+static RfidxStatus stream_convert_record(StreamRecord *record, const uint8_t *buffer, FILE *output) {
+    const RfidxStreamOptions *options = record->options;
+
+    memset(&record->header, 0, sizeof(record->header));
+    const RfidxStatus status = options->tag_type == MFC_1K
+                                   ? mfc1k_parse_binary(buffer, options->record_size,
+                                                        &record->data.mfc1k, &record->header.mfc)
+                                   : ntag215_parse_binary(buffer, options->record_size,
+                                                          &record->data.ntag215, &record->header.ntag21x);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    if (options->command != TRANSFORM_NONE) {
+        const RfidxStatus transform_status = stream_transform(record);
+        if (transform_status != RFIDX_OK) {
+            return transform_status;
+        }
+    }
+
+    return stream_write(record, output);
+}
+
+static RfidxStatus stream_prepare(RfidxContext *ctx, RfidxStreamOptions *options, StreamRecord *record) {
+    size_t data_size;
+    size_t max_size;
+    switch (options->tag_type) {
+        case NTAG_215:
+        case AMIIBO:
+            data_size = sizeof(Ntag215Data);
+            max_size = sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data);
+            break;
+        case MFC_1K:
+            data_size = sizeof(Mfc1kData);
+            max_size = sizeof(Mfc1kData);
+            break;
+        default:
+            return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    if (options->record_size == 0) {
+        options->record_size = max_size;
+    }
+    if (options->record_size != data_size && options->record_size != max_size) {
+        return RFIDX_BINARY_FILE_SIZE_ERROR;
+    }
+    if (options->output_format != FORMAT_BINARY && options->output_format != FORMAT_JSON) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    if (options->command != TRANSFORM_NONE && options->command != TRANSFORM_RANDOMIZE_UID &&
+        options->command != TRANSFORM_WIPE) {
+        return RFIDX_UNKNOWN_ENUM_ERROR;
+    }
+
+    if (options->command == TRANSFORM_RANDOMIZE_UID && rfidx_init_rng_ctx(ctx, NULL, NULL) != 0) {
+        return RFIDX_DRNG_ERROR;
+    }
+    if (options->tag_type == AMIIBO && options->command != TRANSFORM_NONE) {
+        if (!options->retail_key || amiibo_load_dumped_keys(options->retail_key, &record->dumped_keys) != RFIDX_OK) {
+            return RFIDX_NUMERICAL_OPERATION_FAILED;
+        }
+        if (options->uuid && hex_to_bytes(options->uuid, record->uuid, 8) != RFIDX_OK) {
+            return RFIDX_NUMERICAL_OPERATION_FAILED;
+        }
+    }
+
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_convert_stream(
+    RfidxContext *ctx,
+    const int input_fd,
+    FILE *output,
+    const RfidxStreamOptions *options,
+    size_t *records
+) {
+    if (records) *records = 0;
+
+    RfidxStreamOptions resolved = *options;
+    StreamRecord *record = rfidx_malloc(sizeof(StreamRecord));
+    if (!record) {
+        return RFIDX_MEMORY_ERROR;
+    }
+    memset(record, 0, sizeof(StreamRecord));
+    record->ctx = ctx;
+    record->options = &resolved;
+
+    RfidxStatus status = stream_prepare(ctx, &resolved, record);
+    if (status != RFIDX_OK) {
+        rfidx_free(record);
+        return status;
+    }
+
+    StreamReader reader = {0};
+    reader.fd = input_fd;
+    reader.chunk = resolved.record_size * RFIDX_STREAM_RECORDS_PER_BUFFER;
+    reader.status = RFIDX_OK;
+    reader.buffers[0] = rfidx_malloc(reader.chunk);
+    reader.buffers[1] = rfidx_malloc(reader.chunk);
+    if (!reader.buffers[0] || !reader.buffers[1]) {
+        rfidx_free(reader.buffers[0]);
+        rfidx_free(reader.buffers[1]);
+        rfidx_free(record);
+        return RFIDX_MEMORY_ERROR;
+    }
+    pthread_mutex_init(&reader.lock, NULL);
+    pthread_cond_init(&reader.cond, NULL);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, stream_reader_main, &reader) != 0) {
+        status = RFIDX_MEMORY_ERROR;
+    } else {
+        size_t converted = 0;
+        for (int i = 0; status == RFIDX_OK; i ^= 1) {
+            pthread_mutex_lock(&reader.lock);
+            while (!reader.full[i]) {
+                pthread_cond_wait(&reader.cond, &reader.lock);
+            }
+            const size_t length = reader.lengths[i];
+            status = reader.status;
+            pthread_mutex_unlock(&reader.lock);
+
+            const uint8_t *buffer = reader.buffers[i];
+            size_t offset = 0;
+            for (; status == RFIDX_OK && length - offset >= resolved.record_size; offset += resolved.record_size) {
+                status = stream_convert_record(record, buffer + offset, output);
+                if (status == RFIDX_OK) converted++;
+            }
+            if (status == RFIDX_OK && offset != length) {
+                status = RFIDX_BINARY_FILE_SIZE_ERROR;
+            }
+
+            pthread_mutex_lock(&reader.lock);
+            reader.full[i] = false;
+            if (status != RFIDX_OK) reader.stop = true;
+            pthread_cond_broadcast(&reader.cond);
+            pthread_mutex_unlock(&reader.lock);
+
+            if (length < reader.chunk) break;
+        }
+
+        pthread_join(thread, NULL);
+        if (status == RFIDX_OK && fflush(output) != 0) {
+            status = resolved.output_format == FORMAT_JSON ? RFIDX_JSON_FILE_IO_ERROR : RFIDX_BINARY_FILE_IO_ERROR;
+        }
+        if (records) *records = converted;
+    }
+
+    pthread_cond_destroy(&reader.cond);
+    pthread_mutex_destroy(&reader.lock);
+    rfidx_free(reader.buffers[0]);
+    rfidx_free(reader.buffers[1]);
+    // The record held the retail keys
+    memset(record, 0, sizeof(StreamRecord));
+    rfidx_free(record);
+
+    return status;
+}
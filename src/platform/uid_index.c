@@ -0,0 +1,399 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "librfidx/uid_index.h"
+#include "librfidx/archive.h"
+#include "librfidx/rfidx.h"
+#include "librfidx/ntag/ntag215.h"
+#include "librfidx/mifare/mifare_classic_1k.h"
+#include "../core/layout.h"
+
+/* Offsets of the fields in the index header */
+#define UID_INDEX_VERSION_OFFSET 8
+#define UID_INDEX_SLOT_COUNT_OFFSET 16
+#define UID_INDEX_RECORD_COUNT_OFFSET 24
+#define UID_INDEX_NAMES_LEN_OFFSET 32
+
+RfidxStatus rfidx_tag_uid(
+    const TagType tag_type,
+    const void *data,
+    uint8_t uid[RFIDX_UID_MAX_SIZE],
+    size_t *uid_len
+) {
+    switch (tag_type) {
+        case NTAG_215:
+        case AMIIBO: {
+            const Ntag21xManufacturerData *manufacturer = &((const Ntag215Data *) data)->structure.manufacturer_data;
+            memcpy(uid, manufacturer->uid0, 3);
+            memcpy(uid + 3, manufacturer->uid1, 4);
+            *uid_len = 7;
+            return RFIDX_OK;
+        }
+        case MFC_1K: {
+            // Same test as mfc_randomize_uid: a 4-byte NUID is followed by its BCC
+            const uint8_t *block0 = ((const Mfc1kData *) data)->blocks[0][0];
+            *uid_len = (block0[0] ^ block0[1] ^ block0[2] ^ block0[3]) == block0[4] ? 4 : 7;
+            memcpy(uid, block0, *uid_len);
+            return RFIDX_OK;
+        }
+        default:
+            return RFIDX_UNKNOWN_ENUM_ERROR;
+    }
+}
+
+static uint64_t uid_key(const uint8_t *uid, const size_t uid_len) {
+    uint64_t key = (uint64_t) uid_len << 56;
+    for (size_t i = 0; i < uid_len; i++) {
+        key |= (uint64_t) uid[i] << (8 * (uid_len - 1 - i));
+    }
+    return key;
+}
+
+/**
+ * @brief Spread a key over the table
+ *
+ * UIDs from one batch of tags often share their first bytes, so every bit of the key has to
+ * reach the low bits that pick the slot. This is the finalizer of SplitMix64.
+ */
+static uint64_t uid_hash(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBULL;
+    key ^= key >> 31;
+    return key;
+}
+
+/**
+ * @brief Records and UIDs collected before the table is sized
+ */
+typedef struct {
+    uint64_t *keys;                 /**< Key of every record, 0 if it could not be read */
+    uint64_t *name_offsets;         /**< count + 1 offsets into names */
+    char *names;
+    size_t names_len;
+    size_t names_cap;
+    size_t count;
+    size_t cap;
+    size_t indexed;
+} UidEntries;
+
+static void uid_entries_release(UidEntries *entries) {
+    rfidx_free(entries->keys);
+    rfidx_free(entries->name_offsets);
+    rfidx_free(entries->names);
+    memset(entries, 0, sizeof(*entries));
+}
+
+static RfidxStatus uid_entries_add(UidEntries *entries, const uint64_t key, const char *name, const size_t name_len) {
+    if (entries->count + 1 >= entries->cap) {
+        const size_t cap = entries->cap ? entries->cap * 2 : 1024;
+        uint64_t *keys = rfidx_realloc(entries->keys, cap * sizeof(uint64_t));
+        if (!keys) return RFIDX_MEMORY_ERROR;
+        entries->keys = keys;
+        uint64_t *name_offsets = rfidx_realloc(entries->name_offsets, cap * sizeof(uint64_t));
+        if (!name_offsets) return RFIDX_MEMORY_ERROR;
+        entries->name_offsets = name_offsets;
+        entries->cap = cap;
+    }
+    if (entries->names_len + name_len > entries->names_cap) {
+        size_t cap = entries->names_cap ? entries->names_cap * 2 : 4096;
+        while (cap < entries->names_len + name_len) cap *= 2;
+        char *names = rfidx_realloc(entries->names, cap);
+        if (!names) return RFIDX_MEMORY_ERROR;
+        entries->names = names;
+        entries->names_cap = cap;
+    }
+
+    if (name_len) memcpy(entries->names + entries->names_len, name, name_len);
+    entries->name_offsets[entries->count] = entries->names_len;
+    entries->keys[entries->count] = key;
+    entries->count++;
+    entries->names_len += name_len;
+    entries->name_offsets[entries->count] = entries->names_len;
+    if (key) entries->indexed++;
+    return RFIDX_OK;
+}
+
+static RfidxStatus uid_collect_archive(const char *source, UidEntries *entries, RfidxUidIndexSummary *summary) {
+    RfidxArchive archive;
+    RfidxStatus status = rfidx_archive_map(source, &archive);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    for (size_t i = 0; status == RFIDX_OK && i < archive.count; i++) {
+        // A damaged record keeps its number, without a name or a UID, so record numbers stay
+        // those of the archive
+        RfidxArchiveRecord record = {0};
+        uint64_t key = 0;
+        uint8_t uid[RFIDX_UID_MAX_SIZE];
+        size_t uid_len;
+        if (rfidx_archive_get(&archive, i, &record) == RFIDX_OK &&
+            rfidx_tag_uid(archive.tag_type, record.data, uid, &uid_len) == RFIDX_OK) {
+            key = uid_key(uid, uid_len);
+        } else {
+            record.name_len = 0;
+            summary->failed++;
+        }
+        status = uid_entries_add(entries, key, record.name, record.name_len);
+    }
+
+    rfidx_archive_unmap(&archive);
+    return status;
+}
+
+static RfidxStatus uid_collect_directory(const char *source, UidEntries *entries, RfidxUidIndexSummary *summary) {
+    RfidxFileList files;
+    RfidxStatus status = list_files(source, &files);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    for (size_t i = 0; status == RFIDX_OK && i < files.count; i++) {
+        char input[PATH_MAX];
+        if (snprintf(input, sizeof(input), "%s/%s", source, files.paths[i]) >= (int) sizeof(input)) {
+            summary->failed++;
+            continue;
+        }
+
+        void *data = NULL;
+        void *header = NULL;
+        const TagType tag_type = read_tag_from_file(input, TAG_UNSPECIFIED, &data, &header);
+        uint8_t uid[RFIDX_UID_MAX_SIZE];
+        size_t uid_len;
+        if (tag_type != TAG_UNKNOWN && tag_type != TAG_ERROR &&
+            rfidx_tag_uid(tag_type, data, uid, &uid_len) == RFIDX_OK) {
+            status = uid_entries_add(entries, uid_key(uid, uid_len), files.paths[i], strlen(files.paths[i]));
+        } else {
+            summary->failed++;
+        }
+        rfidx_free(data);
+        rfidx_free(header);
+    }
+
+    free_file_list(&files);
+    return status;
+}
+
+static void uid_copy_name(const UidEntries *entries, const size_t record, char *out, const size_t cap) {
+    const size_t len = (size_t) (entries->name_offsets[record + 1] - entries->name_offsets[record]);
+    if (len == 0) {
+        snprintf(out, cap, "#%zu", record);
+    } else {
+        snprintf(out, cap, "%.*s", (int) len, entries->names + entries->name_offsets[record]);
+    }
+}
+
+/**
+ * @brief Lay out the index file in one buffer
+ *
+ * Records are inserted in order, so the first record with a UID is always the one found
+ * first by a probe, and every later one is reported as its duplicate.
+ */
+static RfidxStatus uid_serialize(const UidEntries *entries, const RfidxUidDuplicateCallback on_duplicate,
+                                 void *user, RfidxUidIndexSummary *summary, uint8_t **out, size_t *out_len) {
+    // At most two thirds full, so probes stay short
+    size_t slot_count = 16;
+    while (slot_count < entries->indexed + entries->indexed / 2 + 1) slot_count *= 2;
+
+    const size_t slots_size = slot_count * RFIDX_UID_INDEX_SLOT_SIZE;
+    const size_t offsets_size = (entries->count + 1) * sizeof(uint64_t);
+    const size_t length = RFIDX_UID_INDEX_HEADER_SIZE + slots_size + offsets_size + entries->names_len;
+    uint8_t *buffer = rfidx_malloc(length);
+    if (!buffer) {
+        return RFIDX_MEMORY_ERROR;
+    }
+    memset(buffer, 0, length);
+
+    memcpy(buffer, RFIDX_UID_INDEX_MAGIC, 8);
+    put_u64(buffer + UID_INDEX_VERSION_OFFSET, RFIDX_UID_INDEX_VERSION);
+    put_u64(buffer + UID_INDEX_SLOT_COUNT_OFFSET, slot_count);
+    put_u64(buffer + UID_INDEX_RECORD_COUNT_OFFSET, entries->count);
+    put_u64(buffer + UID_INDEX_NAMES_LEN_OFFSET, entries->names_len);
+
+    uint8_t *slots = buffer + RFIDX_UID_INDEX_HEADER_SIZE;
+    for (size_t record = 0; record < entries->count; record++) {
+        const uint64_t key = entries->keys[record];
+        if (!key) continue;
+
+        bool duplicate = false;
+        size_t first = 0;
+        size_t slot = (size_t) uid_hash(key) & (slot_count - 1);
+        for (uint64_t stored; (stored = get_u64(slots + slot * RFIDX_UID_INDEX_SLOT_SIZE)) != 0;
+             slot = (slot + 1) & (slot_count - 1)) {
+            if (stored == key && !duplicate) {
+                duplicate = true;
+                first = (size_t) get_u64(slots + slot * RFIDX_UID_INDEX_SLOT_SIZE + 8);
+            }
+        }
+        put_u64(slots + slot * RFIDX_UID_INDEX_SLOT_SIZE, key);
+        put_u64(slots + slot * RFIDX_UID_INDEX_SLOT_SIZE + 8, record);
+
+        if (duplicate) {
+            summary->duplicates++;
+            if (on_duplicate) {
+                uint8_t uid[RFIDX_UID_MAX_SIZE];
+                const size_t uid_len = (size_t) (key >> 56);
+                for (size_t i = 0; i < uid_len; i++) uid[i] = (uint8_t) (key >> (8 * (uid_len - 1 - i)));
+                char first_name[PATH_MAX];
+                char duplicate_name[PATH_MAX];
+                uid_copy_name(entries, first, first_name, sizeof(first_name));
+                uid_copy_name(entries, record, duplicate_name, sizeof(duplicate_name));
+                on_duplicate(uid, uid_len, first_name, duplicate_name, user);
+            }
+        }
+    }
+
+    uint8_t *offsets = slots + slots_size;
+    for (size_t i = 0; i <= entries->count; i++) {
+        put_u64(offsets + i * sizeof(uint64_t), entries->name_offsets ? entries->name_offsets[i] : 0);
+    }
+    if (entries->names_len) {
+        memcpy(offsets + offsets_size, entries->names, entries->names_len);
+    }
+
+    *out = buffer;
+    *out_len = length;
+    return RFIDX_OK;
+}
+
+RfidxStatus rfidx_uid_index_build(
+    const char *source,
+    const char *filename,
+    const RfidxUidDuplicateCallback on_duplicate,
+    void *user,
+    RfidxUidIndexSummary *summary
+) {
+    RfidxUidIndexSummary local;
+    if (!summary) summary = &local;
+    memset(summary, 0, sizeof(*summary));
+
+    struct stat st;
+    if (stat(source, &st) != 0) {
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    UidEntries entries = {0};
+    RfidxStatus status = S_ISDIR(st.st_mode)
+                             ? uid_collect_directory(source, &entries, summary)
+                             : uid_collect_archive(source, &entries, summary);
+
+    uint8_t *buffer = NULL;
+    size_t length = 0;
+    if (status == RFIDX_OK) {
+        status = uid_serialize(&entries, on_duplicate, user, summary, &buffer, &length);
+    }
+    summary->indexed = entries.indexed;
+    uid_entries_release(&entries);
+
+    if (status == RFIDX_OK) {
+        status = write_file_atomic(filename, buffer, length);
+    }
+    rfidx_free(buffer);
+    return status;
+}
+
+RfidxStatus rfidx_uid_index_map(const char *filename, RfidxUidIndex *index) {
+    memset(index, 0, sizeof(*index));
+
+    RfidxStatus status = rfidx_map_file(filename, &index->mapping);
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    const uint8_t *base = index->mapping.base;
+    const uint64_t length = index->mapping.length;
+    status = RFIDX_FILE_FORMAT_ERROR;
+    if (length >= RFIDX_UID_INDEX_HEADER_SIZE && memcmp(base, RFIDX_UID_INDEX_MAGIC, 8) == 0 &&
+        get_u64(base + UID_INDEX_VERSION_OFFSET) == RFIDX_UID_INDEX_VERSION) {
+        const uint64_t slot_count = get_u64(base + UID_INDEX_SLOT_COUNT_OFFSET);
+        const uint64_t record_count = get_u64(base + UID_INDEX_RECORD_COUNT_OFFSET);
+        const uint64_t names_len = get_u64(base + UID_INDEX_NAMES_LEN_OFFSET);
+        const uint64_t room = length - RFIDX_UID_INDEX_HEADER_SIZE;
+
+        // Every size is checked against the file before it is multiplied, so nothing can wrap
+        if (slot_count != 0 && (slot_count & (slot_count - 1)) == 0 &&
+            slot_count <= room / RFIDX_UID_INDEX_SLOT_SIZE &&
+            record_count < (room - slot_count * RFIDX_UID_INDEX_SLOT_SIZE) / sizeof(uint64_t) &&
+            names_len == room - slot_count * RFIDX_UID_INDEX_SLOT_SIZE - (record_count + 1) * sizeof(uint64_t)) {
+            index->slot_count = (size_t) slot_count;
+            index->record_count = (size_t) record_count;
+            index->slots = base + RFIDX_UID_INDEX_HEADER_SIZE;
+            index->name_offsets = index->slots + index->slot_count * RFIDX_UID_INDEX_SLOT_SIZE;
+            index->names = (const char *) index->name_offsets + (index->record_count + 1) * sizeof(uint64_t);
+            index->names_len = (size_t) names_len;
+            status = RFIDX_OK;
+        }
+    }
+
+    if (status != RFIDX_OK) {
+        rfidx_uid_index_unmap(index);
+    }
+    return status;
+}
+
+size_t rfidx_uid_index_lookup(
+    const RfidxUidIndex *index,
+    const uint8_t *uid,
+    const size_t uid_len,
+    size_t *records,
+    const size_t max
+) {
+    if (uid_len == 0 || uid_len > RFIDX_UID_MAX_SIZE || index->slot_count == 0) {
+        return 0;
+    }
+
+    const uint64_t key = uid_key(uid, uid_len);
+    const size_t mask = index->slot_count - 1;
+    size_t found = 0;
+    size_t slot = (size_t) uid_hash(key) & mask;
+    // A full table has no empty slot to stop at, so the probe is also bounded by its size
+    for (size_t probes = 0; probes < index->slot_count; probes++, slot = (slot + 1) & mask) {
+        const uint8_t *entry = index->slots + slot * RFIDX_UID_INDEX_SLOT_SIZE;
+        const uint64_t stored = get_u64(entry);
+        if (stored == 0) break;
+        if (stored == key) {
+            if (found < max) records[found] = (size_t) get_u64(entry + 8);
+            found++;
+        }
+    }
+
+    return found;
+}
+
+RfidxStatus rfidx_uid_index_name(
+    const RfidxUidIndex *index,
+    const size_t record,
+    const char **name,
+    size_t *name_len
+) {
+    if (record >= index->record_count) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+
+    const uint64_t start = get_u64(index->name_offsets + record * sizeof(uint64_t));
+    const uint64_t end = get_u64(index->name_offsets + (record + 1) * sizeof(uint64_t));
+    if (start > end || end > index->names_len) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    *name = index->names + start;
+    *name_len = (size_t) (end - start);
+    return RFIDX_OK;
+}
+
+void rfidx_uid_index_unmap(RfidxUidIndex *index) {
+    rfidx_unmap_file(&index->mapping);
+    memset(index, 0, sizeof(*index));
+}
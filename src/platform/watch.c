@@ -0,0 +1,694 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "librfidx/watch.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <dirent.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include "mbedtls/sha256.h"
+#include "librfidx/rfidx.h"
+#include "librfidx/detect.h"
+#include "librfidx/batch.h"
+#include "librfidx/application/amiibo.h"
+
+#define WATCH_HASH_SIZE 32
+
+/**
+ * @brief One entry of a WatchTable
+ */
+typedef struct {
+    char *name;                 /**< NULL for an empty slot */
+    size_t key_len;             /**< Length of the key, the whole name or its output stem */
+    uint8_t hash[WATCH_HASH_SIZE]; /**< Content hash of the converted file */
+    bool running;               /**< Taken by a worker, for a queued name */
+    bool again;                 /**< Changed while being converted, for a queued name */
+} WatchRecord;
+
+/**
+ * @brief File names in a hash table, keyed by the whole name or by its output stem
+ *
+ * Open addressing with linear probing. The table is at most half full, and a removed record is
+ * filled by moving back the records after it, so a probe always ends at the key or at an empty slot.
+ */
+typedef struct {
+    WatchRecord *records;
+    size_t cap;                 /**< Always a power of two */
+    size_t count;
+} WatchTable;
+
+/**
+ * @brief What has been converted, loaded from the state file and appended to as files are converted
+ */
+typedef struct {
+    WatchTable converted;       /**< Names of the converted files and their hashes */
+    WatchTable owners;          /**< For every output stem, the name of the file it is converted from */
+    FILE *log;                  /**< The state file */
+} WatchState;
+
+/**
+ * @brief Names waiting for a worker, in arrival order
+ *
+ * A name is in the queue at most once. It stays in the pending table, which owns the copy of
+ * the name, until its conversion is done, so events for a name that is already queued or being
+ * converted do not start a second conversion of the same file.
+ */
+typedef struct {
+    char **names;
+    size_t head;
+    size_t count;
+    size_t cap;
+    WatchTable pending;         /**< Names queued or being converted */
+    bool closing;               /**< No more names will come, workers exit once the queue is empty */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} WatchQueue;
+
+typedef struct {
+    const char *input_dir;
+    const char *output_dir;
+    const RfidxWatchOptions *options;
+    const DumpedKeys *dumped_keys;
+    WatchQueue queue;
+    WatchState state;
+    pthread_mutex_t state_lock; /**< Guards the state, the summary and the callback */
+    RfidxWatchSummary summary;
+} WatchShared;
+
+typedef struct {
+    WatchShared *shared;
+    RfidxContext ctx;
+} WatchWorker;
+
+static size_t watch_table_home(const WatchTable *table, const char *key, const size_t len) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ (uint8_t) key[i]) * 1099511628211ULL;
+    }
+    return (size_t) hash & (table->cap - 1);
+}
+
+static size_t watch_table_slot(const WatchTable *table, const char *key, const size_t len) {
+    size_t slot = watch_table_home(table, key, len);
+    while (table->records[slot].name &&
+           (table->records[slot].key_len != len || memcmp(table->records[slot].name, key, len) != 0)) {
+        slot = (slot + 1) & (table->cap - 1);
+    }
+    return slot;
+}
+
+static RfidxStatus watch_table_grow(WatchTable *table) {
+    const WatchTable old = *table;
+    table->cap = old.cap ? old.cap * 2 : 64;
+    table->records = rfidx_malloc(sizeof(WatchRecord) * table->cap);
+    if (!table->records) {
+        *table = old;
+        return RFIDX_MEMORY_ERROR;
+    }
+    memset(table->records, 0, sizeof(WatchRecord) * table->cap);
+
+    for (size_t i = 0; i < old.cap; i++) {
+        if (old.records[i].name) {
+            table->records[watch_table_slot(table, old.records[i].name, old.records[i].key_len)] = old.records[i];
+        }
+    }
+    rfidx_free(old.records);
+    return RFIDX_OK;
+}
+
+static WatchRecord *watch_table_find(const WatchTable *table, const char *key, const size_t len) {
+    if (table->cap == 0) {
+        return NULL;
+    }
+    WatchRecord *record = &table->records[watch_table_slot(table, key, len)];
+    return record->name ? record : NULL;
+}
+
+/**
+ * @brief Find the record of a key, adding it if missing
+ * @param name The name, whose first len bytes are the key. Copied into a new record.
+ * @return The record, or NULL if memory ran out
+ */
+static WatchRecord *watch_table_add(WatchTable *table, const char *name, const size_t len) {
+    if ((table->count + 1) * 2 > table->cap && watch_table_grow(table) != RFIDX_OK) {
+        return NULL;
+    }
+
+    WatchRecord *record = &table->records[watch_table_slot(table, name, len)];
+    if (!record->name) {
+        const size_t name_len = strlen(name);
+        record->name = rfidx_malloc(name_len + 1);
+        if (!record->name) {
+            return NULL;
+        }
+        memcpy(record->name, name, name_len + 1);
+        record->key_len = len;
+        table->count++;
+    }
+    return record;
+}
+
+static void watch_table_remove(WatchTable *table, const char *key, const size_t len) {
+    if (table->cap == 0) {
+        return;
+    }
+    const size_t mask = table->cap - 1;
+    size_t hole = watch_table_slot(table, key, len);
+    if (!table->records[hole].name) {
+        return;
+    }
+    rfidx_free(table->records[hole].name);
+    table->count--;
+
+    // A record moves into the hole unless the hole is before its home slot, where probes start
+    for (size_t next = (hole + 1) & mask; table->records[next].name; next = (next + 1) & mask) {
+        const WatchRecord *record = &table->records[next];
+        const size_t home = watch_table_home(table, record->name, record->key_len);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            table->records[hole] = *record;
+            hole = next;
+        }
+    }
+    memset(&table->records[hole], 0, sizeof(WatchRecord));
+}
+
+static void watch_table_free(WatchTable *table) {
+    for (size_t i = 0; i < table->cap; i++) {
+        rfidx_free(table->records[i].name);
+    }
+    rfidx_free(table->records);
+}
+
+static RfidxStatus watch_state_put(WatchState *state, const char *name, const uint8_t hash[WATCH_HASH_SIZE]) {
+    WatchRecord *record = watch_table_add(&state->converted, name, strlen(name));
+    if (!record) {
+        return RFIDX_MEMORY_ERROR;
+    }
+    memcpy(record->hash, hash, WATCH_HASH_SIZE);
+
+    // Files converted before the collision check may share a stem, and the first one keeps it
+    return watch_table_add(&state->owners, name, output_stem_length(name)) ? RFIDX_OK : RFIDX_MEMORY_ERROR;
+}
+
+static bool watch_state_has(const WatchState *state, const char *name, const uint8_t hash[WATCH_HASH_SIZE]) {
+    const WatchRecord *record = watch_table_find(&state->converted, name, strlen(name));
+    return record && memcmp(record->hash, hash, WATCH_HASH_SIZE) == 0;
+}
+
+/**
+ * @brief Take the output of a file, unless it belongs to a file that only differs in its extension
+ * @param claimed Set to true if no file had the output before.
+ * @return RFIDX_OK, RFIDX_OUTPUT_COLLISION_ERROR if the output belongs to another file, or RFIDX_MEMORY_ERROR
+ */
+static RfidxStatus watch_state_claim(WatchState *state, const char *name, bool *claimed) {
+    const size_t stem_len = output_stem_length(name);
+    *claimed = false;
+    const WatchRecord *owner = watch_table_find(&state->owners, name, stem_len);
+    if (owner) {
+        return strcmp(owner->name, name) == 0 ? RFIDX_OK : RFIDX_OUTPUT_COLLISION_ERROR;
+    }
+
+    if (!watch_table_add(&state->owners, name, stem_len)) {
+        return RFIDX_MEMORY_ERROR;
+    }
+    *claimed = true;
+    return RFIDX_OK;
+}
+
+/**
+ * @brief Read the state file, then keep it open for appending
+ *
+ * Each line is the hex hash, a space and the file name. A name converted several times has
+ * several lines, and the last one wins.
+ */
+static RfidxStatus watch_state_open(WatchState *state, const char *output_dir) {
+    char path[PATH_MAX];
+    if (snprintf(path, sizeof(path), "%s/%s", output_dir, RFIDX_WATCH_STATE_FILE) >= (int) sizeof(path)) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+
+    RfidxStatus status = RFIDX_OK;
+    FILE *existing = fopen(path, "r");
+    if (existing) {
+        char *line = NULL;
+        size_t line_cap = 0;
+        ssize_t len;
+        while (status == RFIDX_OK && (len = getline(&line, &line_cap, existing)) > 0) {
+            if (line[len - 1] == '\n') line[--len] = '\0';
+            uint8_t hash[WATCH_HASH_SIZE];
+            // A torn last line from a crash is dropped, and the file converted again
+            if (len < WATCH_HASH_SIZE * 2 + 2 || line[WATCH_HASH_SIZE * 2] != ' ' ||
+                !hex_decode(line, WATCH_HASH_SIZE, hash)) {
+                continue;
+            }
+            status = watch_state_put(state, line + WATCH_HASH_SIZE * 2 + 1, hash);
+        }
+        // getline() allocates with the C library
+        free(line);
+        fclose(existing);
+    }
+    if (status != RFIDX_OK) {
+        return status;
+    }
+
+    state->log = fopen(path, "a");
+    return state->log ? RFIDX_OK : RFIDX_BINARY_FILE_IO_ERROR;
+}
+
+static void watch_state_close(WatchState *state) {
+    if (state->log) fclose(state->log);
+    watch_table_free(&state->converted);
+    watch_table_free(&state->owners);
+}
+
+static RfidxStatus watch_state_record(WatchState *state, const char *name, const uint8_t hash[WATCH_HASH_SIZE]) {
+    char hex[WATCH_HASH_SIZE * 2 + 1];
+    bytes_to_hex(hash, WATCH_HASH_SIZE, hex);
+    if (fprintf(state->log, "%s %s\n", hex, name) < 0 || fflush(state->log) != 0) {
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    return watch_state_put(state, name, hash);
+}
+
+static bool watch_queue_append(WatchQueue *queue, char *name) {
+    if (queue->count == queue->cap) {
+        const size_t cap = queue->cap ? queue->cap * 2 : 64;
+        char **names = rfidx_malloc(sizeof(char *) * cap);
+        if (!names) {
+            return false;
+        }
+        for (size_t i = 0; i < queue->count; i++) {
+            names[i] = queue->names[(queue->head + i) % queue->cap];
+        }
+        rfidx_free(queue->names);
+        queue->names = names;
+        queue->cap = cap;
+        queue->head = 0;
+    }
+    queue->names[(queue->head + queue->count) % queue->cap] = name;
+    queue->count++;
+    pthread_cond_signal(&queue->cond);
+    return true;
+}
+
+static void watch_queue_push(WatchQueue *queue, const char *name) {
+    const size_t len = strlen(name);
+
+    pthread_mutex_lock(&queue->lock);
+    WatchRecord *record = watch_table_find(&queue->pending, name, len);
+    if (record) {
+        // Already waiting, or converted again once the running conversion is done
+        if (record->running) record->again = true;
+    } else if ((record = watch_table_add(&queue->pending, name, len)) != NULL &&
+               !watch_queue_append(queue, record->name)) {
+        watch_table_remove(&queue->pending, name, len);
+    }
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static char *watch_queue_pop(WatchQueue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && !queue->closing) {
+        pthread_cond_wait(&queue->cond, &queue->lock);
+    }
+
+    char *name = NULL;
+    if (queue->count > 0) {
+        name = queue->names[queue->head];
+        queue->head = (queue->head + 1) % queue->cap;
+        queue->count--;
+        watch_table_find(&queue->pending, name, strlen(name))->running = true;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return name;
+}
+
+/**
+ * @brief Forget a name taken from the queue, or queue it again if it changed in the meantime
+ */
+static void watch_queue_done(WatchQueue *queue, const char *name) {
+    const size_t len = strlen(name);
+
+    pthread_mutex_lock(&queue->lock);
+    WatchRecord *record = watch_table_find(&queue->pending, name, len);
+    record->running = false;
+    if (!record->again || !watch_queue_append(queue, record->name)) {
+        watch_table_remove(&queue->pending, name, len);
+    } else {
+        record->again = false;
+    }
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static void watch_queue_close(WatchQueue *queue) {
+    pthread_mutex_lock(&queue->lock);
+    queue->closing = true;
+    pthread_cond_broadcast(&queue->cond);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static RfidxStatus watch_output_path(const WatchShared *shared, const char *name, char *output, const size_t cap) {
+    // Keep the input name, without its extension
+    char template[PATH_MAX];
+    if (snprintf(template, sizeof(template), "%s/%.*s.{ext}", shared->output_dir, (int) output_stem_length(name),
+                 name) >= (int) sizeof(template)) {
+        return RFIDX_BUFFER_SIZE_ERROR;
+    }
+    return expand_output_template(template, shared->options->output_format, output, cap);
+}
+
+static RfidxStatus watch_convert(WatchWorker *worker, const char *buffer, const size_t length, const char *output) {
+    const WatchShared *shared = worker->shared;
+    const RfidxWatchOptions *options = shared->options;
+
+    TagType tag_type;
+    FileFormat format;
+    if (rfidx_detect_tag((const uint8_t *) buffer, length, length, &tag_type, &format) != RFIDX_OK) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    if (options->input_type != TAG_UNSPECIFIED) {
+        tag_type = options->input_type;
+    }
+
+    void *data = NULL;
+    void *header = NULL;
+    RfidxStatus status = RFIDX_OK;
+    tag_type = read_tag_from_buffer(buffer, length, tag_type, format, &data, &header);
+    if (tag_type == TAG_UNKNOWN || tag_type == TAG_ERROR) {
+        status = tag_type == TAG_UNKNOWN ? RFIDX_FILE_FORMAT_ERROR : RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    if (status == RFIDX_OK && options->command != TRANSFORM_NONE) {
+        status = transform_tag_with_keys_ctx(
+            &worker->ctx, tag_type, options->command, &data, &header, options->uuid, shared->dumped_keys);
+    }
+    if (status == RFIDX_OK) {
+        status = write_tag_to_file_atomic(output, data, header, tag_type, options->output_format);
+    }
+
+    rfidx_free(data);
+    rfidx_free(header);
+    return status;
+}
+
+static void watch_process(WatchWorker *worker, const char *name) {
+    WatchShared *shared = worker->shared;
+
+    char input[PATH_MAX];
+    char output[PATH_MAX];
+    output[0] = '\0';
+    char *buffer = NULL;
+    size_t length = 0;
+    RfidxStatus status = RFIDX_OK;
+    if (snprintf(input, sizeof(input), "%s/%s", shared->input_dir, name) >= (int) sizeof(input)) {
+        status = RFIDX_BUFFER_SIZE_ERROR;
+    } else {
+        status = watch_output_path(shared, name, output, sizeof(output));
+    }
+    if (status == RFIDX_OK) {
+        status = read_file(input, &buffer, &length, RFIDX_BINARY_FILE_IO_ERROR);
+    }
+
+    uint8_t hash[WATCH_HASH_SIZE];
+    bool claimed = false;
+    if (status == RFIDX_OK) {
+        mbedtls_sha256((const unsigned char *) buffer, length, hash, 0);
+
+        pthread_mutex_lock(&shared->state_lock);
+        const bool done = watch_state_has(&shared->state, name, hash);
+        if (done) {
+            shared->summary.skipped++;
+        } else {
+            // Claimed before converting, so two files with the same stem are never written at once
+            status = watch_state_claim(&shared->state, name, &claimed);
+        }
+        pthread_mutex_unlock(&shared->state_lock);
+        if (done) {
+            rfidx_free(buffer);
+            return;
+        }
+    }
+
+    if (status == RFIDX_OK) {
+        status = watch_convert(worker, buffer, length, output);
+    }
+    rfidx_free(buffer);
+
+    pthread_mutex_lock(&shared->state_lock);
+    if (status == RFIDX_OK) {
+        status = watch_state_record(&shared->state, name, hash);
+    }
+    // A file that never converted does not keep its stem from the others
+    if (status != RFIDX_OK && claimed) {
+        watch_table_remove(&shared->state.owners, name, output_stem_length(name));
+    }
+    if (status == RFIDX_OK) {
+        shared->summary.converted++;
+    } else {
+        shared->summary.failed++;
+    }
+    if (shared->options->on_result) {
+        shared->options->on_result(name, output[0] ? output : NULL, status, shared->options->user);
+    }
+    pthread_mutex_unlock(&shared->state_lock);
+}
+
+static void *watch_worker_main(void *arg) {
+    WatchWorker *worker = arg;
+
+    char *name;
+    while ((name = watch_queue_pop(&worker->shared->queue)) != NULL) {
+        watch_process(worker, name);
+        watch_queue_done(&worker->shared->queue, name);
+    }
+
+    return NULL;
+}
+
+static RfidxStatus watch_scan(WatchShared *shared) {
+    DIR *dir = opendir(shared->input_dir);
+    if (!dir) {
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    const struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+
+        char path[PATH_MAX];
+        struct stat st;
+        if (snprintf(path, sizeof(path), "%s/%s", shared->input_dir, entry->d_name) >= (int) sizeof(path) ||
+            lstat(path, &st) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+        watch_queue_push(&shared->queue, entry->d_name);
+    }
+
+    closedir(dir);
+    return RFIDX_OK;
+}
+
+/**
+ * @brief Queue the files named by a batch of inotify events
+ * @return true if the kernel dropped events, and the directory must be scanned again
+ */
+static bool watch_dispatch(WatchShared *shared, const char *events, const size_t length) {
+    bool overflow = false;
+    for (size_t offset = 0; offset < length;) {
+        const struct inotify_event *event = (const struct inotify_event *) (events + offset);
+        offset += sizeof(struct inotify_event) + event->len;
+
+        if (event->mask & IN_Q_OVERFLOW) {
+            overflow = true;
+            continue;
+        }
+        // Names starting with a dot are skipped, so a dump can be written under one and renamed
+        if (event->len == 0 || (event->mask & IN_ISDIR) || event->name[0] == '.') continue;
+        watch_queue_push(&shared->queue, event->name);
+    }
+
+    return overflow;
+}
+
+static RfidxStatus watch_loop(WatchShared *shared, const int fd) {
+    char events[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    struct pollfd pfd = {.fd = fd, .events = POLLIN};
+
+    while (!*shared->options->stop) {
+        const int ready = poll(&pfd, 1, RFIDX_WATCH_POLL_INTERVAL);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            return RFIDX_BINARY_FILE_IO_ERROR;
+        }
+        if (ready == 0) continue;
+
+        const ssize_t length = read(fd, events, sizeof(events));
+        if (length < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            return RFIDX_BINARY_FILE_IO_ERROR;
+        }
+        if (watch_dispatch(shared, events, (size_t) length)) {
+            watch_scan(shared);
+        }
+    }
+
+    return RFIDX_OK;
+}
+
+static bool watch_same_directory(const char *a, const char *b) {
+    struct stat sa;
+    struct stat sb;
+    return stat(a, &sa) == 0 && stat(b, &sb) == 0 && sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino;
+}
+
+RfidxStatus rfidx_watch(
+    const char *input_dir,
+    const char *output_dir,
+    const RfidxWatchOptions *options,
+    RfidxWatchSummary *summary
+) {
+    if (summary) {
+        memset(summary, 0, sizeof(RfidxWatchSummary));
+    }
+    if (options->output_format != FORMAT_BINARY && options->output_format != FORMAT_JSON &&
+        options->output_format != FORMAT_NFC) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+    // Generating would replace every input with the same blank tag
+    if (options->command == TRANSFORM_GENERATE) {
+        return RFIDX_UNKNOWN_ENUM_ERROR;
+    }
+    if (mkdir(output_dir, 0777) != 0 && errno != EEXIST) {
+        return RFIDX_BINARY_FILE_IO_ERROR;
+    }
+    // Outputs in the watched directory would be picked up and converted again
+    if (watch_same_directory(input_dir, output_dir)) {
+        return RFIDX_FILE_FORMAT_ERROR;
+    }
+
+    unsigned int threads = options->threads;
+    if (threads == 0) {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (unsigned int) online : 1;
+    }
+    if (threads > RFIDX_BATCH_MAX_THREADS) threads = RFIDX_BATCH_MAX_THREADS;
+
+    WatchShared *shared = rfidx_malloc(sizeof(WatchShared));
+    WatchWorker *workers = rfidx_malloc(sizeof(WatchWorker) * threads);
+    pthread_t *handles = rfidx_malloc(sizeof(pthread_t) * threads);
+    DumpedKeys *dumped_keys = options->retail_key ? rfidx_malloc(sizeof(DumpedKeys)) : NULL;
+    if (!shared || !workers || !handles || (options->retail_key && !dumped_keys)) {
+        rfidx_free(shared);
+        rfidx_free(workers);
+        rfidx_free(handles);
+        rfidx_free(dumped_keys);
+        return RFIDX_MEMORY_ERROR;
+    }
+    memset(shared, 0, sizeof(WatchShared));
+    shared->input_dir = input_dir;
+    shared->output_dir = output_dir;
+    shared->options = options;
+    shared->dumped_keys = dumped_keys;
+    pthread_mutex_init(&shared->queue.lock, NULL);
+    pthread_cond_init(&shared->queue.cond, NULL);
+    pthread_mutex_init(&shared->state_lock, NULL);
+
+    RfidxStatus status = RFIDX_OK;
+    if (dumped_keys && amiibo_load_dumped_keys(options->retail_key, dumped_keys) != RFIDX_OK) {
+        status = RFIDX_NUMERICAL_OPERATION_FAILED;
+    }
+    if (status == RFIDX_OK) {
+        status = watch_state_open(&shared->state, output_dir);
+    }
+
+    // Watch before the first scan, so a file arriving in between is not missed
+    const int fd = status == RFIDX_OK ? inotify_init1(IN_NONBLOCK | IN_CLOEXEC) : -1;
+    if (status == RFIDX_OK &&
+        (fd < 0 || inotify_add_watch(fd, input_dir, IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR) < 0)) {
+        status = RFIDX_BINARY_FILE_IO_ERROR;
+    }
+
+    unsigned int started = 0;
+    if (status == RFIDX_OK) {
+        for (; started < threads; started++) {
+            workers[started].shared = shared;
+            rfidx_context_init(&workers[started].ctx);
+            if (pthread_create(&handles[started], NULL, watch_worker_main, &workers[started]) != 0) {
+                rfidx_context_free(&workers[started].ctx);
+                break;
+            }
+        }
+        if (started == 0) {
+            status = RFIDX_MEMORY_ERROR;
+        }
+    }
+    if (status == RFIDX_OK) {
+        status = watch_scan(shared);
+    }
+    if (status == RFIDX_OK && options->stop) {
+        status = watch_loop(shared, fd);
+    }
+
+    // Files already queued are still converted
+    watch_queue_close(&shared->queue);
+    for (unsigned int i = 0; i < started; i++) {
+        pthread_join(handles[i], NULL);
+        rfidx_context_free(&workers[i].ctx);
+    }
+    if (fd >= 0) close(fd);
+
+    if (summary) *summary = shared->summary;
+
+    // The names still queued belong to the pending table
+    rfidx_free(shared->queue.names);
+    watch_table_free(&shared->queue.pending);
+    watch_state_close(&shared->state);
+    pthread_mutex_destroy(&shared->state_lock);
+    pthread_cond_destroy(&shared->queue.cond);
+    pthread_mutex_destroy(&shared->queue.lock);
+    if (dumped_keys) {
+        memset(dumped_keys, 0, sizeof(DumpedKeys));
+        rfidx_free(dumped_keys);
+    }
+    rfidx_free(shared);
+    rfidx_free(workers);
+    rfidx_free(handles);
+    return status;
+}
+
+#else
+
+RfidxStatus rfidx_watch(
+    const char *input_dir,
+    const char *output_dir,
+    const RfidxWatchOptions *options,
+    RfidxWatchSummary *summary
+) {
+    (void) input_dir;
+    (void) output_dir;
+    (void) options;
+    (void) summary;
+
+    // Watching relies on inotify
+    return RFIDX_UNKNOWN_ENUM_ERROR;
+}
+
+#endif
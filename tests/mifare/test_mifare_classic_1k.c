@@ -9,12 +9,17 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <setjmp.h>
 #include <unistd.h>
 #include <cJSON.h>
 #include <cmocka.h>
 #include "librfidx/mifare/mifare_classic_1k.h"
 
+cJSON *mfc1k_dump_header_to_json(const MfcMetadataHeader *header);
+cJSON *mfc1k_dump_data_to_json(const Mfc1kData *mfc1k);
+cJSON *mfc1k_dump_keys_to_json(const Mfc1kData *mfc1k);
+
 static void assert_manufacturer_correct(const Mfc1kData *mfc1k) {
     const uint8_t expected_uid[4]                   = {0x2A, 0xF9, 0x02, 0x4A};
     const uint8_t expected_manufacturer_data[12]    = {0x88, 0x04, 0x00, 0xC8, 0x48, 0x00,
@@ -30,6 +35,73 @@ static void assert_manufacturer_correct(const Mfc1kData *mfc1k) {
         );
 }
 
+static void test_mfc1k_serialize_json_matches_cjson(void **state) {
+    (void) state;
+    Mfc1kData data;
+    MfcMetadataHeader header;
+    for (size_t i = 0; i < sizeof(data); i++) ((uint8_t *) &data)[i] = (uint8_t) (i * 7);
+    for (size_t i = 0; i < sizeof(header); i++) ((uint8_t *) &header)[i] = (uint8_t) (i * 13 + 1);
+
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "Created", JSON_FORMAT_CREATOR);
+    cJSON_AddStringToObject(root, "FileType", "mfc v2");
+    cJSON_AddItemToObject(root, "Card", mfc1k_dump_header_to_json(&header));
+    cJSON_AddItemToObject(root, "blocks", mfc1k_dump_data_to_json(&data));
+    cJSON_AddItemToObject(root, "SectorKeys", mfc1k_dump_keys_to_json(&data));
+
+    char *expected = cJSON_Print(root);
+    char *json = mfc1k_serialize_json(&data, &header);
+    assert_non_null(json);
+    assert_string_equal(json, expected);
+    rfidx_free(json);
+    cJSON_free(expected);
+
+    expected = cJSON_PrintUnformatted(root);
+    json = mfc1k_serialize_json_unformatted(&data, &header);
+    assert_non_null(json);
+    assert_string_equal(json, expected);
+    rfidx_free(json);
+    cJSON_free(expected);
+
+    cJSON_Delete(root);
+}
+
+static void test_mfc1k_serialize_into(void **state) {
+    (void) state;
+    Mfc1kData data;
+    MfcMetadataHeader header = {.uid = {0x2A, 0xF9, 0x02, 0x4A}, .atqa = {0x00, 0x04}, .sak = 0x08};
+    for (size_t i = 0; i < sizeof(data); i++) ((uint8_t *) &data)[i] = (uint8_t) (i * 7);
+
+    char text[8192];
+    size_t written;
+
+    char *nfc = mfc1k_serialize_nfc(&data, &header);
+    assert_non_null(nfc);
+    const size_t nfc_size = mfc1k_serialized_size(FORMAT_NFC, &data, &header);
+    assert_int_equal(nfc_size, strlen(nfc) + 1);
+    assert_int_equal(mfc1k_serialize_nfc_into(&data, &header, text, nfc_size, &written), RFIDX_OK);
+    assert_int_equal(written, nfc_size - 1);
+    assert_string_equal(text, nfc);
+    assert_int_equal(mfc1k_serialize_nfc_into(&data, &header, text, nfc_size - 1, &written), RFIDX_BUFFER_SIZE_ERROR);
+    rfidx_free(nfc);
+
+    char *json = mfc1k_serialize_json(&data, &header);
+    assert_non_null(json);
+    const size_t json_size = mfc1k_serialized_size(FORMAT_JSON, &data, &header);
+    assert_int_equal(json_size, strlen(json) + 1);
+    assert_int_equal(mfc1k_serialize_json_into(&data, &header, text, json_size, &written), RFIDX_OK);
+    assert_string_equal(text, json);
+    rfidx_free(json);
+
+    uint8_t binary[sizeof(Mfc1kData)];
+    assert_int_equal(mfc1k_serialized_size(FORMAT_BINARY, &data, &header), sizeof(binary));
+    assert_int_equal(mfc1k_serialize_binary_into(&data, &header, binary, sizeof(binary), &written), RFIDX_OK);
+    assert_int_equal(written, sizeof(binary));
+    assert_memory_equal(binary, &data, sizeof(data));
+    assert_int_equal(mfc1k_serialize_binary_into(&data, &header, NULL, sizeof(binary), &written),
+                     RFIDX_BUFFER_SIZE_ERROR);
+}
+
 static void test_mfc1k_load_binary_dump_real(void **state) {
     const char filename[] = "tests/assets/mifare-classic-1k-v2.bin";
     Mfc1kData loaded_data = {0};
@@ -41,6 +113,26 @@ static void test_mfc1k_load_binary_dump_real(void **state) {
     assert_manufacturer_correct(&loaded_data);
 }
 
+static void test_mfc1k_map_binary(void **state) {
+    (void) state;
+    const char filename[] = "tests/assets/mifare-classic-1k-v2.bin";
+    Mfc1kData loaded_data = {0};
+    MfcMetadataHeader loaded_header = {0};
+    assert_int_equal(mfc1k_load_from_binary(filename, &loaded_data, &loaded_header), RFIDX_OK);
+
+    RfidxMapping mapping;
+    const Mfc1kData *data = NULL;
+    RfidxStatus status = mfc1k_map_binary(filename, &mapping, &data);
+    assert_int_equal(status, RFIDX_OK);
+    assert_ptr_equal(data, mapping.base);
+    assert_memory_equal(data, &loaded_data, sizeof(loaded_data));
+    rfidx_unmap_file(&mapping);
+
+    status = mfc1k_map_binary("tests/assets/ntag215.bin", &mapping, &data);
+    assert_int_equal(status, RFIDX_BINARY_FILE_SIZE_ERROR);
+    assert_null(mapping.base);
+}
+
 static void test_mfc1k_save_binary_and_reload(void **state) {
     const char filename[] = "tests/assets/mifare-classic-1k-v2.bin";
     char tmp_filename[] = "/tmp/mfc1k-test-XXXXXX";
@@ -133,7 +225,10 @@ static void test_mfc1k_save_nfc_dump_and_reload(void **state) {
 }
 
 static const struct CMUnitTest mfc1k_tests[] = {
+    cmocka_unit_test(test_mfc1k_serialize_json_matches_cjson),
+    cmocka_unit_test(test_mfc1k_serialize_into),
     cmocka_unit_test(test_mfc1k_load_binary_dump_real),
+    cmocka_unit_test(test_mfc1k_map_binary),
     cmocka_unit_test(test_mfc1k_save_binary_and_reload),
     cmocka_unit_test(test_mfc1k_load_json_dump_real),
     cmocka_unit_test(test_mfc1k_save_json_dump_and_reload),
@@ -286,6 +286,40 @@ static void test_ntag215_parse_json_errors(void **state) {
     assert_int_equal(status, RFIDX_JSON_PARSE_ERROR);
 }
 
+static void test_ntag215_parse_json_out_of_order(void **state) {
+    (void) state;
+    char json[4096];
+    size_t len = 0;
+
+    // blocks before Card, keys in any case, duplicates after the first match and unrelated members
+    len += (size_t) snprintf(json + len, sizeof(json) - len, "{\"BLOCKS\": {\"135\": 7, \"05\": \"zz\"");
+    for (int i = NTAG215_NUM_USER_PAGES - 1; i >= 0; i--) {
+        len += (size_t) snprintf(json + len, sizeof(json) - len, ", \"%d\": \"%08X\"", i, i);
+    }
+    len += (size_t) snprintf(json + len, sizeof(json) - len,
+        ", \"0\": \"FFFFFFFF\"}, \"Extra\": [1, {\"a\": null}], \"card\": {"
+        "\"version\": \"0004040201001103\", \"TBO_0\": \"0000\", \"TBO_1\": \"00\", "
+        "\"Signature\": \"0000000000000000000000000000000000000000000000000000000000000000\", "
+        "\"Counter0\": \"000000\", \"Tearing0\": \"00\", \"Counter1\": \"000000\", \"Tearing1\": \"00\", "
+        "\"Counter2\": \"000000\", \"Tearing2\": \"00\", \"VERSION\": 1}, \"blocks\": 1}");
+    assert_true(len < sizeof(json));
+
+    Ntag215Data data = {0};
+    Ntag21xMetadataHeader header = {0};
+    assert_int_equal(ntag215_parse_json(json, &data, &header), RFIDX_OK);
+    assert_header_correct(&header);
+    for (int i = 0; i < NTAG215_NUM_USER_PAGES; i++) {
+        assert_int_equal(data.pages[i][3], i & 0xFF);
+    }
+
+    // The same document with a trailing comma in blocks is rejected
+    char *comma = strstr(json, "\"FFFFFFFF\"}");
+    assert_non_null(comma);
+    memmove(comma + 11, comma + 10, strlen(comma + 10) + 1);
+    comma[10] = ',';
+    assert_int_equal(ntag215_parse_json(json, &data, &header), RFIDX_JSON_PARSE_ERROR);
+}
+
 static void test_ntag215_dump_header_to_json(void **state) {
     (void) state;
     Ntag21xMetadataHeader header = {0};
@@ -319,6 +353,82 @@ static void test_ntag215_serialize_json(void **state) {
     // free(json);
 }
 
+static void test_ntag215_serialize_json_matches_cjson(void **state) {
+    (void) state;
+    Ntag215Data data;
+    Ntag21xMetadataHeader header;
+    for (size_t i = 0; i < sizeof(data); i++) ((uint8_t *) &data)[i] = (uint8_t) (i * 7);
+    for (size_t i = 0; i < sizeof(header); i++) ((uint8_t *) &header)[i] = (uint8_t) (i * 13);
+
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "Created", JSON_FORMAT_CREATOR);
+    cJSON_AddStringToObject(root, "FileType", "mfu");
+    cJSON_AddItemToObject(root, "Card", ntag215_dump_header_to_json(&header));
+    cJSON_AddItemToObject(root, "blocks", ntag215_dump_data_to_json(&data));
+
+    char *expected = cJSON_Print(root);
+    char *json = ntag215_serialize_json(&data, &header);
+    assert_non_null(json);
+    assert_string_equal(json, expected);
+    rfidx_free(json);
+    cJSON_free(expected);
+
+    expected = cJSON_PrintUnformatted(root);
+    json = ntag215_serialize_json_unformatted(&data, &header);
+    assert_non_null(json);
+    assert_string_equal(json, expected);
+    rfidx_free(json);
+    cJSON_free(expected);
+
+    cJSON_Delete(root);
+}
+
+static void test_ntag215_serialize_into(void **state) {
+    (void) state;
+    Ntag215Data data;
+    Ntag21xMetadataHeader header;
+    for (size_t i = 0; i < sizeof(data); i++) ((uint8_t *) &data)[i] = (uint8_t) (i * 7);
+    for (size_t i = 0; i < sizeof(header); i++) ((uint8_t *) &header)[i] = (uint8_t) (i * 13);
+
+    char text[8192];
+    size_t written;
+
+    char *nfc = ntag215_serialize_nfc(&data, &header);
+    assert_non_null(nfc);
+    const size_t nfc_size = ntag215_serialized_size(FORMAT_NFC, &data, &header);
+    assert_int_equal(nfc_size, strlen(nfc) + 1);
+    assert_int_equal(ntag215_serialize_nfc_into(&data, &header, text, nfc_size, &written), RFIDX_OK);
+    assert_int_equal(written, nfc_size - 1);
+    assert_string_equal(text, nfc);
+    rfidx_free(nfc);
+
+    // One byte short fails without writing past the end
+    memset(text, 0x5A, sizeof(text));
+    assert_int_equal(ntag215_serialize_nfc_into(&data, &header, text, nfc_size - 1, &written), RFIDX_BUFFER_SIZE_ERROR);
+    assert_int_equal((uint8_t) text[nfc_size - 1], 0x5A);
+
+    char *json = ntag215_serialize_json(&data, &header);
+    assert_non_null(json);
+    const size_t json_size = ntag215_serialized_size(FORMAT_JSON, &data, &header);
+    assert_int_equal(json_size, strlen(json) + 1);
+    assert_int_equal(ntag215_serialize_json_into(&data, &header, text, json_size, &written), RFIDX_OK);
+    assert_int_equal(written, json_size - 1);
+    assert_string_equal(text, json);
+    assert_int_equal(ntag215_serialize_json_into(&data, &header, text, json_size - 1, &written), RFIDX_BUFFER_SIZE_ERROR);
+    rfidx_free(json);
+
+    uint8_t binary[sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data)];
+    assert_int_equal(ntag215_serialized_size(FORMAT_BINARY, &data, &header), sizeof(binary));
+    assert_int_equal(ntag215_serialize_binary_into(&data, &header, binary, sizeof(binary), &written), RFIDX_OK);
+    assert_int_equal(written, sizeof(binary));
+    assert_memory_equal(binary, &header, sizeof(header));
+    assert_memory_equal(binary + sizeof(header), &data, sizeof(data));
+    assert_int_equal(ntag215_serialize_binary_into(&data, &header, binary, sizeof(binary) - 1, &written),
+                     RFIDX_BUFFER_SIZE_ERROR);
+
+    assert_int_equal(ntag215_serialized_size(FORMAT_EML, &data, &header), 0);
+}
+
 static void test_ntag215_parse_nfc_success(void **state) {
     (void) state;
     char *nfc = read_file("tests/assets/ntag215.nfc");
@@ -357,6 +467,35 @@ static void test_ntag215_parse_nfc_errors(void **state) {
     free(nfc);
 }
 
+static void test_ntag215_parse_nfc_crlf(void **state) {
+    (void) state;
+    Ntag215Data expected_data = {0};
+    Ntag21xMetadataHeader expected_header = {0};
+    char *nfc = read_file("tests/assets/ntag215.nfc");
+    assert_int_equal(ntag215_parse_nfc(nfc, &expected_data, &expected_header), RFIDX_OK);
+
+    // Rewrite with CRLF line endings and without the final newline
+    const size_t len = strlen(nfc);
+    char *crlf = malloc(len * 2 + 1);
+    assert_non_null(crlf);
+    size_t out = 0;
+    for (size_t i = 0; i < len; i++) {
+        if (nfc[i] == '\n') crlf[out++] = '\r';
+        crlf[out++] = nfc[i];
+    }
+    while (out > 0 && (crlf[out - 1] == '\n' || crlf[out - 1] == '\r')) out--;
+    crlf[out] = '\0';
+
+    Ntag215Data data = {0};
+    Ntag21xMetadataHeader header = {0};
+    assert_int_equal(ntag215_parse_nfc(crlf, &data, &header), RFIDX_OK);
+    assert_memory_equal(&data, &expected_data, sizeof(Ntag215Data));
+    assert_memory_equal(&header, &expected_header, sizeof(Ntag21xMetadataHeader));
+
+    free(crlf);
+    free(nfc);
+}
+
 static void test_ntag215_serialize_nfc(void **state) {
     (void) state;
     Ntag215Data data = {0};
@@ -552,6 +691,33 @@ static void test_ntag215_load_binary_dump_real(void **state) {
     assert_header_correct(&loaded_header);
 }
 
+static void test_ntag215_map_binary(void **state) {
+    (void) state;
+    Ntag215Data loaded_data = {0};
+    Ntag21xMetadataHeader loaded_header = {0};
+    assert_int_equal(ntag215_load_from_binary("tests/assets/ntag215.bin", &loaded_data, &loaded_header), RFIDX_OK);
+
+    RfidxMapping mapping;
+    const Ntag215Data *data = NULL;
+    const Ntag21xMetadataHeader *header = NULL;
+    RfidxStatus status = ntag215_map_binary("tests/assets/ntag215.bin", &mapping, &data, &header);
+    assert_int_equal(status, RFIDX_OK);
+    assert_non_null(header);
+    assert_ptr_equal(header, mapping.base);
+    assert_memory_equal(header, &loaded_header, sizeof(loaded_header));
+    assert_memory_equal(data, &loaded_data, sizeof(loaded_data));
+    rfidx_unmap_file(&mapping);
+    assert_null(mapping.base);
+
+    // A dump of the wrong size is rejected and leaves nothing mapped
+    status = ntag215_map_binary("tests/assets/mifare-classic-1k-v2.bin", &mapping, &data, &header);
+    assert_int_equal(status, RFIDX_BINARY_FILE_SIZE_ERROR);
+    assert_null(mapping.base);
+
+    status = ntag215_map_binary("tests/assets/does-not-exist.bin", &mapping, &data, &header);
+    assert_int_equal(status, RFIDX_BINARY_FILE_IO_ERROR);
+}
+
 static void test_ntag215_load_json_dump_real(void **state) {
     const char filename[] = "tests/assets/ntag215.json";
     Ntag215Data loaded_data = {0};
@@ -630,11 +796,15 @@ static const struct CMUnitTest ntag215_tests[] = {
     cmocka_unit_test(test_ntag215_parse_data_from_json_missing_or_invalid),
     cmocka_unit_test(test_ntag215_parse_json_success),
     cmocka_unit_test(test_ntag215_parse_json_errors),
+    cmocka_unit_test(test_ntag215_parse_json_out_of_order),
     cmocka_unit_test(test_ntag215_dump_header_to_json),
     cmocka_unit_test(test_ntag215_dump_data_to_json),
     cmocka_unit_test(test_ntag215_serialize_json),
+    cmocka_unit_test(test_ntag215_serialize_json_matches_cjson),
+    cmocka_unit_test(test_ntag215_serialize_into),
     cmocka_unit_test(test_ntag215_parse_nfc_success),
     cmocka_unit_test(test_ntag215_parse_nfc_errors),
+    cmocka_unit_test(test_ntag215_parse_nfc_crlf),
     cmocka_unit_test(test_ntag215_serialize_nfc),
     cmocka_unit_test(test_ntag215_generate_success),
     cmocka_unit_test(test_ntag215_wipe),
@@ -648,6 +818,7 @@ static const struct CMUnitTest ntag215_tests[] = {
     cmocka_unit_test(test_ntag215_load_binary_dump_with_header),
     cmocka_unit_test(test_ntag215_save_binary_and_reload),
     cmocka_unit_test(test_ntag215_load_binary_dump_real),
+    cmocka_unit_test(test_ntag215_map_binary),
     cmocka_unit_test(test_ntag215_load_json_dump_real),
     cmocka_unit_test(test_ntag215_save_json_dump_and_reload),
     cmocka_unit_test(test_ntag215_load_nfc_dump_real),
@@ -0,0 +1,149 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "librfidx/columns.h"
+#include "librfidx/application/amiibo_core.h"
+#include "librfidx/mifare/mifare_classic_1k.h"
+
+static void test_columns_filter_column(void **state) {
+    (void) state;
+    // Values around the sign bit of both halves catch signed compares
+    static const uint64_t constants[] = {
+        0, 1, 0x7FFFFFFFULL, 0x80000000ULL, 0x100000000ULL, 0x7FFFFFFFFFFFFFFFULL,
+        0x8000000000000000ULL, 0xFFFFFFFF00000000ULL, UINT64_MAX
+    };
+    const size_t constant_count = sizeof(constants) / sizeof(constants[0]);
+    uint64_t column[150];
+    for (size_t i = 0; i < 150; i++) {
+        column[i] = constants[(i * 7) % constant_count] + (i % 3 == 0 ? 1 : 0);
+    }
+
+    for (int op = RFIDX_COMPARE_EQ; op <= RFIDX_COMPARE_GE; op++) {
+        for (size_t c = 0; c < constant_count; c++) {
+            uint64_t bitmap[3];
+            memset(bitmap, 0xFF, sizeof(bitmap));
+            rfidx_filter_column(column, 150, (RfidxCompareOp) op, constants[c], bitmap);
+
+            for (size_t i = 0; i < 192; i++) {
+                bool expected = false;
+                if (i < 150) {
+                    const uint64_t a = column[i];
+                    const uint64_t b = constants[c];
+                    switch (op) {
+                        case RFIDX_COMPARE_EQ: expected = a == b; break;
+                        case RFIDX_COMPARE_NE: expected = a != b; break;
+                        case RFIDX_COMPARE_LT: expected = a < b; break;
+                        case RFIDX_COMPARE_LE: expected = a <= b; break;
+                        case RFIDX_COMPARE_GT: expected = a > b; break;
+                        default: expected = a >= b; break;
+                    }
+                }
+                assert_int_equal(bitmap[i / 64] >> (i % 64) & 1, expected);
+            }
+        }
+    }
+}
+
+static void test_columns_query_amiibo(void **state) {
+    (void) state;
+    RfidxColumnStore store;
+    assert_int_equal(rfidx_columns_init(&store, AMIIBO, 0), RFIDX_OK);
+    assert_null(rfidx_columns_find(&store, "sak"));
+    assert_non_null(rfidx_columns_find(&store, "amiibo_id"));
+
+    AmiiboData data;
+    Ntag21xMetadataHeader header;
+    memset(&data, 0, sizeof(data));
+    memset(&header, 0, sizeof(header));
+    for (uint8_t i = 0; i < 100; i++) {
+        data.amiibo.model_info.amiibo_id[0] = 0;
+        data.amiibo.model_info.amiibo_id[1] = i % 4;
+        data.amiibo.model_info.set = i % 5;
+        data.amiibo.manufacturer_data.uid0[0] = 0x04;
+        data.amiibo.manufacturer_data.uid1[3] = i;
+        assert_int_equal(rfidx_columns_append(&store, &data, &header), RFIDX_OK);
+    }
+    assert_int_equal(store.count, 100);
+    assert_int_equal(rfidx_columns_find(&store, "uid")[5], 0x04000000000005ULL);
+
+    uint64_t *bitmap = NULL;
+    size_t matches = 0;
+    assert_int_equal(rfidx_query(&store, "amiibo_id == 0x0001 && set == 2", &bitmap, &matches), RFIDX_OK);
+    assert_int_equal(matches, 5);
+    for (size_t i = 0; i < 100; i++) {
+        assert_int_equal(bitmap[i / 64] >> (i % 64) & 1, i % 4 == 1 && i % 5 == 2);
+    }
+    rfidx_free(bitmap);
+
+    assert_int_equal(rfidx_query(&store, "!(amiibo_id != 1 || set >= 3) || uid<=0x04000000000001", &bitmap,
+                                 &matches), RFIDX_OK);
+    size_t expected = 0;
+    for (size_t i = 0; i < 100; i++) {
+        if ((i % 4 == 1 && i % 5 < 3) || i <= 1) expected++;
+    }
+    assert_int_equal(matches, expected);
+    // Negation leaves the bits past the last dump clear
+    assert_int_equal(bitmap[1] >> 36, 0);
+    rfidx_free(bitmap);
+
+    const char *invalid[] = {"", "set", "set ==", "set == x", "sak == 1", "(set == 1", "set == 1)", "set = 1",
+                             "set == 1 &&", "set == 99999999999999999999"};
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        assert_int_equal(rfidx_query(&store, invalid[i], &bitmap, &matches), RFIDX_QUERY_ERROR);
+        assert_null(bitmap);
+    }
+
+    rfidx_columns_free(&store);
+}
+
+static void test_columns_mfc1k(void **state) {
+    (void) state;
+    Mfc1kData data;
+    MfcMetadataHeader header;
+    assert_int_equal(mfc1k_load_from_binary("./tests/assets/mifare-classic-1k-v2.bin", &data, &header), RFIDX_OK);
+
+    RfidxColumnStore store;
+    assert_int_equal(rfidx_columns_init(&store, MFC_1K, 2), RFIDX_OK);
+    assert_int_equal(store.column_count, 35);
+    assert_string_equal(rfidx_columns_name(&store, 34), "key_b15");
+    assert_null(rfidx_columns_name(&store, 35));
+    assert_int_equal(rfidx_columns_append(&store, &data, &header), RFIDX_OK);
+    memset(data.structure.sector[3].sector_trailer.key_a, 0xA0, 6);
+    assert_int_equal(rfidx_columns_append(&store, &data, &header), RFIDX_OK);
+
+    assert_int_equal(rfidx_columns_find(&store, "key_a3")[1], 0xA0A0A0A0A0A0ULL);
+    // A binary dump has no header, so the UID is the one in block 0
+    uint64_t uid = 0;
+    for (size_t i = 0; i < 4; i++) uid = uid << 8 | data.manufacturer_data_4b.nuid[i];
+    assert_int_equal(rfidx_columns_find(&store, "uid")[0], uid);
+
+    uint64_t *bitmap = NULL;
+    size_t matches = 0;
+    assert_int_equal(rfidx_query(&store, "key_a3 == 0xA0A0A0A0A0A0", &bitmap, &matches), RFIDX_OK);
+    assert_int_equal(matches, 1);
+    assert_int_equal(bitmap[0], 2);
+    rfidx_free(bitmap);
+
+    rfidx_columns_free(&store);
+}
+
+static const struct CMUnitTest columns_tests[] = {
+    cmocka_unit_test(test_columns_filter_column),
+    cmocka_unit_test(test_columns_query_amiibo),
+    cmocka_unit_test(test_columns_mfc1k),
+};
+
+const struct CMUnitTest *get_columns_tests(size_t *count) {
+    if (count) *count = sizeof(columns_tests) / sizeof(columns_tests[0]);
+    return columns_tests;
+}
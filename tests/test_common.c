@@ -0,0 +1,326 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "librfidx/common.h"
+#include "librfidx/ntag/ntag215.h"
+#include "librfidx/ntag/ntag21x.h"
+#include "../src/core/nfc_reader.h"
+
+typedef struct {
+    size_t allocations;
+    size_t releases;
+} CountingAllocator;
+
+static void *counting_malloc(const size_t size, void *ctx) {
+    ((CountingAllocator *) ctx)->allocations++;
+    return malloc(size);
+}
+
+static void *counting_realloc(void *ptr, const size_t size, void *ctx) {
+    if (!ptr) ((CountingAllocator *) ctx)->allocations++;
+    return realloc(ptr, size);
+}
+
+static void counting_free(void *ptr, void *ctx) {
+    if (ptr) ((CountingAllocator *) ctx)->releases++;
+    free(ptr);
+}
+
+static void test_common_hex_round_trip(void **state) {
+    (void) state;
+    uint8_t bytes[256];
+    for (int i = 0; i < 256; i++) {
+        bytes[i] = (uint8_t) i;
+    }
+
+    // Cover the scalar, SSE2 and AVX2 paths together with their tails
+    for (size_t len = 0; len <= sizeof(bytes); len += (len < 70 ? 1 : 31)) {
+        char hex[sizeof(bytes) * 2 + 1];
+        uint8_t decoded[sizeof(bytes)] = {0};
+
+        assert_int_equal(bytes_to_hex(bytes, len, hex), RFIDX_OK);
+        assert_int_equal(strlen(hex), len * 2);
+        for (size_t i = 0; i < len; i++) {
+            char expected[3];
+            snprintf(expected, sizeof(expected), "%02X", bytes[i]);
+            assert_memory_equal(hex + 2 * i, expected, 2);
+        }
+
+        assert_int_equal(hex_to_bytes(hex, decoded, len), RFIDX_OK);
+        assert_memory_equal(decoded, bytes, len);
+    }
+}
+
+static void test_common_hex_to_bytes_lower_case(void **state) {
+    (void) state;
+    const char hex[] = "09d0030102bb0e02abcdefABCDEF0123456789aabbccddeeff00112233445566778899";
+    uint8_t decoded[(sizeof(hex) - 1) / 2];
+    uint8_t expected[sizeof(decoded)];
+
+    for (size_t i = 0; i < sizeof(expected); i++) {
+        unsigned int value;
+        sscanf(hex + 2 * i, "%2x", &value);
+        expected[i] = (uint8_t) value;
+    }
+
+    assert_int_equal(hex_to_bytes(hex, decoded, sizeof(decoded)), RFIDX_OK);
+    assert_memory_equal(decoded, expected, sizeof(expected));
+}
+
+static void test_common_hex_to_bytes_invalid(void **state) {
+    (void) state;
+    char hex[129];
+    uint8_t decoded[64];
+
+    // A bad character anywhere must be rejected, whichever kernel handles that position
+    for (size_t pos = 0; pos < 128; pos++) {
+        memset(hex, 'A', 128);
+        hex[128] = '\0';
+        const char bad[] = {'G', 'g', ' ', '/', ':', '@', '`', (char) 0xC1};
+        hex[pos] = bad[pos % sizeof(bad)];
+        assert_int_equal(hex_to_bytes(hex, decoded, 64), RFIDX_NUMERICAL_OPERATION_FAILED);
+    }
+
+    // Strings shorter than requested
+    assert_int_equal(hex_to_bytes("AABB", decoded, 3), RFIDX_NUMERICAL_OPERATION_FAILED);
+    assert_int_equal(hex_to_bytes("AAB", decoded, 2), RFIDX_NUMERICAL_OPERATION_FAILED);
+    assert_int_equal(hex_to_bytes("", decoded, 1), RFIDX_NUMERICAL_OPERATION_FAILED);
+
+    // Null parameters
+    assert_int_equal(hex_to_bytes(NULL, decoded, 1), RFIDX_NUMERICAL_OPERATION_FAILED);
+    assert_int_equal(bytes_to_hex(decoded, 1, NULL), RFIDX_NUMERICAL_OPERATION_FAILED);
+}
+
+static void test_common_hex_span_to_bytes(void **state) {
+    (void) state;
+    const uint8_t expected[] = {0x04, 0x48, 0xB8, 0x0A};
+    uint8_t decoded[4];
+
+    const char spaced[] = "04 48\tb8  0A";
+    assert_int_equal(hex_span_to_bytes(spaced, strlen(spaced), decoded, 4), RFIDX_OK);
+    assert_memory_equal(decoded, expected, 4);
+
+    // The span ends before the last nibble, even though the string continues
+    const char packed[] = "0448B80A";
+    assert_int_equal(hex_span_to_bytes(packed, 7, decoded, 4), RFIDX_NUMERICAL_OPERATION_FAILED);
+    assert_int_equal(hex_span_to_bytes("04 4G B8 0A", 11, decoded, 4), RFIDX_NUMERICAL_OPERATION_FAILED);
+    assert_int_equal(hex_span_to_bytes(NULL, 0, decoded, 1), RFIDX_NUMERICAL_OPERATION_FAILED);
+}
+
+static void test_common_nfc_next_line(void **state) {
+    (void) state;
+    const char text[] = "# Comment: ignored\n\nFiletype: Flipper NFC device\r\nno separator\nPage 1 :  01 02 \nUID:";
+    const char *cursor = text;
+    const char *end = text + strlen(text);
+    NfcLine line;
+
+    assert_true(nfc_next_line(&cursor, end, &line));
+    assert_int_equal(line.key_len, 8);
+    assert_memory_equal(line.key, "Filetype", 8);
+    assert_int_equal(line.value_len, 18);
+    assert_memory_equal(line.value, "Flipper NFC device", 18);
+
+    assert_true(nfc_next_line(&cursor, end, &line));
+    assert_int_equal(line.key_len, 6);
+    assert_memory_equal(line.key, "Page 1", 6);
+    assert_int_equal(line.value_len, 5);
+    assert_memory_equal(line.value, "01 02", 5);
+
+    // The last line has no newline and an empty value
+    assert_true(nfc_next_line(&cursor, end, &line));
+    assert_int_equal(line.key_len, 3);
+    assert_int_equal(line.value_len, 0);
+
+    assert_false(nfc_next_line(&cursor, end, &line));
+}
+
+static void test_common_str_to_uint(void **state) {
+    (void) state;
+    uint32_t value;
+    assert_true(str_to_uint("4294967295:", 11, 10, &value));
+    assert_int_equal(value, UINT32_MAX);
+    assert_true(str_to_uint("ffffffff", 8, 16, &value));
+    assert_int_equal(value, UINT32_MAX);
+    assert_false(str_to_uint(":", 1, 10, &value));
+
+    // Would wrap to page 4
+    assert_false(str_to_uint("4294967300", 10, 10, &value));
+    assert_false(str_to_uint("100000000", 9, 16, &value));
+}
+
+static void test_common_set_allocator(void **state) {
+    (void) state;
+    CountingAllocator counter = {0};
+    Ntag215Data data = {0};
+    Ntag21xMetadataHeader header = {0};
+
+    rfidx_set_allocator(counting_malloc, counting_realloc, counting_free, &counter);
+    char *nfc = ntag215_serialize_nfc(&data, &header);
+    assert_non_null(nfc);
+    assert_int_equal(counter.allocations, 1);
+    rfidx_free(nfc);
+    assert_int_equal(counter.releases, 1);
+
+    // Back to the C library allocator
+    rfidx_set_allocator(NULL, NULL, NULL, NULL);
+    nfc = ntag215_serialize_nfc(&data, &header);
+    assert_non_null(nfc);
+    rfidx_free(nfc);
+    assert_int_equal(counter.allocations, 1);
+}
+
+static void test_common_arena(void **state) {
+    (void) state;
+    _Alignas(16) uint8_t buffer[1024];
+    RfidxArena arena;
+    rfidx_arena_init(&arena, buffer + 1, sizeof(buffer) - 1);
+
+    uint8_t *a = rfidx_arena_alloc(&arena, 10);
+    uint8_t *b = rfidx_arena_alloc(&arena, 3);
+    assert_non_null(a);
+    assert_non_null(b);
+    assert_int_equal((uintptr_t) a % _Alignof(max_align_t), 0);
+    assert_int_equal((uintptr_t) b % _Alignof(max_align_t), 0);
+    assert_true(b >= a + 10);
+    assert_null(rfidx_arena_alloc(&arena, sizeof(buffer)));
+
+    // Everything is released at once, and the space is handed out again
+    rfidx_arena_reset(&arena);
+    assert_ptr_equal(rfidx_arena_alloc(&arena, 10), a);
+
+    // A whole serialize cycle through the arena
+    rfidx_arena_reset(&arena);
+    rfidx_use_arena(&arena);
+    Ntag215Data data = {0};
+    Ntag21xMetadataHeader header = {0};
+    uint8_t *binary = ntag215_serialize_binary(&data, &header);
+    assert_non_null(binary);
+    assert_true(binary > buffer && binary < buffer + sizeof(buffer));
+
+    // The last block grows in place, older ones move
+    char *text = rfidx_realloc(NULL, 4);
+    assert_non_null(text);
+    memcpy(text, "abc", 4);
+    char *grown = rfidx_realloc(text, 64);
+    assert_ptr_equal(grown, text);
+    char *moved = rfidx_realloc(binary, 700);
+    assert_null(moved);
+    moved = rfidx_realloc(binary, 100);
+    assert_non_null(moved);
+    assert_memory_equal(moved, &header, 56);
+    rfidx_free(moved);
+
+    rfidx_use_arena(NULL);
+    rfidx_arena_reset(&arena);
+    assert_int_equal(arena.used, 0);
+}
+
+static void test_common_context(void **state) {
+    (void) state;
+    RfidxContext ctx;
+    rfidx_context_init(&ctx);
+
+    uint8_t buffer[16] = {0};
+    assert_int_equal(rfidx_random_ctx(&ctx, buffer, sizeof(buffer)), RFIDX_DRNG_ERROR);
+    assert_int_equal(rfidx_init_rng_ctx(&ctx, NULL, NULL), 0);
+    assert_true(ctx.rng_initialized);
+    assert_int_equal(rfidx_random_ctx(&ctx, buffer, sizeof(buffer)), RFIDX_OK);
+
+    // Seeding a private context leaves the default one untouched
+    assert_false(rfidx_rng_initialized);
+    Ntag21xManufacturerData manufacturer_data = {0};
+    assert_int_equal(ntag21x_randomize_uid(&manufacturer_data), RFIDX_DRNG_ERROR);
+    assert_int_equal(ntag21x_randomize_uid_ctx(&ctx, &manufacturer_data), RFIDX_OK);
+    assert_int_equal(manufacturer_data.uid0[0], 0x04);
+    assert_int_equal(manufacturer_data.bcc1, manufacturer_data.uid1[0] ^ manufacturer_data.uid1[1] ^
+                                              manufacturer_data.uid1[2] ^ manufacturer_data.uid1[3]);
+
+    rfidx_context_free(&ctx);
+    assert_false(ctx.rng_initialized);
+    const RfidxStatus status = rfidx_free_rng_ctx(&ctx);
+    assert_int_equal(status, RFIDX_DRNG_ERROR);
+}
+
+static void test_common_random_pool_seeded(void **state) {
+    (void) state;
+    const uint8_t seed[] = "fixture seed";
+    RfidxContext first;
+    RfidxContext second;
+    rfidx_context_init(&first);
+    rfidx_context_init(&second);
+    assert_int_equal(rfidx_init_rng_seeded_ctx(&first, seed, sizeof(seed)), 0);
+    assert_int_equal(rfidx_init_rng_seeded_ctx(&second, seed, sizeof(seed)), 0);
+
+    // Small draws that cross pool refills return the same stream as one large draw
+    uint8_t piecewise[RFIDX_RANDOM_POOL_SIZE * 2 + 100];
+    uint8_t whole[sizeof(piecewise)];
+    for (size_t offset = 0; offset < sizeof(piecewise); offset += 7) {
+        const size_t len = sizeof(piecewise) - offset < 7 ? sizeof(piecewise) - offset : 7;
+        assert_int_equal(rfidx_random_ctx(&first, piecewise + offset, len), RFIDX_OK);
+    }
+    assert_int_equal(rfidx_random_ctx(&second, whole, sizeof(whole)), RFIDX_OK);
+    assert_memory_equal(piecewise, whole, sizeof(whole));
+
+    // Reseeding with the same value restarts the stream
+    rfidx_context_free(&second);
+    assert_int_equal(rfidx_init_rng_seeded_ctx(&second, seed, sizeof(seed)), 0);
+    uint8_t again[16];
+    assert_int_equal(rfidx_random_ctx(&second, again, sizeof(again)), RFIDX_OK);
+    assert_memory_equal(again, whole, sizeof(again));
+
+    // A different seed gives a different stream
+    const uint8_t other_seed[] = "another seed";
+    RfidxContext other;
+    rfidx_context_init(&other);
+    assert_int_equal(rfidx_init_rng_seeded_ctx(&other, other_seed, sizeof(other_seed)), 0);
+    uint8_t different[16];
+    assert_int_equal(rfidx_random_ctx(&other, different, sizeof(different)), RFIDX_OK);
+    assert_memory_not_equal(different, whole, sizeof(different));
+
+    RfidxContext invalid;
+    rfidx_context_init(&invalid);
+    assert_int_not_equal(rfidx_init_rng_seeded_ctx(&invalid, seed, 0), 0);
+    assert_false(invalid.rng_initialized);
+
+    rfidx_context_free(&first);
+    rfidx_context_free(&second);
+    rfidx_context_free(&other);
+}
+
+static void test_common_crc32(void **state) {
+    (void) state;
+    assert_int_equal(rfidx_crc32(0, "", 0), 0);
+    assert_int_equal(rfidx_crc32(0, "123456789", 9), 0xCBF43926U);
+    // Checksumming in pieces gives the same result
+    assert_int_equal(rfidx_crc32(rfidx_crc32(0, "1234", 4), "56789", 5), 0xCBF43926U);
+}
+
+static const struct CMUnitTest common_tests[] = {
+    cmocka_unit_test(test_common_hex_round_trip),
+    cmocka_unit_test(test_common_hex_to_bytes_lower_case),
+    cmocka_unit_test(test_common_hex_to_bytes_invalid),
+    cmocka_unit_test(test_common_hex_span_to_bytes),
+    cmocka_unit_test(test_common_nfc_next_line),
+    cmocka_unit_test(test_common_str_to_uint),
+    cmocka_unit_test(test_common_set_allocator),
+    cmocka_unit_test(test_common_arena),
+    cmocka_unit_test(test_common_context),
+    cmocka_unit_test(test_common_random_pool_seeded),
+    cmocka_unit_test(test_common_crc32),
+};
+
+const struct CMUnitTest *get_common_tests(size_t *count) {
+    if (count) *count = sizeof(common_tests) / sizeof(common_tests[0]);
+    return common_tests;
+}
@@ -0,0 +1,156 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "librfidx/delta.h"
+#include "librfidx/ntag/ntag215.h"
+#include "librfidx/mifare/mifare_classic_1k.h"
+
+static void test_delta_diff(void **state) {
+    (void) state;
+    uint8_t base[540];
+    uint8_t target[540];
+    for (size_t i = 0; i < sizeof(base); i++) base[i] = (uint8_t) (i * 31);
+
+    // One changed byte at every position of a page, in every chunk and in the scalar tail
+    for (size_t unit_size = 4; unit_size <= 16; unit_size *= 4) {
+        const size_t size = unit_size == 4 ? 540 : 528;
+        for (size_t pos = 0; pos < size; pos += 3) {
+            memcpy(target, base, sizeof(target));
+            target[pos] ^= 0x80;
+            target[size - 1 - pos / 2] ^= 0x01;
+
+            uint64_t changed[3];
+            memset(changed, 0xFF, sizeof(changed));
+            const size_t count = rfidx_delta_diff(base, target, size, unit_size, changed);
+
+            const size_t a = pos / unit_size;
+            const size_t b = (size - 1 - pos / 2) / unit_size;
+            assert_int_equal(count, a == b ? 1 : 2);
+            for (size_t unit = 0; unit < size / unit_size; unit++) {
+                assert_int_equal(changed[unit / 64] >> (unit % 64) & 1, unit == a || unit == b);
+            }
+        }
+    }
+
+    // Units the vector kernels do not handle are compared one by one
+    memcpy(target, base, sizeof(target));
+    target[25] ^= 1;
+    uint64_t changed[1];
+    assert_int_equal(rfidx_delta_diff(base, target, 60, 6, changed), 1);
+    assert_int_equal(changed[0], 1 << 4);
+}
+
+static void test_delta_ntag215(void **state) {
+    (void) state;
+    Ntag215Data base;
+    Ntag21xMetadataHeader header;
+    assert_int_equal(ntag215_load_from_binary("./tests/assets/ntag215.bin", &base, &header), RFIDX_OK);
+
+    Ntag215Data saves[3];
+    saves[0] = base;
+    saves[0].pages[22][1] ^= 0x01;
+    saves[0].pages[40][0] ^= 0xFF;
+    saves[1] = saves[0];
+    saves[1].pages[22][1] ^= 0x01;
+    saves[1].pages[134][3] ^= 0x10;
+    saves[2] = saves[1];
+
+    uint8_t *deltas[3];
+    size_t lens[3];
+    const Ntag215Data *previous = &base;
+    for (size_t i = 0; i < 3; i++) {
+        assert_int_equal(rfidx_delta_encode(AMIIBO, previous, &saves[i], &deltas[i], &lens[i]), RFIDX_OK);
+        previous = &saves[i];
+    }
+    assert_int_equal(lens[0], RFIDX_DELTA_HEADER_SIZE + 2 * 6);
+    assert_int_equal(lens[2], RFIDX_DELTA_HEADER_SIZE);
+
+    Ntag215Data out;
+    assert_int_equal(rfidx_delta_apply(NTAG_215, &base, deltas[0], lens[0], &out), RFIDX_OK);
+    assert_memory_equal(&out, &saves[0], sizeof(out));
+    assert_int_equal(rfidx_delta_apply_chain(AMIIBO, &base, (const uint8_t *const *) deltas, lens, 3, &out),
+                     RFIDX_OK);
+    assert_memory_equal(&out, &saves[2], sizeof(out));
+
+    // In place, from the wrong base, and the base is left as it was
+    out = base;
+    assert_int_equal(rfidx_delta_apply(AMIIBO, &out, deltas[1], lens[1], &out), RFIDX_CHECKSUM_ERROR);
+    assert_memory_equal(&out, &base, sizeof(out));
+    assert_int_equal(rfidx_delta_apply(AMIIBO, &out, deltas[0], lens[0], &out), RFIDX_OK);
+    assert_memory_equal(&out, &saves[0], sizeof(out));
+
+    // A chain stops at the first delta that does not follow, keeping the result so far
+    const uint8_t *skipping[] = {deltas[0], deltas[0]};
+    const size_t skipping_lens[] = {lens[0], lens[0]};
+    assert_int_equal(rfidx_delta_apply_chain(AMIIBO, &base, skipping, skipping_lens, 2, &out), RFIDX_CHECKSUM_ERROR);
+    assert_memory_equal(&out, &saves[0], sizeof(out));
+
+    // Page 22 changes back, so the merged delta still holds it, with its original content
+    uint8_t *merged;
+    size_t merged_len;
+    assert_int_equal(rfidx_delta_compose(deltas[0], lens[0], deltas[1], lens[1], &merged, &merged_len), RFIDX_OK);
+    assert_int_equal(merged_len, RFIDX_DELTA_HEADER_SIZE + 3 * 6);
+    assert_int_equal(rfidx_delta_apply(AMIIBO, &base, merged, merged_len, &out), RFIDX_OK);
+    assert_memory_equal(&out, &saves[1], sizeof(out));
+    rfidx_free(merged);
+    assert_int_equal(rfidx_delta_compose(deltas[1], lens[1], deltas[0], lens[0], &merged, &merged_len),
+                     RFIDX_CHECKSUM_ERROR);
+    assert_null(merged);
+
+    // Malformed deltas
+    assert_int_equal(rfidx_delta_apply(AMIIBO, &base, deltas[0], lens[0] - 1, &out), RFIDX_FILE_FORMAT_ERROR);
+    assert_int_equal(rfidx_delta_apply(MFC_1K, &base, deltas[0], lens[0], &out), RFIDX_FILE_FORMAT_ERROR);
+    deltas[0][RFIDX_DELTA_HEADER_SIZE + 6] = 0;
+    deltas[0][RFIDX_DELTA_HEADER_SIZE + 7] = 0;
+    assert_int_equal(rfidx_delta_apply(AMIIBO, &base, deltas[0], lens[0], &out), RFIDX_FILE_FORMAT_ERROR);
+
+    for (size_t i = 0; i < 3; i++) rfidx_free(deltas[i]);
+}
+
+static void test_delta_mfc1k(void **state) {
+    (void) state;
+    Mfc1kData base;
+    MfcMetadataHeader header;
+    assert_int_equal(mfc1k_load_from_binary("./tests/assets/mifare-classic-1k-v2.bin", &base, &header), RFIDX_OK);
+
+    Mfc1kData target = base;
+    target.blocks[5][1][0] ^= 0x01;
+    target.blocks[15][3][15] ^= 0x01;
+
+    uint8_t *delta;
+    size_t delta_len;
+    assert_int_equal(rfidx_delta_encode(MFC_1K, &base, &target, &delta, &delta_len), RFIDX_OK);
+    assert_int_equal(delta_len, RFIDX_DELTA_HEADER_SIZE + 2 * 18);
+    // Blocks are numbered across sectors
+    assert_int_equal(delta[RFIDX_DELTA_HEADER_SIZE], 21);
+    assert_int_equal(delta[RFIDX_DELTA_HEADER_SIZE + 18], 63);
+
+    Mfc1kData out;
+    assert_int_equal(rfidx_delta_apply(MFC_1K, &base, delta, delta_len, &out), RFIDX_OK);
+    assert_memory_equal(&out, &target, sizeof(out));
+    rfidx_free(delta);
+
+    assert_int_equal(rfidx_delta_encode(TAG_UNSPECIFIED, &base, &target, &delta, &delta_len),
+                     RFIDX_UNKNOWN_ENUM_ERROR);
+}
+
+static const struct CMUnitTest delta_tests[] = {
+    cmocka_unit_test(test_delta_diff),
+    cmocka_unit_test(test_delta_ntag215),
+    cmocka_unit_test(test_delta_mfc1k),
+};
+
+const struct CMUnitTest *get_delta_tests(size_t *count) {
+    if (count) *count = sizeof(delta_tests) / sizeof(delta_tests[0]);
+    return delta_tests;
+}
@@ -0,0 +1,108 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "librfidx/detect.h"
+#include "librfidx/application/amiibo_core.h"
+#include "librfidx/mifare/mifare_classic_1k_core.h"
+
+static void test_detect_binary_sizes(void **state) {
+    (void) state;
+    uint8_t dump[sizeof(Ntag21xMetadataHeader) + sizeof(Ntag215Data)] = {0};
+    TagType type;
+    FileFormat format;
+
+    assert_int_equal(rfidx_detect_tag(dump, sizeof(Ntag215Data), sizeof(Ntag215Data), &type, &format), RFIDX_OK);
+    assert_int_equal(type, NTAG_215);
+    assert_int_equal(format, FORMAT_BINARY);
+
+    assert_int_equal(rfidx_detect_tag(dump, sizeof(dump), sizeof(dump), &type, &format), RFIDX_OK);
+    assert_int_equal(type, NTAG_215);
+
+    // Only the prefix is needed for a large file
+    assert_int_equal(rfidx_detect_tag(dump, 16, sizeof(Mfc1kData), &type, &format), RFIDX_OK);
+    assert_int_equal(type, MFC_1K);
+    assert_int_equal(format, FORMAT_BINARY);
+
+    assert_int_equal(rfidx_detect_tag(dump, 100, 100, &type, &format), RFIDX_FILE_FORMAT_ERROR);
+    assert_int_equal(type, TAG_UNKNOWN);
+    assert_int_equal(format, FORMAT_UNKNOWN);
+}
+
+static void test_detect_binary_amiibo(void **state) {
+    (void) state;
+    AmiiboData amiibo = {0};
+    Ntag21xMetadataHeader header = {0};
+    assert_int_equal(amiibo_format_dump(&amiibo, &header), RFIDX_OK);
+
+    uint8_t dump[sizeof(Ntag21xMetadataHeader) + sizeof(AmiiboData)];
+    memcpy(dump, &header, sizeof(header));
+    memcpy(dump + sizeof(header), &amiibo, sizeof(amiibo));
+
+    TagType type;
+    FileFormat format;
+    assert_int_equal(rfidx_detect_tag(dump, sizeof(dump), sizeof(dump), &type, &format), RFIDX_OK);
+    assert_int_equal(type, AMIIBO);
+    assert_int_equal(rfidx_detect_tag((uint8_t *) &amiibo, sizeof(amiibo), sizeof(amiibo), &type, &format),
+                     RFIDX_OK);
+    assert_int_equal(type, AMIIBO);
+
+    // Any fixed byte that differs makes it a plain NTAG215
+    amiibo.amiibo.configuration.cfg1[0] = 0;
+    assert_int_equal(rfidx_detect_tag((uint8_t *) &amiibo, sizeof(amiibo), sizeof(amiibo), &type, &format),
+                     RFIDX_OK);
+    assert_int_equal(type, NTAG_215);
+}
+
+static void detect_text(const char *text, const TagType expected_type, const FileFormat expected_format) {
+    TagType type;
+    FileFormat format;
+    const RfidxStatus status = rfidx_detect_tag((const uint8_t *) text, strlen(text), 100000, &type, &format);
+    if (expected_type == TAG_UNKNOWN) {
+        assert_int_equal(status, RFIDX_FILE_FORMAT_ERROR);
+        return;
+    }
+
+    assert_int_equal(status, RFIDX_OK);
+    assert_int_equal(type, expected_type);
+    assert_int_equal(format, expected_format);
+}
+
+static void test_detect_text(void **state) {
+    (void) state;
+    detect_text("{\n  \"Created\": \"proxmark3\",\n  \"FileType\": \"mfc v2\",\n", MFC_1K, FORMAT_JSON);
+    detect_text("{\"FileType\":\"mfu\",\"blocks\":{\"3\":\"E1104000\",\"4\":\"A5000000\"}}", NTAG_215, FORMAT_JSON);
+    detect_text("{\"Card\":{\"3\":\"F110FFEE\"},\"FileType\" : \"mfu\",\"blocks\":{\"13\":\"F110FFEE\","
+                "\"3\":\"f110ffee\",\"4\":\"A5000000\"}}", AMIIBO, FORMAT_JSON);
+    detect_text("{\"FileType\": \"mf des\"}", TAG_UNKNOWN, FORMAT_UNKNOWN);
+
+    detect_text("Filetype: Flipper NFC device\nVersion: 4\nDevice type: Mifare Classic\n"
+                "Mifare Classic type: 1K\n", MFC_1K, FORMAT_NFC);
+    detect_text("Filetype: Flipper NFC device\nVersion: 4\nDevice type: Mifare Classic\n"
+                "Mifare Classic type: 4K\n", TAG_UNKNOWN, FORMAT_UNKNOWN);
+    detect_text("Filetype: Flipper NFC device\nDevice type: NTAG215\r\nPage 3: E1 10 3E 00\n", NTAG_215, FORMAT_NFC);
+    detect_text("Filetype: Flipper NFC device\nDevice type: NTAG/Ultralight\nNTAG/Ultralight type: NTAG215\n"
+                "Page 3: F1 10 FF EE\nPage 4: A5 00 00 00\nPage 130: 01 00 0F BD\n", AMIIBO, FORMAT_NFC);
+    detect_text("Filetype: Flipper NFC device\nDevice type: NTAG/Ultralight\nNTAG/Ultralight type: NTAG213\n",
+                TAG_UNKNOWN, FORMAT_UNKNOWN);
+}
+
+static const struct CMUnitTest detect_tests[] = {
+    cmocka_unit_test(test_detect_binary_sizes),
+    cmocka_unit_test(test_detect_binary_amiibo),
+    cmocka_unit_test(test_detect_text),
+};
+
+const struct CMUnitTest *get_detect_tests(size_t *count) {
+    if (count) *count = sizeof(detect_tests) / sizeof(detect_tests[0]);
+    return detect_tests;
+}
@@ -0,0 +1,125 @@
+/*
+ * librfidx - Universal RFID Tag Format Parser and Converter
+ *
+ * Copyright (c) 2025. Firefox2100
+ *
+ * This software is released under the MIT License.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include "../src/core/json_reader.h"
+
+static bool walk_document(const char *json) {
+    JsonReader reader;
+    json_reader_init(&reader, json, strlen(json));
+    if (!json_reader_enter_object(&reader)) return false;
+
+    const char *key;
+    size_t key_len;
+    JsonReaderResult result;
+    while ((result = json_reader_next_member(&reader, &key, &key_len)) == JSON_READER_MEMBER) {
+        if (!json_reader_skip_value(&reader)) return false;
+    }
+
+    return result == JSON_READER_END;
+}
+
+static void test_json_reader_members(void **state) {
+    (void) state;
+    const char json[] = " {\"Created\": \"proxmark3\", \"Card\" : {\"UID\":\"04\"},\n"
+                        "\t\"skip\": [1, -2.5e+3, 0, true, false, null, {}, []], \"last\": \"\"} trailing";
+    JsonReader reader;
+    json_reader_init(&reader, json, strlen(json));
+    assert_true(json_reader_enter_object(&reader));
+
+    const char *key;
+    size_t key_len;
+    const char *value;
+    size_t value_len;
+
+    assert_int_equal(json_reader_next_member(&reader, &key, &key_len), JSON_READER_MEMBER);
+    assert_true(json_key_equals(key, key_len, "created"));
+    assert_true(json_reader_string(&reader, &value, &value_len));
+    assert_int_equal(value_len, 9);
+    assert_memory_equal(value, "proxmark3", 9);
+
+    assert_int_equal(json_reader_next_member(&reader, &key, &key_len), JSON_READER_MEMBER);
+    assert_true(json_key_equals(key, key_len, "Card"));
+    assert_false(json_key_equals(key, key_len, "Car"));
+    assert_false(json_key_equals(key, key_len, "Cards"));
+    assert_true(json_reader_enter_object(&reader));
+    assert_int_equal(json_reader_next_member(&reader, &key, &key_len), JSON_READER_MEMBER);
+    assert_true(json_key_equals(key, key_len, "UID"));
+    assert_true(json_reader_string(&reader, &value, &value_len));
+    assert_int_equal(json_reader_next_member(&reader, &key, &key_len), JSON_READER_END);
+
+    assert_int_equal(json_reader_next_member(&reader, &key, &key_len), JSON_READER_MEMBER);
+    assert_true(json_reader_skip_value(&reader));
+
+    assert_int_equal(json_reader_next_member(&reader, &key, &key_len), JSON_READER_MEMBER);
+    assert_true(json_reader_string(&reader, &value, &value_len));
+    assert_int_equal(value_len, 0);
+
+    // Content after the root object is not looked at, the same as cJSON_Parse
+    assert_int_equal(json_reader_next_member(&reader, &key, &key_len), JSON_READER_END);
+}
+
+static void test_json_reader_fallback(void **state) {
+    (void) state;
+    assert_true(walk_document("{}"));
+    assert_true(walk_document("{\"a\": {\"b\": [[1], {\"c\": 0.5}]}}"));
+
+    // Malformed documents
+    assert_false(walk_document("{\"a\": 1,}"));
+    assert_false(walk_document("{\"a\" 1}"));
+    assert_false(walk_document("{\"a\": [1 2]}"));
+    assert_false(walk_document("{\"a\": tru}"));
+    assert_false(walk_document("{\"a\": -}"));
+    assert_false(walk_document("{\"a\": 1.}"));
+    assert_false(walk_document("{\"a\": \"open}"));
+    assert_false(walk_document("{\"a\": 1"));
+    assert_false(walk_document("[]"));
+
+    // Valid for cJSON, but left to it
+    assert_false(walk_document("{\"a\": \"\\u0041\"}"));
+    assert_false(walk_document("{\"a\": 01}"));
+
+    char deep[2 * (JSON_READER_MAX_DEPTH + 2) + 8];
+    size_t len = 0;
+    len += (size_t) snprintf(deep, sizeof(deep), "{\"a\":");
+    for (int i = 0; i <= JSON_READER_MAX_DEPTH + 1; i++) deep[len++] = '[';
+    for (int i = 0; i <= JSON_READER_MAX_DEPTH + 1; i++) deep[len++] = ']';
+    deep[len++] = '}';
+    deep[len] = '\0';
+    assert_false(walk_document(deep));
+}
+
+static void test_json_reader_key_index(void **state) {
+    (void) state;
+    uint32_t index;
+    assert_true(json_key_index("0", 1, &index));
+    assert_int_equal(index, 0);
+    assert_true(json_key_index("134", 3, &index));
+    assert_int_equal(index, 134);
+
+    assert_false(json_key_index("", 0, &index));
+    assert_false(json_key_index("07", 2, &index));
+    assert_false(json_key_index("+7", 2, &index));
+    assert_false(json_key_index("7a", 2, &index));
+    assert_false(json_key_index("1234567890", 10, &index));
+}
+
+static const struct CMUnitTest json_reader_tests[] = {
+    cmocka_unit_test(test_json_reader_members),
+    cmocka_unit_test(test_json_reader_fallback),
+    cmocka_unit_test(test_json_reader_key_index),
+};
+
+const struct CMUnitTest *get_json_reader_tests(size_t *count) {
+    if (count) *count = sizeof(json_reader_tests) / sizeof(json_reader_tests[0]);
+    return json_reader_tests;
+}
@@ -9,11 +9,28 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 #include <setjmp.h>
 #include <cmocka.h>
 
 #include "librfidx/rfidx.h"
+#include "librfidx/stream.h"
+#include "librfidx/batch.h"
+#include "librfidx/manifest.h"
+#include "librfidx/watch.h"
+#include "librfidx/cache.h"
+#include "librfidx/archive.h"
+#include "librfidx/uid_index.h"
+#include "librfidx/store.h"
 #include "librfidx/ntag/ntag215.h"
+#include "librfidx/mifare/mifare_classic_1k.h"
 
 RfidxStatus save_tag_to_file(
     const void *data,
@@ -34,6 +51,18 @@ RfidxStatus transform_tag(
 );
 TransformCommand string_to_transform_command(const char *str);
 
+static void copy_to_temp_file(const char *source, char *filename) {
+    char *buffer = NULL;
+    size_t length = 0;
+    assert_int_equal(read_file(source, &buffer, &length, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+
+    const int fd = mkstemp(filename);
+    assert_true(fd != -1);
+    close(fd);
+    assert_int_equal(write_file(filename, buffer, length, true, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+    rfidx_free(buffer);
+}
+
 static void test_rfidx_string_to_transform_command(void **state) {
     (void) state;
     assert_int_equal(string_to_transform_command("generate"), TRANSFORM_GENERATE);
@@ -71,12 +100,51 @@ static void test_rfidx_read_tag_from_file_unknown(void **state) {
     (void) state;
     void *data = (void*)0x1;
     void *header = (void*)0x2;
-    const TagType type = read_tag_from_file("./tests/assets/ntag215.bin", TAG_UNSPECIFIED, &data, &header);
+    const TagType type = read_tag_from_file("./tests/assets/README.md", TAG_UNSPECIFIED, &data, &header);
     assert_int_equal(type, TAG_UNKNOWN);
     assert_ptr_equal(data, (void*)0x1);
     assert_ptr_equal(header, (void*)0x2);
 }
 
+static void test_rfidx_read_tag_from_file_detect(void **state) {
+    (void) state;
+    // The NTAG215 assets are Amiibo dumps
+    const struct {
+        const char *filename;
+        TagType type;
+    } cases[] = {
+        {"./tests/assets/ntag215.bin", AMIIBO},
+        {"./tests/assets/ntag215.nfc", AMIIBO},
+        {"./tests/assets/mifare-classic-1k-v2.bin", MFC_1K},
+        {"./tests/assets/mifare-classic-1k-v2.nfc", MFC_1K},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        void *data = NULL;
+        void *header = NULL;
+        assert_int_equal(read_tag_from_file(cases[i].filename, TAG_UNSPECIFIED, &data, &header), cases[i].type);
+        rfidx_free(data);
+        rfidx_free(header);
+    }
+
+    // Without an extension to go by
+    char filename[] = "/tmp/rfidx-detect-XXXXXX";
+    copy_to_temp_file("./tests/assets/mifare-classic-1k-v2.nfc", filename);
+    void *data = NULL;
+    void *header = NULL;
+    assert_int_equal(read_tag_from_file(filename, TAG_UNSPECIFIED, &data, &header), MFC_1K);
+
+    Mfc1kData expected;
+    MfcMetadataHeader expected_header;
+    assert_int_equal(mfc1k_load_from_nfc("./tests/assets/mifare-classic-1k-v2.nfc", &expected, &expected_header),
+                     RFIDX_OK);
+    assert_memory_equal(data, &expected, sizeof(expected));
+
+    rfidx_free(data);
+    rfidx_free(header);
+    unlink(filename);
+}
+
 static void test_rfidx_read_tag_from_file_missing(void **state) {
     (void) state;
     void *data = NULL;
@@ -144,11 +212,14 @@ static void test_rfidx_transform_tag_ntag215_wipe(void **state) {
     memset(&header, 0xAA, sizeof(header));
     Ntag215Data *pdata = &data;
     Ntag21xMetadataHeader *pheader = &header;
+    rfidx_free_rng();
     const RfidxStatus status = transform_tag(NTAG_215, TRANSFORM_WIPE, (void**)&pdata, (void**)&pheader, NULL, NULL);
     assert_int_equal(status, RFIDX_OK);
     for (int i = 0; i < NTAG215_NUM_USER_PAGES; ++i) {
         assert_memory_equal(data.structure.user_memory[i], (uint8_t[NTAG21X_PAGE_SIZE]){0}, NTAG21X_PAGE_SIZE);
     }
+    // Wiping needs no randomness, so the DRNG is left unseeded
+    assert_false(rfidx_rng_initialized);
 }
 
 static void test_rfidx_transform_tag_amiibo_missing_key(void **state) {
@@ -280,11 +351,1074 @@ static void test_rfidx_generate_amiibo(void **state) {
     assert_true(strncmp(out_buf, "Tag data: \n", 11) == 0);
 }
 
+static void test_rfidx_write_file_vectored(void **state) {
+    (void) state;
+    char filename[] = "/tmp/rfidx-writev-XXXXXX";
+    const int fd = mkstemp(filename);
+    assert_true(fd != -1);
+    close(fd);
+
+    const struct iovec iov[] = {
+        {.iov_base = "head", .iov_len = 4},
+        {.iov_base = "", .iov_len = 0},
+        {.iov_base = "tail", .iov_len = 4},
+    };
+    assert_int_equal(write_file_vectored(filename, iov, 3, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+
+    char *buffer = NULL;
+    size_t length = 0;
+    assert_int_equal(read_file(filename, &buffer, &length, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+    assert_int_equal(length, 8);
+    assert_memory_equal(buffer, "headtail", 8);
+    rfidx_free(buffer);
+
+    assert_int_equal(write_file_vectored("/nonexistent/dir/file", iov, 3, RFIDX_BINARY_FILE_IO_ERROR),
+                     RFIDX_BINARY_FILE_IO_ERROR);
+
+    unlink(filename);
+}
+
+static void test_rfidx_in_place_wipe_ntag215(void **state) {
+    (void) state;
+    char filename[] = "/tmp/rfidx-in-place-XXXXXX";
+    copy_to_temp_file("./tests/assets/ntag215.bin", filename);
+
+    // The same transform applied to a heap copy
+    Ntag215Data expected_data;
+    Ntag21xMetadataHeader expected_header;
+    assert_int_equal(ntag215_load_from_binary(filename, &expected_data, &expected_header), RFIDX_OK);
+    Ntag215Data *pdata = &expected_data;
+    Ntag21xMetadataHeader *pheader = &expected_header;
+    assert_int_equal(ntag215_transform_data(&pdata, &pheader, TRANSFORM_WIPE), RFIDX_OK);
+
+    char *argv[] = {
+        "rfidx",
+        "--input", filename,
+        "--transform", "wipe",
+        "--in-place",
+        NULL
+    };
+    const int argc = sizeof(argv) / sizeof(argv[0]) - 1;
+    const RfidxStatus status = rfidx_main(argc, argv, stdout, stderr);
+    assert_int_equal(status, RFIDX_OK);
+
+    Ntag215Data data;
+    Ntag21xMetadataHeader header;
+    assert_int_equal(ntag215_load_from_binary(filename, &data, &header), RFIDX_OK);
+    assert_memory_equal(&data, &expected_data, sizeof(data));
+    assert_memory_equal(&header, &expected_header, sizeof(header));
+
+    unlink(filename);
+}
+
+static void test_rfidx_in_place_randomize_uid_mfc1k(void **state) {
+    (void) state;
+    char filename[] = "/tmp/rfidx-in-place-XXXXXX";
+    copy_to_temp_file("./tests/assets/mifare-classic-1k-v2.bin", filename);
+
+    Mfc1kData original;
+    MfcMetadataHeader original_header;
+    assert_int_equal(mfc1k_load_from_binary(filename, &original, &original_header), RFIDX_OK);
+
+    RfidxContext ctx;
+    rfidx_context_init(&ctx);
+    assert_int_equal(transform_tag_in_place(&ctx, TAG_UNSPECIFIED, TRANSFORM_RANDOMIZE_UID, filename, NULL, NULL),
+                     RFIDX_OK);
+    assert_true(ctx.rng_initialized);
+
+    Mfc1kData data;
+    MfcMetadataHeader header;
+    assert_int_equal(mfc1k_load_from_binary(filename, &data, &header), RFIDX_OK);
+    assert_memory_not_equal(data.blocks[0][0], original.blocks[0][0], 4);
+    // Nothing past the UID changes
+    assert_memory_equal(data.blocks[0][1], original.blocks[0][1], sizeof(Mfc1kData) - MFC_1K_BLOCK_SIZE);
+
+    // Generating cannot be done in place, and leaves the file alone
+    assert_int_equal(transform_tag_in_place(&ctx, MFC_1K, TRANSFORM_GENERATE, filename, NULL, NULL),
+                     RFIDX_UNKNOWN_ENUM_ERROR);
+    Mfc1kData unchanged;
+    assert_int_equal(mfc1k_load_from_binary(filename, &unchanged, &header), RFIDX_OK);
+    assert_memory_equal(&unchanged, &data, sizeof(data));
+
+    rfidx_context_free(&ctx);
+    unlink(filename);
+}
+
+static void test_rfidx_read_fd_pipe(void **state) {
+    (void) state;
+    int fds[2];
+    assert_int_equal(pipe(fds), 0);
+
+    // More than the initial buffer, so the reader has to grow it
+    char content[10000];
+    memset(content, 'A', sizeof(content));
+    assert_int_equal(write(fds[1], content, sizeof(content)), sizeof(content));
+    close(fds[1]);
+
+    char *buffer = NULL;
+    size_t length = 0;
+    assert_int_equal(read_fd(fds[0], &buffer, &length, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+    close(fds[0]);
+
+    assert_int_equal(length, sizeof(content));
+    assert_memory_equal(buffer, content, sizeof(content));
+    assert_int_equal(buffer[length], '\0');
+    rfidx_free(buffer);
+}
+
+static void test_rfidx_read_tag_from_buffer_nfc(void **state) {
+    (void) state;
+    char *buffer = NULL;
+    size_t length = 0;
+    assert_int_equal(read_file("./tests/assets/ntag215.nfc", &buffer, &length, RFIDX_NFC_FILE_IO_ERROR), RFIDX_OK);
+
+    void *data = NULL;
+    void *header = NULL;
+    assert_int_equal(read_tag_from_buffer(buffer, length, NTAG_215, FORMAT_NFC, &data, &header), NTAG_215);
+
+    Ntag215Data expected = {0};
+    Ntag21xMetadataHeader expected_header = {0};
+    assert_int_equal(ntag215_load_from_nfc("./tests/assets/ntag215.nfc", &expected, &expected_header), RFIDX_OK);
+    assert_memory_equal(data, &expected, sizeof(expected));
+
+    rfidx_free(data);
+    rfidx_free(header);
+    rfidx_free(buffer);
+}
+
+static void test_rfidx_binary_to_stdout(void **state) {
+    (void) state;
+    char *argv[] = {
+        "rfidx",
+        "--input", "./tests/assets/ntag215.bin",
+        "--input-type", "ntag215",
+        "--input-format", "binary",
+        "--output", "-",
+        "--output-format", "binary",
+        NULL
+    };
+    const int argc = sizeof(argv) / sizeof(argv[0]) - 1;
+
+    char *out_buf = NULL, *err_buf = NULL;
+    size_t out_size = 0, err_size = 0;
+    FILE *out_stream = open_memstream(&out_buf, &out_size);
+    FILE *err_stream = open_memstream(&err_buf, &err_size);
+
+    const RfidxStatus status = rfidx_main(argc, argv, out_stream, err_stream);
+
+    fclose(out_stream);
+    fclose(err_stream);
+
+    assert_int_equal(status, RFIDX_OK);
+    assert_string_equal(err_buf, "");
+
+    // The raw dump, not a hex dump of it
+    char *expected = NULL;
+    size_t expected_size = 0;
+    assert_int_equal(read_file("./tests/assets/ntag215.bin", &expected, &expected_size, RFIDX_BINARY_FILE_IO_ERROR),
+                     RFIDX_OK);
+    assert_int_equal(out_size, expected_size);
+    assert_memory_equal(out_buf, expected, expected_size);
+
+    rfidx_free(expected);
+}
+
+static void test_rfidx_stdin_needs_format(void **state) {
+    (void) state;
+    char *argv[] = {
+        "rfidx",
+        "--input", "-",
+        "--input-type", "ntag215",
+        NULL
+    };
+    const int argc = sizeof(argv) / sizeof(argv[0]) - 1;
+
+    char *out_buf = NULL, *err_buf = NULL;
+    size_t out_size = 0, err_size = 0;
+    FILE *out_stream = open_memstream(&out_buf, &out_size);
+    FILE *err_stream = open_memstream(&err_buf, &err_size);
+
+    const RfidxStatus status = rfidx_main(argc, argv, out_stream, err_stream);
+
+    fclose(out_stream);
+    fclose(err_stream);
+
+    assert_int_equal(status, EXIT_FAILURE);
+    assert_non_null(strstr(err_buf, "stdin"));
+}
+
+static void test_rfidx_convert_stream_mfc1k_wipe(void **state) {
+    (void) state;
+    Mfc1kData record;
+    MfcMetadataHeader header;
+    assert_int_equal(mfc1k_load_from_binary("./tests/assets/mifare-classic-1k-v2.bin", &record, &header), RFIDX_OK);
+
+    // Enough records to go through both buffers more than once, ending on a partial buffer
+    const size_t count = RFIDX_STREAM_RECORDS_PER_BUFFER * 2 + 3;
+    int fds[2];
+    assert_int_equal(pipe(fds), 0);
+    const pid_t writer = fork();
+    assert_true(writer != -1);
+    if (writer == 0) {
+        close(fds[0]);
+        for (size_t i = 0; i < count; i++) {
+            if (write(fds[1], &record, sizeof(record)) != sizeof(record)) _exit(1);
+        }
+        _exit(0);
+    }
+    close(fds[1]);
+
+    char *out_buf = NULL;
+    size_t out_size = 0;
+    FILE *out_stream = open_memstream(&out_buf, &out_size);
+
+    const RfidxStreamOptions options = {
+        .tag_type = MFC_1K,
+        .command = TRANSFORM_WIPE,
+        .output_format = FORMAT_BINARY,
+    };
+    size_t records = 0;
+    RfidxContext ctx;
+    rfidx_context_init(&ctx);
+    const RfidxStatus status = rfidx_convert_stream(&ctx, fds[0], out_stream, &options, &records);
+    fclose(out_stream);
+    close(fds[0]);
+    waitpid(writer, NULL, 0);
+
+    assert_int_equal(status, RFIDX_OK);
+    assert_int_equal(records, count);
+    assert_int_equal(out_size, count * sizeof(Mfc1kData));
+    // Wiping needs no random bytes
+    assert_false(ctx.rng_initialized);
+
+    Mfc1kData *expected = &record;
+    MfcMetadataHeader *pheader = &header;
+    assert_int_equal(mfc1k_transform_data(&expected, &pheader, TRANSFORM_WIPE), RFIDX_OK);
+    for (size_t i = 0; i < count; i++) {
+        assert_memory_equal(out_buf + i * sizeof(Mfc1kData), expected, sizeof(Mfc1kData));
+    }
+
+    rfidx_context_free(&ctx);
+}
+
+static void test_rfidx_convert_stream_partial_record(void **state) {
+    (void) state;
+    char filename[] = "/tmp/rfidx-stream-XXXXXX";
+    copy_to_temp_file("./tests/assets/ntag215.bin", filename);
+
+    // A second record cut short
+    char *buffer = NULL;
+    size_t length = 0;
+    assert_int_equal(read_file(filename, &buffer, &length, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+    const struct iovec iov[] = {
+        {.iov_base = buffer, .iov_len = length},
+        {.iov_base = buffer, .iov_len = 100},
+    };
+    assert_int_equal(write_file_vectored(filename, iov, 2, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+
+    char *out_buf = NULL;
+    size_t out_size = 0;
+    FILE *out_stream = open_memstream(&out_buf, &out_size);
+
+    const RfidxStreamOptions options = {
+        .tag_type = NTAG_215,
+        .output_format = FORMAT_BINARY,
+    };
+    size_t records = 0;
+    const int fd = open(filename, O_RDONLY);
+    assert_true(fd != -1);
+    const RfidxStatus status = rfidx_convert_stream(&rfidx_default_context, fd, out_stream, &options, &records);
+    close(fd);
+    fclose(out_stream);
+
+    assert_int_equal(status, RFIDX_BINARY_FILE_SIZE_ERROR);
+    assert_int_equal(records, 1);
+    assert_int_equal(out_size, length);
+    assert_memory_equal(out_buf, buffer, length);
+
+    // Only the two binary dump sizes of the tag type make sense as records
+    const RfidxStreamOptions bad_size = {
+        .tag_type = NTAG_215,
+        .record_size = 1024,
+        .output_format = FORMAT_BINARY,
+    };
+    assert_int_equal(rfidx_convert_stream(&rfidx_default_context, STDIN_FILENO, stdout, &bad_size, NULL),
+                     RFIDX_BINARY_FILE_SIZE_ERROR);
+
+    rfidx_free(buffer);
+    unlink(filename);
+}
+
+static void test_rfidx_output_format_list(void **state) {
+    (void) state;
+    FileFormat formats[RFIDX_MAX_OUTPUT_FORMATS];
+    size_t count = 0;
+    assert_int_equal(parse_file_format_list("json,nfc,binary", formats, &count), RFIDX_OK);
+    assert_int_equal(count, 3);
+    assert_int_equal(formats[0], FORMAT_JSON);
+    assert_int_equal(formats[1], FORMAT_NFC);
+    assert_int_equal(formats[2], FORMAT_BINARY);
+
+    assert_int_equal(parse_file_format_list("json,,nfc", formats, &count), RFIDX_FILE_FORMAT_ERROR);
+    assert_int_equal(parse_file_format_list("json,json", formats, &count), RFIDX_FILE_FORMAT_ERROR);
+    assert_int_equal(parse_file_format_list("json,xml", formats, &count), RFIDX_FILE_FORMAT_ERROR);
+
+    char filename[32];
+    assert_int_equal(expand_output_template("out/{ext}/tag.{ext}", FORMAT_NFC, filename, sizeof(filename)),
+                     RFIDX_OK);
+    assert_string_equal(filename, "out/nfc/tag.nfc");
+    assert_int_equal(expand_output_template("tag", FORMAT_BINARY, filename, sizeof(filename)), RFIDX_OK);
+    assert_string_equal(filename, "tag.bin");
+    assert_int_equal(expand_output_template("a-name-too-long-for-the-buffer.{ext}", FORMAT_JSON, filename,
+                                            sizeof(filename)), RFIDX_BUFFER_SIZE_ERROR);
+
+    // Only the extension of the file name is dropped, and inputs that share the rest collide
+    assert_int_equal(output_stem_length("dir.d/a.json"), 7);
+    assert_int_equal(output_stem_length("dir.d/a"), 7);
+    assert_int_equal(output_stem_length(".hidden"), 7);
+    const char *paths[] = {"a.bin", "a.c.bin", "a.json", "b/a.nfc", "a"};
+    bool collides[5];
+    assert_int_equal(find_output_collisions(paths, 5, collides), RFIDX_OK);
+    assert_false(collides[0]);
+    assert_false(collides[1]);
+    assert_true(collides[2]);
+    assert_false(collides[3]);
+    assert_true(collides[4]);
+}
+
+static void test_rfidx_fan_out_formats(void **state) {
+    (void) state;
+    char directory[] = "/tmp/rfidx-fan-out-XXXXXX";
+    assert_non_null(mkdtemp(directory));
+    char template[64];
+    snprintf(template, sizeof(template), "%s/tag.{ext}", directory);
+
+    char *argv[] = {
+        "rfidx",
+        "--input", "./tests/assets/mifare-classic-1k-v2.bin",
+        "--input-type", "mfc1k",
+        "--output", template,
+        "--output-format", "nfc,binary",
+        "--transform", "wipe",
+        NULL
+    };
+    const int argc = sizeof(argv) / sizeof(argv[0]) - 1;
+    assert_int_equal(rfidx_main(argc, argv, stdout, stderr), EXIT_SUCCESS);
+
+    // Both outputs hold the same transformed dump
+    char filename[64];
+    Mfc1kData from_binary;
+    MfcMetadataHeader header;
+    snprintf(filename, sizeof(filename), "%s/tag.bin", directory);
+    assert_int_equal(mfc1k_load_from_binary(filename, &from_binary, &header), RFIDX_OK);
+    unlink(filename);
+
+    Mfc1kData from_nfc = {0};
+    snprintf(filename, sizeof(filename), "%s/tag.nfc", directory);
+    assert_int_equal(mfc1k_load_from_nfc(filename, &from_nfc, &header), RFIDX_OK);
+    unlink(filename);
+    assert_memory_equal(&from_binary, &from_nfc, sizeof(Mfc1kData));
+
+    Mfc1kData expected;
+    Mfc1kData *pexpected = &expected;
+    MfcMetadataHeader *pheader = &header;
+    assert_int_equal(mfc1k_load_from_binary("./tests/assets/mifare-classic-1k-v2.bin", &expected, &header), RFIDX_OK);
+    assert_int_equal(mfc1k_transform_data(&pexpected, &pheader, TRANSFORM_WIPE), RFIDX_OK);
+    assert_memory_equal(&from_binary, &expected, sizeof(Mfc1kData));
+
+    // The placeholder is replaced for a single format too
+    argv[8] = "binary";
+    assert_int_equal(rfidx_main(argc, argv, stdout, stderr), EXIT_SUCCESS);
+    snprintf(filename, sizeof(filename), "%s/tag.bin", directory);
+    assert_int_equal(mfc1k_load_from_binary(filename, &from_binary, &header), RFIDX_OK);
+    assert_memory_equal(&from_binary, &expected, sizeof(Mfc1kData));
+    unlink(filename);
+
+    rmdir(directory);
+}
+
+static void count_batch_result(const char *input, const char *output, const RfidxStatus status, void *user) {
+    size_t *counts = user;
+    if (status == RFIDX_OK) {
+        assert_non_null(output);
+        counts[0]++;
+    } else if (status == RFIDX_OUTPUT_COLLISION_ERROR) {
+        assert_string_equal(input, "nested/c.json");
+        assert_non_null(output);
+        counts[2]++;
+    } else {
+        assert_string_equal(input, "notes.txt");
+        counts[1]++;
+    }
+}
+
+static void test_rfidx_batch_convert(void **state) {
+    (void) state;
+    char input_dir[] = "/tmp/rfidx-batch-in-XXXXXX";
+    char output_dir[] = "/tmp/rfidx-batch-out-XXXXXX";
+    assert_non_null(mkdtemp(input_dir));
+    assert_non_null(mkdtemp(output_dir));
+
+    char path[128];
+    char *content = NULL;
+    size_t length = 0;
+    assert_int_equal(read_file("./tests/assets/mifare-classic-1k-v2.bin", &content, &length,
+                               RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+    snprintf(path, sizeof(path), "%s/nested", input_dir);
+    assert_int_equal(mkdir(path, 0700), 0);
+    // The last input would be written over the output of the one before it
+    const char *names[] = {"a.bin", "nested/b.dump", "nested/c", "nested/c.json"};
+    for (size_t i = 0; i < 4; i++) {
+        snprintf(path, sizeof(path), "%s/%s", input_dir, names[i]);
+        assert_int_equal(write_file(path, content, length, true, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+    }
+    snprintf(path, sizeof(path), "%s/notes.txt", input_dir);
+    assert_int_equal(write_file(path, "not a dump", 10, false, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+
+    size_t counts[3] = {0};
+    const RfidxBatchOptions options = {
+        .input_type = TAG_UNSPECIFIED,
+        .command = TRANSFORM_WIPE,
+        .output_format = FORMAT_BINARY,
+        .threads = 3,
+        .on_result = count_batch_result,
+        .user = counts,
+    };
+    RfidxBatchSummary summary;
+    assert_int_equal(rfidx_batch_convert(input_dir, output_dir, &options, &summary), RFIDX_OK);
+    assert_int_equal(summary.converted, 3);
+    assert_int_equal(summary.failed, 2);
+    assert_int_equal(counts[0], 3);
+    assert_int_equal(counts[1], 1);
+    assert_int_equal(counts[2], 1);
+
+    Mfc1kData expected;
+    MfcMetadataHeader header;
+    Mfc1kData *pexpected = &expected;
+    MfcMetadataHeader *pheader = &header;
+    assert_int_equal(mfc1k_load_from_binary("./tests/assets/mifare-classic-1k-v2.bin", &expected, &header), RFIDX_OK);
+    assert_int_equal(mfc1k_transform_data(&pexpected, &pheader, TRANSFORM_WIPE), RFIDX_OK);
+
+    // Outputs keep their relative paths, with the extension of the output format
+    const char *outputs[] = {"a.bin", "nested/b.bin", "nested/c.bin"};
+    for (size_t i = 0; i < 3; i++) {
+        Mfc1kData data;
+        snprintf(path, sizeof(path), "%s/%s", output_dir, outputs[i]);
+        assert_int_equal(mfc1k_load_from_binary(path, &data, &header), RFIDX_OK);
+        assert_memory_equal(&data, &expected, sizeof(data));
+        unlink(path);
+        snprintf(path, sizeof(path), "%s/%s", input_dir, names[i]);
+        unlink(path);
+    }
+    snprintf(path, sizeof(path), "%s/%s", input_dir, names[3]);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/notes.txt", input_dir);
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/nested", input_dir);
+    rmdir(path);
+    snprintf(path, sizeof(path), "%s/nested", output_dir);
+    // Nothing else, such as a temporary file, is left behind
+    assert_int_equal(rmdir(path), 0);
+    assert_int_equal(rmdir(output_dir), 0);
+    rmdir(input_dir);
+    rfidx_free(content);
+}
+
+static void record_manifest_result(const size_t line, const char *input, const char *output,
+                                   const RfidxStatus status, void *user) {
+    (void) input;
+    (void) output;
+    RfidxStatus *statuses = user;
+    assert_true(line < 8);
+    statuses[line] = status;
+}
+
+static void test_rfidx_run_manifest(void **state) {
+    (void) state;
+    char wiped[] = "/tmp/rfidx-manifest-XXXXXX";
+    const int wiped_fd = mkstemp(wiped);
+    assert_true(wiped_fd >= 0);
+    close(wiped_fd);
+    // Missing parent directories of an output are created
+    char directory[] = "/tmp/rfidx-manifest-XXXXXX";
+    assert_non_null(mkdtemp(directory));
+    char nested[64];
+    char copied[sizeof(nested) + 16];
+    snprintf(nested, sizeof(nested), "%s/nested", directory);
+    snprintf(copied, sizeof(copied), "%s/copied.bin", nested);
+
+    char text[1024];
+    snprintf(text, sizeof(text),
+             "{\"input\": \"./tests/assets/mifare-classic-1k-v2.bin\", \"transform\": \"wipe\", "
+             "\"output\": \"%s\", \"output_format\": \"binary\"}\n"
+             "\n"
+             "{\"input\": \"./tests/assets/ntag215.bin\", \"input_type\": \"ntag215\", "
+             "\"output\": \"%s\", \"output_format\": \"binary\"}\n"
+             "not json\n"
+             "{\"input\": \"./tests/assets/ntag215.bin\", \"transform\": \"shred\", "
+             "\"output\": \"%s\", \"output_format\": \"binary\"}\n"
+             "{\"input\": \"./tests/assets/missing.bin\", \"input_type\": \"mfc1k\", "
+             "\"output\": \"%s\", \"output_format\": \"binary\"}\n",
+             wiped, copied, copied, copied);
+    FILE *manifest = fmemopen(text, strlen(text), "r");
+    assert_non_null(manifest);
+
+    RfidxStatus statuses[8];
+    for (size_t i = 0; i < 8; i++) statuses[i] = RFIDX_OK;
+    const RfidxManifestOptions options = {
+        .retail_key = NULL,
+        .on_result = record_manifest_result,
+        .user = statuses,
+    };
+    RfidxBatchSummary summary;
+    assert_int_equal(rfidx_run_manifest(&rfidx_default_context, manifest, &options, &summary), RFIDX_OK);
+    fclose(manifest);
+
+    assert_int_equal(summary.converted, 2);
+    assert_int_equal(summary.failed, 3);
+    assert_int_equal(statuses[1], RFIDX_OK);
+    assert_int_equal(statuses[3], RFIDX_OK);
+    assert_int_equal(statuses[4], RFIDX_JSON_PARSE_ERROR);
+    assert_int_equal(statuses[5], RFIDX_UNKNOWN_ENUM_ERROR);
+    assert_int_equal(statuses[6], RFIDX_BINARY_FILE_IO_ERROR);
+
+    Mfc1kData expected_mfc;
+    MfcMetadataHeader mfc_header;
+    Mfc1kData *pexpected = &expected_mfc;
+    MfcMetadataHeader *pheader = &mfc_header;
+    assert_int_equal(mfc1k_load_from_binary("./tests/assets/mifare-classic-1k-v2.bin", &expected_mfc, &mfc_header),
+                     RFIDX_OK);
+    assert_int_equal(mfc1k_transform_data(&pexpected, &pheader, TRANSFORM_WIPE), RFIDX_OK);
+    Mfc1kData mfc;
+    assert_int_equal(mfc1k_load_from_binary(wiped, &mfc, &mfc_header), RFIDX_OK);
+    assert_memory_equal(&mfc, &expected_mfc, sizeof(mfc));
+
+    Ntag215Data expected_ntag;
+    Ntag21xMetadataHeader expected_header;
+    Ntag215Data ntag;
+    Ntag21xMetadataHeader ntag_header;
+    assert_int_equal(ntag215_load_from_binary("./tests/assets/ntag215.bin", &expected_ntag, &expected_header),
+                     RFIDX_OK);
+    assert_int_equal(ntag215_load_from_binary(copied, &ntag, &ntag_header), RFIDX_OK);
+    assert_memory_equal(&ntag, &expected_ntag, sizeof(ntag));
+
+    unlink(wiped);
+    unlink(copied);
+    // Failed jobs leave no partial output behind
+    assert_int_equal(rmdir(nested), 0);
+    rmdir(directory);
+}
+
+typedef struct {
+    const char *input_dir;
+    const char *output_dir;
+    RfidxWatchOptions options;
+    RfidxWatchSummary summary;
+    RfidxStatus status;
+} WatchRun;
+
+static void *run_watch_thread(void *arg) {
+    WatchRun *run = arg;
+    run->status = rfidx_watch(run->input_dir, run->output_dir, &run->options, &run->summary);
+    return NULL;
+}
+
+static void test_rfidx_watch(void **state) {
+    (void) state;
+    char input_dir[] = "/tmp/rfidx-watch-in-XXXXXX";
+    char output_dir[] = "/tmp/rfidx-watch-out-XXXXXX";
+    assert_non_null(mkdtemp(input_dir));
+    assert_non_null(mkdtemp(output_dir));
+
+    char *content = NULL;
+    size_t length = 0;
+    char path[128];
+    assert_int_equal(read_file("./tests/assets/mifare-classic-1k-v2.bin", &content, &length,
+                               RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+    snprintf(path, sizeof(path), "%s/first.bin", input_dir);
+    assert_int_equal(write_file(path, content, length, true, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+
+    // Without a stop flag, the files already there are converted and the call returns
+    WatchRun run = {
+        .input_dir = input_dir,
+        .output_dir = output_dir,
+        .options = {
+            .input_type = TAG_UNSPECIFIED,
+            .command = TRANSFORM_WIPE,
+            .output_format = FORMAT_NFC,
+            .threads = 2,
+        },
+    };
+    assert_int_equal(rfidx_watch(input_dir, output_dir, &run.options, &run.summary), RFIDX_OK);
+    assert_int_equal(run.summary.converted, 1);
+    assert_int_equal(run.summary.skipped, 0);
+
+    // A file with the same stem would replace the output of the first one
+    char twin[128];
+    snprintf(twin, sizeof(twin), "%s/first.dump", input_dir);
+    assert_int_equal(write_file(twin, content, length, true, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+
+    // A restart skips the file, then picks up the one that arrives while watching
+    volatile sig_atomic_t stop = 0;
+    run.options.stop = &stop;
+    pthread_t thread;
+    assert_int_equal(pthread_create(&thread, NULL, run_watch_thread, &run), 0);
+
+    snprintf(path, sizeof(path), "%s/.second.tmp", input_dir);
+    assert_int_equal(write_file(path, content, length, true, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+    char arrived[128];
+    snprintf(arrived, sizeof(arrived), "%s/second.bin", input_dir);
+    assert_int_equal(rename(path, arrived), 0);
+
+    char output[128];
+    snprintf(output, sizeof(output), "%s/second.nfc", output_dir);
+    for (int i = 0; i < 100 && access(output, F_OK) != 0; i++) {
+        usleep(50000);
+    }
+    stop = 1;
+    pthread_join(thread, NULL);
+
+    assert_int_equal(run.status, RFIDX_OK);
+    assert_int_equal(run.summary.converted, 1);
+    assert_int_equal(run.summary.failed, 1);
+    assert_int_equal(run.summary.skipped, 1);
+
+    Mfc1kData expected;
+    MfcMetadataHeader header;
+    Mfc1kData *pexpected = &expected;
+    MfcMetadataHeader *pheader = &header;
+    assert_int_equal(mfc1k_load_from_binary("./tests/assets/mifare-classic-1k-v2.bin", &expected, &header), RFIDX_OK);
+    assert_int_equal(mfc1k_transform_data(&pexpected, &pheader, TRANSFORM_WIPE), RFIDX_OK);
+    Mfc1kData data;
+    assert_int_equal(mfc1k_load_from_nfc(output, &data, &header), RFIDX_OK);
+    assert_memory_equal(&data, &expected, sizeof(data));
+
+    // Watch mode does not use a cache, so it refuses the option instead of ignoring it
+    char *argv[] = {
+        "rfidx", "watch",
+        "--cache", output_dir,
+        "--output-format", "nfc",
+        input_dir, output_dir,
+        NULL
+    };
+    const int argc = sizeof(argv) / sizeof(argv[0]) - 1;
+    assert_int_equal(rfidx_main(argc, argv, stdout, stderr), EXIT_FAILURE);
+
+    unlink(output);
+    snprintf(output, sizeof(output), "%s/first.nfc", output_dir);
+    unlink(output);
+    snprintf(output, sizeof(output), "%s/" RFIDX_WATCH_STATE_FILE, output_dir);
+    unlink(output);
+    unlink(arrived);
+    unlink(twin);
+    snprintf(path, sizeof(path), "%s/first.bin", input_dir);
+    unlink(path);
+    assert_int_equal(rmdir(output_dir), 0);
+    assert_int_equal(rmdir(input_dir), 0);
+    rfidx_free(content);
+}
+
+static int remove_tree(const char *path) {
+    DIR *dir = opendir(path);
+    if (!dir) {
+        return remove(path);
+    }
+
+    const struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        char child[PATH_MAX];
+        if (snprintf(child, sizeof(child), "%s/%s", path, entry->d_name) >= (int) sizeof(child)) continue;
+        remove_tree(child);
+    }
+    closedir(dir);
+    return rmdir(path);
+}
+
+static void test_rfidx_convert_cached(void **state) {
+    (void) state;
+    char cache_dir[] = "/tmp/rfidx-cache-XXXXXX";
+    assert_non_null(mkdtemp(cache_dir));
+    char first[] = "/tmp/rfidx-cached-XXXXXX";
+    char second[] = "/tmp/rfidx-cached-XXXXXX";
+    const int first_fd = mkstemp(first);
+    const int second_fd = mkstemp(second);
+    assert_true(first_fd >= 0 && second_fd >= 0);
+    close(first_fd);
+    close(second_fd);
+
+    assert_false(rfidx_cache_applies(TRANSFORM_RANDOMIZE_UID));
+    assert_false(rfidx_cache_applies(TRANSFORM_GENERATE));
+    bool hit = true;
+    assert_int_equal(rfidx_convert_cached(&rfidx_default_context, cache_dir, "./tests/assets/mifare-classic-1k-v2.bin",
+                                          MFC_1K, TRANSFORM_RANDOMIZE_UID, FORMAT_NFC, NULL, first, &hit),
+                     RFIDX_UNKNOWN_ENUM_ERROR);
+    assert_false(hit);
+
+    assert_int_equal(rfidx_convert_cached(&rfidx_default_context, cache_dir, "./tests/assets/mifare-classic-1k-v2.bin",
+                                          TAG_UNSPECIFIED, TRANSFORM_WIPE, FORMAT_NFC, NULL, first, &hit), RFIDX_OK);
+    assert_false(hit);
+    assert_int_equal(rfidx_convert_cached(&rfidx_default_context, cache_dir, "./tests/assets/mifare-classic-1k-v2.bin",
+                                          TAG_UNSPECIFIED, TRANSFORM_WIPE, FORMAT_NFC, NULL, second, &hit), RFIDX_OK);
+    assert_true(hit);
+
+    // The cached output is the one a fresh conversion writes
+    char *first_content = NULL;
+    char *second_content = NULL;
+    size_t first_len = 0;
+    size_t second_len = 0;
+    assert_int_equal(read_file(first, &first_content, &first_len, RFIDX_NFC_FILE_IO_ERROR), RFIDX_OK);
+    assert_int_equal(read_file(second, &second_content, &second_len, RFIDX_NFC_FILE_IO_ERROR), RFIDX_OK);
+    assert_int_equal(first_len, second_len);
+    assert_memory_equal(first_content, second_content, first_len);
+
+    // Any other output format is a different entry
+    uint8_t key[RFIDX_CACHE_KEY_SIZE];
+    uint8_t other_key[RFIDX_CACHE_KEY_SIZE];
+    rfidx_cache_key((const uint8_t *) "dump", 4, TAG_UNSPECIFIED, TRANSFORM_WIPE, FORMAT_NFC, key);
+    rfidx_cache_key((const uint8_t *) "dump", 4, TAG_UNSPECIFIED, TRANSFORM_WIPE, FORMAT_BINARY, other_key);
+    assert_memory_not_equal(key, other_key, RFIDX_CACHE_KEY_SIZE);
+    char *cached = NULL;
+    size_t cached_len = 0;
+    assert_int_equal(rfidx_cache_lookup(cache_dir, other_key, &cached, &cached_len), RFIDX_BINARY_FILE_IO_ERROR);
+    rfidx_free(cached);
+
+    assert_int_equal(rfidx_cache_store(cache_dir, key, "cached", 6), RFIDX_OK);
+    assert_int_equal(rfidx_cache_lookup(cache_dir, key, &cached, &cached_len), RFIDX_OK);
+    assert_int_equal(cached_len, 6);
+    assert_memory_equal(cached, "cached", 6);
+
+    rfidx_free(cached);
+    rfidx_free(first_content);
+    rfidx_free(second_content);
+    unlink(first);
+    unlink(second);
+    assert_int_equal(remove_tree(cache_dir), 0);
+}
+
+// The JSON and binary dumps of the same Mifare Classic tag, and an Amiibo: a/mfc.json, b.bin, ntag215.bin
+static void make_mixed_corpus(const char *dir) {
+    const char *assets[][2] = {
+        {"./tests/assets/mifare-classic-1k-v2.json", "a/mfc.json"},
+        {"./tests/assets/mifare-classic-1k-v2.bin", "b.bin"},
+        {"./tests/assets/ntag215.bin", "ntag215.bin"},
+    };
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/a", dir);
+    assert_int_equal(mkdir(path, 0700), 0);
+    for (size_t i = 0; i < 3; i++) {
+        char *content = NULL;
+        size_t length = 0;
+        assert_int_equal(read_file(assets[i][0], &content, &length, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+        snprintf(path, sizeof(path), "%s/%s", dir, assets[i][1]);
+        assert_int_equal(write_file(path, content, length, true, RFIDX_BINARY_FILE_IO_ERROR), RFIDX_OK);
+        rfidx_free(content);
+    }
+}
+
+static RfidxStatus count_archive_record(const size_t number, const RfidxArchiveRecord *record, void *user) {
+    (void) number;
+    assert_non_null(record->data);
+    (*(size_t *) user)++;
+    return RFIDX_OK;
+}
+
+static void record_unpack_collision(const char *input, const char *output, const RfidxStatus status, void *user) {
+    if (status != RFIDX_OK) {
+        assert_int_equal(status, RFIDX_OUTPUT_COLLISION_ERROR);
+        assert_string_equal(input, "#3");
+        assert_non_null(output);
+        (*(size_t *) user)++;
+    }
+}
+
+static void test_rfidx_archive(void **state) {
+    (void) state;
+    char input_dir[] = "/tmp/rfidx-pack-in-XXXXXX";
+    char output_dir[] = "/tmp/rfidx-pack-out-XXXXXX";
+    assert_non_null(mkdtemp(input_dir));
+    assert_non_null(mkdtemp(output_dir));
+
+    make_mixed_corpus(input_dir);
+    char path[PATH_MAX];
+
+    // The first dump in name order makes it a Mifare Classic archive, so the NTAG dump is left out
+    char archive_path[PATH_MAX];
+    snprintf(archive_path, sizeof(archive_path), "%s/dumps.rfa", output_dir);
+    RfidxBatchSummary summary;
+    assert_int_equal(rfidx_archive_pack(input_dir, archive_path, TAG_UNSPECIFIED, NULL, NULL, &summary), RFIDX_OK);
+    assert_int_equal(summary.converted, 2);
+    assert_int_equal(summary.failed, 1);
+
+    RfidxArchiveWriter writer;
+    assert_int_equal(rfidx_archive_open(archive_path, &writer), RFIDX_OK);
+    assert_int_equal(writer.tag_type, MFC_1K);
+    Mfc1kData expected;
+    MfcMetadataHeader header;
+    assert_int_equal(mfc1k_load_from_binary("./tests/assets/mifare-classic-1k-v2.bin", &expected, &header), RFIDX_OK);
+    assert_int_equal(rfidx_archive_append(&writer, &expected, NULL, NULL), RFIDX_OK);
+    assert_int_equal(rfidx_archive_close(&writer), RFIDX_OK);
+
+    RfidxArchive archive;
+    assert_int_equal(rfidx_archive_map(archive_path, &archive), RFIDX_OK);
+    assert_int_equal(archive.tag_type, MFC_1K);
+    assert_int_equal(archive.count, 3);
+    RfidxArchiveRecord record;
+    assert_int_equal(rfidx_archive_get(&archive, 0, &record), RFIDX_OK);
+    assert_int_equal(record.name_len, strlen("a/mfc.json"));
+    assert_memory_equal(record.name, "a/mfc.json", record.name_len);
+    assert_int_equal(rfidx_archive_get(&archive, 1, &record), RFIDX_OK);
+    assert_memory_equal(record.name, "b.bin", record.name_len);
+    assert_memory_equal(record.data, &expected, sizeof(expected));
+    assert_memory_equal(record.header, &header, sizeof(header));
+    assert_int_equal(rfidx_archive_get(&archive, 2, &record), RFIDX_OK);
+    assert_int_equal(record.name_len, 0);
+    assert_int_equal(rfidx_archive_get(&archive, 3, &record), RFIDX_BUFFER_SIZE_ERROR);
+    size_t visited = 0;
+    assert_int_equal(rfidx_archive_iterate(&archive, count_archive_record, &visited), RFIDX_OK);
+    assert_int_equal(visited, 3);
+    const size_t record_size = archive.record_size;
+    rfidx_archive_unmap(&archive);
+
+    assert_int_equal(rfidx_archive_unpack(archive_path, output_dir, FORMAT_BINARY, NULL, NULL, &summary), RFIDX_OK);
+    assert_int_equal(summary.converted, 3);
+    assert_int_equal(summary.failed, 0);
+    const char *unpacked[] = {"a/mfc.bin", "b.bin", "2.bin"};
+    for (size_t i = 0; i < 3; i++) {
+        snprintf(path, sizeof(path), "%s/%s", output_dir, unpacked[i]);
+        Mfc1kData data;
+        MfcMetadataHeader data_header;
+        assert_int_equal(mfc1k_load_from_binary(path, &data, &data_header), RFIDX_OK);
+        assert_memory_equal(&data, &expected, sizeof(expected));
+    }
+
+    // A record that only differs in its extension from an earlier one is not written over it
+    assert_int_equal(rfidx_archive_open(archive_path, &writer), RFIDX_OK);
+    Mfc1kData wiped;
+    Mfc1kData *pwiped = &wiped;
+    MfcMetadataHeader *pheader = &header;
+    assert_int_equal(mfc1k_load_from_binary("./tests/assets/mifare-classic-1k-v2.bin", &wiped, &header), RFIDX_OK);
+    assert_int_equal(mfc1k_transform_data(&pwiped, &pheader, TRANSFORM_WIPE), RFIDX_OK);
+    assert_int_equal(rfidx_archive_append(&writer, &wiped, NULL, "a/mfc.bin"), RFIDX_OK);
+    assert_int_equal(rfidx_archive_close(&writer), RFIDX_OK);
+    size_t collisions = 0;
+    assert_int_equal(rfidx_archive_unpack(archive_path, output_dir, FORMAT_BINARY, record_unpack_collision,
+                                          &collisions, &summary), RFIDX_OK);
+    assert_int_equal(summary.converted, 3);
+    assert_int_equal(summary.failed, 1);
+    assert_int_equal(collisions, 1);
+    snprintf(path, sizeof(path), "%s/a/mfc.bin", output_dir);
+    Mfc1kData data;
+    assert_int_equal(mfc1k_load_from_binary(path, &data, &header), RFIDX_OK);
+    assert_memory_equal(&data, &expected, sizeof(expected));
+
+    // A flipped bit in a record is caught when it is read
+    const int fd = open(archive_path, O_RDWR);
+    assert_true(fd >= 0);
+    const off_t damaged = (off_t) (RFIDX_ARCHIVE_HEADER_SIZE + record_size + 100);
+    uint8_t byte;
+    assert_int_equal(pread(fd, &byte, 1, damaged), 1);
+    byte ^= 0x01;
+    assert_int_equal(pwrite(fd, &byte, 1, damaged), 1);
+    close(fd);
+    assert_int_equal(rfidx_archive_map(archive_path, &archive), RFIDX_OK);
+    assert_int_equal(rfidx_archive_get(&archive, 0, &record), RFIDX_OK);
+    assert_int_equal(rfidx_archive_get(&archive, 1, &record), RFIDX_CHECKSUM_ERROR);
+    visited = 0;
+    assert_int_equal(rfidx_archive_iterate(&archive, count_archive_record, &visited), RFIDX_CHECKSUM_ERROR);
+    assert_int_equal(visited, 1);
+    rfidx_archive_unmap(&archive);
+
+    // An unfinished archive has no index to trust
+    assert_int_equal(rfidx_archive_create(archive_path, NTAG_215, &writer), RFIDX_OK);
+    fflush(writer.file);
+    assert_int_equal(rfidx_archive_map(archive_path, &archive), RFIDX_FILE_FORMAT_ERROR);
+    assert_int_equal(rfidx_archive_close(&writer), RFIDX_OK);
+    assert_int_equal(rfidx_archive_map(archive_path, &archive), RFIDX_OK);
+    assert_int_equal(archive.count, 0);
+    rfidx_archive_unmap(&archive);
+
+    assert_int_equal(remove_tree(input_dir), 0);
+    assert_int_equal(remove_tree(output_dir), 0);
+}
+
+static void record_uid_duplicate(const uint8_t *uid, const size_t uid_len, const char *first,
+                                 const char *duplicate, void *user) {
+    (void) uid;
+    assert_int_equal(uid_len, 4);
+    assert_string_equal(first, "a/mfc.json");
+    assert_string_equal(duplicate, "b.bin");
+    (*(size_t *) user)++;
+}
+
+static void test_rfidx_uid_index(void **state) {
+    (void) state;
+    char input_dir[] = "/tmp/rfidx-uid-in-XXXXXX";
+    char output_dir[] = "/tmp/rfidx-uid-out-XXXXXX";
+    assert_non_null(mkdtemp(input_dir));
+    assert_non_null(mkdtemp(output_dir));
+
+    make_mixed_corpus(input_dir);
+
+    char index_path[PATH_MAX];
+    snprintf(index_path, sizeof(index_path), "%s/uids.idx", output_dir);
+    size_t duplicates = 0;
+    RfidxUidIndexSummary summary;
+    assert_int_equal(rfidx_uid_index_build(input_dir, index_path, record_uid_duplicate, &duplicates, &summary),
+                     RFIDX_OK);
+    assert_int_equal(summary.indexed, 3);
+    assert_int_equal(summary.duplicates, 1);
+    assert_int_equal(summary.failed, 0);
+    assert_int_equal(duplicates, 1);
+
+    Mfc1kData mfc;
+    MfcMetadataHeader mfc_header;
+    assert_int_equal(mfc1k_load_from_binary("./tests/assets/mifare-classic-1k-v2.bin", &mfc, &mfc_header), RFIDX_OK);
+    uint8_t uid[RFIDX_UID_MAX_SIZE];
+    size_t uid_len = 0;
+    assert_int_equal(rfidx_tag_uid(MFC_1K, &mfc, uid, &uid_len), RFIDX_OK);
+    assert_int_equal(uid_len, 4);
+
+    RfidxUidIndex index;
+    assert_int_equal(rfidx_uid_index_map(index_path, &index), RFIDX_OK);
+    assert_int_equal(index.record_count, 3);
+    size_t records[2];
+    assert_int_equal(rfidx_uid_index_lookup(&index, uid, uid_len, records, 2), 2);
+    assert_int_equal(records[0] + records[1], 1);
+    const char *name;
+    size_t name_len;
+    assert_int_equal(rfidx_uid_index_name(&index, 1, &name, &name_len), RFIDX_OK);
+    assert_memory_equal(name, "b.bin", name_len);
+    assert_int_equal(rfidx_uid_index_name(&index, 3, &name, &name_len), RFIDX_BUFFER_SIZE_ERROR);
+
+    Ntag215Data ntag;
+    Ntag21xMetadataHeader ntag_header;
+    assert_int_equal(ntag215_load_from_binary("./tests/assets/ntag215.bin", &ntag, &ntag_header), RFIDX_OK);
+    assert_int_equal(rfidx_tag_uid(NTAG_215, &ntag, uid, &uid_len), RFIDX_OK);
+    assert_int_equal(uid_len, 7);
+    assert_int_equal(rfidx_uid_index_lookup(&index, uid, uid_len, records, 2), 1);
+    assert_int_equal(records[0], 2);
+    // The same leading bytes with another length are another UID
+    assert_int_equal(rfidx_uid_index_lookup(&index, uid, 4, NULL, 0), 0);
+    uid[6] ^= 0xFF;
+    assert_int_equal(rfidx_uid_index_lookup(&index, uid, uid_len, NULL, 0), 0);
+    rfidx_uid_index_unmap(&index);
+
+    // An archive keeps the numbering and names of its records
+    char archive_path[PATH_MAX];
+    snprintf(archive_path, sizeof(archive_path), "%s/dumps.rfa", output_dir);
+    assert_int_equal(rfidx_archive_pack(input_dir, archive_path, MFC_1K, NULL, NULL, NULL), RFIDX_OK);
+    duplicates = 0;
+    assert_int_equal(rfidx_uid_index_build(archive_path, index_path, record_uid_duplicate, &duplicates, &summary),
+                     RFIDX_OK);
+    assert_int_equal(summary.indexed, 2);
+    assert_int_equal(summary.duplicates, 1);
+    assert_int_equal(duplicates, 1);
+    assert_int_equal(rfidx_uid_index_map(index_path, &index), RFIDX_OK);
+    assert_int_equal(index.record_count, 2);
+    assert_int_equal(rfidx_tag_uid(MFC_1K, &mfc, uid, &uid_len), RFIDX_OK);
+    assert_int_equal(rfidx_uid_index_lookup(&index, uid, uid_len, records, 2), 2);
+    rfidx_uid_index_unmap(&index);
+
+    // Anything else is not an index
+    assert_int_equal(rfidx_uid_index_map(archive_path, &index), RFIDX_FILE_FORMAT_ERROR);
+
+    assert_int_equal(remove_tree(input_dir), 0);
+    assert_int_equal(remove_tree(output_dir), 0);
+}
+
+static void test_rfidx_store(void **state) {
+    (void) state;
+    char input_dir[] = "/tmp/rfidx-store-in-XXXXXX";
+    char store_dir[] = "/tmp/rfidx-store-XXXXXX";
+    assert_non_null(mkdtemp(input_dir));
+    assert_non_null(mkdtemp(store_dir));
+
+    make_mixed_corpus(input_dir);
+    char path[PATH_MAX];
+
+    // The JSON and binary Mifare Classic dumps hold the same data
+    RfidxStoreSummary summary;
+    assert_int_equal(rfidx_store_add_tree(store_dir, input_dir, TAG_UNSPECIFIED, NULL, NULL, &summary), RFIDX_OK);
+    assert_int_equal(summary.added, 3);
+    assert_int_equal(summary.deduplicated, 1);
+    assert_int_equal(summary.failed, 0);
+
+    TagType tag_type;
+    void *data = NULL;
+    void *header = NULL;
+    assert_int_equal(rfidx_store_get(store_dir, "ntag215.bin", &tag_type, &data, &header), RFIDX_OK);
+    // The asset is an Amiibo, which is detected as such
+    assert_int_equal(tag_type, AMIIBO);
+    Ntag215Data ntag;
+    Ntag21xMetadataHeader ntag_header;
+    assert_int_equal(ntag215_load_from_binary("./tests/assets/ntag215.bin", &ntag, &ntag_header), RFIDX_OK);
+    assert_memory_equal(data, &ntag, sizeof(ntag));
+    assert_memory_equal(header, &ntag_header, sizeof(ntag_header));
+    rfidx_free(data);
+    rfidx_free(header);
+
+    // Only the header differs, so the data object is shared
+    ntag_header.version[0] ^= 0xFF;
+    bool deduplicated = false;
+    assert_int_equal(rfidx_store_add(store_dir, "copies/ntag215.bin", NTAG_215, &ntag, &ntag_header, &deduplicated),
+                     RFIDX_OK);
+    assert_true(deduplicated);
+    assert_int_equal(rfidx_store_get(store_dir, "copies/ntag215.bin", &tag_type, &data, &header), RFIDX_OK);
+    assert_memory_equal(header, &ntag_header, sizeof(ntag_header));
+    rfidx_free(data);
+    rfidx_free(header);
+
+    assert_int_equal(rfidx_store_add(store_dir, "../escape.bin", NTAG_215, &ntag, &ntag_header, NULL),
+                     RFIDX_FILE_FORMAT_ERROR);
+    assert_int_equal(rfidx_store_add(store_dir, "a//b.bin", NTAG_215, &ntag, &ntag_header, NULL),
+                     RFIDX_FILE_FORMAT_ERROR);
+    assert_int_equal(rfidx_store_get(store_dir, "missing.bin", &tag_type, &data, &header), RFIDX_BINARY_FILE_IO_ERROR);
+    assert_null(data);
+
+    // Replacing both references to the NTAG data orphans its object
+    size_t kept = 0;
+    size_t removed = 0;
+    assert_int_equal(rfidx_store_gc(store_dir, &kept, &removed), RFIDX_OK);
+    assert_int_equal(kept, 2);
+    assert_int_equal(removed, 0);
+    ntag.pages[10][0] ^= 0xFF;
+    assert_int_equal(rfidx_store_add(store_dir, "ntag215.bin", NTAG_215, &ntag, &ntag_header, &deduplicated), RFIDX_OK);
+    assert_false(deduplicated);
+    assert_int_equal(rfidx_store_add(store_dir, "copies/ntag215.bin", NTAG_215, &ntag, &ntag_header, &deduplicated),
+                     RFIDX_OK);
+    assert_true(deduplicated);
+    assert_int_equal(rfidx_store_gc(store_dir, &kept, &removed), RFIDX_OK);
+    assert_int_equal(kept, 2);
+    assert_int_equal(removed, 1);
+
+    // A damaged object is caught when it is read
+    snprintf(path, sizeof(path), "%s/objects", store_dir);
+    RfidxFileList objects;
+    assert_int_equal(list_files(path, &objects), RFIDX_OK);
+    assert_int_equal(objects.count, 2);
+    for (size_t i = 0; i < objects.count; i++) {
+        snprintf(path, sizeof(path), "%s/objects/%s", store_dir, objects.paths[i]);
+        const int fd = open(path, O_RDWR);
+        assert_true(fd >= 0);
+        assert_int_equal(pwrite(fd, "x", 1, 100), 1);
+        close(fd);
+    }
+    free_file_list(&objects);
+    assert_int_equal(rfidx_store_get(store_dir, "ntag215.bin", &tag_type, &data, &header), RFIDX_CHECKSUM_ERROR);
+    assert_null(data);
+    assert_null(header);
+
+    assert_int_equal(remove_tree(input_dir), 0);
+    assert_int_equal(remove_tree(store_dir), 0);
+}
+
 static const struct CMUnitTest rfidx_tests[] = {
     cmocka_unit_test(test_rfidx_string_to_transform_command),
     cmocka_unit_test(test_rfidx_read_tag_from_file_ntag215),
     cmocka_unit_test(test_rfidx_read_tag_from_file_amiibo),
     cmocka_unit_test(test_rfidx_read_tag_from_file_unknown),
+    cmocka_unit_test(test_rfidx_read_tag_from_file_detect),
     cmocka_unit_test(test_rfidx_read_tag_from_file_missing),
     cmocka_unit_test(test_rfidx_save_tag_to_file_binary),
     cmocka_unit_test(test_rfidx_save_tag_to_file_invalid_format),
@@ -295,6 +1429,24 @@ static const struct CMUnitTest rfidx_tests[] = {
     cmocka_unit_test(test_rfidx_randomize_uid_mfc1k),
     cmocka_unit_test(test_rfidx_randomize_uid_amiibo),
     cmocka_unit_test(test_rfidx_generate_amiibo),
+    cmocka_unit_test(test_rfidx_write_file_vectored),
+    cmocka_unit_test(test_rfidx_in_place_wipe_ntag215),
+    cmocka_unit_test(test_rfidx_in_place_randomize_uid_mfc1k),
+    cmocka_unit_test(test_rfidx_read_fd_pipe),
+    cmocka_unit_test(test_rfidx_read_tag_from_buffer_nfc),
+    cmocka_unit_test(test_rfidx_binary_to_stdout),
+    cmocka_unit_test(test_rfidx_stdin_needs_format),
+    cmocka_unit_test(test_rfidx_convert_stream_mfc1k_wipe),
+    cmocka_unit_test(test_rfidx_convert_stream_partial_record),
+    cmocka_unit_test(test_rfidx_output_format_list),
+    cmocka_unit_test(test_rfidx_fan_out_formats),
+    cmocka_unit_test(test_rfidx_batch_convert),
+    cmocka_unit_test(test_rfidx_run_manifest),
+    cmocka_unit_test(test_rfidx_watch),
+    cmocka_unit_test(test_rfidx_convert_cached),
+    cmocka_unit_test(test_rfidx_archive),
+    cmocka_unit_test(test_rfidx_uid_index),
+    cmocka_unit_test(test_rfidx_store),
 };
 
 const struct CMUnitTest *get_rfidx_tests(size_t *count) {
@@ -13,6 +13,11 @@
 #include <setjmp.h>
 #include <cmocka.h>
 
+extern const struct CMUnitTest *get_common_tests(size_t *count);
+extern const struct CMUnitTest *get_json_reader_tests(size_t *count);
+extern const struct CMUnitTest *get_detect_tests(size_t *count);
+extern const struct CMUnitTest *get_columns_tests(size_t *count);
+extern const struct CMUnitTest *get_delta_tests(size_t *count);
 extern const struct CMUnitTest *get_ntag21x_tests(size_t *count);
 extern const struct CMUnitTest *get_ntag215_tests(size_t *count);
 extern const struct CMUnitTest *get_mfc1k_tests(size_t *count);
@@ -46,12 +51,22 @@ struct CombinedTests combine_test_arrays(
 }
 
 int main(const int argc, char **argv) {
+    size_t common_count;
+    size_t json_reader_count;
+    size_t detect_count;
+    size_t columns_count;
+    size_t delta_count;
     size_t ntag21x_count;
     size_t ntag215_count;
     size_t mfc1k_count;
     size_t amiibo_count;
     size_t rfidx_count;
 
+    const struct CMUnitTest *common_tests = get_common_tests(&common_count);
+    const struct CMUnitTest *json_reader_tests = get_json_reader_tests(&json_reader_count);
+    const struct CMUnitTest *detect_tests = get_detect_tests(&detect_count);
+    const struct CMUnitTest *columns_tests = get_columns_tests(&columns_count);
+    const struct CMUnitTest *delta_tests = get_delta_tests(&delta_count);
     const struct CMUnitTest *ntag21x_tests = get_ntag21x_tests(&ntag21x_count);
     const struct CMUnitTest *ntag215_tests = get_ntag215_tests(&ntag215_count);
     const struct CMUnitTest *mfc1k_tests = get_mfc1k_tests(&mfc1k_count);
@@ -59,6 +74,11 @@ int main(const int argc, char **argv) {
     const struct CMUnitTest *rfidx_tests = get_rfidx_tests(&rfidx_count);
 
     const struct CMUnitTest *test_arrays[] = {
+        common_tests,
+        json_reader_tests,
+        detect_tests,
+        columns_tests,
+        delta_tests,
         ntag21x_tests,
         ntag215_tests,
         mfc1k_tests,
@@ -66,6 +86,11 @@ int main(const int argc, char **argv) {
         rfidx_tests
     };
     const size_t test_counts[] = {
+        common_count,
+        json_reader_count,
+        detect_count,
+        columns_count,
+        delta_count,
         ntag21x_count,
         ntag215_count,
         mfc1k_count,